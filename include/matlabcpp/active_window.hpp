@@ -7,82 +7,14 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include "matlabcpp/array.hpp"
 
 namespace matlabcpp {
 
 // ========== VARIABLE STORAGE ==========
 
-class Variable {
-public:
-    enum class Type { Scalar, Vector, Matrix };
-    
-private:
-    Type type_;
-    double scalar_value_;
-    std::vector<double> vector_value_;
-    std::vector<std::vector<double>> matrix_value_;
-    
-public:
-    // Constructors
-    Variable() : type_(Type::Scalar), scalar_value_(0.0) {}
-    
-    explicit Variable(double value) 
-        : type_(Type::Scalar), scalar_value_(value) {}
-    
-    explicit Variable(const std::vector<double>& vec) 
-        : type_(Type::Vector), scalar_value_(0.0), vector_value_(vec) {}
-    
-    explicit Variable(const std::vector<std::vector<double>>& mat) 
-        : type_(Type::Matrix), scalar_value_(0.0), matrix_value_(mat) {}
-    
-    // Type checks
-    bool is_scalar() const { return type_ == Type::Scalar; }
-    bool is_vector() const { return type_ == Type::Vector; }
-    bool is_matrix() const { return type_ == Type::Matrix; }
-    
-    // Accessors
-    double as_scalar() const { return scalar_value_; }
-    const std::vector<double>& as_vector() const { return vector_value_; }
-    const std::vector<std::vector<double>>& as_matrix() const { return matrix_value_; }
-    
-    // Info
-    std::string type_string() const {
-        switch (type_) {
-            case Type::Scalar: return "double";
-            case Type::Vector: return "double";
-            case Type::Matrix: return "double";
-        }
-        return "unknown";
-    }
-    
-    std::string size_string() const {
-        switch (type_) {
-            case Type::Scalar: return "1x1";
-            case Type::Vector: return "1x" + std::to_string(vector_value_.size());
-            case Type::Matrix: {
-                if (matrix_value_.empty()) return "0x0";
-                return std::to_string(matrix_value_.size()) + "x" + 
-                       std::to_string(matrix_value_[0].size());
-            }
-        }
-        return "0x0";
-    }
-    
-    size_t memory_size() const {
-        switch (type_) {
-            case Type::Scalar: return sizeof(double);
-            case Type::Vector: return vector_value_.size() * sizeof(double);
-            case Type::Matrix: {
-                size_t total = 0;
-                for (const auto& row : matrix_value_) {
-                    total += row.size() * sizeof(double);
-                }
-                return total;
-            }
-        }
-        return 0;
-    }
-};
+// Workspace variables are plain numeric arrays (array.hpp)
+using Variable = Array;
 
 // Forward declaration
 class Workspace;
@@ -105,6 +37,12 @@ public:
     // Script execution support
     void process_command_external(const std::string& line);
     double get_scalar(const std::string& name) const;
+    const Variable* find_variable(const std::string& name) const;  // nullptr if undefined
+    void set_variable(const std::string& name, Variable value);
+    Variable call_function(const std::string& func_name, const std::vector<Variable>& args);
+    void show_variable(const std::string& name, const Variable& var);  // "name = ..." block
+    void show_ans(const Variable& var);                                // "ans = ..." block
+    Workspace& workspace() { return *workspace_; }                    // slot-level access (workspace.hpp)
 
     // Configuration
     void set_fancy_mode(bool fancy) { fancy_mode_ = fancy; }
@@ -119,9 +57,6 @@ private:
     
     // Expression evaluation
     Variable evaluate_expression(const std::string& expr);
-    Variable evaluate_function_call(const std::string& func_name, const std::string& args_str);
-    Variable parse_vector(const std::string& expr);
-    Variable parse_matrix(const std::string& content);
     Variable evaluate_math_expression(const std::string& expr);
     
     // Display
@@ -129,6 +64,7 @@ private:
     void display_value(const Variable& var);
     void list_variables();
     void list_variables_detailed();
+    void show_memory(const std::string& option);   // "memory [trim]"
     
     // UI
     void print_banner();
@@ -1,5 +1,7 @@
 #pragma once
 #include "core.hpp"
+#include "matlabcpp/fft.hpp"
+#include <memory>
 #include <vector>
 #include <complex>
 #include <functional>
@@ -102,12 +104,30 @@ struct FFTResult {
     double peak_frequency;
 };
 
+// One second-order section: (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+struct Biquad {
+    double b0, b1, b2, a1, a2;
+};
+
 class SignalProcessing {
 public:
     // Fast Fourier Transform
     static FFTResult fft(const std::vector<double>& signal, double fs);
     
-    // Filters
+    // Butterworth designs as cascaded biquads, cutoffs in Hz (bilinear
+    // transform with prewarping, like MATLAB's butter). Bandpass has
+    // order * 2 poles. Odd orders end in a first-order section (b2 = a2 = 0).
+    static std::vector<Biquad> butter_lowpass(int order, double cutoff, double fs);
+    static std::vector<Biquad> butter_highpass(int order, double cutoff, double fs);
+    static std::vector<Biquad> butter_bandpass(int order, double low, double high, double fs);
+
+    // Causal filtering through the cascade, and the zero-phase
+    // forward-backward version (reflected ends, steady-state initial
+    // conditions, as in MATLAB)
+    static std::vector<double> sosfilt(const std::vector<Biquad>& sos, const std::vector<double>& signal);
+    static std::vector<double> filtfilt(const std::vector<Biquad>& sos, const std::vector<double>& signal);
+
+    // Zero-phase Butterworth filters
     static std::vector<double> lowpass(const std::vector<double>& signal, 
                                        double cutoff, double fs, int order = 5);
     
@@ -117,11 +137,98 @@ public:
     static std::vector<double> bandpass(const std::vector<double>& signal,
                                         double low, double high, double fs, int order = 5);
     
-    // Convolution
+    // Full convolution, length a.size() + b.size() - 1: a direct SIMD sum
+    // for short kernels, overlap-save FFT blocks for long ones
     static std::vector<double> convolve(const std::vector<double>& a,
                                         const std::vector<double>& b);
 };
 
+// Short-time Fourier transform of a signal that arrives in blocks of any
+// size. Frames of frame_size samples start every hop samples; each one is
+// windowed, transformed with a cached real FFT plan and handed to the
+// callback as soon as its last sample arrives. Only one frame of input
+// is ever held, however long the stream.
+//
+//   StreamingSTFT stft(1024, 256);
+//   while (read(block)) stft.push(block, [&](size_t frame, const auto& bins) { ... });
+class StreamingSTFT {
+public:
+    enum class Window { Rectangular, Hann, Hamming };
+    using Spectrum = std::vector<std::complex<double>>;       // frame_size/2 + 1 bins
+    using FrameCallback = std::function<void(size_t frame, const Spectrum& spectrum)>;
+
+    StreamingSTFT(size_t frame_size, size_t hop, Window window = Window::Hann);
+
+    void push(const double* samples, size_t count, const FrameCallback& on_frame);
+    void push(const std::vector<double>& samples, const FrameCallback& on_frame) {
+        push(samples.data(), samples.size(), on_frame);
+    }
+    // Zero-pads and emits a final frame if samples past the last frame are pending
+    void flush(const FrameCallback& on_frame);
+    void reset();
+
+    size_t frame_size() const { return frame_size_; }
+    size_t hop() const { return hop_; }
+    size_t bins() const { return frame_size_ / 2 + 1; }
+    size_t frames() const { return frames_; }
+
+private:
+    size_t frame_size_, hop_;
+    std::shared_ptr<const fft::RealPlan> plan_;
+    std::vector<double> window_;
+    std::vector<double> pending_;      // start of the next frame, < frame_size_ samples
+    std::vector<double> frame_;        // windowed copy handed to the FFT
+    Spectrum spectrum_;
+    size_t skip_ = 0;                  // input still to drop when hop > frame_size
+    size_t frames_ = 0;
+    bool fresh_ = false;               // pending_ holds samples no frame has used
+
+    void emit(const FrameCallback& on_frame);
+};
+
+// Convolution of an unbounded signal with a fixed FIR kernel, one block at
+// a time. The kernel spectrum is computed once; each block costs one
+// forward and one inverse real FFT of size fft_size() >= block + taps - 1.
+// Output comes out in order: after pushing N samples, the first
+// floor(N / block_size()) * block_size() samples of conv(x, kernel) have
+// been emitted, and flush() emits the rest, for N + taps - 1 in all.
+//
+//   StreamingConvolver fir(taps);                    // overlap-save
+//   fir.push(block.data(), block.size(), out);       // appends to out
+class StreamingConvolver {
+public:
+    enum class Method { OverlapAdd, OverlapSave };
+
+    // block_size 0 picks one from the kernel length
+    explicit StreamingConvolver(std::vector<double> kernel, size_t block_size = 0,
+                                Method method = Method::OverlapSave);
+
+    void push(const double* samples, size_t count, std::vector<double>& out);
+    void push(const std::vector<double>& samples, std::vector<double>& out) {
+        push(samples.data(), samples.size(), out);
+    }
+    void flush(std::vector<double>& out);
+    void reset();
+
+    size_t taps() const { return taps_; }
+    size_t block_size() const { return block_; }
+    size_t fft_size() const { return size_; }
+    Method method() const { return method_; }
+
+private:
+    size_t taps_, block_, size_;
+    Method method_;
+    std::shared_ptr<const fft::RealPlan> plan_;
+    std::vector<std::complex<double>> kernel_spectrum_;   // scaled by 1/fft_size
+    std::vector<std::complex<double>> spectrum_;
+    std::vector<double> input_;        // overlap-save: last size - block inputs, then the new block
+    std::vector<double> frame_;
+    std::vector<double> tail_;         // overlap-add: carried into the next block
+    size_t filled_ = 0;                // new samples in the current block
+
+    void process_block(std::vector<double>& out, size_t keep);
+};
+
 // ========== Finite Element Analysis ==========
 
 struct FEMResult {
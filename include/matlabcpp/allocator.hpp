@@ -0,0 +1,75 @@
+// MatLabC++ Aligned Allocation
+// include/matlabcpp/allocator.hpp
+//
+// Array payloads are 64-byte aligned (one cache line, one AVX-512
+// register), so kernels can use aligned vector loads and never straddle
+// cache lines at the start of a buffer.
+//
+// AlignedVector::resize(n) default-initializes, i.e. leaves doubles
+// uninitialized; use resize(n, 0.0) or assign() when zeros are needed.
+//
+// Buffers come from the size-class pool (buffer_pool.hpp), so a freed
+// buffer is reused by the next allocation of a similar size.
+
+#pragma once
+
+#include "matlabcpp/buffer_pool.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace matlabcpp {
+
+constexpr std::size_t kArrayAlignment = 64;
+
+template <typename T, std::size_t Alignment = kArrayAlignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n == 0) return nullptr;
+        if (n > static_cast<std::size_t>(-1) / sizeof(T)) throw std::bad_alloc();
+        if constexpr (Alignment <= kArrayAlignment) {
+            return static_cast<T*>(buffer_pool::allocate(n * sizeof(T)));
+        }
+        std::size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        void* p = ::operator new(bytes, std::align_val_t(Alignment));
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if constexpr (Alignment <= kArrayAlignment) {
+            buffer_pool::deallocate(p, n * sizeof(T));
+        } else if (p) {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+    }
+
+    template <typename U>
+    void construct(U* p) noexcept {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+using AlignedVector = std::vector<double, AlignedAllocator<double>>;
+
+} // namespace matlabcpp
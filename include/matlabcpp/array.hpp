@@ -0,0 +1,122 @@
+// MatLabC++ Array
+// include/matlabcpp/array.hpp
+//
+// The one numeric array type: N-d, column-major, contiguous, 64-byte
+// aligned and copy-on-write. The workspace (Variable), the Value API and
+// the script VM all use it, so kernels can walk data() linearly.
+//
+//   Array a(2, 3);                   // 2x3 zeros
+//   Array v(std::vector<double>{1, 2, 3});  // 1x3 row
+//   Array b = a;                     // shares a's buffer until written
+//   b(0, 1) = 5.0;                   // detaches, then writes
+//
+// 1x1 arrays keep their value inline (no heap allocation), which keeps
+// scalar-heavy script code cheap.
+
+#pragma once
+
+#include "matlabcpp/allocator.hpp"
+#include "matlabcpp/cow.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace matlabcpp {
+
+class Array {
+public:
+    // Shape class: 1x1, 1xN / Nx1, anything else (including N-d)
+    enum Type { SCALAR, VECTOR, MATRIX };
+
+private:
+    size_t rows_ = 1;
+    size_t cols_ = 1;
+    std::vector<size_t> trailing_dims_;   // dims 3..N, empty for 2-D arrays
+    size_t numel_ = 1;
+    double scalar_ = 0.0;                 // payload when numel == 1
+    CowPtr<AlignedVector> data_;          // payload otherwise
+
+    void set_shape(const std::vector<size_t>& dims);
+    void adopt(AlignedVector data);
+
+public:
+    // ----- construction -----
+    Array() = default;
+    explicit Array(double value) : scalar_(value) {}
+    explicit Array(const std::vector<double>& row);                  // 1xN row vector
+    explicit Array(const std::vector<std::vector<double>>& rows);    // row-of-rows literal
+    Array(size_t rows, size_t cols);                                 // zeros
+    Array(size_t rows, size_t cols, const std::vector<double>& column_major);
+    Array(size_t rows, size_t cols, AlignedVector column_major);
+
+    // N-d; trailing singleton dimensions are dropped
+    static Array zeros(const std::vector<size_t>& dims);
+    // Contents unspecified: for kernels that overwrite every element
+    static Array uninitialized(size_t rows, size_t cols);
+    static Array uninitialized(const std::vector<size_t>& dims);
+
+    // ----- shape -----
+    Type type() const {
+        if (numel_ == 1) return SCALAR;
+        if (trailing_dims_.empty() && (rows_ == 1 || cols_ == 1)) return VECTOR;
+        return MATRIX;
+    }
+    bool is_scalar() const { return type() == SCALAR; }
+    bool is_vector() const { return type() == VECTOR; }
+    bool is_matrix() const { return type() == MATRIX; }
+    bool empty() const { return numel_ == 0; }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t ndims() const { return 2 + trailing_dims_.size(); }
+    size_t dim(size_t k) const;               // 0-based; 1 beyond ndims()
+    std::vector<size_t> dims() const;
+    size_t numel() const { return numel_; }
+    size_t size() const { return numel_; }
+
+    // Same data, new shape (numel must match); shares the buffer
+    Array reshape(const std::vector<size_t>& dims) const;
+
+    // x(n) = ... growth for vectors: keeps orientation (row if ambiguous),
+    // zero-fills, and reuses spare buffer capacity so repeated appends are
+    // amortized O(1). Throws for matrices.
+    void resize_vector(size_t n);
+
+    // ----- element access (column-major) -----
+    const double* data() const { return numel_ == 1 ? &scalar_ : data_->data(); }
+    double* mutable_data();                   // detaches a shared buffer first
+    const double* begin() const { return data(); }
+    const double* end() const { return data() + numel_; }
+
+    double operator()(size_t i) const { return data()[i]; }
+    double operator()(size_t i, size_t j) const { return data()[i + j * rows_]; }
+    double& operator()(size_t i) { return mutable_data()[i]; }
+    double& operator()(size_t i, size_t j) { return mutable_data()[i + j * rows_]; }
+
+    double as_scalar() const;                 // throws unless numel == 1
+
+    // Conversions for code that still wants std containers (copies; keep
+    // them off hot paths)
+    std::vector<double> as_vector() const { return std::vector<double>(begin(), end()); }
+    std::vector<std::vector<double>> as_matrix() const;
+
+    bool shares_data_with(const Array& other) const {
+        return numel_ > 1 && other.numel_ > 1 && data_.same_buffer(other.data_);
+    }
+
+    // ----- info -----
+    std::string type_string() const { return "double"; }
+    std::string size_string() const;
+    size_t memory_size() const { return numel_ * sizeof(double); }
+
+    // ----- arithmetic -----
+    Array operator+(const Array& other) const;
+    Array operator-(const Array& other) const;
+    Array operator*(const Array& other) const;      // Matrix multiply
+    Array dot_times(const Array& other) const;      // Element-wise .*
+    Array transpose() const;                        // A'
+
+    std::string to_string() const;
+};
+
+} // namespace matlabcpp
@@ -0,0 +1,68 @@
+// MatLabC++ Buffer Pool
+// include/matlabcpp/buffer_pool.hpp
+//
+// Size-class pool behind AlignedAllocator (allocator.hpp), so Array
+// payloads, ComplexTensor storage and kernel scratch reuse freed buffers
+// instead of going back to operator new. An iterative solver that frees
+// and reallocates the same few shapes every step runs from the pool after
+// its first step.
+//
+// Sizes round up to one of four classes per power of two (at most 25%
+// waste). Each thread keeps a small cache of blocks up to 256 KiB; larger
+// blocks and the overflow of thread caches go to a shared pool. Idle
+// blocks in the shared pool and the thread caches together stay within
+// cache_limit(); the rest are freed. Blocks of
+// 2 MiB and more are 2 MiB aligned and advised for transparent huge
+// pages, so big matrices take fewer TLB entries.
+//
+//   BufferPoolStats s = buffer_pool::stats();    // the REPL's "memory"
+//   buffer_pool::trim();                         // idle blocks back to the OS
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace matlabcpp {
+
+struct BufferPoolStats {
+    uint64_t allocations = 0;       // blocks handed out
+    uint64_t hits = 0;              // ... of which came from a cache
+    uint64_t system_allocations = 0;
+    uint64_t system_frees = 0;
+    size_t bytes_in_use = 0;        // block bytes held by live buffers
+    size_t bytes_requested = 0;     // what those buffers asked for
+    size_t peak_bytes_in_use = 0;
+    size_t bytes_cached = 0;        // idle blocks kept for reuse
+    size_t bytes_thread_cached = 0; // ... of which in per-thread caches
+
+    double hit_rate() const { return allocations ? double(hits) / double(allocations) : 0.0; }
+    // Internal: share of in-use bytes lost to size-class rounding
+    double fragmentation() const {
+        return bytes_in_use ? 1.0 - double(bytes_requested) / double(bytes_in_use) : 0.0;
+    }
+};
+
+namespace buffer_pool {
+
+// At least 64-byte aligned; bytes == 0 gives nullptr. deallocate must get
+// the same byte count allocate did.
+void* allocate(size_t bytes);
+void deallocate(void* p, size_t bytes) noexcept;
+
+BufferPoolStats stats();
+void reset_peak();                  // peak_bytes_in_use = bytes_in_use
+
+// Idle bytes the pool keeps, thread caches included (default 256 MiB, or
+// MATLABCPP_POOL_LIMIT_MB); lowering it frees the excess
+size_t cache_limit();
+void set_cache_limit(size_t bytes);
+
+// Frees every idle block. The shared pool and the calling thread's cache
+// are freed now; other threads free their caches on their next allocate
+// or deallocate, so bytes_thread_cached can stay nonzero until they run.
+// set_cache_limit flushes the thread caches the same way.
+void trim();
+
+} // namespace buffer_pool
+} // namespace matlabcpp
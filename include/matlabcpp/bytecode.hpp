@@ -0,0 +1,193 @@
+// MatLabC++ Script Bytecode
+// include/matlabcpp/bytecode.hpp
+//
+// A .m script is compiled once (tokens -> AST -> register bytecode) and
+// then executed by a small dispatch loop, so loop bodies are never
+// re-lexed or re-parsed. Lines the compiler does not understand are kept
+// as source text and handed to ActiveWindow at run time, exactly like the
+// old line-by-line interpreter did.
+
+#pragma once
+
+#include "matlabcpp/active_window.hpp"
+#include "matlabcpp/workspace.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace matlabcpp {
+namespace interpreter {
+
+// Bump whenever the instruction set, operand encoding or CompiledScript
+// layout changes; invalidates on-disk caches (script_cache.hpp).
+constexpr uint32_t kBytecodeVersion = 6;
+
+// ========== INSTRUCTION SET ==========
+
+enum class OpCode : uint8_t {
+    Nop,
+    LoadConst,      // r[a] = K[b]
+    LoadVar,        // r[a] = workspace[V[b]]
+    StoreVar,       // workspace[V[b]] = op(a)
+    Move,           // r[a] = op(b)            (register sources are moved from)
+
+    // Unary:  r[a] = op op(b)
+    Neg, Not, Transpose,
+
+    // Binary: r[a] = op(b) <op> op(c)
+    Add, Sub, Mul, Div, LeftDiv, Pow,
+    ElemMul, ElemDiv, ElemPow,
+    Eq, Ne, Lt, Le, Gt, Ge,
+    And, Or,
+
+    Range,          // r[a] = r[b] : r[b+1] (n == 2)  or  r[b] : r[b+1] : r[b+2] (n == 3)
+    HorzCat,        // r[a] = [r[b] r[b+1] ... r[b+c-1]]
+    VertCat,        // r[a] = [r[b]; r[b+1]; ... r[b+c-1]]
+    CallOrIndex,    // r[a] = V[c](r[b] .. r[b+n-1]) - indexes a variable, else calls a builtin;
+                    // flags & kColonIndex: the one subscript is a bare ':'
+    StoreIndex,     // workspace[V[c]](r[b] .. r[b+n-1]) = r[a]
+    Fused,          // r[a] = fused elementwise kernel F[b], then pc = c; falls through
+                    // to the equivalent unfused code when operand shapes don't allow it
+    EndOf,          // r[a] = size of workspace[V[b]] along dim (c >> 8) of (c & 0xff) subscripts
+
+    Jump,           // pc = a
+    JumpIfFalse,    // if !truthy(op(a)) pc = b
+    JumpIfTrue,     // if  truthy(op(a)) pc = b
+
+    ForRangePrep,   // r[a..a+2] = start, step, stop  ->  r[a+3] = count, r[a+4] = 0
+    ForRangeNext,   // if r[a+4] < r[a+3]: workspace[V[b]] = start + k*step, k++  else pc = c
+    ForEachPrep,    // r[a] = iterable  ->  r[a+1] = 0
+    ForEachNext,    // if columns remain: workspace[V[b]] = next column  else pc = c
+
+    Display,        // show workspace[V[b]]; n = DisplayMode (None only checks it exists)
+    Command,        // forward S[b] to ActiveWindow (clear, clc, close, ...)
+    EvalText,       // forward uncompiled source S[b] to ActiveWindow
+    Section,        // %% section marker, title S[b]
+    Raise,          // throw S[b]
+    Halt
+};
+
+enum class DisplayMode : uint8_t { None = 0, Named = 1, Ans = 2 };
+
+// Operand encoding: plain values are register numbers, values with
+// kConstBit set index the constant pool and values with kSlotBit set
+// index the symbol table (read straight from the workspace, no copy).
+constexpr uint32_t kConstBit = 0x80000000u;
+constexpr uint32_t kSlotBit = 0x40000000u;
+constexpr uint32_t kOperandMask = 0x3fffffffu;
+
+// Instruction::flags
+constexpr uint16_t kColonIndex = 1;
+
+struct Instruction {
+    OpCode op;
+    uint8_t n;      // small immediate (argument/subscript count, display mode)
+    uint16_t flags;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+// Source mapping for error recovery: when an instruction in [begin, end)
+// throws, the error is reported against `line` and execution resumes at
+// `resume` (the next statement, or the false branch of a condition).
+struct StatementInfo {
+    uint32_t begin;
+    uint32_t end;
+    uint32_t resume;
+    uint32_t line;
+};
+
+// An elementwise expression tree flattened into one kernel, evaluated a
+// cache-sized tile at a time instead of one full-size temporary per
+// operator. Values 0 .. n_inputs-1 are the leaf operands (VM operand
+// encodings in fused_inputs); op k produces value n_inputs + k and the
+// last op is the result.
+struct FusedOp {
+    OpCode op;      // binary/unary opcode, or CallOrIndex for an elementwise builtin
+    uint8_t fn;     // kernels::UnaryOp of the builtin
+    uint16_t pad;
+    uint32_t x;     // value index
+    uint32_t y;     // value index (binary) or builtin symbol V[y]
+};
+
+struct FusedKernel {
+    uint32_t first_input;
+    uint32_t n_inputs;
+    uint32_t first_op;
+    uint32_t n_ops;
+};
+
+struct CompiledScript {
+    std::vector<Instruction> code;
+    std::vector<Variable> constants;
+    std::vector<std::string> strings;     // S: command text, messages, section titles
+    std::vector<std::string> symbols;     // V: variable names, bound to workspace slots at run time
+    std::vector<StatementInfo> statements;
+    std::vector<FusedKernel> fused;       // F: fused elementwise kernels
+    std::vector<uint32_t> fused_inputs;
+    std::vector<FusedOp> fused_ops;
+    uint32_t num_registers = 0;
+    size_t source_lines = 0;
+};
+
+// Compile .m source text. Never throws for bad input: statements that fail
+// to parse are compiled as EvalText/Raise so errors surface at run time
+// with the right line number.
+CompiledScript compile(const std::string& source);
+
+// Compile a single expression (REPL input) whose value ends up in
+// register 0 for VM::evaluate. Throws std::runtime_error if `source` is
+// not exactly one expression.
+CompiledScript compile_expression(const std::string& source);
+
+// Human-readable listing (for debugging the compiler)
+std::string disassemble(const CompiledScript& script);
+
+// ========== VIRTUAL MACHINE ==========
+
+class VM {
+public:
+    struct Result {
+        std::vector<std::string> errors;
+        std::vector<std::string> sections;
+    };
+
+    VM(ActiveWindow& window, bool verbose = true)
+        : window_(window), verbose_(verbose) {}
+
+    Result run(const CompiledScript& script);
+
+    // Runs a compile_expression() result and returns its value; errors
+    // propagate as exceptions
+    Variable evaluate(const CompiledScript& expression);
+
+private:
+    ActiveWindow& window_;
+    bool verbose_;
+    std::vector<Variable> regs_;
+    Workspace* ws_ = nullptr;
+    std::vector<Workspace::Slot> slots_;   // symbol index -> workspace slot
+
+    // Fused kernel state, reused across executions
+    struct FusedValue {
+        const double* data;   // input array
+        double scalar;        // scalar input or folded scalar subtree
+        uint32_t tile;        // scratch tile of an array temporary
+        uint8_t kind;
+    };
+    std::vector<FusedValue> fused_values_;
+
+    const Variable& operand(const CompiledScript& s, uint32_t op) const {
+        if (op & kConstBit) return s.constants[op & kOperandMask];
+        if (op & kSlotBit) return ws_->get(slots_[op & kOperandMask]);
+        return regs_[op];
+    }
+    void bind(const CompiledScript& s);
+    bool run_fused(const CompiledScript& s, const FusedKernel& k, Variable& result);
+    // Runs until Halt; on a throw `pc` is left at the faulting instruction
+    void execute(const CompiledScript& s, uint32_t& pc, Result& result);
+};
+
+} // namespace interpreter
+} // namespace matlabcpp
@@ -1,4 +1,6 @@
 #pragma once
+#include "matlabcpp/allocator.hpp"
+#include "matlabcpp/device.hpp"
 #include <complex>
 #include <vector>
 #include <cstddef>
@@ -9,8 +11,16 @@ namespace matlabcpp {
 
 // Forward declarations
 class TensorStorage;
+class PlanarStorage;
+class GPUStorage;
 enum class Device { CPU, GPU };
 
+// Element layout in memory. Interleaved stores std::complex pairs;
+// Planar (split complex) stores the real parts and the imaginary parts in
+// two separate arrays, and leaves out the imaginary one while the tensor
+// is real.
+enum class Layout { Interleaved, Planar };
+
 // Complex-aware tensor for MATLAB compatibility
 class ComplexTensor {
 public:
@@ -21,7 +31,10 @@ public:
     ComplexTensor(size_t rows, size_t cols, Device device = Device::CPU);
     ComplexTensor(size_t rows, size_t cols, size_t depth, Device device = Device::CPU);
     
-    // From real data
+    // Planar zeros: real, no imaginary plane
+    static ComplexTensor planar(size_t rows, size_t cols, size_t depth = 1);
+
+    // From real data (planar, real)
     static ComplexTensor from_real(const std::vector<double>& data, size_t rows, size_t cols);
     
     // From complex data
@@ -38,51 +51,109 @@ public:
     bool is_matrix() const { return rows_ > 1 && cols_ > 1 && depth_ == 1; }
     bool is_3d() const { return depth_ > 1; }
     
-    // Device management
+    // Device management. GPU tensors live on DeviceBackend::current()
+    // (device.hpp). Elementwise operators, scalar products, conj and
+    // matrix products run there when either operand does, uploading a
+    // host operand, and leave the result on the device. Element reads and
+    // data() use a host copy that is downloaded once and kept while the
+    // device has nothing newer; anything else runs on the host copy.
     Device device() const { return device_; }
     void to_gpu();                // Move to GPU
     void to_cpu();                // Move to CPU
     ComplexTensor on_gpu() const; // Copy to GPU
     ComplexTensor on_cpu() const; // Copy to CPU
     
+    // Layout. Elementwise operators, times, abs, angle and matrix products
+    // have planar kernels and keep a result planar when all operands are.
+    // Anything that needs a Complex* (data(), the reference accessors,
+    // the decompositions) converts a planar tensor to interleaved first:
+    // one O(n) pass, after which it stays interleaved.
+    Layout layout() const;
+    void to_planar();             // drops the imaginary plane if all zero
+    void to_interleaved();
+    bool is_real() const;         // planar without an imaginary plane
+    
     // Data access (CPU only)
     Complex& operator()(size_t i, size_t j);
-    Complex operator()(size_t i, size_t j) const;
+    Complex operator()(size_t i, size_t j) const;   // either layout
     Complex& operator()(size_t i, size_t j, size_t k);
     Complex operator()(size_t i, size_t j, size_t k) const;
     
-    const Complex* data() const;
+    const Complex* data() const;  // converts to interleaved
     Complex* data();
+    // Planes; these convert to planar. imag_data() is null while the
+    // tensor is real; the non-const overload creates a zero plane.
+    const double* real_data() const;
+    double* real_data();
+    const double* imag_data() const;
+    double* imag_data();
     
     // Real/Imaginary parts
     ComplexTensor real() const;
     ComplexTensor imag() const;
-    ComplexTensor conj() const;  // Complex conjugate
+    ComplexTensor conj() const &;  // Complex conjugate
+    ComplexTensor conj() &&;
     ComplexTensor abs() const;   // Magnitude
     ComplexTensor angle() const; // Phase
     
-    // Basic operations (GPU-accelerated if on GPU)
-    ComplexTensor operator+(const ComplexTensor& other) const;
-    ComplexTensor operator-(const ComplexTensor& other) const;
+    // Basic operations (GPU-accelerated if on GPU). The && overloads
+    // reuse a temporary left operand's buffer: in A.times(B) + C the
+    // product's storage becomes the sum's.
+    ComplexTensor operator+(const ComplexTensor& other) const &;
+    ComplexTensor operator+(const ComplexTensor& other) &&;
+    ComplexTensor operator-(const ComplexTensor& other) const &;
+    ComplexTensor operator-(const ComplexTensor& other) &&;
     ComplexTensor operator*(const ComplexTensor& other) const;  // Matrix multiply
-    ComplexTensor operator/(const ComplexTensor& other) const;  // Element-wise
+    ComplexTensor operator/(const ComplexTensor& other) const &;  // Element-wise
+    ComplexTensor operator/(const ComplexTensor& other) &&;
     
     ComplexTensor& operator+=(const ComplexTensor& other);
     ComplexTensor& operator-=(const ComplexTensor& other);
     
     // Scalar operations
-    ComplexTensor operator*(const Complex& scalar) const;
-    ComplexTensor operator/(const Complex& scalar) const;
+    ComplexTensor operator*(const Complex& scalar) const &;
+    ComplexTensor operator*(const Complex& scalar) &&;
+    ComplexTensor operator/(const Complex& scalar) const &;
+    ComplexTensor operator/(const Complex& scalar) &&;
     
     // Element-wise operations
-    ComplexTensor times(const ComplexTensor& other) const;  // .*
-    ComplexTensor rdivide(const ComplexTensor& other) const; // ./
+    ComplexTensor times(const ComplexTensor& other) const &;  // .*
+    ComplexTensor times(const ComplexTensor& other) &&;
+    ComplexTensor rdivide(const ComplexTensor& other) const &; // ./
+    ComplexTensor rdivide(const ComplexTensor& other) &&;
+    
+    // In place; these allocate only to change layout (an interleaved
+    // operand makes a planar tensor interleaved) or to add an imaginary
+    // plane to a real one
+    ComplexTensor& add_inplace(const ComplexTensor& other);      // +=
+    ComplexTensor& sub_inplace(const ComplexTensor& other);      // -=
+    ComplexTensor& times_inplace(const ComplexTensor& other);    // .*=
+    ComplexTensor& scale_inplace(const Complex& scalar);
+    ComplexTensor& conj_inplace();
+    
+    // Output parameters: the result goes to out, reusing out's buffer when
+    // it already has the result's shape, device and layout (and an
+    // imaginary plane is not in the way of a real planar result), so a
+    // loop over preallocated tensors does no heap work after its first
+    // pass. out may be one of the operands. Elementwise operands of
+    // different shapes, and matrix products whose inner dimensions differ,
+    // throw std::invalid_argument.
+    void plus(const ComplexTensor& other, ComplexTensor& out) const;
+    void minus(const ComplexTensor& other, ComplexTensor& out) const;
+    void times(const ComplexTensor& other, ComplexTensor& out) const;
+    void times(const Complex& scalar, ComplexTensor& out) const;
+    void rdivide(const ComplexTensor& other, ComplexTensor& out) const;
+    void mtimes(const ComplexTensor& other, ComplexTensor& out) const;  // matrix product
+    void conj(ComplexTensor& out) const;
+    void abs(ComplexTensor& out) const;
     
     // Linear algebra
     ComplexTensor transpose() const;        // A'  (conjugate transpose)
     ComplexTensor transpose_no_conj() const; // A.' (transpose without conjugate)
+    // Built on one LU factorization (ComplexLUFactorization below)
     ComplexTensor inv() const;              // Matrix inverse
-    ComplexTensor solve(const ComplexTensor& b) const; // A\b
+    ComplexTensor solve(const ComplexTensor& b) const; // A\b, b n x k for any k
+    Complex det() const;
     
     // Reductions
     Complex sum() const;
@@ -91,22 +162,35 @@ public:
     double norm() const;    // Frobenius norm
     
     // Decompositions (GPU-accelerated)
-    void lu(ComplexTensor& L, ComplexTensor& U, ComplexTensor& P) const;
-    void qr(ComplexTensor& Q, ComplexTensor& R) const;
-    void svd(ComplexTensor& U, std::vector<double>& S, ComplexTensor& V) const;
+    // A(p, :) = L * U, like [L, U, p] = lu(A, 'vector')
+    void lu(ComplexTensor& L, ComplexTensor& U, std::vector<size_t>& p) const;
+    // economy: Q is m x min(m, n) and R is min(m, n) x n, like qr(A, 0)
+    void qr(ComplexTensor& Q, ComplexTensor& R, bool economy = false) const;
+    // A = U diag(S) V^H, S descending. Full: U m x m, V n x n; economy:
+    // min(m, n) columns each, like svd(A, 'econ')
+    void svd(ComplexTensor& U, std::vector<double>& S, ComplexTensor& V, bool economy = false) const;
+    std::vector<double> singular_values() const;    // s = svd(A), no vectors
+    // Unit-norm eigenvectors; throws if the QR iteration does not converge
     void eig(std::vector<Complex>& eigenvalues, ComplexTensor& eigenvectors) const;
     
     // FFT (GPU-accelerated)
     ComplexTensor fft() const;
     ComplexTensor ifft() const;
-    ComplexTensor fft2() const;  // 2D FFT
+    ComplexTensor fft2() const;  // 2D FFT (of each page when 3D)
     ComplexTensor ifft2() const;
+    ComplexTensor fftn() const;  // along all three dimensions
+    ComplexTensor ifftn() const;
+    // Real input: bins 0..n/2 of fft(signal) as a row (the rest are conjugates)
+    static ComplexTensor rfft(const std::vector<double>& signal);
+    // Inverse of rfft for a half spectrum of an n-point signal; throws
+    // std::invalid_argument unless this is a vector of n/2 + 1 bins
+    std::vector<double> irfft(size_t n) const;
     
     // Display
     std::string to_string() const;
     
     // Memory info
-    size_t memory_bytes() const { return size() * sizeof(Complex); }
+    size_t memory_bytes() const;
     bool is_on_gpu() const { return device_ == Device::GPU; }
     
 private:
@@ -117,7 +201,65 @@ private:
     std::unique_ptr<TensorStorage> storage_;
     
     void ensure_cpu() const;
+    void ensure_layout(Layout layout) const;
+    PlanarStorage& planes() const;        // storage_ of a planar tensor
+    GPUStorage& device_storage() const;   // storage_ of a GPU tensor
     void sync_if_needed() const;
+    
+    // Device paths of the operators; out becomes a device tensor
+    bool on_device(const ComplexTensor& other) const {
+        return device_ == Device::GPU || other.device_ == Device::GPU;
+    }
+    void device_elementwise(DeviceOp op, const ComplexTensor& other, ComplexTensor& out) const;
+    void device_scale(const Complex& scalar, ComplexTensor& out) const;
+    void device_conj(ComplexTensor& out) const;
+    void device_mtimes(const ComplexTensor& other, ComplexTensor& out) const;
+    static ComplexTensor device_tensor(size_t rows, size_t cols, size_t depth);  // uninitialized
+};
+
+// Operand checks of the operators above, shared with LazyTensor: each
+// throws std::invalid_argument naming op and the mismatched sizes
+void check_same_shape(const char* op, size_t rows, size_t cols, size_t depth,
+                      size_t other_rows, size_t other_cols, size_t other_depth);
+void check_inner_dims(const char* op, size_t cols, size_t other_rows);
+
+// PA = LU with partial pivoting for square A, blocked like zgetrf. Factor
+// once, then solve any number of right-hand sides:
+//
+//   ComplexLUFactorization lu(A);
+//   ComplexTensor X = lu.solve(B);     // B n x k
+//   ComplexTensor Y = lu.solve(C);     // reuses the factors
+class ComplexLUFactorization {
+public:
+    using Complex = std::complex<double>;
+
+    ComplexLUFactorization() = default;
+    explicit ComplexLUFactorization(const ComplexTensor& A);   // A square, 2-D
+
+    size_t size() const { return n_; }
+    // Some pivot is exactly zero: determinant() is 0 and solve() throws
+    bool singular() const { return singular_; }
+
+    // X with A * X = B; B is n x k for any k
+    ComplexTensor solve(const ComplexTensor& B) const;
+    // Same, overwriting the n x nrhs column-major block at B
+    void solve_in_place(Complex* B, size_t ldb, size_t nrhs) const;
+
+    ComplexTensor inverse() const;
+    Complex determinant() const;
+
+    ComplexTensor lower() const;          // unit lower triangular L
+    ComplexTensor upper() const;          // U
+    // Step i swapped rows i and pivots()[i] (0-based, LAPACK order)
+    const std::vector<size_t>& pivots() const { return pivots_; }
+    // The same as a permutation: row i of L * U is row permutation()[i] of A
+    std::vector<size_t> permutation() const;
+
+private:
+    std::vector<Complex> lu_;             // n x n column-major, L below U
+    std::vector<size_t> pivots_;
+    size_t n_ = 0;
+    bool singular_ = false;
 };
 
 // Tensor storage abstraction (CPU/GPU)
@@ -131,6 +273,7 @@ public:
     virtual const Complex* data() const = 0;
     virtual size_t size() const = 0;
     virtual Device device() const = 0;
+    virtual Layout layout() const { return Layout::Interleaved; }
     
     virtual void to_gpu() = 0;
     virtual void to_cpu() = 0;
@@ -140,8 +283,10 @@ public:
 // CPU storage
 class CPUStorage : public TensorStorage {
 public:
+    using Buffer = std::vector<Complex, AlignedAllocator<Complex>>;   // pooled
+    
     explicit CPUStorage(size_t size);
-    CPUStorage(const std::vector<Complex>& data);
+    explicit CPUStorage(Buffer data);
     
     Complex* data() override { return data_.data(); }
     const Complex* data() const override { return data_.data(); }
@@ -153,39 +298,90 @@ public:
     std::unique_ptr<TensorStorage> clone() const override;
     
 private:
-    std::vector<Complex> data_;
+    Buffer data_;
 };
 
-// GPU storage (CUDA)
+// Split-complex CPU storage: 64-byte aligned real and imaginary planes.
+// The imaginary plane exists only once something writes it. There is no
+// interleaved view (data() is null); ComplexTensor converts instead.
+class PlanarStorage : public TensorStorage {
+public:
+    explicit PlanarStorage(size_t size);                 // zeros, real
+    PlanarStorage(AlignedVector re, AlignedVector im);   // empty im: real
+    
+    Complex* data() override { return nullptr; }
+    const Complex* data() const override { return nullptr; }
+    size_t size() const override { return re_.size(); }
+    Device device() const override { return Device::CPU; }
+    Layout layout() const override { return Layout::Planar; }
+    
+    void to_gpu() override;
+    void to_cpu() override {} // Already on CPU
+    std::unique_ptr<TensorStorage> clone() const override;
+    
+    double* real() { return re_.data(); }
+    const double* real() const { return re_.data(); }
+    const double* imag() const { return im_.empty() ? nullptr : im_.data(); }
+    double* imag();               // allocates a zero plane on first use
+    bool is_real() const { return im_.empty(); }
+    void clear_imag() { im_.clear(); }   // real again; keeps the capacity
+    
+private:
+    AlignedVector re_;
+    AlignedVector im_;
+};
+
+// Device storage on a DeviceBackend (device.hpp): the virtual device
+// unless a CUDA backend is installed. The device copy is the master; a
+// host copy is made on first host access and kept while it is current.
+// host_dirty_: the host copy has writes the device lacks (uploaded before
+// the next device use). gpu_dirty_: the device has results the host copy
+// lacks (downloaded, with a synchronize, before the next host access).
+// Commands go on the backend's default stream, so they stay ordered.
 class GPUStorage : public TensorStorage {
 public:
-    explicit GPUStorage(size_t size);
-    GPUStorage(const Complex* host_data, size_t size);
-    ~GPUStorage() override;
+    explicit GPUStorage(size_t size);                   // zeros
+    GPUStorage(const Complex* host_data, size_t size);  // uploads
+    ~GPUStorage() override;                             // stream-ordered free
     
-    // GPU memory access (for kernels)
-    Complex* gpu_ptr() { return gpu_data_; }
-    const Complex* gpu_ptr() const { return gpu_data_; }
+    // Contents unspecified: for device kernels that write every element
+    static std::unique_ptr<GPUStorage> uninitialized(size_t size);
     
-    // Host access (requires sync)
+    // Device memory for kernels. Both upload pending host writes; the
+    // non-const form also marks the host copy stale.
+    Complex* gpu_ptr();
+    const Complex* gpu_ptr() const;
+    DeviceBackend& backend() const { return *backend_; }
+    DeviceStream& stream() const { return backend_->default_stream(); }
+    
+    // Host view: downloads if the device copy is newer. The non-const form
+    // marks the device copy stale (the caller may write).
     Complex* data() override;
     const Complex* data() const override;
     size_t size() const override { return size_; }
     Device device() const override { return Device::GPU; }
     
-    void to_gpu() override {} // Already on GPU
-    void to_cpu() override;
-    std::unique_ptr<TensorStorage> clone() const override;
+    void to_gpu() override;       // upload pending host writes
+    void to_cpu() override;       // make the host copy current
+    std::unique_ptr<TensorStorage> clone() const override;  // device to device
+    
+    // The current host copy, moved out; a later host access downloads again
+    CPUStorage::Buffer release_host();
     
 private:
+    struct Uninitialized {};
+    GPUStorage(size_t size, Uninitialized);
+    
+    std::shared_ptr<DeviceBackend> backend_;
     Complex* gpu_data_;          // Device pointer
-    mutable std::vector<Complex> host_cache_; // For CPU access
+    mutable CPUStorage::Buffer host_cache_; // For CPU access
     size_t size_;
     mutable bool host_dirty_;
     mutable bool gpu_dirty_;
     
+    size_t bytes() const { return size_ * sizeof(Complex); }
     void sync_to_host() const;
-    void sync_to_gpu();
+    void sync_to_gpu() const;
     void allocate_gpu();
     void free_gpu();
 };
@@ -1,4 +1,6 @@
 #pragma once
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/linalg.hpp"
 #include <array>
 #include <vector>
 #include <functional>
@@ -7,6 +9,7 @@
 #include <cmath>
 #include <numbers>
 #include <stdexcept>
+#include <utility>
 
 namespace matlabcpp {
 
@@ -20,16 +23,19 @@ inline Matrix matmul(const Matrix& A, const Matrix& B) {
     const std::size_t kB = B.size();
     if (k != kB) throw std::invalid_argument("matmul: dimension mismatch");
     const std::size_t n = B[0].size();
-    Matrix C(m, std::vector<double>(n, 0.0));
+    // Row-major copies for the packed kernel: C' = B' * A' column-major
+    std::vector<double> a(m * k), b(k * n), c(m * n);
     for (std::size_t i = 0; i < m; ++i) {
         if (A[i].size() != k) throw std::invalid_argument("matmul: ragged A");
-        for (std::size_t p = 0; p < k; ++p) {
-            double a = A[i][p];
-            const auto& rowB = B[p];
-            if (rowB.size() != n) throw std::invalid_argument("matmul: ragged B");
-            for (std::size_t j = 0; j < n; ++j) C[i][j] += a * rowB[j];
-        }
+        std::copy(A[i].begin(), A[i].end(), a.begin() + i * k);
+    }
+    for (std::size_t p = 0; p < k; ++p) {
+        if (B[p].size() != n) throw std::invalid_argument("matmul: ragged B");
+        std::copy(B[p].begin(), B[p].end(), b.begin() + p * n);
     }
+    kernels::gemm(n, m, k, 1.0, b.data(), n, a.data(), k, 0.0, c.data(), n);
+    Matrix C(m);
+    for (std::size_t i = 0; i < m; ++i) C[i].assign(c.begin() + i * n, c.begin() + (i + 1) * n);
     return C;
 }
 
@@ -46,31 +52,20 @@ inline Vector matvec(const Matrix& A, const Vector& x) {
     return y;
 }
 
-inline Vector lu_solve(Matrix A, Vector b) {
+// One-shot solve; use LUFactorization (linalg.hpp) to reuse the factors
+inline Vector lu_solve(const Matrix& A, const Vector& b) {
     const std::size_t n = A.size();
     if (n == 0 || A[0].size() != n || b.size() != n) throw std::invalid_argument("lu_solve: dimension mismatch");
-    // LU with partial pivot (in-place)
-    for (std::size_t k = 0; k < n; ++k) {
-        std::size_t piv = k;
-        double maxv = std::abs(A[k][k]);
-        for (std::size_t i = k + 1; i < n; ++i) {
-            if (std::abs(A[i][k]) > maxv) { maxv = std::abs(A[i][k]); piv = i; }
-        }
-        if (maxv == 0.0) throw std::runtime_error("lu_solve: singular matrix");
-        if (piv != k) { std::swap(A[piv], A[k]); std::swap(b[piv], b[k]); }
-        for (std::size_t i = k + 1; i < n; ++i) {
-            A[i][k] /= A[k][k];
-            for (std::size_t j = k + 1; j < n; ++j) A[i][j] -= A[i][k] * A[k][j];
-            b[i] -= A[i][k] * b[k];
-        }
-    }
-    // Back substitution
-    Vector x(n);
-    for (int i = static_cast<int>(n) - 1; i >= 0; --i) {
-        double sum = b[i];
-        for (std::size_t j = i + 1; j < n; ++j) sum -= A[i][j] * x[j];
-        x[i] = sum / A[i][i];
+    Array a = Array::uninitialized(n, n);
+    double* p = a.mutable_data();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (A[i].size() != n) throw std::invalid_argument("lu_solve: dimension mismatch");
+        for (std::size_t j = 0; j < n; ++j) p[i + j * n] = A[i][j];
     }
+    LUFactorization lu(std::move(a));
+    if (lu.singular()) throw std::runtime_error("lu_solve: singular matrix");
+    Vector x = b;
+    lu.solve_in_place(x.data(), n, 1);
     return x;
 }
 
@@ -0,0 +1,53 @@
+// MatLabC++ Copy-on-Write Storage
+// include/matlabcpp/cow.hpp
+//
+// MATLAB value semantics without the copies: `b = a` shares a's buffer
+// and bumps a refcount; the buffer is duplicated only when one of the
+// owners mutates it while it is still shared.
+//
+// The refcount is atomic, so sharing across threads is safe, but two
+// threads must not mutate the *same* Variable/Value concurrently (exactly
+// as with std::vector).
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace matlabcpp {
+
+template <typename T>
+class CowPtr {
+    std::shared_ptr<T> ptr_;
+
+    static const T& empty_value() {
+        static const T empty{};
+        return empty;
+    }
+
+public:
+    CowPtr() = default;
+    explicit CowPtr(T value) : ptr_(std::make_shared<T>(std::move(value))) {}
+
+    // Read access never copies
+    const T& get() const { return ptr_ ? *ptr_ : empty_value(); }
+    const T& operator*() const { return get(); }
+    const T* operator->() const { return &get(); }
+
+    // Write access: detaches from other owners first
+    T& mutate() {
+        if (!ptr_) ptr_ = std::make_shared<T>();
+        else if (ptr_.use_count() > 1) ptr_ = std::make_shared<T>(*ptr_);
+        return *ptr_;
+    }
+
+    bool shared() const { return ptr_ && ptr_.use_count() > 1; }
+    long use_count() const { return ptr_.use_count(); }
+
+    // True if both refer to the same buffer (b = a without a later write)
+    bool same_buffer(const CowPtr& other) const { return ptr_ == other.ptr_; }
+
+    void reset() { ptr_.reset(); }
+};
+
+} // namespace matlabcpp
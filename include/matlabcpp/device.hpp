@@ -0,0 +1,158 @@
+// MatLabC++ Devices
+// include/matlabcpp/device.hpp
+//
+// What GPU tensors (GPUStorage in complex_tensor.hpp) run on. A backend
+// owns device memory and in-order command streams; every command is
+// asynchronous and ordered after the ones enqueued before it on the same
+// stream, like a CUDA stream.
+//
+// The reference backend, VirtualDevice, is a CPU "device": a fixed-size
+// memory arena standing in for device memory, and one worker thread per
+// stream executing the commands. Transfers can be given a modelled
+// bandwidth and commands a launch latency, so offload scheduling (what to
+// upload, when to synchronize) can be developed and measured without an
+// accelerator. A CUDA backend implements the same interface.
+//
+//   DeviceBackend& dev = *DeviceBackend::current();
+//   DeviceStream& s = dev.default_stream();
+//   void* d = dev.allocate(bytes);
+//   s.copy_to_device(d, host, bytes);     // returns at once
+//   s.scale(z, 2.0, z, n);                // runs after the copy
+//   s.copy_to_host(host, d, bytes);
+//   s.synchronize();                      // host now has the result
+//   s.release(d, bytes);
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace matlabcpp {
+
+struct DeviceStats {
+    uint64_t bytes_to_device = 0;
+    uint64_t bytes_to_host = 0;
+    uint64_t transfers_to_device = 0;
+    uint64_t transfers_to_host = 0;
+    uint64_t kernel_launches = 0;   // everything but transfers and releases
+    uint64_t synchronizations = 0;  // host waits on a stream
+    size_t memory_capacity = 0;
+    size_t memory_in_use = 0;
+    size_t peak_memory_in_use = 0;
+};
+
+enum class DeviceOp { Add, Sub, Mul, Div };
+
+// In-order command queue. Pointers are device memory of the owning
+// backend, except the host side of the two host transfers. Outputs may
+// alias inputs in the elementwise commands, not in gemm.
+class DeviceStream {
+public:
+    using Complex = std::complex<double>;
+
+    virtual ~DeviceStream() = default;
+
+    // The host buffer may be reused as soon as this returns
+    virtual void copy_to_device(void* device, const void* host, size_t bytes) = 0;
+    // The host buffer is written when the stream gets there: synchronize
+    // before reading it
+    virtual void copy_to_host(void* host, const void* device, size_t bytes) = 0;
+    virtual void copy(void* dst, const void* src, size_t bytes) = 0;
+    virtual void zero(void* device, size_t bytes) = 0;
+
+    virtual void elementwise(DeviceOp op, const Complex* a, const Complex* b, Complex* out, size_t n) = 0;
+    virtual void scale(const Complex* a, Complex s, Complex* out, size_t n) = 0;
+    virtual void conj(const Complex* a, Complex* out, size_t n) = 0;
+    // Column-major C = A * B: m x k times k x n
+    virtual void gemm(size_t m, size_t n, size_t k, const Complex* a, size_t lda,
+                      const Complex* b, size_t ldb, Complex* c, size_t ldc) = 0;
+
+    // Frees device memory once the commands before it are done
+    virtual void release(void* device, size_t bytes) = 0;
+
+    // Waits for every enqueued command; rethrows the first failure
+    virtual void synchronize() = 0;
+};
+
+class DeviceBackend {
+public:
+    virtual ~DeviceBackend() = default;
+
+    virtual std::string name() const = 0;
+
+    // Device memory; throws std::bad_alloc when the device is full
+    virtual void* allocate(size_t bytes) = 0;
+
+    // GPUStorage uses the default stream only, so tensor commands never
+    // need ordering across streams
+    virtual DeviceStream& default_stream() = 0;
+    virtual std::unique_ptr<DeviceStream> create_stream() = 0;
+
+    virtual DeviceStats stats() const = 0;
+    virtual void reset_stats() = 0;   // counters and peak; not capacity or use
+
+    // The backend new GPU tensors use, a VirtualDevice until another is
+    // installed. Tensors keep the backend they were made on alive.
+    static std::shared_ptr<DeviceBackend> current();
+    static void set_current(std::shared_ptr<DeviceBackend> backend);
+};
+
+// CPU reference backend
+class VirtualDevice : public DeviceBackend {
+public:
+    struct Options {
+        size_t memory_bytes = size_t(1) << 30;  // arena; MATLABCPP_DEVICE_MB overrides
+        double transfer_gbps = 0.0;             // host <-> device; 0: memcpy speed
+        double launch_latency_us = 0.0;         // added to every kernel
+    };
+
+    VirtualDevice();
+    explicit VirtualDevice(const Options& options);
+    ~VirtualDevice() override;
+
+    std::string name() const override { return "virtual"; }
+    void* allocate(size_t bytes) override;
+    DeviceStream& default_stream() override;
+    std::unique_ptr<DeviceStream> create_stream() override;
+    DeviceStats stats() const override;
+    void reset_stats() override;
+
+    const Options& options() const { return options_; }
+
+private:
+    class Stream;
+
+    // First fit over free ranges kept sorted and coalesced
+    class Arena {
+    public:
+        explicit Arena(size_t capacity);
+        ~Arena();
+        void* allocate(size_t bytes);           // nullptr when full
+        void deallocate(void* p, size_t bytes);
+        size_t capacity() const { return capacity_; }
+        size_t in_use() const;
+        size_t peak() const;
+        void reset_peak();
+
+    private:
+        char* base_;
+        size_t capacity_;
+        mutable std::mutex mutex_;
+        std::map<size_t, size_t> free_;         // offset -> length
+        size_t in_use_ = 0;
+        size_t peak_ = 0;
+    };
+
+    Options options_;
+    Arena arena_;
+    mutable std::mutex stats_mutex_;
+    DeviceStats counters_;
+    std::unique_ptr<Stream> default_stream_;    // last: drains first
+};
+
+} // namespace matlabcpp
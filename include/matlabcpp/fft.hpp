@@ -0,0 +1,136 @@
+// MatLabC++ Fast Fourier Transform
+// include/matlabcpp/fft.hpp
+//
+// In-place complex FFTs of any length on contiguous std::complex<double>
+// buffers, shared by ComplexTensor and the signal-processing helpers.
+//
+//   auto plan = fft::Plan::get(44100);     // cached per (length, direction)
+//   plan->execute(x);                      // forward, in place
+//   fft::transform(x, 1000, true);         // one-off inverse, not divided by n
+//
+// A plan picks its algorithm once:
+//   - powers of two: iterative radix-4 decimation in time over
+//     bit-reversed input (one radix-2 stage when log2(n) is odd), AVX2
+//     butterflies when the CPU has them
+//   - lengths whose prime factors are all <= 13: self-sorting (Stockham)
+//     mixed-radix passes with radix 2, 3, 4, 5, 7, 11 and 13 butterflies
+//   - anything else: Bluestein's chirp-z algorithm, i.e. a convolution
+//     done with power-of-two transforms of length >= 2n - 1
+// Twiddles, chirps and the bit-reversal permutation live in the plan (or
+// in caches shared by all plans) and are never recomputed. Plans are
+// immutable, so one plan may run on many threads at once; per-call
+// scratch space is thread-local.
+//
+// Many lines at once (rows, columns or pages of a tensor):
+//
+//   fft::transform_batch(x, cols, rows, 1, cols);   // every row
+//   fft::transform_batch(x, rows, cols, cols, 1);   // every column
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace matlabcpp {
+namespace fft {
+
+using Complex = std::complex<double>;
+
+bool is_power_of_two(size_t n);
+size_t next_power_of_two(size_t n);    // smallest power of two >= n (1 for 0)
+
+// x[0..n) <- DFT(x), n a power of two (throws otherwise). The forward
+// transform uses exp(-2*pi*i*j*k/n); the inverse uses the conjugate
+// kernel and leaves the 1/n scaling to the caller.
+void transform_pow2(Complex* x, size_t n, bool inverse = false);
+
+enum class Direction { Forward, Inverse };
+
+class Plan {
+public:
+    enum class Algorithm { Radix4, MixedRadix, Bluestein };
+
+    // Shared plan from the process-wide cache (built on first request)
+    static std::shared_ptr<const Plan> get(size_t n, Direction direction = Direction::Forward);
+
+    Plan(size_t n, Direction direction);
+
+    size_t size() const { return n_; }
+    Direction direction() const { return direction_; }
+    Algorithm algorithm() const { return algorithm_; }
+
+    // x[0..n) <- DFT(x); the inverse is not divided by n
+    void execute(Complex* x) const;
+
+    // The same transform on `count` lines: line b is x[b*dist + j*stride]
+    // for j < n. Lines are spread over the thread pool. Strided lines are
+    // copied in tiles into a contiguous block (a blocked transpose), so
+    // every cache line read from x is fully used.
+    void execute_batch(Complex* x, size_t count, size_t stride, size_t dist) const;
+
+private:
+    struct Stage {
+        size_t radix;
+        size_t span;                    // L: length of the DFTs this pass combines
+        size_t twiddle_offset;          // L * (radix - 1) entries in twiddles_
+        size_t root_offset;             // radix > 5: W_r^k for k < r, in twiddles_
+    };
+
+    size_t n_;
+    Direction direction_;
+    Algorithm algorithm_;
+
+    // Mixed radix
+    std::vector<Stage> stages_;
+    std::vector<Complex> twiddles_;     // W_{L*r}^(t*f) for f < L, 1 <= t < r
+
+    // Bluestein
+    size_t conv_size_ = 0;              // power of two >= 2n - 1
+    std::vector<Complex> chirp_;        // exp(+-i*pi*k^2/n)
+    std::vector<Complex> chirp_spectrum_;   // FFT of the conjugate chirp, over conv_size_
+
+    void execute_mixed(Complex* x) const;
+    void execute_bluestein(Complex* x) const;
+};
+
+// Forward or inverse transform of any length through the plan cache
+void transform(Complex* x, size_t n, bool inverse = false);
+
+// Batched form of transform(): see Plan::execute_batch
+void transform_batch(Complex* x, size_t n, size_t count, size_t stride, size_t dist,
+                     bool inverse = false);
+
+// Real-input transforms. For even n the samples are packed pairwise into
+// n/2 complex values, transformed with a half-length plan and separated
+// again in one pass, so a real signal costs half a complex transform and
+// is never widened to complex. Odd lengths go through a full complex plan.
+//
+//   auto plan = fft::RealPlan::get(4096);
+//   std::vector<fft::Complex> X(plan->spectrum_size());   // n/2 + 1 bins
+//   plan->forward(signal.data(), X.data());
+//   plan->inverse(X.data(), signal.data());               // n * signal
+class RealPlan {
+public:
+    static std::shared_ptr<const RealPlan> get(size_t n);
+
+    explicit RealPlan(size_t n);
+
+    size_t size() const { return n_; }
+    size_t spectrum_size() const { return n_ / 2 + 1; }
+
+    // out[0..n/2] <- bins 0..n/2 of DFT(x); the rest are their conjugates
+    void forward(const double* x, Complex* out) const;
+    // x[0..n) <- the real signal with half spectrum in[0..n/2], times n
+    // (no 1/n scaling, like the complex inverse)
+    void inverse(const Complex* in, double* x) const;
+
+private:
+    size_t n_;
+    std::shared_ptr<const Plan> forward_, inverse_;   // n/2 points, or n when n is odd
+    std::vector<Complex> twiddles_;                   // W_n^k for k < n/2 (even n)
+};
+
+} // namespace fft
+} // namespace matlabcpp
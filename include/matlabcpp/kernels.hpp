@@ -0,0 +1,105 @@
+// MatLabC++ Elementwise Kernels
+// include/matlabcpp/kernels.hpp
+//
+// Tight loops over contiguous double buffers, shared by the script VM,
+// the REPL and the builtins. Each entry point picks an AVX2 version at
+// run time when the CPU has it and falls back to portable scalar loops
+// otherwise, so the same binary runs everywhere.
+//
+//   kernels::binary(BinaryOp::Add, a, 1, b, 1, out, n);   // out = a + b
+//   kernels::binary(BinaryOp::Mul, a, 1, &k, 0, out, n);  // out = a * k
+//   kernels::unary(UnaryOp::Sqrt, a, out, n);             // out = sqrt(a)
+//
+// `out` may alias either input. Large buffers are split across the shared
+// thread pool (thread_pool.hpp); reductions use fixed chunks, so their
+// results do not depend on the thread count.
+
+#pragma once
+
+#include <cstddef>
+#include <complex>
+#include <cstdint>
+#include <string>
+
+namespace matlabcpp {
+namespace kernels {
+
+enum class BinaryOp : uint8_t {
+    Add, Sub, Mul, Div, Pow,
+    Eq, Ne, Lt, Le, Gt, Ge,     // 1.0 / 0.0
+    And, Or                     // nonzero is true
+};
+
+enum class UnaryOp : uint8_t {
+    Neg, Not, Abs, Sqrt,
+    Exp, Log, Log10,
+    Sin, Cos, Tan,
+    Floor, Ceil, Round          // Round: halves away from zero
+};
+
+// out[i] = x[i * x_stride] op y[i * y_stride]; strides are 0 (broadcast
+// a single value) or 1
+void binary(BinaryOp op, const double* x, size_t x_stride,
+            const double* y, size_t y_stride, double* out, size_t n);
+
+// out[i] = op(x[i])
+void unary(UnaryOp op, const double* x, double* out, size_t n);
+
+// Reductions. min/max skip NaNs; an empty input gives +inf / -inf.
+double sum(const double* x, size_t n);
+double min(const double* x, size_t n);
+double max(const double* x, size_t n);
+
+// Split complex (separate real and imaginary arrays, as in a planar
+// ComplexTensor). Outputs may alias inputs.
+// (cr, ci) = (ar, ai) .* (br, bi)
+void complex_multiply(const double* ar, const double* ai, const double* br, const double* bi,
+                      double* cr, double* ci, size_t n);
+// out = |re + i im|, without overflow or underflow in the squares
+void complex_abs(const double* re, const double* im, double* out, size_t n);
+
+// Full convolution: out[i] = sum_k h[k] * x[i - k] for i < nx + nh - 1.
+// Direct sum, O(nx * nh): meant for short kernels. out must not alias.
+void convolve(const double* x, size_t nx, const double* h, size_t nh, double* out);
+
+// Matrix multiply (src/core/gemm.cpp), all column-major with leading
+// dimensions: C = alpha * A * B + beta * C with A m x k, B k x n and C
+// m x n. beta == 0 overwrites C. Row-major callers get C' = B' * A' by
+// swapping the operands.
+void gemm(size_t m, size_t n, size_t k, double alpha,
+          const double* A, size_t lda, const double* B, size_t ldb,
+          double beta, double* C, size_t ldc);
+
+// Same with op(A) = A' when trans_a (A is then stored k x m) and op(B) =
+// B' when trans_b (B stored n x k): C = alpha * op(A) * op(B) + beta * C
+void gemm(bool trans_a, bool trans_b, size_t m, size_t n, size_t k, double alpha,
+          const double* A, size_t lda, const double* B, size_t ldb,
+          double beta, double* C, size_t ldc);
+
+// Complex C = alpha * A * B + beta * C (real alpha, beta), and C = A * B
+void gemm(size_t m, size_t n, size_t k, double alpha,
+          const std::complex<double>* A, size_t lda, const std::complex<double>* B, size_t ldb,
+          double beta, std::complex<double>* C, size_t ldc);
+void gemm(size_t m, size_t n, size_t k,
+          const std::complex<double>* A, size_t lda, const std::complex<double>* B, size_t ldb,
+          std::complex<double>* C, size_t ldc);
+
+// Complex operands as stored, transposed (A.') or conjugate transposed
+// (A'); a transposed A is stored k x m, a transposed B n x k
+enum class MatrixOp : uint8_t { None, Transpose, ConjTranspose };
+void gemm(MatrixOp op_a, MatrixOp op_b, size_t m, size_t n, size_t k, double alpha,
+          const std::complex<double>* A, size_t lda, const std::complex<double>* B, size_t ldb,
+          double beta, std::complex<double>* C, size_t ldc);
+
+// Micro-kernel gemm dispatches to: "avx512", "avx2" or "scalar"
+const char* gemm_level();
+
+// Builtin function backed by a unary kernel (sqrt, exp, sin, round, ...);
+// nullptr for any other name
+const UnaryOp* unary_function(const std::string& name);
+
+// Instruction set the kernels dispatch to: "avx2" or "scalar"
+const char* simd_level();
+
+} // namespace kernels
+} // namespace matlabcpp
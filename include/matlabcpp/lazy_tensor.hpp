@@ -0,0 +1,99 @@
+// MatLabC++ Lazy Tensors
+// include/matlabcpp/lazy_tensor.hpp
+//
+// Opt-in deferred evaluation for ComplexTensor. Operators on a LazyTensor
+// record a node in a small DAG instead of computing; the graph runs when
+// a value is asked for (eval(), data(), an element, to_string()), after
+// three rewrites over the part of it that value depends on:
+//   - fusion: a tree of elementwise nodes (+ - .* ./, scalar * and /,
+//     conj) whose inner results have no other consumer is one kernel, one
+//     pass over the data with no intermediate tensors
+//   - dead results: nodes the value does not depend on never run, and
+//     conj(conj(x)), transpose(transpose(x)) and scaling by 1 drop out;
+//     conj(fft(conj(x))) becomes one inverse transform and a scale after
+//     a transform is applied by the transform
+//   - transpose folding: A' * B and A.' * B become one gemm reading A
+//     through transposed strides
+// Intermediates are freed after their last use, and one that is used
+// only by the next elementwise kernel or transform becomes its output.
+//
+//   LazyTensor a = lazy(A), b = lazy(B);
+//   LazyTensor g = a.transpose() * b;              // nothing runs yet
+//   LazyTensor y = (a.times(b) + a) * 0.5;          // one kernel
+//   const ComplexTensor& r = y.eval();             // runs, then cached
+//
+// lazy(A) refers to A without copying, so A must outlive the evaluation
+// and not change before it; lazy(std::move(A)) takes A over. Evaluation
+// runs on the host: GPU inputs are read through their host copy.
+
+#pragma once
+
+#include "matlabcpp/complex_tensor.hpp"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace matlabcpp {
+
+// What an evaluation did, for the graph rooted at the evaluated value
+struct LazyStats {
+    size_t nodes = 0;              // reachable nodes that had not run, before rewriting
+    size_t kernels = 0;            // passes run: fused kernels, products, transforms, transposes
+    size_t fused = 0;              // elementwise nodes run inside a larger kernel
+    size_t eliminated = 0;         // nodes removed by rewriting
+    size_t folded_transposes = 0;  // transposes read through gemm strides
+    size_t temporaries = 0;        // intermediate tensors allocated
+};
+
+class LazyTensor {
+public:
+    using Complex = ComplexTensor::Complex;
+
+    LazyTensor(const ComplexTensor& t);    // refers to t
+    LazyTensor(ComplexTensor&& t);         // owns t
+
+    size_t rows() const;
+    size_t cols() const;
+    size_t depth() const;
+    size_t size() const { return rows() * cols() * depth(); }
+
+    // Recording; shapes are checked here, like the eager operators, and a
+    // mismatch throws std::invalid_argument
+    LazyTensor operator+(const LazyTensor& other) const;
+    LazyTensor operator-(const LazyTensor& other) const;
+    LazyTensor operator*(const LazyTensor& other) const;   // matrix product
+    LazyTensor operator/(const LazyTensor& other) const;   // elementwise
+    LazyTensor times(const LazyTensor& other) const;       // .*
+    LazyTensor rdivide(const LazyTensor& other) const;     // ./
+    LazyTensor operator*(const Complex& scalar) const;
+    LazyTensor operator/(const Complex& scalar) const;
+    LazyTensor conj() const;
+    LazyTensor transpose() const;            // A'
+    LazyTensor transpose_no_conj() const;    // A.'
+    LazyTensor fft() const;                  // vectors, like ComplexTensor::fft
+    LazyTensor ifft() const;
+
+    // Runs what the value needs once; later calls return the same tensor,
+    // and graphs built on this value read it instead of recomputing it
+    const ComplexTensor& eval() const;
+    bool evaluated() const;
+    const LazyStats& stats() const;          // of the evaluation that made the value
+
+    const Complex* data() const { return eval().data(); }
+    Complex operator()(size_t i, size_t j) const { return eval()(i, j); }
+    std::string to_string() const { return eval().to_string(); }
+
+private:
+    struct Node;
+    class Evaluator;
+
+    explicit LazyTensor(std::shared_ptr<Node> node) : node_(std::move(node)) {}
+    void check_same_shape(const LazyTensor& other, const char* op) const;
+
+    std::shared_ptr<Node> node_;
+};
+
+inline LazyTensor lazy(const ComplexTensor& t) { return LazyTensor(t); }
+inline LazyTensor lazy(ComplexTensor&& t) { return LazyTensor(std::move(t)); }
+
+} // namespace matlabcpp
@@ -0,0 +1,72 @@
+// MatLabC++ .m Lexer
+// include/matlabcpp/lexer.hpp
+//
+// Turns .m source text into a flat token stream. Shared by the script
+// compiler (bytecode.hpp) and anything else that needs MATLAB tokens.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace matlabcpp {
+namespace interpreter {
+
+// ========== TOKEN TYPES ==========
+
+enum class TokenType {
+    Number, String, Identifier, Operator, Assign,
+    LParen, RParen, LBracket, RBracket,
+    Semicolon, Comma, Colon, Dot, Newline,
+    Keyword_if, Keyword_elseif, Keyword_else, Keyword_end,
+    Keyword_for, Keyword_while, Keyword_break, Keyword_continue,
+    Keyword_function, Keyword_return,
+    Keyword_clear, Keyword_clc, Keyword_close,
+    Comment, SectionComment,
+    EndOfFile
+};
+
+struct Token {
+    TokenType type;
+    std::string value;
+    int line;
+    int col;
+};
+
+// ========== LEXER ==========
+
+class Lexer {
+    std::string source_;
+    size_t pos_ = 0;
+    int line_ = 1;
+    int col_ = 1;
+
+    static const std::unordered_map<std::string, TokenType> keywords_;
+
+public:
+    explicit Lexer(const std::string& source) : source_(source) {}
+
+    std::vector<Token> tokenize();
+
+private:
+    char peek() const {
+        return (pos_ + 1 < source_.size()) ? source_[pos_ + 1] : '\0';
+    }
+
+    void advance() {
+        if (source_[pos_] == '\n') { line_++; col_ = 1; }
+        else { col_++; }
+        pos_++;
+    }
+
+    void skip_whitespace_no_newline();
+    std::string read_to_eol();
+    Token read_number();
+    Token read_string();
+    bool quote_is_transpose(const std::vector<Token>& tokens) const;
+    Token read_identifier();
+};
+
+} // namespace interpreter
+} // namespace matlabcpp
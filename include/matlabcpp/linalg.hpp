@@ -0,0 +1,109 @@
+// MatLabC++ Dense Linear Algebra
+// include/matlabcpp/linalg.hpp
+//
+// Factorizations of column-major Arrays. A factorization is computed once
+// and can then solve any number of right-hand sides:
+//
+//   LUFactorization lu(A);        // PA = LU, blocked and multithreaded
+//   Array x = lu.solve(b);        // b may have many columns
+//   Array y = lu.solve(c);        // reuses the factors
+//
+// Symmetric matrices have cheaper paths: CholeskyFactorization (A = L L',
+// half the flops of LU) and eig_symmetric (tridiagonal reduction, then
+// divide and conquer). left_divide picks Cholesky or a triangular solve
+// on its own when A has that structure, as MATLAB's backslash does.
+//
+// The blocked algorithms do their O(n^3) work in kernels::gemm.
+
+#pragma once
+
+#include "matlabcpp/array.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace matlabcpp {
+
+class LUFactorization {
+public:
+    LUFactorization() = default;
+    // A must be square and 2-D; pass an rvalue to factor in place
+    explicit LUFactorization(Array A);
+
+    size_t size() const { return n_; }
+    // Some pivot is exactly zero: determinant() is 0 and solve() throws
+    bool singular() const { return singular_; }
+
+    // X with A * X = B; B is n x k for any k
+    Array solve(const Array& B) const;
+    // Same, overwriting the n x nrhs column-major block at B
+    void solve_in_place(double* B, size_t ldb, size_t nrhs) const;
+
+    Array inverse() const;
+    double determinant() const;
+
+    // Unit-diagonal L below the diagonal, U on and above it
+    const Array& factors() const { return lu_; }
+    // Step i swapped rows i and pivots()[i] (0-based, LAPACK order)
+    const std::vector<size_t>& pivots() const { return pivots_; }
+
+private:
+    Array lu_;
+    std::vector<size_t> pivots_;
+    size_t n_ = 0;
+    bool singular_ = false;
+};
+
+// A = L * L' for symmetric positive definite A. Only the lower triangle
+// of A is read.
+class CholeskyFactorization {
+public:
+    CholeskyFactorization() = default;
+    // A must be square and 2-D; pass an rvalue to factor in place
+    explicit CholeskyFactorization(Array A);
+
+    size_t size() const { return n_; }
+    // Some leading minor is not positive: the factor is incomplete and
+    // solve() throws
+    bool positive_definite() const { return positive_definite_; }
+
+    // X with A * X = B; B is n x k for any k
+    Array solve(const Array& B) const;
+    // Same, overwriting the n x nrhs column-major block at B
+    void solve_in_place(double* B, size_t ldb, size_t nrhs) const;
+
+    Array inverse() const;
+    double determinant() const;
+
+    // L on and below the diagonal, zeros above it
+    const Array& factor() const { return l_; }
+
+private:
+    Array l_;
+    size_t n_ = 0;
+    bool positive_definite_ = true;
+};
+
+// A = V * diag(values) * V' for symmetric A (only the lower triangle is
+// read). Values ascend; column j of vectors goes with values[j].
+struct SymmetricEigen {
+    std::vector<double> values;
+    Array vectors;              // n x n orthonormal; empty without vectors
+};
+SymmetricEigen eig_symmetric(const Array& A, bool want_vectors = true);
+
+// Eigenvalues of the n x n symmetric tridiagonal matrix with diagonal d
+// and off-diagonal e (n - 1 entries), ascending, into d. When z is not
+// null its n x n column-major block (leading dimension ldz) receives the
+// eigenvectors. e is overwritten. Throws if the iteration stalls.
+void tridiagonal_eigen(size_t n, double* d, double* e, double* z, size_t ldz);
+
+// Square, 2-D and exactly equal to its transpose
+bool is_symmetric(const Array& A);
+
+// A \ B and B / A for square A: the script operators. Triangular A is
+// solved by substitution; symmetric A with a positive diagonal tries
+// Cholesky first; everything else (and a failed Cholesky) uses LU.
+Array left_divide(const Array& A, const Array& B);
+Array right_divide(const Array& B, const Array& A);
+
+} // namespace matlabcpp
@@ -0,0 +1,77 @@
+// MatLabC++ Compiled Script Cache
+// include/matlabcpp/script_cache.hpp
+//
+// Persists CompiledScript bytecode on disk so that re-running an unchanged
+// .m file skips lexing, parsing and code generation. Entries are keyed by
+// a hash of the source text, the interpreter version and the bytecode
+// format version; each entry also carries a second, independent hash of
+// the source, and is used only if both match.
+//
+// Default location: $MATLABCPP_CACHE_DIR, else ~/.matlabcpp/cache
+
+#pragma once
+
+#include "matlabcpp/bytecode.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+namespace matlabcpp {
+namespace interpreter {
+
+class ScriptCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        uint64_t rejected = 0;  // stale/corrupt entries that were recompiled
+    };
+
+    // With record_stats, every lookup and store is also added to the
+    // counters kept in the cache directory (one locked file update each)
+    explicit ScriptCache(std::filesystem::path directory = default_directory(),
+                         bool record_stats = false);
+
+    // $MATLABCPP_CACHE_DIR, else $HOME/.matlabcpp/cache (empty if neither is set)
+    static std::filesystem::path default_directory();
+
+    // Cache key for `source` under this interpreter build
+    static uint64_t key(const std::string& source);
+
+    // Look up / insert a compiled script. Never throws: I/O problems are
+    // treated as a miss (load) or silently skipped (store).
+    std::optional<CompiledScript> load(const std::string& source);
+    bool store(const std::string& source, const CompiledScript& script);
+
+    // load() or compile() + store(); `hit` reports which one happened
+    CompiledScript get_or_compile(const std::string& source, bool* hit = nullptr);
+
+    // Counters for this process
+    const Stats& stats() const { return stats_; }
+
+    // Counters accumulated by every recording run that used this directory
+    Stats persistent_stats() const;
+    void reset_persistent_stats();
+
+    // Remove every cached entry (stats are kept)
+    size_t clear();
+
+    const std::filesystem::path& directory() const { return dir_; }
+    bool enabled() const { return !dir_.empty(); }
+
+    void print_stats(std::ostream& os) const;
+
+private:
+    std::filesystem::path dir_;
+    bool record_stats_ = false;
+    Stats stats_;
+
+    std::filesystem::path entry_path(uint64_t key) const;
+    void record(const Stats& delta);
+};
+
+} // namespace interpreter
+} // namespace matlabcpp
@@ -0,0 +1,102 @@
+// MatLabC++ Thread Pool
+// include/matlabcpp/thread_pool.hpp
+//
+// One process-wide pool of worker threads for data-parallel kernels. Each
+// worker owns a task deque and steals from the others when it runs dry;
+// the thread that submits a batch works on it too, so nested parallel
+// calls cannot deadlock.
+//
+//   ThreadPool::global().set_threads(4);        // maxNumCompThreads(4)
+//   parallel_for(n, 1 << 14, [&](size_t lo, size_t hi) { ... });
+//
+// Work is split into fixed-size chunks that do not depend on the thread
+// count, so reductions that combine per-chunk results in chunk order give
+// bit-identical answers with 1 thread or 64.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace matlabcpp {
+
+class ThreadPool {
+public:
+    // Sized from MATLABCPP_NUM_THREADS, else the hardware thread count
+    static ThreadPool& global();
+
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads that work on a batch, counting the submitting thread
+    size_t threads() const { return threads_.load(std::memory_order_acquire); }
+
+    // Waits for running batches (from any thread, e.g. a device stream) to
+    // finish; batches submitted meanwhile wait and then use the new
+    // threads. Must not be called from inside a task.
+    void set_threads(size_t threads);
+
+    // Runs task(0) .. task(count - 1), possibly concurrently, and returns
+    // when all are done. The first exception thrown by a task is rethrown.
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+private:
+    struct Batch;
+    struct Task {
+        Batch* batch;
+        size_t index;
+    };
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> threads_{1};
+    std::mutex resize_mutex_;          // held by set_threads while it resizes
+    std::condition_variable idle_;
+    size_t running_ = 0;               // batches in run(), guarded by resize_mutex_
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::atomic<size_t> pending_{0};   // queued, unclaimed tasks
+    bool stopping_ = false;
+
+    void start(size_t workers);
+    void stop();
+    void worker_loop(size_t self);
+    bool try_pop(size_t self, Task& out);   // own deque first, then steal
+    void execute(const Task& task);
+};
+
+// Splits [0, n) into chunks of `chunk` elements (the last may be shorter)
+// and runs fn(begin, end) for each on the global pool. Small ranges run
+// inline on the calling thread.
+template <typename F>
+void parallel_for(size_t n, size_t chunk, F&& fn) {
+    size_t chunks = chunk ? (n + chunk - 1) / chunk : 0;
+    ThreadPool& pool = ThreadPool::global();
+    if (chunks <= 1 || pool.threads() == 1) {
+        for (size_t c = 0; c < chunks; ++c) {
+            size_t begin = c * chunk;
+            fn(begin, begin + chunk < n ? begin + chunk : n);
+        }
+        return;
+    }
+    pool.run(chunks, [&](size_t c) {
+        size_t begin = c * chunk;
+        fn(begin, begin + chunk < n ? begin + chunk : n);
+    });
+}
+
+} // namespace matlabcpp
@@ -0,0 +1,116 @@
+// MatLabC++ Workspace
+// include/matlabcpp/workspace.hpp
+//
+// Variables live in a dense array of slots. Compiled scripts resolve each
+// identifier to a slot once, when they start running, so reading `x` in a
+// loop is an indexed load. The name -> slot map is only consulted by the
+// REPL and other by-name callers.
+//
+// Slots are never reused or removed: `clear` just marks them undefined, so
+// slot numbers held by a running script stay valid.
+
+#pragma once
+
+#include "matlabcpp/active_window.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace matlabcpp {
+
+class Workspace {
+public:
+    using Slot = uint32_t;
+
+private:
+    std::vector<Variable> values_;
+    std::vector<uint8_t> defined_;
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, Slot> slots_;
+
+public:
+    // ----- slot access (compiled code) -----
+
+    // Slot for `name`, creating an undefined one if needed
+    Slot slot(const std::string& name) {
+        auto it = slots_.find(name);
+        if (it != slots_.end()) return it->second;
+        Slot s = static_cast<Slot>(values_.size());
+        values_.emplace_back();
+        defined_.push_back(0);
+        names_.push_back(name);
+        slots_.emplace(name, s);
+        return s;
+    }
+
+    const Variable* find(Slot s) const { return defined_[s] ? &values_[s] : nullptr; }
+    Variable* find_mutable(Slot s) { return defined_[s] ? &values_[s] : nullptr; }
+
+    const Variable& get(Slot s) const {
+        if (!defined_[s]) throw std::runtime_error("Undefined variable: " + names_[s]);
+        return values_[s];
+    }
+
+    void set(Slot s, Variable var) {
+        values_[s] = std::move(var);
+        defined_[s] = 1;
+    }
+
+    const std::string& name(Slot s) const { return names_[s]; }
+
+    // ----- by-name access (REPL) -----
+
+    void set(const std::string& name, Variable var) {
+        set(slot(name), std::move(var));
+    }
+
+    const Variable& get(const std::string& name) const {
+        if (const Variable* v = find(name)) return *v;
+        throw std::runtime_error("Undefined variable: " + name);
+    }
+
+    const Variable* find(const std::string& name) const {
+        auto it = slots_.find(name);
+        return it != slots_.end() ? find(it->second) : nullptr;
+    }
+
+    bool exists(const std::string& name) const {
+        return find(name) != nullptr;
+    }
+
+    void clear() {
+        for (Slot s = 0; s < values_.size(); ++s) clear(s);
+    }
+
+    void clear(Slot s) {
+        values_[s] = Variable();
+        defined_[s] = 0;
+    }
+
+    void clear_var(const std::string& name) {
+        auto it = slots_.find(name);
+        if (it != slots_.end()) clear(it->second);
+    }
+
+    std::vector<std::string> list() const {
+        std::vector<std::string> names;
+        for (Slot s = 0; s < values_.size(); ++s) {
+            if (defined_[s]) names.push_back(names_[s]);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    size_t memory_usage() const {
+        size_t total = 0;
+        for (Slot s = 0; s < values_.size(); ++s) {
+            if (defined_[s]) total += values_[s].memory_size();
+        }
+        return total;
+    }
+};
+
+} // namespace matlabcpp
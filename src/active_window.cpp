@@ -2,6 +2,12 @@
 // src/active_window.cpp
 
 #include "matlabcpp/active_window.hpp"
+#include "matlabcpp/workspace.hpp"
+#include "matlabcpp/buffer_pool.hpp"
+#include "matlabcpp/bytecode.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/linalg.hpp"
+#include "matlabcpp/thread_pool.hpp"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -11,54 +17,6 @@
 
 namespace matlabcpp {
 
-// ========== VARIABLE STORAGE ==========
-
-class Workspace {
-    std::unordered_map<std::string, Variable> vars_;
-    
-public:
-    void set(const std::string& name, const Variable& var) {
-        vars_[name] = var;
-    }
-    
-    Variable get(const std::string& name) const {
-        auto it = vars_.find(name);
-        if (it != vars_.end()) {
-            return it->second;
-        }
-        throw std::runtime_error("Undefined variable: " + name);
-    }
-    
-    bool exists(const std::string& name) const {
-        return vars_.find(name) != vars_.end();
-    }
-    
-    void clear() {
-        vars_.clear();
-    }
-    
-    void clear_var(const std::string& name) {
-        vars_.erase(name);
-    }
-    
-    std::vector<std::string> list() const {
-        std::vector<std::string> names;
-        for (const auto& pair : vars_) {
-            names.push_back(pair.first);
-        }
-        std::sort(names.begin(), names.end());
-        return names;
-    }
-    
-    size_t memory_usage() const {
-        size_t total = 0;
-        for (const auto& pair : vars_) {
-            total += pair.second.memory_size();
-        }
-        return total;
-    }
-};
-
 // ========== ACTIVE WINDOW ==========
 
 ActiveWindow::ActiveWindow() 
@@ -129,6 +87,11 @@ void ActiveWindow::process_command(const std::string& line) {
         return;
     }
     
+    if (line == "memory" || line.substr(0, 7) == "memory ") {
+        show_memory(trim(line.substr(6)));
+        return;
+    }
+    
     if (line.substr(0, 5) == "clear" && line.length() > 6) {
         std::string var_name = line.substr(6);
         workspace_->clear_var(trim(var_name));
@@ -154,7 +117,15 @@ void ActiveWindow::process_command(const std::string& line) {
 }
 
 bool ActiveWindow::is_assignment(const std::string& cmd) const {
-    return cmd.find('=') != std::string::npos;
+    // A lone '=' (not part of ==, ~=, <=, >=)
+    for (size_t i = 0; i < cmd.size(); ++i) {
+        if (cmd[i] != '=') continue;
+        bool joined_after = i + 1 < cmd.size() && cmd[i + 1] == '=';
+        bool joined_before = i > 0 && std::string("=~<>").find(cmd[i - 1]) != std::string::npos;
+        if (!joined_after && !joined_before) return true;
+        if (joined_after) ++i;
+    }
+    return false;
 }
 
 void ActiveWindow::execute_assignment(const std::string& cmd, bool suppress) {
@@ -211,116 +182,32 @@ void ActiveWindow::execute_expression(const std::string& expr, bool suppress) {
 }
 
 Variable ActiveWindow::evaluate_expression(const std::string& expr) {
-    // Check for function calls: function_name(args)
-    size_t open_paren = expr.find('(');
-    if (open_paren != std::string::npos && expr.back() == ')') {
-        std::string func_name = trim(expr.substr(0, open_paren));
-        std::string args_str = expr.substr(open_paren + 1, expr.length() - open_paren - 2);
-        return evaluate_function_call(func_name, args_str);
-    }
-    
-    // Check if it's a vector/matrix literal: [...]
-    if (!expr.empty() && expr.front() == '[' && expr.back() == ']') {
-        return parse_vector(expr);
-    }
-    
-    // Check if it's a variable reference
-    if (is_valid_name(expr) && workspace_->exists(expr)) {
-        return workspace_->get(expr);
+    // Plain variable names and numbers skip the compiler
+    if (is_valid_name(expr)) {
+        if (const Variable* var = workspace_->find(expr)) return *var;
     }
     
-    // Check if it's a number
     if (is_number(expr)) {
         return Variable(std::stod(expr));
     }
     
-    // Try to evaluate as expression (simple math)
     return evaluate_math_expression(expr);
 }
 
-Variable ActiveWindow::parse_vector(const std::string& expr) {
-    // Remove brackets
-    std::string content = expr.substr(1, expr.length() - 2);
-    content = trim(content);
-    
-    // Check for matrix (contains semicolons)
-    if (content.find(';') != std::string::npos) {
-        return parse_matrix(content);
-    }
-    
-    // Parse vector: split by spaces or commas
-    std::vector<double> values;
-    std::istringstream iss(content);
-    std::string token;
-    
-    while (iss >> token) {
-        // Remove commas
-        token.erase(std::remove(token.begin(), token.end(), ','), token.end());
-        
-        if (!token.empty()) {
-            try {
-                values.push_back(std::stod(token));
-            } catch (...) {
-                throw std::runtime_error("Invalid number in vector: " + token);
-            }
-        }
-    }
-    
-    return Variable(values);
-}
-
-Variable ActiveWindow::parse_matrix(const std::string& content) {
-    // Split by semicolons (rows)
-    std::vector<std::vector<double>> rows;
-    std::istringstream row_stream(content);
-    std::string row_str;
-    
-    while (std::getline(row_stream, row_str, ';')) {
-        row_str = trim(row_str);
-        if (row_str.empty()) continue;
-        
-        std::vector<double> row;
-        std::istringstream col_stream(row_str);
-        std::string token;
-        
-        while (col_stream >> token) {
-            token.erase(std::remove(token.begin(), token.end(), ','), token.end());
-            if (!token.empty()) {
-                row.push_back(std::stod(token));
-            }
-        }
-        
-        if (!row.empty()) {
-            rows.push_back(row);
-        }
-    }
-    
-    return Variable(rows);
-}
-
 Variable ActiveWindow::evaluate_math_expression(const std::string& expr) {
-    // Simple expression evaluator (supports +, -, *, /, ^)
-    // For now, just try to parse as a number
+    // Same parser and VM as scripts, so operators work on whole arrays
+    // and calls/indexing behave identically at the prompt
+    interpreter::CompiledScript code;
     try {
-        return Variable(std::stod(expr));
-    } catch (...) {
+        code = interpreter::compile_expression(expr);
+    } catch (const std::exception&) {
         throw std::runtime_error("Cannot evaluate expression: " + expr);
     }
+    interpreter::VM vm(*this, false);
+    return vm.evaluate(code);
 }
 
-Variable ActiveWindow::evaluate_function_call(const std::string& func_name, const std::string& args_str) {
-    // Parse arguments (simple: split by commas)
-    std::vector<Variable> args;
-    std::istringstream iss(args_str);
-    std::string arg;
-    
-    while (std::getline(iss, arg, ',')) {
-        arg = trim(arg);
-        if (!arg.empty()) {
-            args.push_back(evaluate_expression(arg));
-        }
-    }
-    
+Variable ActiveWindow::call_function(const std::string& func_name, const std::vector<Variable>& args) {
     // Handle built-in functions
     if (func_name == "disp") {
         // Display value(s)
@@ -335,159 +222,101 @@ Variable ActiveWindow::evaluate_function_call(const std::string& func_name, cons
         if (args.empty()) {
             throw std::runtime_error("size() requires at least one argument");
         }
-        const auto& var = args[0];
-        if (var.is_scalar()) {
-            return Variable(std::vector<double>{1.0, 1.0});
-        } else if (var.is_vector()) {
-            return Variable(std::vector<double>{1.0, static_cast<double>(var.as_vector().size())});
-        } else if (var.is_matrix()) {
-            const auto& mat = var.as_matrix();
-            return Variable(std::vector<double>{
-                static_cast<double>(mat.size()), 
-                static_cast<double>(mat.empty() ? 0 : mat[0].size())
-            });
-        }
+        std::vector<double> dims;
+        for (size_t d : args[0].dims()) dims.push_back(static_cast<double>(d));
+        return Variable(dims);
     }
     else if (func_name == "length") {
         if (args.empty()) {
             throw std::runtime_error("length() requires one argument");
         }
         const auto& var = args[0];
-        if (var.is_scalar()) {
-            return Variable(1.0);
-        } else if (var.is_vector()) {
-            return Variable(static_cast<double>(var.as_vector().size()));
-        } else if (var.is_matrix()) {
-            const auto& mat = var.as_matrix();
-            size_t max_dim = std::max(mat.size(), mat.empty() ? 0 : mat[0].size());
-            return Variable(static_cast<double>(max_dim));
-        }
+        if (var.empty()) return Variable(0.0);
+        auto dims = var.dims();
+        return Variable(static_cast<double>(*std::max_element(dims.begin(), dims.end())));
     }
     else if (func_name == "sum") {
         if (args.empty()) {
             throw std::runtime_error("sum() requires one argument");
         }
-        const auto& var = args[0];
-        double total = 0.0;
-        if (var.is_scalar()) {
-            total = var.as_scalar();
-        } else if (var.is_vector()) {
-            for (double v : var.as_vector()) {
-                total += v;
-            }
-        } else if (var.is_matrix()) {
-            for (const auto& row : var.as_matrix()) {
-                for (double v : row) {
-                    total += v;
-                }
-            }
-        }
-        return Variable(total);
+        return Variable(kernels::sum(args[0].data(), args[0].numel()));
     }
     else if (func_name == "mean") {
         if (args.empty()) {
             throw std::runtime_error("mean() requires one argument");
         }
         const auto& var = args[0];
-        double total = 0.0;
-        size_t count = 0;
-        if (var.is_scalar()) {
-            return var;
-        } else if (var.is_vector()) {
-            for (double v : var.as_vector()) {
-                total += v;
-                count++;
-            }
-        } else if (var.is_matrix()) {
-            for (const auto& row : var.as_matrix()) {
-                for (double v : row) {
-                    total += v;
-                    count++;
-                }
-            }
-        }
-        return Variable(count > 0 ? total / count : 0.0);
+        double total = kernels::sum(var.data(), var.numel());
+        return Variable(var.numel() > 0 ? total / var.numel() : 0.0);
     }
     else if (func_name == "min") {
         if (args.empty()) {
             throw std::runtime_error("min() requires one argument");
         }
-        const auto& var = args[0];
-        double min_val = std::numeric_limits<double>::max();
-        if (var.is_scalar()) {
-            return var;
-        } else if (var.is_vector()) {
-            for (double v : var.as_vector()) {
-                min_val = std::min(min_val, v);
-            }
-        } else if (var.is_matrix()) {
-            for (const auto& row : var.as_matrix()) {
-                for (double v : row) {
-                    min_val = std::min(min_val, v);
-                }
-            }
-        }
-        return Variable(min_val);
+        return Variable(kernels::min(args[0].data(), args[0].numel()));
     }
     else if (func_name == "max") {
         if (args.empty()) {
             throw std::runtime_error("max() requires one argument");
         }
-        const auto& var = args[0];
-        double max_val = std::numeric_limits<double>::lowest();
-        if (var.is_scalar()) {
-            return var;
-        } else if (var.is_vector()) {
-            for (double v : var.as_vector()) {
-                max_val = std::max(max_val, v);
-            }
-        } else if (var.is_matrix()) {
-            for (const auto& row : var.as_matrix()) {
-                for (double v : row) {
-                    max_val = std::max(max_val, v);
-                }
-            }
+        return Variable(kernels::max(args[0].data(), args[0].numel()));
+    }
+    else if (func_name == "inv" || func_name == "det") {
+        if (args.size() != 1) {
+            throw std::runtime_error(func_name + "() requires one argument");
         }
-        return Variable(max_val);
+        LUFactorization lu(args[0]);
+        if (func_name == "det") return Variable(lu.determinant());
+        return lu.inverse();
     }
-    else if (func_name == "sqrt") {
-        if (args.empty()) {
-            throw std::runtime_error("sqrt() requires one argument");
+    else if (func_name == "chol") {
+        // Upper triangular R with R' * R = A, like MATLAB
+        if (args.size() != 1) {
+            throw std::runtime_error("chol() requires one argument");
         }
-        const auto& var = args[0];
-        if (var.is_scalar()) {
-            return Variable(std::sqrt(var.as_scalar()));
+        CholeskyFactorization chol(args[0]);
+        if (!chol.positive_definite()) {
+            throw std::runtime_error("chol(): matrix must be positive definite");
         }
-        throw std::runtime_error("sqrt() only supports scalar arguments for now");
+        return chol.factor().transpose();
     }
-    else if (func_name == "abs") {
-        if (args.empty()) {
-            throw std::runtime_error("abs() requires one argument");
+    else if (func_name == "eig") {
+        // Eigenvalues of a symmetric matrix, ascending, as a column
+        if (args.size() != 1) {
+            throw std::runtime_error("eig() requires one argument");
         }
-        const auto& var = args[0];
-        if (var.is_scalar()) {
-            return Variable(std::abs(var.as_scalar()));
+        if (!is_symmetric(args[0])) {
+            throw std::runtime_error("eig(): only symmetric matrices are supported");
         }
-        throw std::runtime_error("abs() only supports scalar arguments for now");
+        std::vector<double> values = eig_symmetric(args[0], false).values;
+        return Variable(values.size(), 1, values);
     }
-    else if (func_name == "sin" || func_name == "cos" || func_name == "tan" ||
-             func_name == "exp" || func_name == "log" || func_name == "log10") {
-        if (args.empty()) {
+    else if (func_name == "maxNumCompThreads") {
+        // Returns the previous setting, like MATLAB
+        ThreadPool& pool = ThreadPool::global();
+        double previous = static_cast<double>(pool.threads());
+        if (!args.empty()) {
+            double n = args[0].as_scalar();
+            if (n < 1.0 || n != std::floor(n)) {
+                throw std::runtime_error("maxNumCompThreads() requires a positive integer");
+            }
+            pool.set_threads(static_cast<size_t>(n));
+        }
+        return Variable(previous);
+    }
+    else if (const kernels::UnaryOp* op = kernels::unary_function(func_name)) {
+        if (args.size() != 1) {
             throw std::runtime_error(func_name + "() requires one argument");
         }
         const auto& var = args[0];
-        if (!var.is_scalar()) {
-            throw std::runtime_error(func_name + "() only supports scalar arguments for now");
+        if (var.is_scalar()) {
+            double x = var.as_scalar();
+            kernels::unary(*op, &x, &x, 1);
+            return Variable(x);
         }
-        double val = var.as_scalar();
-        double result;
-        if (func_name == "sin") result = std::sin(val);
-        else if (func_name == "cos") result = std::cos(val);
-        else if (func_name == "tan") result = std::tan(val);
-        else if (func_name == "exp") result = std::exp(val);
-        else if (func_name == "log") result = std::log(val);
-        else if (func_name == "log10") result = std::log10(val);
-        return Variable(result);
+        Variable result = Variable::uninitialized(var.dims());
+        kernels::unary(*op, var.data(), result.mutable_data(), var.numel());
+        return result;
     }
     
     // Unknown function
@@ -509,23 +338,22 @@ void ActiveWindow::display_value(const Variable& var) {
     if (var.is_scalar()) {
         // Single number
         std::cout << "    " << std::setprecision(4) << var.as_scalar() << "\n";
-    } else if (var.is_vector()) {
-        // Vector
-        const auto& vec = var.as_vector();
-        std::cout << "    ";
-        for (size_t i = 0; i < vec.size(); ++i) {
-            std::cout << std::setw(10) << std::setprecision(4) << vec[i];
-            if (i < vec.size() - 1) std::cout << "  ";
-        }
-        std::cout << "\n";
-    } else if (var.is_matrix()) {
-        // Matrix
-        const auto& mat = var.as_matrix();
-        for (const auto& row : mat) {
+        return;
+    }
+
+    // Row by row; N-d arrays page by page
+    size_t rows = var.rows(), cols = var.cols();
+    size_t page_size = rows * cols;
+    size_t pages = page_size ? var.numel() / page_size : 0;
+    const double* data = var.data();
+    for (size_t k = 0; k < pages; ++k) {
+        if (pages > 1) std::cout << "  (:,:," << (k + 1) << ")\n";
+        const double* page = data + k * page_size;
+        for (size_t i = 0; i < rows; ++i) {
             std::cout << "    ";
-            for (size_t j = 0; j < row.size(); ++j) {
-                std::cout << std::setw(10) << std::setprecision(4) << row[j];
-                if (j < row.size() - 1) std::cout << "  ";
+            for (size_t j = 0; j < cols; ++j) {
+                std::cout << std::setw(10) << std::setprecision(4) << page[i + j * rows];
+                if (j < cols - 1) std::cout << "  ";
             }
             std::cout << "\n";
         }
@@ -560,7 +388,7 @@ void ActiveWindow::list_variables_detailed() {
     std::cout << "  ────────────  ────────────────  ──────  ──────\n";
     
     for (const auto& name : names) {
-        Variable var = workspace_->get(name);
+        const Variable& var = workspace_->get(name);
         std::cout << "  " << std::setw(12) << std::left << name;
         std::cout << "  " << std::setw(16) << var.size_string();
         std::cout << "  " << std::setw(6) << std::right << var.memory_size();
@@ -569,6 +397,43 @@ void ActiveWindow::list_variables_detailed() {
     std::cout << "\n";
 }
 
+void ActiveWindow::show_memory(const std::string& option) {
+    if (option == "trim") {
+        buffer_pool::trim();
+    } else if (!option.empty()) {
+        throw std::runtime_error("memory: unknown option '" + option + "' (use 'memory' or 'memory trim')");
+    }
+    
+    auto bytes = [](size_t n) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(n < 1024 ? 0 : 1);
+        if (n < 1024) ss << n << " B";
+        else if (n < (1 << 20)) ss << n / 1024.0 << " KiB";
+        else if (n < (1 << 30)) ss << n / 1048576.0 << " MiB";
+        else ss << n / 1073741824.0 << " GiB";
+        return ss.str();
+    };
+    auto percent = [](double fraction) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(1) << 100.0 * fraction << " %";
+        return ss.str();
+    };
+    BufferPoolStats s = buffer_pool::stats();
+    std::cout << "\n  Buffer pool\n";
+    std::cout << "  ──────────────────────────────────────\n";
+    std::cout << "  In use          " << std::setw(12) << bytes(s.bytes_in_use) << "\n";
+    std::cout << "  Peak            " << std::setw(12) << bytes(s.peak_bytes_in_use) << "\n";
+    std::cout << "  Cached (idle)   " << std::setw(12) << bytes(s.bytes_cached)
+              << "  limit " << bytes(buffer_pool::cache_limit()) << "\n";
+    std::cout << "    in threads    " << std::setw(12) << bytes(s.bytes_thread_cached)
+              << "  freed on each thread's next call after a trim\n";
+    std::cout << "  Fragmentation   " << std::setw(12) << percent(s.fragmentation()) << "\n";
+    std::cout << "  Allocations     " << std::setw(12) << s.allocations << "\n";
+    std::cout << "  Pool hits       " << std::setw(12) << percent(s.hit_rate()) << "\n";
+    std::cout << "  System allocs   " << std::setw(12) << s.system_allocations
+              << "  frees " << s.system_frees << "\n\n";
+}
+
 void ActiveWindow::print_banner() {
     if (!fancy_mode_) return;
     
@@ -612,6 +477,8 @@ void ActiveWindow::print_help() {
     std::cout << "    x = 5                 Assign scalar\n";
     std::cout << "    v = [1 2 3 4]         Create vector\n";
     std::cout << "    M = [1 2; 3 4]        Create matrix\n";
+    std::cout << "    y = 2*x.^2 + M'       Operators work on whole arrays\n";
+    std::cout << "    x = M \\ b             Solve M*x = b\n";
     std::cout << "    x = 5;                Suppress output (semicolon)\n\n";
     
     std::cout << "  \033[1mFunctions:\033[0m\n";
@@ -622,14 +489,19 @@ void ActiveWindow::print_help() {
     std::cout << "    mean(x)               Average\n";
     std::cout << "    min(x), max(x)        Minimum/maximum\n";
     std::cout << "    sqrt(x), abs(x)       Square root, absolute value\n";
+    std::cout << "    floor, ceil, round    Rounding\n";
     std::cout << "    sin(x), cos(x), tan(x)  Trigonometric\n";
-    std::cout << "    exp(x), log(x)        Exponential, logarithm\n\n";
+    std::cout << "    exp(x), log(x)        Exponential, logarithm\n";
+    std::cout << "    inv(M), det(M)        Inverse, determinant\n";
+    std::cout << "    chol(M), eig(M)       Cholesky factor, symmetric eigenvalues\n";
+    std::cout << "    maxNumCompThreads(n)  Threads used by array kernels\n\n";
     
     std::cout << "  \033[1mWorkspace:\033[0m\n";
     std::cout << "    who                   List variables\n";
     std::cout << "    whos                  Detailed variable info\n";
     std::cout << "    clear                 Clear all variables\n";
-    std::cout << "    clear x               Clear variable x\n\n";
+    std::cout << "    clear x               Clear variable x\n";
+    std::cout << "    memory [trim]         Buffer pool statistics; trim frees idle buffers\n\n";
     
     std::cout << "  \033[1mDisplay:\033[0m\n";
     std::cout << "    clc                   Clear screen\n";
@@ -677,8 +549,9 @@ bool ActiveWindow::is_valid_name(const std::string& name) const {
 
 bool ActiveWindow::is_number(const std::string& str) const {
     try {
-        std::stod(str);
-        return true;
+        size_t used = 0;
+        std::stod(str, &used);
+        return used == str.size();
     } catch (...) {
         return false;
     }
@@ -696,12 +569,29 @@ void ActiveWindow::process_command_external(const std::string& line) {
     }
 }
 
+const Variable* ActiveWindow::find_variable(const std::string& name) const {
+    return workspace_->find(name);
+}
+
+void ActiveWindow::set_variable(const std::string& name, Variable value) {
+    workspace_->set(name, std::move(value));
+}
+
+void ActiveWindow::show_variable(const std::string& name, const Variable& var) {
+    std::cout << "\n";
+    display_variable(name, var);
+}
+
+void ActiveWindow::show_ans(const Variable& var) {
+    std::cout << "\nans =\n\n";
+    display_value(var);
+    std::cout << "\n";
+}
+
 double ActiveWindow::get_scalar(const std::string& name) const {
-    if (workspace_->exists(name)) {
-        Variable var = workspace_->get(name);
-        if (var.is_scalar()) {
-            return var.as_scalar();
-        }
+    const Variable* var = workspace_->find(name);
+    if (var && var->is_scalar()) {
+        return var->as_scalar();
     }
     return 0.0;
 }
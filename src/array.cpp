@@ -0,0 +1,260 @@
+// MatLabC++ Array
+// src/array.cpp
+
+#include "matlabcpp/array.hpp"
+#include "matlabcpp/kernels.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace matlabcpp {
+
+// ========== Construction ==========
+
+Array::Array(const std::vector<double>& row) {
+    rows_ = 1;
+    cols_ = row.size();
+    numel_ = cols_;
+    if (numel_ == 1) scalar_ = row[0];
+    else adopt(AlignedVector(row.begin(), row.end()));
+}
+
+Array::Array(const std::vector<std::vector<double>>& rows) {
+    rows_ = rows.size();
+    cols_ = rows.empty() ? 0 : rows[0].size();
+    numel_ = rows_ * cols_;
+    for (const auto& r : rows) {
+        if (r.size() != cols_) throw std::runtime_error("Matrix rows must have the same length");
+    }
+    if (numel_ == 1) {
+        scalar_ = rows[0][0];
+        return;
+    }
+    AlignedVector data(numel_);
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t j = 0; j < cols_; ++j) data[i + j * rows_] = rows[i][j];
+    }
+    adopt(std::move(data));
+}
+
+Array::Array(size_t rows, size_t cols) : rows_(rows), cols_(cols), numel_(rows * cols) {
+    if (numel_ != 1) adopt(AlignedVector(numel_, 0.0));
+}
+
+Array::Array(size_t rows, size_t cols, const std::vector<double>& column_major)
+    : Array(rows, cols, AlignedVector(column_major.begin(), column_major.end())) {}
+
+Array::Array(size_t rows, size_t cols, AlignedVector column_major)
+    : rows_(rows), cols_(cols), numel_(rows * cols) {
+    if (column_major.size() != numel_) {
+        throw std::runtime_error("Data size doesn't match dimensions");
+    }
+    if (numel_ == 1) scalar_ = column_major[0];
+    else adopt(std::move(column_major));
+}
+
+Array Array::zeros(const std::vector<size_t>& dims) {
+    Array a;
+    a.set_shape(dims);
+    if (a.numel_ != 1) a.adopt(AlignedVector(a.numel_, 0.0));
+    return a;
+}
+
+Array Array::uninitialized(size_t rows, size_t cols) {
+    return uninitialized(std::vector<size_t>{rows, cols});
+}
+
+Array Array::uninitialized(const std::vector<size_t>& dims) {
+    Array a;
+    a.set_shape(dims);
+    if (a.numel_ != 1) a.adopt(AlignedVector(a.numel_));
+    return a;
+}
+
+void Array::set_shape(const std::vector<size_t>& dims) {
+    size_t n = dims.size();
+    while (n > 2 && dims[n - 1] == 1) --n;
+    rows_ = n > 0 ? dims[0] : 1;
+    cols_ = n > 1 ? dims[1] : 1;
+    trailing_dims_.assign(dims.begin() + std::min<size_t>(n, 2), dims.begin() + std::max<size_t>(n, 2));
+    numel_ = rows_ * cols_;
+    for (size_t d : trailing_dims_) numel_ *= d;
+}
+
+void Array::adopt(AlignedVector data) {
+    data_ = CowPtr<AlignedVector>(std::move(data));
+}
+
+// ========== Shape ==========
+
+size_t Array::dim(size_t k) const {
+    if (k == 0) return rows_;
+    if (k == 1) return cols_;
+    return k - 2 < trailing_dims_.size() ? trailing_dims_[k - 2] : 1;
+}
+
+std::vector<size_t> Array::dims() const {
+    std::vector<size_t> out{rows_, cols_};
+    out.insert(out.end(), trailing_dims_.begin(), trailing_dims_.end());
+    return out;
+}
+
+Array Array::reshape(const std::vector<size_t>& dims) const {
+    Array out = *this;
+    out.set_shape(dims);
+    if (out.numel_ != numel_) {
+        throw std::runtime_error("To RESHAPE the number of elements must not change");
+    }
+    return out;
+}
+
+void Array::resize_vector(size_t n) {
+    if (!trailing_dims_.empty() || (rows_ > 1 && cols_ > 1)) {
+        throw std::runtime_error("Attempt to grow matrix with a linear index");
+    }
+    if (n == numel_) return;
+    bool column = cols_ == 1 && rows_ > 1;
+
+    if (n == 1) {
+        scalar_ = numel_ ? data()[0] : 0.0;
+        data_.reset();
+    } else if (numel_ == 1) {
+        AlignedVector v;
+        v.reserve(std::max<size_t>(n, 4));
+        v.push_back(scalar_);
+        v.resize(n, 0.0);
+        adopt(std::move(v));
+    } else {
+        data_.mutate().resize(n, 0.0);
+    }
+
+    rows_ = column ? n : 1;
+    cols_ = column ? 1 : n;
+    numel_ = n;
+}
+
+// ========== Element Access ==========
+
+double* Array::mutable_data() {
+    return numel_ == 1 ? &scalar_ : data_.mutate().data();
+}
+
+double Array::as_scalar() const {
+    if (numel_ != 1) {
+        throw std::runtime_error("Value is not a scalar");
+    }
+    return scalar_;
+}
+
+std::vector<std::vector<double>> Array::as_matrix() const {
+    // N-d arrays are shown as rows x (cols * pages), like A(:,:)
+    size_t cols = rows_ ? numel_ / rows_ : 0;
+    std::vector<std::vector<double>> out(rows_, std::vector<double>(cols));
+    const double* p = data();
+    for (size_t j = 0; j < cols; ++j) {
+        for (size_t i = 0; i < rows_; ++i) out[i][j] = p[i + j * rows_];
+    }
+    return out;
+}
+
+std::string Array::size_string() const {
+    std::string s = std::to_string(rows_);
+    s += 'x';
+    s += std::to_string(cols_);
+    for (size_t d : trailing_dims_) {
+        s += 'x';
+        s += std::to_string(d);
+    }
+    return s;
+}
+
+// ========== Operators ==========
+
+namespace {
+
+Array elementwise(const Array& a, const Array& b, const char* what, kernels::BinaryOp op) {
+    if (a.dims() != b.dims()) {
+        throw std::runtime_error(std::string("Size mismatch for ") + what);
+    }
+    Array result = Array::uninitialized(a.dims());
+    kernels::binary(op, a.data(), 1, b.data(), 1, result.mutable_data(), a.numel());
+    return result;
+}
+
+} // namespace
+
+Array Array::operator+(const Array& other) const {
+    return elementwise(*this, other, "addition", kernels::BinaryOp::Add);
+}
+
+Array Array::operator-(const Array& other) const {
+    return elementwise(*this, other, "subtraction", kernels::BinaryOp::Sub);
+}
+
+Array Array::dot_times(const Array& other) const {
+    return elementwise(*this, other, "element-wise multiply", kernels::BinaryOp::Mul);
+}
+
+Array Array::operator*(const Array& other) const {
+    // Matrix multiply
+    if (cols_ != other.rows_ || ndims() > 2 || other.ndims() > 2) {
+        throw std::runtime_error("Size mismatch for matrix multiply");
+    }
+
+    Array result = uninitialized(rows_, other.cols_);
+    kernels::gemm(rows_, other.cols_, cols_, 1.0, data(), rows_, other.data(), other.rows_,
+                  0.0, result.mutable_data(), rows_);
+    return result;
+}
+
+Array Array::transpose() const {
+    if (ndims() > 2) {
+        throw std::runtime_error("Transpose on N-D array is not defined");
+    }
+    // A vector's transpose has the same column-major layout: share the buffer
+    if (rows_ == 1 || cols_ == 1) return reshape({cols_, rows_});
+
+    Array result = uninitialized(cols_, rows_);
+    const double* in = data();
+    double* out = result.mutable_data();
+
+    for (size_t j = 0; j < cols_; ++j) {
+        for (size_t i = 0; i < rows_; ++i) {
+            out[j + i * cols_] = in[i + j * rows_];
+        }
+    }
+
+    return result;
+}
+
+// ========== Display ==========
+
+std::string Array::to_string() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(4);
+
+    if (is_scalar()) {
+        oss << scalar_;
+        return oss.str();
+    }
+
+    // Matrix/vector display (N-d arrays page by page)
+    size_t pages = (rows_ * cols_) != 0 ? numel_ / (rows_ * cols_) : 0;
+    const double* p = data();
+    for (size_t k = 0; k < pages; ++k) {
+        if (pages > 1) oss << "(:,:," << (k + 1) << ")\n";
+        const double* page = p + k * rows_ * cols_;
+        for (size_t i = 0; i < rows_; ++i) {
+            oss << "    ";
+            for (size_t j = 0; j < cols_; ++j) {
+                oss << std::setw(10) << page[i + j * rows_];
+            }
+            oss << "\n";
+        }
+    }
+
+    return oss.str();
+}
+
+} // namespace matlabcpp
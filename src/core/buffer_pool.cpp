@@ -0,0 +1,351 @@
+// MatLabC++ Buffer Pool
+// src/core/buffer_pool.cpp
+
+#include "matlabcpp/buffer_pool.hpp"
+#include "matlabcpp/allocator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace matlabcpp::buffer_pool {
+
+namespace {
+
+constexpr size_t kMinBlock = kArrayAlignment;
+constexpr size_t kHugePage = size_t(2) << 20;
+constexpr size_t kMaxPooled = size_t(1) << 30;          // larger blocks bypass the pool
+constexpr size_t kClasses = 1 + 4 * (30 - 6);           // 64 B .. 1 GiB
+constexpr size_t kThreadCacheBlock = size_t(256) << 10; // largest block a thread caches
+constexpr size_t kThreadCacheBytes = size_t(256) << 10; // per class
+
+// Classes: 64, then 2^e + k 2^(e-2) for k = 1..4 in each doubling
+constexpr size_t class_of(size_t bytes) {
+    if (bytes <= kMinBlock) return 0;
+    size_t e = std::bit_width(bytes - 1) - 1;            // 2^e < bytes <= 2^(e+1)
+    size_t step = size_t(1) << (e - 2);
+    size_t k = (bytes - (size_t(1) << e) + step - 1) / step;
+    return 1 + 4 * (e - 6) + (k - 1);
+}
+
+constexpr size_t class_size(size_t c) {
+    if (c == 0) return kMinBlock;
+    size_t e = (c - 1) / 4 + 6, k = (c - 1) % 4 + 1;
+    return (size_t(1) << e) + k * (size_t(1) << (e - 2));
+}
+
+constexpr size_t kThreadClasses = class_of(kThreadCacheBlock) + 1;
+static_assert(class_size(kThreadClasses - 1) == kThreadCacheBlock);
+static_assert(class_size(kClasses - 1) == kMaxPooled);
+
+struct Counters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> system_allocations{0};
+    std::atomic<uint64_t> system_frees{0};
+    std::atomic<size_t> in_use{0};
+    std::atomic<size_t> requested{0};
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> cached{0};
+    std::atomic<size_t> thread_cached{0};   // ... of cached, in thread caches
+    std::atomic<uint64_t> epoch{0};         // bumped by trim and set_cache_limit
+};
+
+// Never destroyed: thread caches flush into the shared pool at thread
+// exit, which can come after static destructors have run
+Counters& counters() {
+    static Counters* c = new Counters;
+    return *c;
+}
+
+// Huge blocks are mapped directly, 2 MiB aligned and advised for
+// transparent huge pages; the rest come from aligned operator new
+size_t mapped_size(size_t size) {
+    return (size + 4095) & ~size_t(4095);
+}
+
+void* system_allocate(size_t size) {
+    counters().system_allocations.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    if (size >= kHugePage) {
+        size = mapped_size(size);
+        size_t span = size + kHugePage;
+        void* raw = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + kHugePage - 1) & ~(kHugePage - 1);
+        size_t head = aligned - start, tail = span - head - size;
+        if (head) munmap(raw, head);
+        if (tail) munmap(reinterpret_cast<void*>(aligned + size), tail);
+        void* p = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+        madvise(p, size, MADV_HUGEPAGE);                 // advice only
+#endif
+        return p;
+    }
+#endif
+    return ::operator new(size, std::align_val_t(kArrayAlignment));
+}
+
+void system_free(void* p, size_t size) noexcept {
+    counters().system_frees.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    if (size >= kHugePage) {
+        munmap(p, mapped_size(size));
+        return;
+    }
+#endif
+    ::operator delete(p, std::align_val_t(kArrayAlignment));
+}
+
+size_t default_limit() {
+    if (const char* env = std::getenv("MATLABCPP_POOL_LIMIT_MB")) {
+        char* end = nullptr;
+        unsigned long long mb = std::strtoull(env, &end, 10);
+        if (end != env) return static_cast<size_t>(mb) << 20;
+    }
+    return size_t(256) << 20;
+}
+
+// Free lists shared by all threads. Thread caches count against the same
+// limit, so all idle blocks together stay within it
+class SharedPool {
+public:
+    void* take(size_t c) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_[c].empty()) return nullptr;
+        void* p = free_[c].back();
+        free_[c].pop_back();
+        bytes_ -= class_size(c);
+        return p;
+    }
+
+    void give(size_t c, void* p) noexcept {
+        size_t size = class_size(c);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (counters().cached.load(std::memory_order_relaxed) + size <= limit()) {
+                try {
+                    free_[c].push_back(p);
+                    bytes_ += size;
+                    counters().cached.fetch_add(size, std::memory_order_relaxed);
+                    return;
+                } catch (const std::bad_alloc&) {
+                    // no room to remember the block: free it
+                }
+            }
+        }
+        system_free(p, size);
+    }
+
+    size_t limit() const noexcept { return limit_.load(std::memory_order_relaxed); }
+
+    void set_limit(size_t limit) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        limit_.store(limit, std::memory_order_relaxed);
+        release(limit);
+    }
+
+    void trim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        release(0);
+    }
+
+private:
+    // Frees idle blocks, largest first, down to target bytes; mutex_ held
+    void release(size_t target) noexcept {
+        for (size_t c = kClasses; c-- > 0 && bytes_ > target;) {
+            size_t size = class_size(c);
+            while (!free_[c].empty() && bytes_ > target) {
+                system_free(free_[c].back(), size);
+                free_[c].pop_back();
+                bytes_ -= size;
+                counters().cached.fetch_sub(size, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<void*> free_[kClasses];
+    size_t bytes_ = 0;
+    std::atomic<size_t> limit_{default_limit()};
+};
+
+SharedPool& shared() {
+    static SharedPool* pool = new SharedPool;
+    return *pool;
+}
+
+// Other threads cannot reach into this cache, so trim and set_cache_limit
+// bump the epoch and each cache frees its blocks on the thread's next
+// allocate or deallocate. A thread that never calls again keeps its
+// blocks until it exits.
+class ThreadCache {
+public:
+    ~ThreadCache();
+
+    void* take(size_t c) {
+        sync();
+        if (free_[c].empty()) return nullptr;
+        void* p = free_[c].back();
+        free_[c].pop_back();
+        return p;
+    }
+
+    bool put(size_t c, void* p) noexcept {
+        sync();
+        size_t size = class_size(c);
+        if (free_[c].size() >= std::max<size_t>(1, kThreadCacheBytes / size)) return false;
+        if (counters().cached.load(std::memory_order_relaxed) + size > shared().limit()) return false;
+        try {
+            free_[c].push_back(p);
+        } catch (const std::bad_alloc&) {
+            return false;
+        }
+        counters().cached.fetch_add(size, std::memory_order_relaxed);
+        counters().thread_cached.fetch_add(size, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Hands the blocks to the shared pool, or frees them outright
+    void flush(bool release = false) noexcept {
+        Counters& s = counters();
+        for (size_t c = 0; c < kThreadClasses; c++) {
+            size_t size = class_size(c);
+            for (void* p : free_[c]) {
+                s.cached.fetch_sub(size, std::memory_order_relaxed);
+                s.thread_cached.fetch_sub(size, std::memory_order_relaxed);
+                if (release) system_free(p, size);
+                else shared().give(c, p);
+            }
+            free_[c].clear();
+        }
+    }
+
+    // Frees the cache if trim or set_cache_limit ran since the last call
+    void sync() noexcept {
+        uint64_t epoch = counters().epoch.load(std::memory_order_acquire);
+        if (epoch != epoch_) {
+            epoch_ = epoch;
+            flush(true);
+        }
+    }
+
+private:
+    std::vector<void*> free_[kThreadClasses];
+    uint64_t epoch_ = counters().epoch.load(std::memory_order_acquire);
+};
+
+// Other thread_locals (kernel scratch buffers) can be destroyed after the
+// cache; their blocks then go straight to the shared pool
+thread_local bool t_cache_destroyed = false;
+
+ThreadCache::~ThreadCache() {
+    flush();
+    t_cache_destroyed = true;
+}
+
+ThreadCache* thread_cache() {
+    if (t_cache_destroyed) return nullptr;
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+void note_in_use(size_t size) {
+    Counters& s = counters();
+    size_t now = s.in_use.fetch_add(size, std::memory_order_relaxed) + size;
+    size_t peak = s.peak.load(std::memory_order_relaxed);
+    while (now > peak && !s.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+void* allocate(size_t bytes) {
+    if (bytes == 0) return nullptr;
+    Counters& s = counters();
+    size_t size = bytes;
+    void* p = nullptr;
+    if (bytes <= kMaxPooled) {
+        size_t c = class_of(bytes);
+        size = class_size(c);
+        if (size <= kThreadCacheBlock) {
+            if (ThreadCache* cache = thread_cache()) {
+                if ((p = cache->take(c))) s.thread_cached.fetch_sub(size, std::memory_order_relaxed);
+            }
+        }
+        if (!p) p = shared().take(c);
+        if (p) {
+            s.hits.fetch_add(1, std::memory_order_relaxed);
+            s.cached.fetch_sub(size, std::memory_order_relaxed);
+        }
+    }
+    if (!p) p = system_allocate(size);
+    s.allocations.fetch_add(1, std::memory_order_relaxed);
+    s.requested.fetch_add(bytes, std::memory_order_relaxed);
+    note_in_use(size);
+    return p;
+}
+
+void deallocate(void* p, size_t bytes) noexcept {
+    if (!p) return;
+    Counters& s = counters();
+    s.requested.fetch_sub(bytes, std::memory_order_relaxed);
+    if (bytes > kMaxPooled) {
+        s.in_use.fetch_sub(bytes, std::memory_order_relaxed);
+        system_free(p, bytes);
+        return;
+    }
+    size_t c = class_of(bytes);
+    size_t size = class_size(c);
+    s.in_use.fetch_sub(size, std::memory_order_relaxed);
+    if (size <= kThreadCacheBlock) {
+        ThreadCache* cache = thread_cache();
+        if (cache && cache->put(c, p)) return;
+    }
+    shared().give(c, p);
+}
+
+BufferPoolStats stats() {
+    const Counters& s = counters();
+    BufferPoolStats out;
+    out.allocations = s.allocations.load(std::memory_order_relaxed);
+    out.hits = s.hits.load(std::memory_order_relaxed);
+    out.system_allocations = s.system_allocations.load(std::memory_order_relaxed);
+    out.system_frees = s.system_frees.load(std::memory_order_relaxed);
+    out.bytes_in_use = s.in_use.load(std::memory_order_relaxed);
+    out.bytes_requested = s.requested.load(std::memory_order_relaxed);
+    out.peak_bytes_in_use = s.peak.load(std::memory_order_relaxed);
+    out.bytes_cached = s.cached.load(std::memory_order_relaxed);
+    out.bytes_thread_cached = s.thread_cached.load(std::memory_order_relaxed);
+    return out;
+}
+
+void reset_peak() {
+    Counters& s = counters();
+    s.peak.store(s.in_use.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+size_t cache_limit() {
+    return shared().limit();
+}
+
+void set_cache_limit(size_t bytes) {
+    shared().set_limit(bytes);
+    counters().epoch.fetch_add(1, std::memory_order_release);
+}
+
+void trim() {
+    counters().epoch.fetch_add(1, std::memory_order_release);
+    if (ThreadCache* cache = thread_cache()) cache->sync();
+    shared().trim();
+}
+
+} // namespace matlabcpp::buffer_pool
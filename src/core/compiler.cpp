@@ -0,0 +1,1274 @@
+// MatLabC++ .m Script Compiler
+// src/core/compiler.cpp
+//
+// Lexer tokens -> statement/expression AST -> register bytecode.
+//
+// Expressions use precedence climbing with MATLAB's operator table:
+//   ||  <  &&  <  |  <  &  <  comparisons  <  :  <  + -  <  * / .* ./
+//   <  unary + - ~  <  ^ .^ ' .'  <  postfix ( )
+//
+// Chains of elementwise operators and builtins (a.*x.^2 + b.*x + c,
+// exp(-t).*sin(w*t), ...) compile to a single Fused instruction followed by
+// the ordinary per-operator code, which the VM only runs when operand
+// shapes rule the fused kernel out.
+//
+// A statement that fails to parse is not fatal: its source text is kept
+// and forwarded to ActiveWindow at run time (EvalText), so anything the
+// compiler does not cover yet behaves exactly as it did before.
+
+#include "matlabcpp/bytecode.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/lexer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace matlabcpp {
+namespace interpreter {
+
+namespace {
+
+// ========== AST ==========
+
+enum class NodeKind { Number, Identifier, MagicColon, MagicEnd, Unary, Binary, AndAnd, OrOr, Range, Call, Matrix };
+
+struct Node;
+using NodePtr = std::unique_ptr<Node>;
+
+struct Node {
+    NodeKind kind;
+    double number = 0.0;
+    std::string name;                        // Identifier / Call target
+    OpCode op = OpCode::Nop;                 // Unary / Binary
+    std::vector<NodePtr> args;               // operands, range parts, call arguments
+    std::vector<std::vector<NodePtr>> rows;  // Matrix literal
+};
+
+NodePtr make_node(NodeKind kind) {
+    auto n = std::make_unique<Node>();
+    n->kind = kind;
+    return n;
+}
+
+enum class StmtKind { Assign, IndexAssign, Expr, If, For, While, Break, Continue, Return, Command, Section, Fallback, Error };
+
+struct Stmt {
+    StmtKind kind;
+    int line = 0;
+    bool suppress = false;
+    std::string text;                 // target name, loop variable, command/fallback text, message
+    std::vector<NodePtr> subscripts;  // IndexAssign
+    NodePtr expr;                     // rhs, loop range, while condition
+    std::vector<Stmt> body;
+    std::vector<std::pair<NodePtr, std::vector<Stmt>>> branches;  // if / elseif / else (null cond)
+};
+
+struct ParseError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// ========== PARSER ==========
+
+class Parser {
+    std::vector<Token> toks_;
+    std::vector<std::string> lines_;
+    size_t pos_ = 0;
+    // true = inside [...] where whitespace separates elements
+    std::vector<bool> ws_sensitive_;
+    int subscript_depth_ = 0;
+
+public:
+    Parser(std::vector<Token> toks, std::vector<std::string> lines)
+        : toks_(std::move(toks)), lines_(std::move(lines)) {
+        // Plain comments carry no meaning for execution
+        toks_.erase(std::remove_if(toks_.begin(), toks_.end(),
+                                   [](const Token& t) { return t.type == TokenType::Comment; }),
+                    toks_.end());
+    }
+
+    std::vector<Stmt> parse_script() {
+        return parse_block({});
+    }
+
+    // Exactly one expression, optionally followed by ';'
+    NodePtr parse_single_expression() {
+        auto e = parse_expr();
+        while (at(TokenType::Semicolon) || at(TokenType::Newline)) pos_++;
+        if (!at_eof()) throw ParseError("unexpected '" + cur().value + "'");
+        return e;
+    }
+
+private:
+    const Token& cur() const { return toks_[pos_]; }
+    const Token& peek_tok(size_t k = 1) const {
+        return toks_[std::min(pos_ + k, toks_.size() - 1)];
+    }
+    bool at(TokenType t) const { return cur().type == t; }
+    bool at_op(const char* op) const { return cur().type == TokenType::Operator && cur().value == op; }
+    bool at_eof() const { return at(TokenType::EndOfFile); }
+
+    const Token& expect(TokenType t, const char* what) {
+        if (!at(t)) throw ParseError(std::string("expected ") + what + " near '" + cur().value + "'");
+        return toks_[pos_++];
+    }
+
+    static int token_end_col(const Token& t) {
+        int len = static_cast<int>(t.value.size());
+        if (t.type == TokenType::String) len += 2;
+        return t.col + len;
+    }
+
+    bool space_before(size_t i) const {
+        if (i == 0 || i >= toks_.size()) return false;
+        const Token& prev = toks_[i - 1];
+        const Token& t = toks_[i];
+        return t.line == prev.line && t.col > token_end_col(prev);
+    }
+
+    bool in_matrix() const { return !ws_sensitive_.empty() && ws_sensitive_.back(); }
+
+    bool at_statement_end() const {
+        switch (cur().type) {
+            case TokenType::Newline: case TokenType::Semicolon: case TokenType::Comma:
+            case TokenType::EndOfFile: case TokenType::SectionComment:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    bool at_terminator(const std::vector<TokenType>& terms) const {
+        for (auto t : terms) if (cur().type == t) return true;
+        return false;
+    }
+
+    void skip_separators() {
+        while (at(TokenType::Newline) || at(TokenType::Semicolon) || at(TokenType::Comma)) pos_++;
+    }
+
+    void reset_nesting() {
+        ws_sensitive_.clear();
+        subscript_depth_ = 0;
+    }
+
+    void skip_to_eol() {
+        while (!at_eof() && !at(TokenType::Newline)) pos_++;
+    }
+
+    // Consumes the statement terminator; returns true if it was ';'
+    bool finish_statement() {
+        if (!at_statement_end() && !at(TokenType::Keyword_end) &&
+            !at(TokenType::Keyword_else) && !at(TokenType::Keyword_elseif)) {
+            throw ParseError("unexpected '" + cur().value + "'");
+        }
+        if (at(TokenType::Semicolon)) { pos_++; return true; }
+        if (at(TokenType::Comma)) pos_++;
+        return false;
+    }
+
+    // Raw source of a statement from `tok` to end of its line, minus any trailing comment
+    std::string source_from(const Token& tok) const {
+        if (tok.line < 1 || static_cast<size_t>(tok.line) > lines_.size()) return "";
+        const std::string& line = lines_[tok.line - 1];
+        size_t start = std::min(line.size(), static_cast<size_t>(std::max(tok.col - 1, 0)));
+        std::string text = line.substr(start);
+        bool in_string = false;
+        for (size_t j = 0; j < text.size(); j++) {
+            if (text[j] == '\'') {
+                // x' is a transpose, not the start of a string
+                char prev = j > 0 ? text[j - 1] : ' ';
+                bool transpose = !in_string && (std::isalnum(static_cast<unsigned char>(prev)) ||
+                                                std::strchr("_)]'.", prev) != nullptr);
+                if (!transpose) in_string = !in_string;
+            }
+            if (text[j] == '%' && !in_string) { text = text.substr(0, j); break; }
+        }
+        size_t last = text.find_last_not_of(" \t\r");
+        return last == std::string::npos ? "" : text.substr(0, last + 1);
+    }
+
+    // ----- statements -----
+
+    std::vector<Stmt> parse_block(const std::vector<TokenType>& terms) {
+        std::vector<Stmt> out;
+        while (true) {
+            skip_separators();
+            if (at_eof() || at_terminator(terms)) return out;
+            out.push_back(parse_statement());
+        }
+    }
+
+    Stmt parse_statement() {
+        const Token& first = cur();
+        Stmt st;
+        st.line = first.line;
+
+        switch (first.type) {
+            case TokenType::SectionComment: {
+                st.kind = StmtKind::Section;
+                std::string title = first.value.substr(2);
+                size_t b = title.find_first_not_of(" \t");
+                size_t e = title.find_last_not_of(" \t\r");
+                st.text = b == std::string::npos ? "" : title.substr(b, e - b + 1);
+                pos_++;
+                return st;
+            }
+            case TokenType::Keyword_if:    return parse_if();
+            case TokenType::Keyword_for:   return parse_for();
+            case TokenType::Keyword_while: return parse_while();
+            case TokenType::Keyword_break:
+            case TokenType::Keyword_continue:
+            case TokenType::Keyword_return:
+                st.kind = first.type == TokenType::Keyword_break ? StmtKind::Break
+                        : first.type == TokenType::Keyword_continue ? StmtKind::Continue
+                        : StmtKind::Return;
+                pos_++;
+                finish_statement();
+                return st;
+            case TokenType::Keyword_clear:
+            case TokenType::Keyword_clc:
+            case TokenType::Keyword_close: {
+                st.kind = StmtKind::Command;
+                while (!at_statement_end()) {
+                    if (!st.text.empty()) st.text += " ";
+                    st.text += cur().value;
+                    pos_++;
+                }
+                st.suppress = finish_statement();
+                return st;
+            }
+            case TokenType::Keyword_end:
+                pos_++;
+                st.kind = StmtKind::Error;
+                st.text = "Unexpected 'end'";
+                return st;
+            default:
+                break;
+        }
+
+        size_t start = pos_;
+        try {
+            return parse_simple_statement();
+        } catch (const ParseError&) {
+            // Keep the source and let ActiveWindow deal with it at run time
+            pos_ = start;
+            st.kind = StmtKind::Fallback;
+            st.text = source_from(toks_[start]);
+            skip_to_eol();
+            reset_nesting();
+            return st;
+        }
+    }
+
+    Stmt parse_simple_statement() {
+        Stmt st;
+        st.line = cur().line;
+
+        if (at(TokenType::Identifier) && peek_tok().type == TokenType::Assign) {
+            st.kind = StmtKind::Assign;
+            st.text = cur().value;
+            pos_ += 2;
+            st.expr = parse_expr();
+        } else if (at(TokenType::Identifier) && peek_tok().type == TokenType::LParen && is_index_assignment()) {
+            st.kind = StmtKind::IndexAssign;
+            st.text = cur().value;
+            pos_ += 2;
+            ws_sensitive_.push_back(false);
+            st.subscripts = parse_arguments();
+            ws_sensitive_.pop_back();
+            expect(TokenType::Assign, "'='");
+            st.expr = parse_expr();
+        } else {
+            st.kind = StmtKind::Expr;
+            st.expr = parse_expr();
+        }
+        st.suppress = finish_statement();
+        return st;
+    }
+
+    // name( ... ) = ...
+    bool is_index_assignment() const {
+        int depth = 0;
+        for (size_t i = pos_ + 1; i < toks_.size(); i++) {
+            TokenType t = toks_[i].type;
+            if (t == TokenType::LParen || t == TokenType::LBracket) depth++;
+            else if (t == TokenType::RParen || t == TokenType::RBracket) {
+                if (--depth == 0) {
+                    return i + 1 < toks_.size() && toks_[i + 1].type == TokenType::Assign;
+                }
+            } else if (t == TokenType::Newline || t == TokenType::EndOfFile) {
+                return false;
+            }
+        }
+        return false;
+    }
+
+    // Header failures and missing 'end' turn the whole block into an Error
+    // statement so the body never runs half-parsed.
+    Stmt block_error(int line, const std::string& msg) {
+        Stmt st;
+        st.kind = StmtKind::Error;
+        st.line = line;
+        st.text = msg;
+        return st;
+    }
+
+    bool expect_block_end() {
+        if (!at(TokenType::Keyword_end)) return false;
+        pos_++;
+        return true;
+    }
+
+    std::string missing_end(int line) const {
+        return "Missing 'end' for control block starting near line " + std::to_string(line);
+    }
+
+    Stmt parse_for() {
+        Stmt st;
+        st.kind = StmtKind::For;
+        st.line = cur().line;
+        pos_++;  // for
+
+        std::string header_error;
+        try {
+            bool paren = at(TokenType::LParen);
+            if (paren) pos_++;
+            st.text = expect(TokenType::Identifier, "loop variable").value;
+            expect(TokenType::Assign, "'='");
+            st.expr = parse_expr();
+            if (paren) expect(TokenType::RParen, "')'");
+            if (!at_statement_end()) throw ParseError("unexpected '" + cur().value + "' in for header");
+        } catch (const ParseError& e) {
+            header_error = std::string("Invalid for loop: ") + e.what();
+            skip_to_eol();
+            reset_nesting();
+        }
+
+        st.body = parse_block({TokenType::Keyword_end});
+        if (!expect_block_end()) return block_error(st.line, missing_end(st.line));
+        if (!header_error.empty()) return block_error(st.line, header_error);
+        return st;
+    }
+
+    Stmt parse_while() {
+        Stmt st;
+        st.kind = StmtKind::While;
+        st.line = cur().line;
+        pos_++;  // while
+
+        std::string header_error;
+        try {
+            st.expr = parse_expr();
+            if (!at_statement_end()) throw ParseError("unexpected '" + cur().value + "' in while condition");
+        } catch (const ParseError& e) {
+            header_error = std::string("Invalid while condition: ") + e.what();
+            skip_to_eol();
+            reset_nesting();
+        }
+
+        st.body = parse_block({TokenType::Keyword_end});
+        if (!expect_block_end()) return block_error(st.line, missing_end(st.line));
+        if (!header_error.empty()) return block_error(st.line, header_error);
+        return st;
+    }
+
+    Stmt parse_if() {
+        Stmt st;
+        st.kind = StmtKind::If;
+        st.line = cur().line;
+        std::string header_error;
+
+        bool first = true;
+        while (true) {
+            NodePtr cond;
+            if (first || at(TokenType::Keyword_elseif)) {
+                pos_++;  // if / elseif
+                try {
+                    cond = parse_expr();
+                    if (!at_statement_end()) throw ParseError("unexpected '" + cur().value + "' in condition");
+                } catch (const ParseError& e) {
+                    if (header_error.empty()) header_error = std::string("Invalid if condition: ") + e.what();
+                    skip_to_eol();
+                    reset_nesting();
+                }
+            } else {
+                pos_++;  // else
+            }
+            first = false;
+
+            auto body = parse_block({TokenType::Keyword_elseif, TokenType::Keyword_else, TokenType::Keyword_end});
+            st.branches.emplace_back(std::move(cond), std::move(body));
+
+            if (at(TokenType::Keyword_elseif) || at(TokenType::Keyword_else)) {
+                if (!st.branches.back().first) break;  // else must be last
+                continue;
+            }
+            break;
+        }
+
+        if (!expect_block_end()) return block_error(st.line, missing_end(st.line));
+        if (!header_error.empty()) return block_error(st.line, header_error);
+        return st;
+    }
+
+    // ----- expressions -----
+
+    NodePtr parse_expr() { return parse_oror(); }
+
+    NodePtr binary(NodeKind kind, OpCode op, NodePtr lhs, NodePtr rhs) {
+        auto n = make_node(kind);
+        n->op = op;
+        n->args.push_back(std::move(lhs));
+        n->args.push_back(std::move(rhs));
+        return n;
+    }
+
+    NodePtr parse_oror() {
+        auto lhs = parse_andand();
+        while (at_op("||")) { pos_++; lhs = binary(NodeKind::OrOr, OpCode::Nop, std::move(lhs), parse_andand()); }
+        return lhs;
+    }
+
+    NodePtr parse_andand() {
+        auto lhs = parse_or();
+        while (at_op("&&")) { pos_++; lhs = binary(NodeKind::AndAnd, OpCode::Nop, std::move(lhs), parse_or()); }
+        return lhs;
+    }
+
+    NodePtr parse_or() {
+        auto lhs = parse_and();
+        while (at_op("|")) { pos_++; lhs = binary(NodeKind::Binary, OpCode::Or, std::move(lhs), parse_and()); }
+        return lhs;
+    }
+
+    NodePtr parse_and() {
+        auto lhs = parse_comparison();
+        while (at_op("&")) { pos_++; lhs = binary(NodeKind::Binary, OpCode::And, std::move(lhs), parse_comparison()); }
+        return lhs;
+    }
+
+    NodePtr parse_comparison() {
+        static const std::unordered_map<std::string, OpCode> ops = {
+            {"==", OpCode::Eq}, {"~=", OpCode::Ne}, {"<", OpCode::Lt},
+            {"<=", OpCode::Le}, {">", OpCode::Gt}, {">=", OpCode::Ge}
+        };
+        auto lhs = parse_range();
+        while (at(TokenType::Operator)) {
+            auto it = ops.find(cur().value);
+            if (it == ops.end()) break;
+            pos_++;
+            lhs = binary(NodeKind::Binary, it->second, std::move(lhs), parse_range());
+        }
+        return lhs;
+    }
+
+    NodePtr parse_range() {
+        auto first = parse_additive();
+        if (!at(TokenType::Colon)) return first;
+        pos_++;
+        auto range = make_node(NodeKind::Range);
+        range->args.push_back(std::move(first));
+        range->args.push_back(parse_additive());
+        if (at(TokenType::Colon)) {
+            pos_++;
+            range->args.push_back(parse_additive());  // start : step : stop
+        }
+        return range;
+    }
+
+    // Inside [...], "a -b" is two elements while "a - b" and "a-b" are one
+    bool binary_sign_ends_element() const {
+        return in_matrix() && space_before(pos_) && !space_before(pos_ + 1);
+    }
+
+    NodePtr parse_additive() {
+        auto lhs = parse_multiplicative();
+        while ((at_op("+") || at_op("-")) && !binary_sign_ends_element()) {
+            OpCode op = cur().value == "+" ? OpCode::Add : OpCode::Sub;
+            pos_++;
+            lhs = binary(NodeKind::Binary, op, std::move(lhs), parse_multiplicative());
+        }
+        return lhs;
+    }
+
+    NodePtr parse_multiplicative() {
+        auto lhs = parse_unary();
+        while (at(TokenType::Operator)) {
+            const std::string& v = cur().value;
+            OpCode op;
+            if (v == "*") op = OpCode::Mul;
+            else if (v == "/") op = OpCode::Div;
+            else if (v == "\\") op = OpCode::LeftDiv;
+            else if (v == ".*") op = OpCode::ElemMul;
+            else if (v == "./") op = OpCode::ElemDiv;
+            else break;
+            pos_++;
+            lhs = binary(NodeKind::Binary, op, std::move(lhs), parse_unary());
+        }
+        return lhs;
+    }
+
+    NodePtr parse_unary() {
+        if (at_op("-") || at_op("+") || at_op("~")) {
+            std::string v = cur().value;
+            pos_++;
+            auto operand = parse_unary();
+            if (v == "+") return operand;
+            return unary_node(v == "-" ? OpCode::Neg : OpCode::Not, std::move(operand));
+        }
+        return parse_power();
+    }
+
+    NodePtr unary_node(OpCode op, NodePtr operand) {
+        auto n = make_node(NodeKind::Unary);
+        n->op = op;
+        n->args.push_back(std::move(operand));
+        return n;
+    }
+
+    // ^ .^ ' .' share one level and associate left: a^b' is (a^b)'
+    NodePtr parse_power() {
+        auto base = parse_postfix();
+        while (true) {
+            if (at_op("'") || at_op(".'")) {
+                // Real arrays: conjugate and plain transpose coincide
+                pos_++;
+                base = unary_node(OpCode::Transpose, std::move(base));
+                continue;
+            }
+            if (!at_op("^") && !at_op(".^")) break;
+            OpCode op = cur().value == "^" ? OpCode::Pow : OpCode::ElemPow;
+            pos_++;
+            // Exponent may carry its own sign: 2^-1
+            NodePtr exponent;
+            if (at_op("-") || at_op("+")) {
+                bool neg = cur().value == "-";
+                pos_++;
+                exponent = parse_postfix();
+                if (neg) exponent = unary_node(OpCode::Neg, std::move(exponent));
+            } else {
+                exponent = parse_postfix();
+            }
+            base = binary(NodeKind::Binary, op, std::move(base), std::move(exponent));
+        }
+        return base;
+    }
+
+    NodePtr parse_postfix() {
+        auto node = parse_primary();
+        if (node->kind == NodeKind::Identifier && at(TokenType::LParen) &&
+            !(in_matrix() && space_before(pos_))) {
+            pos_++;
+            auto call = make_node(NodeKind::Call);
+            call->name = node->name;
+            ws_sensitive_.push_back(false);
+            call->args = parse_arguments();
+            ws_sensitive_.pop_back();
+            return call;
+        }
+        return node;
+    }
+
+    // After '(' ... consumes ')'
+    std::vector<NodePtr> parse_arguments() {
+        std::vector<NodePtr> args;
+        if (at(TokenType::RParen)) { pos_++; return args; }
+        subscript_depth_++;
+        while (true) {
+            if (at(TokenType::Colon) &&
+                (peek_tok().type == TokenType::Comma || peek_tok().type == TokenType::RParen)) {
+                pos_++;
+                args.push_back(make_node(NodeKind::MagicColon));
+            } else {
+                args.push_back(parse_expr());
+            }
+            if (at(TokenType::Comma)) { pos_++; continue; }
+            expect(TokenType::RParen, "')'");
+            subscript_depth_--;
+            return args;
+        }
+    }
+
+    NodePtr parse_primary() {
+        const Token& t = cur();
+        switch (t.type) {
+            case TokenType::Number: {
+                auto n = make_node(NodeKind::Number);
+                try {
+                    n->number = std::stod(t.value);
+                } catch (...) {
+                    throw ParseError("invalid number '" + t.value + "'");
+                }
+                pos_++;
+                return n;
+            }
+            case TokenType::Identifier: {
+                auto n = make_node(NodeKind::Identifier);
+                n->name = t.value;
+                pos_++;
+                return n;
+            }
+            case TokenType::Keyword_end: {
+                // Only meaningful inside a subscript: x(end)
+                if (subscript_depth_ == 0) throw ParseError("unexpected 'end'");
+                pos_++;
+                return make_node(NodeKind::MagicEnd);
+            }
+            case TokenType::LParen: {
+                pos_++;
+                ws_sensitive_.push_back(false);
+                auto inner = parse_expr();
+                ws_sensitive_.pop_back();
+                expect(TokenType::RParen, "')'");
+                return inner;
+            }
+            case TokenType::LBracket:
+                return parse_matrix();
+            default:
+                throw ParseError("unsupported syntax near '" + t.value + "'");
+        }
+    }
+
+    NodePtr parse_matrix() {
+        pos_++;  // [
+        ws_sensitive_.push_back(true);
+        auto m = make_node(NodeKind::Matrix);
+        std::vector<NodePtr> row;
+
+        while (true) {
+            if (at(TokenType::RBracket)) { pos_++; break; }
+            if (at_eof()) throw ParseError("unterminated matrix literal");
+            if (at(TokenType::Semicolon) || at(TokenType::Newline)) {
+                pos_++;
+                if (!row.empty()) m->rows.push_back(std::move(row));
+                row.clear();
+                continue;
+            }
+            if (at(TokenType::Comma)) { pos_++; continue; }
+            row.push_back(parse_expr());
+        }
+        if (!row.empty()) m->rows.push_back(std::move(row));
+        ws_sensitive_.pop_back();
+        return m;
+    }
+};
+
+// ========== CODE GENERATION ==========
+
+class CodeGen {
+    CompiledScript& out_;
+    uint32_t reg_top_ = 0;
+    std::unordered_map<std::string, uint32_t> string_ids_;
+    std::unordered_map<std::string, uint32_t> symbol_ids_;
+    std::unordered_map<uint64_t, uint32_t> number_ids_;
+
+    struct LoopLabels {
+        uint32_t continue_target;
+        std::vector<uint32_t> breaks;
+    };
+    std::vector<LoopLabels> loops_;
+
+    // Context for 'end' and ':' inside x(...)
+    struct SubscriptContext {
+        uint32_t name;
+        uint32_t dim;
+        uint32_t count;
+    };
+
+    // While emitting the unfused copy of a fused expression: its leaves are
+    // already in registers, and nothing inside it is fused again
+    const std::unordered_map<const Node*, uint32_t>* fused_leaves_ = nullptr;
+    int unfused_depth_ = 0;
+
+public:
+    explicit CodeGen(CompiledScript& out) : out_(out) {}
+
+    void compile_block(const std::vector<Stmt>& stmts) {
+        for (const auto& st : stmts) compile_statement(st);
+    }
+
+    // Expression value into register 0
+    void compile_result(const Node& e) {
+        compile_into(e, alloc(), nullptr);
+    }
+
+    void finish() {
+        emit(OpCode::Halt);
+    }
+
+private:
+    uint32_t here() const { return static_cast<uint32_t>(out_.code.size()); }
+
+    uint32_t emit(OpCode op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint8_t n = 0) {
+        out_.code.push_back({op, n, 0, a, b, c});
+        return here() - 1;
+    }
+
+    uint32_t alloc(uint32_t count = 1) {
+        uint32_t r = reg_top_;
+        reg_top_ += count;
+        out_.num_registers = std::max(out_.num_registers, reg_top_);
+        return r;
+    }
+
+    uint32_t str(const std::string& s) {
+        auto it = string_ids_.find(s);
+        if (it != string_ids_.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(out_.strings.size());
+        out_.strings.push_back(s);
+        string_ids_.emplace(s, id);
+        return id;
+    }
+
+    // Variable names get their own table; the VM binds each entry to a
+    // workspace slot before running
+    uint32_t sym(const std::string& name) {
+        auto it = symbol_ids_.find(name);
+        if (it != symbol_ids_.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(out_.symbols.size());
+        out_.symbols.push_back(name);
+        symbol_ids_.emplace(name, id);
+        return id;
+    }
+
+    uint32_t number(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof bits);
+        auto it = number_ids_.find(bits);
+        if (it != number_ids_.end()) return it->second | kConstBit;
+        uint32_t id = static_cast<uint32_t>(out_.constants.size());
+        out_.constants.emplace_back(v);
+        number_ids_.emplace(bits, id);
+        return id | kConstBit;
+    }
+
+    uint32_t begin_statement(uint32_t line) {
+        out_.statements.push_back({here(), here(), here(), line});
+        return static_cast<uint32_t>(out_.statements.size() - 1);
+    }
+
+    void end_statement(uint32_t idx) {
+        out_.statements[idx].end = here();
+        out_.statements[idx].resume = here();
+    }
+
+    // ----- statements -----
+
+    void compile_statement(const Stmt& st) {
+        uint32_t saved_top = reg_top_;
+        uint32_t line = static_cast<uint32_t>(st.line);
+
+        switch (st.kind) {
+            case StmtKind::Assign: {
+                uint32_t s = begin_statement(line);
+                uint32_t v = compile_expr(*st.expr);
+                uint32_t name = sym(st.text);
+                emit(OpCode::StoreVar, v, name);
+                if (!st.suppress) emit(OpCode::Display, 0, name, 0, static_cast<uint8_t>(DisplayMode::Named));
+                end_statement(s);
+                break;
+            }
+            case StmtKind::IndexAssign: {
+                uint32_t s = begin_statement(line);
+                uint32_t name = sym(st.text);
+                uint32_t value = alloc();
+                compile_into(*st.expr, value, nullptr);
+                uint32_t base = compile_subscripts(st.subscripts, name);
+                emit(OpCode::StoreIndex, value, base, name, static_cast<uint8_t>(st.subscripts.size()));
+                if (!st.suppress) emit(OpCode::Display, 0, name, 0, static_cast<uint8_t>(DisplayMode::Named));
+                end_statement(s);
+                break;
+            }
+            case StmtKind::Expr:
+                compile_expression_statement(st, line);
+                break;
+            case StmtKind::If:
+                compile_if(st);
+                break;
+            case StmtKind::For:
+                compile_for(st);
+                break;
+            case StmtKind::While:
+                compile_while(st);
+                break;
+            case StmtKind::Break:
+                if (!loops_.empty()) loops_.back().breaks.push_back(emit(OpCode::Jump));
+                break;
+            case StmtKind::Continue:
+                if (!loops_.empty()) emit(OpCode::Jump, loops_.back().continue_target);
+                break;
+            case StmtKind::Return:
+                emit(OpCode::Halt);
+                break;
+            case StmtKind::Command: {
+                uint32_t s = begin_statement(line);
+                emit(OpCode::Command, 0, str(st.suppress ? st.text + ";" : st.text));
+                end_statement(s);
+                break;
+            }
+            case StmtKind::Section:
+                emit(OpCode::Section, 0, str(st.text));
+                break;
+            case StmtKind::Fallback: {
+                uint32_t s = begin_statement(line);
+                emit(OpCode::EvalText, 0, str(st.text));
+                end_statement(s);
+                break;
+            }
+            case StmtKind::Error: {
+                uint32_t s = begin_statement(line);
+                emit(OpCode::Raise, 0, str(st.text));
+                end_statement(s);
+                break;
+            }
+        }
+
+        reg_top_ = saved_top;
+    }
+
+    static bool is_statement_function(const Node& n) {
+        return n.kind == NodeKind::Call &&
+               (n.name == "disp" || n.name == "fprintf" || n.name == "printf");
+    }
+
+    void compile_expression_statement(const Stmt& st, uint32_t line) {
+        uint32_t s = begin_statement(line);
+        const Node& e = *st.expr;
+
+        if (is_statement_function(e)) {
+            // disp(x) etc. produce output, not a value
+            compile_expr(e);
+        } else if (e.kind == NodeKind::Identifier) {
+            // Bare variable name: show it under its own name
+            uint8_t mode = static_cast<uint8_t>(st.suppress ? DisplayMode::None : DisplayMode::Named);
+            emit(OpCode::Display, 0, sym(e.name), 0, mode);
+        } else {
+            uint32_t v = compile_expr(e);
+            uint32_t ans = sym("ans");
+            emit(OpCode::StoreVar, v, ans);
+            if (!st.suppress) emit(OpCode::Display, 0, ans, 0, static_cast<uint8_t>(DisplayMode::Ans));
+        }
+        end_statement(s);
+    }
+
+    // Emits condition + JumpIfFalse; returns the jump to patch. A condition
+    // that throws counts as false (resume at the false target).
+    uint32_t compile_condition(const Node& cond, uint32_t line, uint32_t& stmt_idx) {
+        uint32_t saved_top = reg_top_;
+        stmt_idx = begin_statement(line);
+        uint32_t c = compile_expr(cond);
+        uint32_t jump = emit(OpCode::JumpIfFalse, c, 0);
+        out_.statements[stmt_idx].end = here();
+        reg_top_ = saved_top;
+        return jump;
+    }
+
+    void patch_false_target(uint32_t jump, uint32_t stmt_idx, uint32_t target) {
+        out_.code[jump].b = target;
+        out_.statements[stmt_idx].resume = target;
+    }
+
+    void compile_if(const Stmt& st) {
+        std::vector<uint32_t> exits;
+        for (size_t i = 0; i < st.branches.size(); i++) {
+            const auto& branch = st.branches[i];
+            if (branch.first) {
+                uint32_t stmt_idx;
+                uint32_t jump = compile_condition(*branch.first, static_cast<uint32_t>(st.line), stmt_idx);
+                compile_block(branch.second);
+                if (i + 1 < st.branches.size()) exits.push_back(emit(OpCode::Jump));
+                patch_false_target(jump, stmt_idx, here());
+            } else {
+                compile_block(branch.second);
+            }
+        }
+        for (uint32_t j : exits) out_.code[j].a = here();
+    }
+
+    void compile_while(const Stmt& st) {
+        uint32_t top = here();
+        uint32_t stmt_idx;
+        uint32_t jump = compile_condition(*st.expr, static_cast<uint32_t>(st.line), stmt_idx);
+
+        loops_.push_back({top, {}});
+        compile_block(st.body);
+        emit(OpCode::Jump, top);
+        patch_false_target(jump, stmt_idx, here());
+        for (uint32_t j : loops_.back().breaks) out_.code[j].a = here();
+        loops_.pop_back();
+    }
+
+    void compile_for(const Stmt& st) {
+        uint32_t line = static_cast<uint32_t>(st.line);
+        uint32_t var = sym(st.text);
+        uint32_t stmt_idx = begin_statement(line);
+        uint32_t top, next;
+
+        if (st.expr->kind == NodeKind::Range) {
+            // Counted loop: the range is never materialized
+            const auto& parts = st.expr->args;
+            uint32_t base = alloc(5);
+            compile_into(*parts[0], base, nullptr);
+            if (parts.size() == 3) {
+                compile_into(*parts[1], base + 1, nullptr);
+                compile_into(*parts[2], base + 2, nullptr);
+            } else {
+                emit(OpCode::LoadConst, base + 1, number(1.0) & kOperandMask);
+                compile_into(*parts[1], base + 2, nullptr);
+            }
+            emit(OpCode::ForRangePrep, base);
+            top = here();
+            next = emit(OpCode::ForRangeNext, base, var);
+        } else {
+            uint32_t base = alloc(2);
+            compile_into(*st.expr, base, nullptr);
+            emit(OpCode::ForEachPrep, base);
+            top = here();
+            next = emit(OpCode::ForEachNext, base, var);
+        }
+        out_.statements[stmt_idx].end = here();
+
+        loops_.push_back({top, {}});
+        compile_block(st.body);
+        emit(OpCode::Jump, top);
+        uint32_t exit = here();
+        out_.code[next].c = exit;
+        out_.statements[stmt_idx].resume = exit;
+        for (uint32_t j : loops_.back().breaks) out_.code[j].a = exit;
+        loops_.pop_back();
+        // Loop registers (base..) are released by compile_statement
+    }
+
+    // ----- expressions -----
+
+    void compile_into(const Node& n, uint32_t reg, const SubscriptContext* ctx) {
+        uint32_t v = compile_expr(n, ctx);
+        if (v == reg) return;
+        if (v & kConstBit) emit(OpCode::LoadConst, reg, v & kOperandMask);
+        else if (v & kSlotBit) emit(OpCode::LoadVar, reg, v & kOperandMask);
+        else emit(OpCode::Move, reg, v);
+    }
+
+    uint32_t compile_subscripts(const std::vector<NodePtr>& subs, uint32_t name) {
+        uint32_t count = static_cast<uint32_t>(subs.size());
+        uint32_t base = alloc(count);
+        for (uint32_t i = 0; i < count; i++) {
+            SubscriptContext ctx{name, i, count};
+            compile_into(*subs[i], base + i, &ctx);
+        }
+        return base;
+    }
+
+    // ----- elementwise fusion -----
+
+    static bool uses_subscript_context(const Node& n) {
+        if (n.kind == NodeKind::MagicEnd || n.kind == NodeKind::MagicColon) return true;
+        for (const auto& a : n.args) {
+            if (uses_subscript_context(*a)) return true;
+        }
+        return false;
+    }
+
+    static bool fusable(const Node& n) {
+        switch (n.kind) {
+            case NodeKind::Binary:
+                return n.op != OpCode::LeftDiv;   // always a linear solve for arrays
+            case NodeKind::Unary:
+                return n.op == OpCode::Neg || n.op == OpCode::Not;
+            case NodeKind::Call:
+                // Resolved at run time: a variable with the same name wins
+                return n.args.size() == 1 && kernels::unary_function(n.name) &&
+                       !uses_subscript_context(*n.args[0]);
+            default:
+                return false;
+        }
+    }
+
+    static size_t fusable_ops(const Node& n) {
+        if (!fusable(n)) return 0;
+        size_t count = 1;
+        for (const auto& a : n.args) count += fusable_ops(*a);
+        return count;
+    }
+
+    static constexpr uint32_t kTempBit = 0x80000000u;
+
+    // Post-order: fusable nodes become kernel ops (kTempBit | op index),
+    // anything else is compiled normally and becomes a kernel input
+    uint32_t build_fused(const Node& n, const SubscriptContext* ctx,
+                         std::unordered_map<const Node*, uint32_t>& leaves,
+                         std::vector<uint32_t>& inputs, std::vector<FusedOp>& ops) {
+        if (!fusable(n)) {
+            uint32_t operand = compile_expr(n, ctx);
+            leaves.emplace(&n, operand);
+            auto it = std::find(inputs.begin(), inputs.end(), operand);
+            if (it != inputs.end()) return static_cast<uint32_t>(it - inputs.begin());
+            inputs.push_back(operand);
+            return static_cast<uint32_t>(inputs.size() - 1);
+        }
+
+        FusedOp op{n.op, 0, 0, 0, 0};
+        op.x = build_fused(*n.args[0], ctx, leaves, inputs, ops);
+        if (n.kind == NodeKind::Binary) {
+            op.y = build_fused(*n.args[1], ctx, leaves, inputs, ops);
+        } else if (n.kind == NodeKind::Call) {
+            op.op = OpCode::CallOrIndex;
+            op.fn = static_cast<uint8_t>(*kernels::unary_function(n.name));
+            op.y = sym(n.name);
+        }
+        ops.push_back(op);
+        return kTempBit | static_cast<uint32_t>(ops.size() - 1);
+    }
+
+    uint32_t compile_fused(const Node& root, const SubscriptContext* ctx) {
+        std::unordered_map<const Node*, uint32_t> leaves;
+        std::vector<uint32_t> inputs;
+        std::vector<FusedOp> ops;
+        build_fused(root, ctx, leaves, inputs, ops);
+
+        uint32_t n_inputs = static_cast<uint32_t>(inputs.size());
+        auto value = [n_inputs](uint32_t v) { return v & kTempBit ? n_inputs + (v & ~kTempBit) : v; };
+        for (auto& op : ops) {
+            op.x = value(op.x);
+            bool binary = op.op != OpCode::Neg && op.op != OpCode::Not && op.op != OpCode::CallOrIndex;
+            if (binary) op.y = value(op.y);
+        }
+
+        FusedKernel kernel{static_cast<uint32_t>(out_.fused_inputs.size()), n_inputs,
+                           static_cast<uint32_t>(out_.fused_ops.size()), static_cast<uint32_t>(ops.size())};
+        out_.fused_inputs.insert(out_.fused_inputs.end(), inputs.begin(), inputs.end());
+        out_.fused_ops.insert(out_.fused_ops.end(), ops.begin(), ops.end());
+        uint32_t id = static_cast<uint32_t>(out_.fused.size());
+        out_.fused.push_back(kernel);
+
+        uint32_t r = alloc();
+        uint32_t fused = emit(OpCode::Fused, r, id);
+        fused_leaves_ = &leaves;
+        unfused_depth_++;
+        compile_into(root, r, ctx);
+        unfused_depth_--;
+        fused_leaves_ = nullptr;
+        out_.code[fused].c = here();
+        return r;
+    }
+
+    uint32_t compile_expr(const Node& n, const SubscriptContext* ctx = nullptr) {
+        if (fused_leaves_) {
+            auto it = fused_leaves_->find(&n);
+            if (it != fused_leaves_->end()) return it->second;
+        }
+        if (unfused_depth_ == 0 && fusable_ops(n) >= 2) return compile_fused(n, ctx);
+
+        switch (n.kind) {
+            case NodeKind::Number:
+                return number(n.number);
+
+            case NodeKind::Identifier:
+                // Operands read the workspace slot in place
+                return sym(n.name) | kSlotBit;
+
+            case NodeKind::MagicEnd: {
+                uint32_t r = alloc();
+                emit(OpCode::EndOf, r, ctx->name, (ctx->dim << 8) | ctx->count);
+                return r;
+            }
+
+            case NodeKind::MagicColon: {
+                // x(:) -> x(1:end)
+                uint32_t base = alloc(2);
+                emit(OpCode::LoadConst, base, number(1.0) & kOperandMask);
+                emit(OpCode::EndOf, base + 1, ctx->name, (ctx->dim << 8) | ctx->count);
+                uint32_t r = alloc();
+                emit(OpCode::Range, r, base, 0, 2);
+                return r;
+            }
+
+            case NodeKind::Unary: {
+                uint32_t x = compile_expr(*n.args[0], ctx);
+                uint32_t r = alloc();
+                emit(n.op, r, x);
+                return r;
+            }
+
+            case NodeKind::Binary: {
+                uint32_t l = compile_expr(*n.args[0], ctx);
+                uint32_t rr = compile_expr(*n.args[1], ctx);
+                uint32_t r = alloc();
+                emit(n.op, r, l, rr);
+                return r;
+            }
+
+            case NodeKind::AndAnd:
+            case NodeKind::OrOr: {
+                // Short-circuit: result is logical 0/1
+                bool is_and = n.kind == NodeKind::AndAnd;
+                OpCode test = is_and ? OpCode::JumpIfFalse : OpCode::JumpIfTrue;
+                uint32_t r = alloc();
+                uint32_t l = compile_expr(*n.args[0], ctx);
+                uint32_t j1 = emit(test, l, 0);
+                uint32_t rr = compile_expr(*n.args[1], ctx);
+                uint32_t j2 = emit(test, rr, 0);
+                emit(OpCode::LoadConst, r, number(is_and ? 1.0 : 0.0) & kOperandMask);
+                uint32_t jend = emit(OpCode::Jump);
+                out_.code[j1].b = here();
+                out_.code[j2].b = here();
+                emit(OpCode::LoadConst, r, number(is_and ? 0.0 : 1.0) & kOperandMask);
+                out_.code[jend].a = here();
+                return r;
+            }
+
+            case NodeKind::Range: {
+                uint32_t count = static_cast<uint32_t>(n.args.size());
+                uint32_t base = alloc(count);
+                for (uint32_t i = 0; i < count; i++) compile_into(*n.args[i], base + i, ctx);
+                uint32_t r = alloc();
+                emit(OpCode::Range, r, base, 0, static_cast<uint8_t>(count));
+                return r;
+            }
+
+            case NodeKind::Call: {
+                uint32_t name = sym(n.name);
+                uint32_t base = compile_subscripts(n.args, name);
+                uint32_t r = alloc();
+                uint32_t call = emit(OpCode::CallOrIndex, r, base, name, static_cast<uint8_t>(n.args.size()));
+                // x(:) is always a column, unlike x(1:end)
+                if (n.args.size() == 1 && n.args[0]->kind == NodeKind::MagicColon) {
+                    out_.code[call].flags = kColonIndex;
+                }
+                return r;
+            }
+
+            case NodeKind::Matrix: {
+                if (n.rows.empty()) {
+                    uint32_t r = alloc();
+                    emit(OpCode::HorzCat, r, r, 0);
+                    return r;
+                }
+                uint32_t row_base = alloc(static_cast<uint32_t>(n.rows.size()));
+                for (size_t i = 0; i < n.rows.size(); i++) {
+                    const auto& row = n.rows[i];
+                    uint32_t saved = reg_top_;
+                    uint32_t base = alloc(static_cast<uint32_t>(row.size()));
+                    for (size_t j = 0; j < row.size(); j++) compile_into(*row[j], base + static_cast<uint32_t>(j), ctx);
+                    emit(OpCode::HorzCat, row_base + static_cast<uint32_t>(i), base, static_cast<uint32_t>(row.size()));
+                    reg_top_ = saved;
+                }
+                if (n.rows.size() == 1) return row_base;
+                uint32_t r = alloc();
+                emit(OpCode::VertCat, r, row_base, static_cast<uint32_t>(n.rows.size()));
+                return r;
+            }
+        }
+        throw std::logic_error("compile_expr: unknown node");
+    }
+};
+
+std::vector<std::string> split_lines(const std::string& source) {
+    std::vector<std::string> lines;
+    std::istringstream stream(source);
+    std::string line;
+    while (std::getline(stream, line)) lines.push_back(line);
+    return lines;
+}
+
+} // namespace
+
+// ========== PUBLIC API ==========
+
+CompiledScript compile(const std::string& source) {
+    CompiledScript script;
+    auto lines = split_lines(source);
+    script.source_lines = lines.size();
+
+    Lexer lexer(source);
+    Parser parser(lexer.tokenize(), std::move(lines));
+    auto program = parser.parse_script();
+
+    CodeGen gen(script);
+    gen.compile_block(program);
+    gen.finish();
+    return script;
+}
+
+CompiledScript compile_expression(const std::string& source) {
+    CompiledScript script;
+    script.source_lines = 1;
+
+    Lexer lexer(source);
+    Parser parser(lexer.tokenize(), {source});
+    NodePtr expr = parser.parse_single_expression();
+
+    CodeGen gen(script);
+    gen.compile_result(*expr);
+    gen.finish();
+    return script;
+}
+
+static const char* opcode_name(OpCode op) {
+    switch (op) {
+        case OpCode::Nop: return "nop";
+        case OpCode::LoadConst: return "loadk";
+        case OpCode::LoadVar: return "loadvar";
+        case OpCode::StoreVar: return "storevar";
+        case OpCode::Move: return "move";
+        case OpCode::Neg: return "neg";
+        case OpCode::Not: return "not";
+        case OpCode::Transpose: return "transpose";
+        case OpCode::Add: return "add";
+        case OpCode::Sub: return "sub";
+        case OpCode::Mul: return "mul";
+        case OpCode::Div: return "div";
+        case OpCode::LeftDiv: return "ldiv";
+        case OpCode::Pow: return "pow";
+        case OpCode::ElemMul: return "emul";
+        case OpCode::ElemDiv: return "ediv";
+        case OpCode::ElemPow: return "epow";
+        case OpCode::Eq: return "eq";
+        case OpCode::Ne: return "ne";
+        case OpCode::Lt: return "lt";
+        case OpCode::Le: return "le";
+        case OpCode::Gt: return "gt";
+        case OpCode::Ge: return "ge";
+        case OpCode::And: return "and";
+        case OpCode::Or: return "or";
+        case OpCode::Range: return "range";
+        case OpCode::HorzCat: return "horzcat";
+        case OpCode::VertCat: return "vertcat";
+        case OpCode::CallOrIndex: return "call";
+        case OpCode::StoreIndex: return "storeidx";
+        case OpCode::Fused: return "fused";
+        case OpCode::EndOf: return "endof";
+        case OpCode::Jump: return "jmp";
+        case OpCode::JumpIfFalse: return "jf";
+        case OpCode::JumpIfTrue: return "jt";
+        case OpCode::ForRangePrep: return "forprep";
+        case OpCode::ForRangeNext: return "fornext";
+        case OpCode::ForEachPrep: return "foreachprep";
+        case OpCode::ForEachNext: return "foreachnext";
+        case OpCode::Display: return "display";
+        case OpCode::Command: return "command";
+        case OpCode::EvalText: return "evaltext";
+        case OpCode::Section: return "section";
+        case OpCode::Raise: return "raise";
+        case OpCode::Halt: return "halt";
+    }
+    return "?";
+}
+
+std::string disassemble(const CompiledScript& script) {
+    std::ostringstream ss;
+    for (size_t pc = 0; pc < script.code.size(); pc++) {
+        const auto& in = script.code[pc];
+        ss << pc << "\t" << opcode_name(in.op) << "\t" << in.a << " " << in.b << " " << in.c;
+        if (in.n) ss << " n=" << static_cast<int>(in.n);
+        ss << "\n";
+    }
+    return ss.str();
+}
+
+} // namespace interpreter
+} // namespace matlabcpp
@@ -0,0 +1,643 @@
+// MatLabC++ Fast Fourier Transform
+// src/core/fft.cpp
+//
+// Power of two: iterative radix-4 DIT over bit-reversed input. With the four quarter
+// blocks of a 4q-point stage at offsets 0, q, 2q, 3q holding the sub-DFTs
+// of the samples = 0, 2, 1, 3 (mod 4), one butterfly is
+//
+//   t1 = w^j x[j+2q]   t2 = w^2j x[j+q]   t3 = w^3j x[j+3q]
+//   X[j]    = (x[j] + t2) + (t1 + t3)     X[j+2q] = (x[j] + t2) - (t1 + t3)
+//   X[j+q]  = (x[j] - t2) -+ i(t1 - t3)   X[j+3q] = (x[j] - t2) +- i(t1 - t3)
+//
+// (upper signs forward), so each pass over the data does two radix-2
+// stages' worth of work with three complex multiplies per four points.
+//
+// Other smooth lengths: Stockham passes. A pass of radix r takes the
+// length-L DFTs of the r interleaved subsequences of each group and
+// combines them into length-L*r DFTs, reading and writing with unit stride
+// over the m = n / (L*r) groups, so the output ends up in natural order
+// without a permutation.
+//
+// Real input of even length n: z_k = x_2k + i x_2k+1 has Z = FFT_n/2(z),
+// and with h = n/2 the even/odd sub-spectra come back out as
+//   E_k = (Z_k + conj Z_h-k) / 2,  O_k = (Z_k - conj Z_h-k) / 2i,
+//   X_k = E_k + W_n^k O_k.
+
+#include "matlabcpp/fft.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MATLABCPP_AVX2_FFT 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+
+namespace matlabcpp {
+namespace fft {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Plain complex arithmetic: std::complex's operator* takes a slow path
+// to get inf/NaN corner cases right, which butterflies don't need
+inline Complex mul(Complex a, Complex b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+inline Complex mul_conj(Complex a, Complex b) {     // a * conj(b)
+    return {a.real() * b.real() + a.imag() * b.imag(), a.imag() * b.real() - a.real() * b.imag()};
+}
+inline Complex times_i(Complex a) { return {-a.imag(), a.real()}; }
+
+// Everything that depends only on the length
+struct Pow2Tables {
+    size_t n = 0;
+    bool radix2_first = false;          // log2(n) odd
+    std::vector<uint32_t> reverse;      // bit-reversed index
+    // Per radix-4 stage (q = 1 or 2, then x4): W^j, W^2j, W^3j for j < q,
+    // as three runs of q entries, W = exp(-2*pi*i / 4q)
+    std::vector<Complex> twiddles;
+};
+
+Pow2Tables* build_tables(unsigned log2n) {
+    auto* t = new Pow2Tables;
+    size_t n = size_t(1) << log2n;
+    t->n = n;
+    t->radix2_first = (log2n & 1) != 0;
+
+    t->reverse.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t r = 0;
+        for (unsigned b = 0; b < log2n; ++b) r |= ((i >> b) & 1) << (log2n - 1 - b);
+        t->reverse[i] = static_cast<uint32_t>(r);
+    }
+
+    for (size_t q = t->radix2_first ? 2 : 1; 4 * q <= n; q *= 4) {
+        for (int power = 1; power <= 3; ++power) {
+            for (size_t j = 0; j < q; ++j) {
+                double angle = -2.0 * kPi * static_cast<double>(power * j) / static_cast<double>(4 * q);
+                t->twiddles.push_back({std::cos(angle), std::sin(angle)});
+            }
+        }
+    }
+    return t;
+}
+
+// Built on first use, never freed, so references stay valid and readers
+// need no lock
+const Pow2Tables& tables(unsigned log2n) {
+    static std::atomic<const Pow2Tables*> cache[64] = {};
+    static std::mutex build_mutex;
+    const Pow2Tables* t = cache[log2n].load(std::memory_order_acquire);
+    if (!t) {
+        std::lock_guard<std::mutex> lock(build_mutex);
+        t = cache[log2n].load(std::memory_order_relaxed);
+        if (!t) {
+            t = build_tables(log2n);
+            cache[log2n].store(t, std::memory_order_release);
+        }
+    }
+    return *t;
+}
+
+// ========== SCALAR ==========
+
+template <bool Inverse>
+void radix4_stage(Complex* x, size_t n, size_t q, const Complex* w) {
+    const Complex* w1 = w;
+    const Complex* w2 = w + q;
+    const Complex* w3 = w + 2 * q;
+    for (size_t base = 0; base < n; base += 4 * q) {
+        Complex* a = x + base;
+        for (size_t j = 0; j < q; ++j) {
+            Complex t1 = Inverse ? mul_conj(a[j + 2 * q], w1[j]) : mul(a[j + 2 * q], w1[j]);
+            Complex t2 = Inverse ? mul_conj(a[j + q], w2[j]) : mul(a[j + q], w2[j]);
+            Complex t3 = Inverse ? mul_conj(a[j + 3 * q], w3[j]) : mul(a[j + 3 * q], w3[j]);
+            Complex s0 = a[j] + t2, s1 = a[j] - t2;
+            Complex s2 = t1 + t3, s3 = times_i(t1 - t3);
+            a[j] = s0 + s2;
+            a[j + 2 * q] = s0 - s2;
+            a[j + q] = Inverse ? s1 + s3 : s1 - s3;
+            a[j + 3 * q] = Inverse ? s1 - s3 : s1 + s3;
+        }
+    }
+}
+
+// ========== AVX2 ==========
+
+#ifdef MATLABCPP_AVX2_FFT
+
+// Two interleaved complex numbers per register
+AVX2_TARGET inline __m256d cmul(__m256d a, __m256d w) {
+    __m256d wr = _mm256_movedup_pd(w);              // re re
+    __m256d wi = _mm256_permute_pd(w, 0xf);         // im im
+    __m256d swapped = _mm256_permute_pd(a, 0x5);    // im re
+    return _mm256_fmaddsub_pd(a, wr, _mm256_mul_pd(swapped, wi));
+}
+
+AVX2_TARGET inline __m256d cmul_conj(__m256d a, __m256d w) {
+    __m256d wr = _mm256_movedup_pd(w);
+    __m256d wi = _mm256_permute_pd(w, 0xf);
+    __m256d swapped = _mm256_permute_pd(a, 0x5);
+    return _mm256_fmsubadd_pd(a, wr, _mm256_mul_pd(swapped, wi));
+}
+
+AVX2_TARGET inline __m256d load(const Complex* p) {
+    return _mm256_loadu_pd(reinterpret_cast<const double*>(p));
+}
+
+AVX2_TARGET inline void store(Complex* p, __m256d v) {
+    _mm256_storeu_pd(reinterpret_cast<double*>(p), v);
+}
+
+AVX2_TARGET inline __m256d ctimes_i(__m256d a) {   // (re, im) -> (-im, re)
+    const __m256d flip = _mm256_setr_pd(-0.0, 0.0, -0.0, 0.0);
+    return _mm256_xor_pd(_mm256_permute_pd(a, 0x5), flip);
+}
+
+template <bool Inverse>
+AVX2_TARGET void radix4_stage_avx2(Complex* x, size_t n, size_t q, const Complex* w) {
+    const Complex* w1 = w;
+    const Complex* w2 = w + q;
+    const Complex* w3 = w + 2 * q;
+    for (size_t base = 0; base < n; base += 4 * q) {
+        Complex* a = x + base;
+        for (size_t j = 0; j < q; j += 2) {
+            __m256d a0 = load(a + j), a1 = load(a + j + q);
+            __m256d a2 = load(a + j + 2 * q), a3 = load(a + j + 3 * q);
+            __m256d t1 = Inverse ? cmul_conj(a2, load(w1 + j)) : cmul(a2, load(w1 + j));
+            __m256d t2 = Inverse ? cmul_conj(a1, load(w2 + j)) : cmul(a1, load(w2 + j));
+            __m256d t3 = Inverse ? cmul_conj(a3, load(w3 + j)) : cmul(a3, load(w3 + j));
+            __m256d s0 = _mm256_add_pd(a0, t2), s1 = _mm256_sub_pd(a0, t2);
+            __m256d s2 = _mm256_add_pd(t1, t3), s3 = ctimes_i(_mm256_sub_pd(t1, t3));
+            store(a + j, _mm256_add_pd(s0, s2));
+            store(a + j + 2 * q, _mm256_sub_pd(s0, s2));
+            store(a + j + q, Inverse ? _mm256_add_pd(s1, s3) : _mm256_sub_pd(s1, s3));
+            store(a + j + 3 * q, Inverse ? _mm256_sub_pd(s1, s3) : _mm256_add_pd(s1, s3));
+        }
+    }
+}
+
+#endif // MATLABCPP_AVX2_FFT
+
+bool use_avx2() {
+#ifdef MATLABCPP_AVX2_FFT
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+template <bool Inverse>
+void run_stages(Complex* x, const Pow2Tables& t) {
+    const size_t n = t.n;
+    size_t q = 1;
+    if (t.radix2_first) {
+        for (size_t i = 0; i < n; i += 2) {
+            Complex a = x[i], b = x[i + 1];
+            x[i] = a + b;
+            x[i + 1] = a - b;
+        }
+        q = 2;
+    }
+    const Complex* w = t.twiddles.data();
+    for (; 4 * q <= n; w += 3 * q, q *= 4) {
+#ifdef MATLABCPP_AVX2_FFT
+        if (q >= 2 && use_avx2()) {
+            radix4_stage_avx2<Inverse>(x, n, q, w);
+            continue;
+        }
+#endif
+        radix4_stage<Inverse>(x, n, q, w);
+    }
+}
+
+// ========== MIXED RADIX ==========
+
+constexpr size_t kMaxRadix = 13;
+
+// Butterfly constants for one direction: sign is -1 forward, +1 inverse
+struct Roots {
+    double sign;
+    double s3;                  // sign * sin(2*pi/3)
+    double c5a, c5b, s5a, s5b;  // cos/sin(2*pi/5), cos/sin(4*pi/5), sines signed
+    explicit Roots(double sign_)
+        : sign(sign_), s3(sign_ * std::sqrt(0.75)),
+          c5a(std::cos(2 * kPi / 5)), c5b(std::cos(4 * kPi / 5)),
+          s5a(sign_ * std::sin(2 * kPi / 5)), s5b(sign_ * std::sin(4 * kPi / 5)) {}
+};
+
+inline void butterfly2(Complex* a) {
+    Complex t = a[1];
+    a[1] = a[0] - t;
+    a[0] += t;
+}
+
+inline void butterfly3(Complex* a, const Roots& w) {
+    Complex t1 = a[1] + a[2];
+    Complex t2 = a[0] - 0.5 * t1;
+    Complex t3 = w.s3 * times_i(a[1] - a[2]);
+    a[0] += t1;
+    a[1] = t2 + t3;
+    a[2] = t2 - t3;
+}
+
+inline void butterfly4(Complex* a, const Roots& w) {
+    Complex s0 = a[0] + a[2], s1 = a[0] - a[2];
+    Complex s2 = a[1] + a[3], s3 = w.sign * times_i(a[1] - a[3]);
+    a[0] = s0 + s2;
+    a[2] = s0 - s2;
+    a[1] = s1 + s3;
+    a[3] = s1 - s3;
+}
+
+inline void butterfly5(Complex* a, const Roots& w) {
+    Complex t1 = a[1] + a[4], t2 = a[2] + a[3];
+    Complex t3 = a[1] - a[4], t4 = a[2] - a[3];
+    Complex b1 = a[0] + w.c5a * t1 + w.c5b * t2;
+    Complex b2 = a[0] + w.c5b * t1 + w.c5a * t2;
+    Complex d1 = times_i(w.s5a * t3 + w.s5b * t4);
+    Complex d2 = times_i(w.s5b * t3 - w.s5a * t4);
+    a[0] += t1 + t2;
+    a[1] = b1 + d1;
+    a[4] = b1 - d1;
+    a[2] = b2 + d2;
+    a[3] = b2 - d2;
+}
+
+// DFT for the remaining odd primes (7, 11, 13), pairing t with r - t:
+// X_v, X_(r-v) = a_0 + sum cos(tv) (a_t + a_(r-t)) +- i sum sin(tv) (a_t - a_(r-t))
+template <size_t R>
+inline void butterfly_odd(Complex* a, const Complex* roots) {
+    constexpr size_t r = R, h = R / 2;
+    Complex p[h], q[h];
+    Complex sum = a[0];
+    for (size_t t = 1; t <= h; ++t) {
+        p[t - 1] = a[t] + a[r - t];
+        q[t - 1] = a[t] - a[r - t];
+        sum += p[t - 1];
+    }
+    Complex out[R];
+    out[0] = sum;
+    for (size_t v = 1; v <= h; ++v) {
+        Complex re = a[0], im = 0.0;
+        size_t tv = v;
+        for (size_t t = 1; t <= h; ++t) {
+            re += roots[tv].real() * p[t - 1];
+            im += roots[tv].imag() * q[t - 1];
+            tv += v;
+            if (tv >= r) tv -= r;
+        }
+        out[v] = re + times_i(im);
+        out[r - v] = re - times_i(im);
+    }
+    std::copy(out, out + r, a);
+}
+
+// One Stockham pass, x -> y. Input DFT f of group k + m*t sits at
+// x[k + m*(t + r*f)]; output DFT f + L*v of group k goes to y[k + m*(f + L*v)].
+template <size_t R>
+void stockham_pass(const Complex* x, Complex* y, size_t n, size_t L,
+                   const Complex* tw, const Complex* roots, const Roots& w) {
+    constexpr size_t r = R;
+    const size_t m = n / (L * r);
+    Complex a[R];
+    for (size_t f = 0; f < L; ++f) {
+        const Complex* wf = tw + f * (r - 1);
+        for (size_t k = 0; k < m; ++k) {
+            const Complex* in = x + k + m * r * f;
+            a[0] = in[0];
+            for (size_t t = 1; t < r; ++t) a[t] = mul(in[m * t], wf[t - 1]);
+            switch (R) {
+                case 2: butterfly2(a); break;
+                case 3: butterfly3(a, w); break;
+                case 4: butterfly4(a, w); break;
+                case 5: butterfly5(a, w); break;
+                default: butterfly_odd<R>(a, roots); break;
+            }
+            Complex* out = y + k + m * f;
+            for (size_t v = 0; v < r; ++v) out[m * L * v] = a[v];
+        }
+    }
+}
+
+// Lines per tile when gathering strided lines, and points per pool task
+constexpr size_t kBatchTile = 16;
+constexpr size_t kBatchPoints = size_t(1) << 15;
+
+// Per-thread work buffers: 0 Stockham passes, 1 Bluestein, 2 real input,
+// 3 batch tiles
+std::vector<Complex>& scratch(size_t n, int which) {
+    thread_local std::vector<Complex> buffers[4];
+    std::vector<Complex>& b = buffers[which];
+    if (b.size() < n) b.resize(n);
+    return b;
+}
+
+} // namespace
+
+bool is_power_of_two(size_t n) {
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+size_t next_power_of_two(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+void transform_pow2(Complex* x, size_t n, bool inverse) {
+    if (!is_power_of_two(n)) {
+        throw std::invalid_argument("fft: length must be a power of two");
+    }
+    if (n == 1) return;
+    unsigned log2n = 0;
+    while ((size_t(1) << log2n) < n) ++log2n;
+    const Pow2Tables& t = tables(log2n);
+
+    const uint32_t* rev = t.reverse.data();
+    for (size_t i = 0; i < n; ++i) {
+        if (i < rev[i]) std::swap(x[i], x[rev[i]]);
+    }
+    if (inverse) run_stages<true>(x, t);
+    else run_stages<false>(x, t);
+}
+
+// ========== PLANS ==========
+
+Plan::Plan(size_t n, Direction direction) : n_(n), direction_(direction) {
+    const double sign = direction == Direction::Forward ? -1.0 : 1.0;
+    if (n <= 1 || is_power_of_two(n)) {
+        algorithm_ = Algorithm::Radix4;
+        return;
+    }
+
+    // Radix 4 first, then 2, 3, 5, ... while the factors stay small
+    std::vector<size_t> radices;
+    size_t rest = n;
+    while (rest % 4 == 0) { radices.push_back(4); rest /= 4; }
+    for (size_t p = 2; p <= kMaxRadix && rest > 1; ++p) {
+        while (rest % p == 0) { radices.push_back(p); rest /= p; }
+    }
+
+    if (rest == 1) {
+        algorithm_ = Algorithm::MixedRadix;
+        size_t L = 1;
+        for (size_t r : radices) {
+            Stage stage{r, L, twiddles_.size(), 0};
+            for (size_t f = 0; f < L; ++f) {
+                for (size_t t = 1; t < r; ++t) {
+                    double angle = sign * 2.0 * kPi * static_cast<double>(t * f) / static_cast<double>(L * r);
+                    twiddles_.push_back({std::cos(angle), std::sin(angle)});
+                }
+            }
+            if (r > 5) {
+                stage.root_offset = twiddles_.size();
+                for (size_t k = 0; k < r; ++k) {
+                    double angle = sign * 2.0 * kPi * static_cast<double>(k) / static_cast<double>(r);
+                    twiddles_.push_back({std::cos(angle), std::sin(angle)});
+                }
+            }
+            stages_.push_back(stage);
+            L *= r;
+        }
+        return;
+    }
+
+    // Bluestein: with w_k = exp(sign*i*pi*k^2/n), X_f = w_f * sum_k (x_k w_k) conj(w_(f-k)),
+    // a circular convolution once padded to a power of two >= 2n - 1
+    algorithm_ = Algorithm::Bluestein;
+    conv_size_ = next_power_of_two(2 * n - 1);
+    chirp_.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        // k^2 mod 2n keeps the angle small and exact
+        size_t k2 = static_cast<size_t>((static_cast<unsigned long long>(k) * k) % (2 * n));
+        double angle = sign * kPi * static_cast<double>(k2) / static_cast<double>(n);
+        chirp_[k] = {std::cos(angle), std::sin(angle)};
+    }
+    chirp_spectrum_.assign(conv_size_, Complex{0.0, 0.0});
+    chirp_spectrum_[0] = std::conj(chirp_[0]);
+    for (size_t k = 1; k < n; ++k) {
+        chirp_spectrum_[k] = chirp_spectrum_[conv_size_ - k] = std::conj(chirp_[k]);
+    }
+    transform_pow2(chirp_spectrum_.data(), conv_size_);
+    // Fold in the 1/conv_size of the inverse transform
+    double scale = 1.0 / static_cast<double>(conv_size_);
+    for (Complex& c : chirp_spectrum_) c *= scale;
+}
+
+std::shared_ptr<const Plan> Plan::get(size_t n, Direction direction) {
+    static std::mutex mutex;
+    static std::map<std::pair<size_t, Direction>, std::shared_ptr<const Plan>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& plan = cache[{n, direction}];
+    if (!plan) plan = std::make_shared<const Plan>(n, direction);
+    return plan;
+}
+
+void Plan::execute(Complex* x) const {
+    switch (algorithm_) {
+        case Algorithm::Radix4:
+            if (n_ > 1) transform_pow2(x, n_, direction_ == Direction::Inverse);
+            break;
+        case Algorithm::MixedRadix:
+            execute_mixed(x);
+            break;
+        case Algorithm::Bluestein:
+            execute_bluestein(x);
+            break;
+    }
+}
+
+void Plan::execute_batch(Complex* x, size_t count, size_t stride, size_t dist) const {
+    const size_t n = n_;
+    if (n <= 1 || count == 0) return;
+
+    if (stride == 1) {
+        size_t chunk = std::max<size_t>(1, kBatchPoints / n);
+        parallel_for(count, chunk, [&](size_t lo, size_t hi) {
+            for (size_t b = lo; b < hi; ++b) execute(x + b * dist);
+        });
+        return;
+    }
+
+    const size_t tiles = (count + kBatchTile - 1) / kBatchTile;
+    const size_t chunk = std::max<size_t>(1, kBatchPoints / (n * kBatchTile));
+    parallel_for(tiles, chunk, [&](size_t lo, size_t hi) {
+        Complex* block = scratch(n * kBatchTile, 3).data();
+        for (size_t t = lo; t < hi; ++t) {
+            const size_t first = t * kBatchTile;
+            const size_t width = std::min(kBatchTile, count - first);
+            Complex* base = x + first * dist;
+            for (size_t j = 0; j < n; ++j) {
+                const Complex* src = base + j * stride;
+                for (size_t b = 0; b < width; ++b) block[b * n + j] = src[b * dist];
+            }
+            for (size_t b = 0; b < width; ++b) execute(block + b * n);
+            for (size_t j = 0; j < n; ++j) {
+                Complex* dst = base + j * stride;
+                for (size_t b = 0; b < width; ++b) dst[b * dist] = block[b * n + j];
+            }
+        }
+    });
+}
+
+void Plan::execute_mixed(Complex* x) const {
+    Roots w(direction_ == Direction::Forward ? -1.0 : 1.0);
+    Complex* tmp = scratch(n_, 0).data();
+    Complex* src = x;
+    Complex* dst = tmp;
+    for (const Stage& stage : stages_) {
+        const Complex* tw = twiddles_.data() + stage.twiddle_offset;
+        const Complex* roots = twiddles_.data() + stage.root_offset;
+        switch (stage.radix) {
+            case 2: stockham_pass<2>(src, dst, n_, stage.span, tw, roots, w); break;
+            case 3: stockham_pass<3>(src, dst, n_, stage.span, tw, roots, w); break;
+            case 4: stockham_pass<4>(src, dst, n_, stage.span, tw, roots, w); break;
+            case 5: stockham_pass<5>(src, dst, n_, stage.span, tw, roots, w); break;
+            case 7: stockham_pass<7>(src, dst, n_, stage.span, tw, roots, w); break;
+            case 11: stockham_pass<11>(src, dst, n_, stage.span, tw, roots, w); break;
+            case 13: stockham_pass<13>(src, dst, n_, stage.span, tw, roots, w); break;
+            default: throw std::logic_error("fft: unsupported radix");
+        }
+        std::swap(src, dst);
+    }
+    if (src != x) std::copy(src, src + n_, x);
+}
+
+void Plan::execute_bluestein(Complex* x) const {
+    std::vector<Complex>& buffer = scratch(conv_size_, 1);
+    Complex* a = buffer.data();
+    for (size_t k = 0; k < n_; ++k) a[k] = mul(x[k], chirp_[k]);
+    std::fill(a + n_, a + conv_size_, Complex{0.0, 0.0});
+    transform_pow2(a, conv_size_);
+    for (size_t k = 0; k < conv_size_; ++k) a[k] = mul(a[k], chirp_spectrum_[k]);
+    transform_pow2(a, conv_size_, true);
+    for (size_t k = 0; k < n_; ++k) x[k] = mul(a[k], chirp_[k]);
+}
+
+void transform(Complex* x, size_t n, bool inverse) {
+    if (is_power_of_two(n)) {
+        transform_pow2(x, n, inverse);      // no plan object needed
+        return;
+    }
+    if (n == 0) return;
+    Plan::get(n, inverse ? Direction::Inverse : Direction::Forward)->execute(x);
+}
+
+void transform_batch(Complex* x, size_t n, size_t count, size_t stride, size_t dist, bool inverse) {
+    if (n <= 1 || count == 0) return;
+    Plan::get(n, inverse ? Direction::Inverse : Direction::Forward)->execute_batch(x, count, stride, dist);
+}
+
+// ========== REAL INPUT ==========
+
+RealPlan::RealPlan(size_t n) : n_(n) {
+    if (n <= 1) return;
+    if (n % 2 != 0) {
+        forward_ = Plan::get(n, Direction::Forward);
+        inverse_ = Plan::get(n, Direction::Inverse);
+        return;
+    }
+    size_t h = n / 2;
+    forward_ = Plan::get(h, Direction::Forward);
+    inverse_ = Plan::get(h, Direction::Inverse);
+    twiddles_.resize(h);
+    for (size_t k = 0; k < h; ++k) {
+        double angle = -2.0 * kPi * static_cast<double>(k) / static_cast<double>(n);
+        twiddles_[k] = {std::cos(angle), std::sin(angle)};
+    }
+}
+
+std::shared_ptr<const RealPlan> RealPlan::get(size_t n) {
+    static std::mutex mutex;
+    static std::map<size_t, std::shared_ptr<const RealPlan>> cache;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& plan = cache[n];
+    if (!plan) plan = std::make_shared<const RealPlan>(n);
+    return plan;
+}
+
+void RealPlan::forward(const double* x, Complex* out) const {
+    if (n_ == 0) return;
+    if (n_ == 1) {
+        out[0] = x[0];
+        return;
+    }
+    if (n_ % 2 != 0) {
+        Complex* full = scratch(n_, 2).data();
+        for (size_t k = 0; k < n_; ++k) full[k] = x[k];
+        forward_->execute(full);
+        std::copy(full, full + spectrum_size(), out);
+        return;
+    }
+
+    const size_t h = n_ / 2;
+    for (size_t k = 0; k < h; ++k) out[k] = {x[2 * k], x[2 * k + 1]};
+    forward_->execute(out);
+
+    // Bins k and h - k come from the same pair of Z values
+    Complex z0 = out[0];
+    out[0] = z0.real() + z0.imag();
+    out[h] = z0.real() - z0.imag();
+    for (size_t k = 1, j = h - 1; k <= j; ++k, --j) {
+        Complex zk = out[k], zj = out[j];
+        Complex e = 0.5 * (zk + std::conj(zj));
+        Complex o = 0.5 * (zk - std::conj(zj));
+        o = {o.imag(), -o.real()};                      // / i
+        out[k] = e + mul(twiddles_[k], o);
+        out[j] = std::conj(e) + mul(twiddles_[j], std::conj(o));
+    }
+}
+
+void RealPlan::inverse(const Complex* in, double* x) const {
+    if (n_ == 0) return;
+    if (n_ == 1) {
+        x[0] = in[0].real();
+        return;
+    }
+    if (n_ % 2 != 0) {
+        // Rebuild the Hermitian spectrum
+        Complex* full = scratch(n_, 2).data();
+        size_t half = spectrum_size();
+        full[0] = in[0].real();
+        for (size_t k = 1; k < half; ++k) {
+            full[k] = in[k];
+            full[n_ - k] = std::conj(in[k]);
+        }
+        inverse_->execute(full);
+        for (size_t k = 0; k < n_; ++k) x[k] = full[k].real();
+        return;
+    }
+
+    // Undo the separation: E_k + i O_k, scaled by 2 so the half-length
+    // inverse comes out as n * x
+    const size_t h = n_ / 2;
+    Complex* z = scratch(h, 2).data();
+    double x0 = in[0].real(), xh = in[h].real();
+    z[0] = {x0 + xh, x0 - xh};
+    for (size_t k = 1; k < h; ++k) {
+        Complex a = in[k], b = std::conj(in[h - k]);
+        Complex e = a + b;
+        Complex o = mul_conj(a - b, twiddles_[k]);      // / W_n^k
+        z[k] = e + times_i(o);
+    }
+    inverse_->execute(z);
+    for (size_t k = 0; k < h; ++k) {
+        x[2 * k] = z[k].real();
+        x[2 * k + 1] = z[k].imag();
+    }
+}
+
+} // namespace fft
+} // namespace matlabcpp
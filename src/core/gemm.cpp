@@ -0,0 +1,351 @@
+// MatLabC++ Matrix Multiply
+// src/core/gemm.cpp
+//
+// Blocked, packed DGEMM in the usual Goto/BLIS layout:
+//
+//   for each NC-wide column panel of B
+//     for each KC-deep slice
+//       pack B(kc x nc) into NR-wide slivers    (stays in L3)
+//       pack A(m  x kc) into MR-tall slivers    (one MC block stays in L2)
+//       for each (MC block, column chunk) task  (thread pool)
+//         micro-kernel: MR x NR tile of C += sliver(A) * sliver(B)
+//
+// The micro-kernel keeps its C tile in registers for the whole KC loop.
+// AVX-512 and AVX2 versions are picked at run time; a scalar one covers
+// everything else. Each element of C accumulates the KC slices in the same
+// order whatever the thread count, so results are reproducible.
+//
+// Matrices are addressed through row and column strides, which lets the
+// complex product run as four real products over the interleaved data.
+
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/allocator.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MATLABCPP_SIMD_GEMM 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#define AVX512_TARGET __attribute__((target("avx512f")))
+#endif
+
+namespace matlabcpp {
+namespace kernels {
+
+namespace {
+
+// Below this many multiply-adds packing costs more than it saves
+constexpr size_t kSmallGemm = 32 * 32 * 32;
+
+// Columns of C per task inside one packed B panel
+constexpr size_t kTaskCols = 192;
+
+using MicroKernel = void (*)(size_t kc, const double* a, const double* b, double* c, size_t ldc);
+
+struct GemmKernel {
+    size_t mr, nr;          // register tile
+    size_t mc, kc, nc;      // cache blocks (mc % mr == 0, nc % nr == 0)
+    MicroKernel micro;      // c[0..mr) x [0..nr) += a-sliver * b-sliver
+};
+
+// ========== MICRO-KERNELS ==========
+
+void micro_scalar(size_t kc, const double* a, const double* b, double* c, size_t ldc) {
+    double ab[4][4] = {};
+    for (size_t p = 0; p < kc; ++p, a += 4, b += 4) {
+        for (size_t j = 0; j < 4; ++j) {
+            for (size_t i = 0; i < 4; ++i) ab[j][i] += a[i] * b[j];
+        }
+    }
+    for (size_t j = 0; j < 4; ++j) {
+        for (size_t i = 0; i < 4; ++i) c[i + j * ldc] += ab[j][i];
+    }
+}
+
+#ifdef MATLABCPP_SIMD_GEMM
+
+// 8x6 tile: 12 accumulators, 2 A loads and 6 broadcasts per step
+AVX2_TARGET void micro_avx2(size_t kc, const double* a, const double* b, double* c, size_t ldc) {
+    __m256d c0[6], c1[6];
+#pragma GCC unroll 6
+    for (int j = 0; j < 6; ++j) c0[j] = c1[j] = _mm256_setzero_pd();
+    for (size_t p = 0; p < kc; ++p, a += 8, b += 6) {
+        __m256d a0 = _mm256_load_pd(a);
+        __m256d a1 = _mm256_load_pd(a + 4);
+#pragma GCC unroll 6
+        for (int j = 0; j < 6; ++j) {
+            __m256d bj = _mm256_broadcast_sd(b + j);
+            c0[j] = _mm256_fmadd_pd(a0, bj, c0[j]);
+            c1[j] = _mm256_fmadd_pd(a1, bj, c1[j]);
+        }
+    }
+#pragma GCC unroll 6
+    for (int j = 0; j < 6; ++j) {
+        double* col = c + j * ldc;
+        _mm256_storeu_pd(col, _mm256_add_pd(_mm256_loadu_pd(col), c0[j]));
+        _mm256_storeu_pd(col + 4, _mm256_add_pd(_mm256_loadu_pd(col + 4), c1[j]));
+    }
+}
+
+// 16x12 tile: 24 of the 32 zmm registers hold C
+AVX512_TARGET void micro_avx512(size_t kc, const double* a, const double* b, double* c, size_t ldc) {
+    __m512d c0[12], c1[12];
+#pragma GCC unroll 12
+    for (int j = 0; j < 12; ++j) c0[j] = c1[j] = _mm512_setzero_pd();
+    for (size_t p = 0; p < kc; ++p, a += 16, b += 12) {
+        __m512d a0 = _mm512_load_pd(a);
+        __m512d a1 = _mm512_load_pd(a + 8);
+#pragma GCC unroll 12
+        for (int j = 0; j < 12; ++j) {
+            __m512d bj = _mm512_set1_pd(b[j]);
+            c0[j] = _mm512_fmadd_pd(a0, bj, c0[j]);
+            c1[j] = _mm512_fmadd_pd(a1, bj, c1[j]);
+        }
+    }
+#pragma GCC unroll 12
+    for (int j = 0; j < 12; ++j) {
+        double* col = c + j * ldc;
+        _mm512_storeu_pd(col, _mm512_add_pd(_mm512_loadu_pd(col), c0[j]));
+        _mm512_storeu_pd(col + 8, _mm512_add_pd(_mm512_loadu_pd(col + 8), c1[j]));
+    }
+}
+
+#endif // MATLABCPP_SIMD_GEMM
+
+const GemmKernel& select_kernel() {
+    static const GemmKernel kernel = [] {
+#ifdef MATLABCPP_SIMD_GEMM
+        if (__builtin_cpu_supports("avx512f")) return GemmKernel{16, 12, 144, 256, 4092, micro_avx512};
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return GemmKernel{8, 6, 96, 256, 4092, micro_avx2};
+        }
+#endif
+        return GemmKernel{4, 4, 64, 256, 2048, micro_scalar};
+    }();
+    return kernel;
+}
+
+// ========== PACKING ==========
+
+struct View {
+    const double* data;
+    size_t rs, cs;          // element (i, j) lives at data[i * rs + j * cs]
+    double operator()(size_t i, size_t j) const { return data[i * rs + j * cs]; }
+};
+
+// A(0..m, 0..kc) -> MR-tall slivers, each stored k-major; rows past m are
+// zero and alpha is folded in
+void pack_a(const View& A, size_t m, size_t kc, double alpha, size_t mr, double* out) {
+    size_t slivers = (m + mr - 1) / mr;
+    parallel_for(slivers, 16, [&](size_t lo, size_t hi) {
+        for (size_t s = lo; s < hi; ++s) {
+            double* dst = out + s * mr * kc;
+            size_t i0 = s * mr;
+            size_t rows = std::min(mr, m - i0);
+            for (size_t p = 0; p < kc; ++p, dst += mr) {
+                size_t i = 0;
+                for (; i < rows; ++i) dst[i] = alpha * A(i0 + i, p);
+                for (; i < mr; ++i) dst[i] = 0.0;
+            }
+        }
+    });
+}
+
+// B(0..kc, 0..n) -> NR-wide slivers, each stored k-major; columns past n
+// are zero
+void pack_b(const View& B, size_t kc, size_t n, size_t nr, double* out) {
+    size_t slivers = (n + nr - 1) / nr;
+    parallel_for(slivers, 16, [&](size_t lo, size_t hi) {
+        for (size_t s = lo; s < hi; ++s) {
+            double* dst = out + s * nr * kc;
+            size_t j0 = s * nr;
+            size_t cols = std::min(nr, n - j0);
+            for (size_t p = 0; p < kc; ++p, dst += nr) {
+                size_t j = 0;
+                for (; j < cols; ++j) dst[j] = B(p, j0 + j);
+                for (; j < nr; ++j) dst[j] = 0.0;
+            }
+        }
+    });
+}
+
+// ========== DRIVERS ==========
+
+void scale_c(double* C, size_t rsc, size_t csc, size_t m, size_t n, double beta) {
+    if (beta == 1.0) return;
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = 0; i < m; ++i) {
+            double& c = C[i * rsc + j * csc];
+            c = beta == 0.0 ? 0.0 : beta * c;
+        }
+    }
+}
+
+// Straight loops for products too small to be worth packing, and for
+// matrix-vector products, which are bound by reading A anyway
+void gemm_simple(size_t m, size_t n, size_t k, double alpha, const View& A, const View& B,
+                 double* C, size_t rsc, size_t csc) {
+    parallel_for(m, 4096, [&](size_t lo, size_t hi) {
+        if (A.cs == 1 && B.rs == 1) {
+            // A' * B: rows of A are contiguous, so take dot products
+            for (size_t j = 0; j < n; ++j) {
+                const double* b = B.data + j * B.cs;
+                for (size_t i = lo; i < hi; ++i) {
+                    const double* a = A.data + i * A.rs;
+                    double dot = 0.0;
+                    for (size_t p = 0; p < k; ++p) dot += a[p] * b[p];
+                    C[i * rsc + j * csc] += alpha * dot;
+                }
+            }
+            return;
+        }
+        for (size_t j = 0; j < n; ++j) {
+            for (size_t p = 0; p < k; ++p) {
+                double b = alpha * B(p, j);
+                if (A.rs == 1 && rsc == 1) {
+                    const double* a = A.data + p * A.cs;
+                    double* c = C + j * csc;
+                    for (size_t i = lo; i < hi; ++i) c[i] += a[i] * b;
+                } else {
+                    for (size_t i = lo; i < hi; ++i) C[i * rsc + j * csc] += A(i, p) * b;
+                }
+            }
+        }
+    });
+}
+
+void gemm_blocked(size_t m, size_t n, size_t k, double alpha, const View& A, const View& B,
+                  double* C, size_t rsc, size_t csc) {
+    const GemmKernel& K = select_kernel();
+    const size_t mr = K.mr, nr = K.nr;
+
+    AlignedVector a_pack(((m + mr - 1) / mr) * mr * std::min(k, K.kc));
+    AlignedVector b_pack(((std::min(n, K.nc) + nr - 1) / nr) * nr * std::min(k, K.kc));
+
+    const size_t task_cols = std::max(nr, kTaskCols / nr * nr);
+
+    for (size_t jc = 0; jc < n; jc += K.nc) {
+        size_t nc = std::min(K.nc, n - jc);
+        for (size_t pc = 0; pc < k; pc += K.kc) {
+            size_t kc = std::min(K.kc, k - pc);
+
+            pack_b(View{B.data + pc * B.rs + jc * B.cs, B.rs, B.cs}, kc, nc, nr, b_pack.data());
+            pack_a(View{A.data + pc * A.cs, A.rs, A.cs}, m, kc, alpha, mr, a_pack.data());
+
+            size_t m_blocks = (m + K.mc - 1) / K.mc;
+            size_t n_chunks = (nc + task_cols - 1) / task_cols;
+            parallel_for(m_blocks * n_chunks, 1, [&](size_t lo, size_t hi) {
+                alignas(64) double tile[16 * 12];
+                for (size_t t = lo; t < hi; ++t) {
+                    size_t ic = (t / n_chunks) * K.mc;
+                    size_t j_lo = (t % n_chunks) * task_cols;
+                    size_t i_hi = std::min(m, ic + K.mc);
+                    size_t j_hi = std::min(nc, j_lo + task_cols);
+
+                    for (size_t jr = j_lo; jr < j_hi; jr += nr) {
+                        const double* b = b_pack.data() + (jr / nr) * nr * kc;
+                        size_t cols = std::min(nr, j_hi - jr);
+                        for (size_t ir = ic; ir < i_hi; ir += mr) {
+                            const double* a = a_pack.data() + (ir / mr) * mr * kc;
+                            size_t rows = std::min(mr, i_hi - ir);
+                            double* c = C + ir * rsc + (jc + jr) * csc;
+                            if (rsc == 1 && rows == mr && cols == nr) {
+                                K.micro(kc, a, b, c, csc);
+                                continue;
+                            }
+                            // Edge tile or strided C: go through a scratch tile
+                            std::fill(tile, tile + mr * nr, 0.0);
+                            K.micro(kc, a, b, tile, mr);
+                            for (size_t j = 0; j < cols; ++j) {
+                                for (size_t i = 0; i < rows; ++i) c[i * rsc + j * csc] += tile[i + j * mr];
+                            }
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+void gemm_strided(size_t m, size_t n, size_t k, double alpha, const View& A, const View& B,
+                  double beta, double* C, size_t rsc, size_t csc) {
+    if (m == 0 || n == 0) return;
+    scale_c(C, rsc, csc, m, n, beta);
+    if (k == 0 || alpha == 0.0) return;
+    if (n == 1 || m * n * k <= kSmallGemm) {
+        gemm_simple(m, n, k, alpha, A, B, C, rsc, csc);
+    } else {
+        gemm_blocked(m, n, k, alpha, A, B, C, rsc, csc);
+    }
+}
+
+} // namespace
+
+void gemm(size_t m, size_t n, size_t k, double alpha,
+          const double* A, size_t lda, const double* B, size_t ldb,
+          double beta, double* C, size_t ldc) {
+    gemm_strided(m, n, k, alpha, View{A, 1, lda}, View{B, 1, ldb}, beta, C, 1, ldc);
+}
+
+void gemm(bool trans_a, bool trans_b, size_t m, size_t n, size_t k, double alpha,
+          const double* A, size_t lda, const double* B, size_t ldb,
+          double beta, double* C, size_t ldc) {
+    View a = trans_a ? View{A, lda, 1} : View{A, 1, lda};
+    View b = trans_b ? View{B, ldb, 1} : View{B, 1, ldb};
+    gemm_strided(m, n, k, alpha, a, b, beta, C, 1, ldc);
+}
+
+void gemm(size_t m, size_t n, size_t k, double alpha,
+          const std::complex<double>* A, size_t lda, const std::complex<double>* B, size_t ldb,
+          double beta, std::complex<double>* C, size_t ldc) {
+    // std::complex<double> is laid out as double[2]: view each part as a
+    // real matrix with row stride 2
+    const double* a = reinterpret_cast<const double*>(A);
+    const double* b = reinterpret_cast<const double*>(B);
+    double* c = reinterpret_cast<double*>(C);
+    View Ar{a, 2, 2 * lda}, Ai{a + 1, 2, 2 * lda};
+    View Br{b, 2, 2 * ldb}, Bi{b + 1, 2, 2 * ldb};
+
+    // re(C) = Ar*Br - Ai*Bi, im(C) = Ar*Bi + Ai*Br
+    gemm_strided(m, n, k, alpha, Ar, Br, beta, c, 2, 2 * ldc);
+    gemm_strided(m, n, k, -alpha, Ai, Bi, 1.0, c, 2, 2 * ldc);
+    gemm_strided(m, n, k, alpha, Ar, Bi, beta, c + 1, 2, 2 * ldc);
+    gemm_strided(m, n, k, alpha, Ai, Br, 1.0, c + 1, 2, 2 * ldc);
+}
+
+void gemm(size_t m, size_t n, size_t k,
+          const std::complex<double>* A, size_t lda, const std::complex<double>* B, size_t ldb,
+          std::complex<double>* C, size_t ldc) {
+    gemm(m, n, k, 1.0, A, lda, B, ldb, 0.0, C, ldc);
+}
+
+// The transposes are strides; a conjugate flips the sign of the products
+// its imaginary part enters
+void gemm(MatrixOp op_a, MatrixOp op_b, size_t m, size_t n, size_t k, double alpha,
+          const std::complex<double>* A, size_t lda, const std::complex<double>* B, size_t ldb,
+          double beta, std::complex<double>* C, size_t ldc) {
+    const double* a = reinterpret_cast<const double*>(A);
+    const double* b = reinterpret_cast<const double*>(B);
+    double* c = reinterpret_cast<double*>(C);
+    bool ta = op_a != MatrixOp::None, tb = op_b != MatrixOp::None;
+    size_t ars = ta ? 2 * lda : 2, acs = ta ? 2 : 2 * lda;
+    size_t brs = tb ? 2 * ldb : 2, bcs = tb ? 2 : 2 * ldb;
+    View Ar{a, ars, acs}, Ai{a + 1, ars, acs};
+    View Br{b, brs, bcs}, Bi{b + 1, brs, bcs};
+    double sa = op_a == MatrixOp::ConjTranspose ? -1.0 : 1.0;
+    double sb = op_b == MatrixOp::ConjTranspose ? -1.0 : 1.0;
+
+    gemm_strided(m, n, k, alpha, Ar, Br, beta, c, 2, 2 * ldc);
+    gemm_strided(m, n, k, -alpha * sa * sb, Ai, Bi, 1.0, c, 2, 2 * ldc);
+    gemm_strided(m, n, k, alpha * sb, Ar, Bi, beta, c + 1, 2, 2 * ldc);
+    gemm_strided(m, n, k, alpha * sa, Ai, Br, 1.0, c + 1, 2, 2 * ldc);
+}
+
+const char* gemm_level() {
+    const GemmKernel& K = select_kernel();
+    return K.mr == 16 ? "avx512" : K.mr == 8 ? "avx2" : "scalar";
+}
+
+} // namespace kernels
+} // namespace matlabcpp
@@ -0,0 +1,502 @@
+// MatLabC++ Elementwise Kernels
+// src/core/kernels.cpp
+//
+// Portable scalar loops plus AVX2 versions selected at run time. The AVX2
+// code is compiled with a per-function target attribute, so the rest of
+// the library keeps the baseline instruction set.
+//
+// Vector kernels cover arithmetic, comparisons, logic, abs/sqrt/rounding,
+// exp (Cephes rational approximation, within a couple of ulp) and the
+// split-complex product and modulus.
+// log and the trig functions stay on libm per element.
+
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MATLABCPP_AVX2_KERNELS 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+
+namespace matlabcpp {
+namespace kernels {
+
+namespace {
+
+// ========== SCALAR ==========
+
+template <typename F>
+void binary_loop(const double* x, size_t xs, const double* y, size_t ys, double* out, size_t n, F f) {
+    for (size_t i = 0; i < n; ++i) out[i] = f(x[i * xs], y[i * ys]);
+}
+
+template <typename F>
+void unary_loop(const double* x, double* out, size_t n, F f) {
+    for (size_t i = 0; i < n; ++i) out[i] = f(x[i]);
+}
+
+void binary_scalar(BinaryOp op, const double* x, size_t xs, const double* y, size_t ys, double* out, size_t n) {
+    switch (op) {
+        case BinaryOp::Add: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a + b; }); break;
+        case BinaryOp::Sub: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a - b; }); break;
+        case BinaryOp::Mul: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a * b; }); break;
+        case BinaryOp::Div: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a / b; }); break;
+        case BinaryOp::Pow: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return std::pow(a, b); }); break;
+        case BinaryOp::Eq: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a == b ? 1.0 : 0.0; }); break;
+        case BinaryOp::Ne: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a != b ? 1.0 : 0.0; }); break;
+        case BinaryOp::Lt: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a < b ? 1.0 : 0.0; }); break;
+        case BinaryOp::Le: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a <= b ? 1.0 : 0.0; }); break;
+        case BinaryOp::Gt: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a > b ? 1.0 : 0.0; }); break;
+        case BinaryOp::Ge: binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a >= b ? 1.0 : 0.0; }); break;
+        case BinaryOp::And:
+            binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a != 0.0 && b != 0.0 ? 1.0 : 0.0; });
+            break;
+        case BinaryOp::Or:
+            binary_loop(x, xs, y, ys, out, n, [](double a, double b) { return a != 0.0 || b != 0.0 ? 1.0 : 0.0; });
+            break;
+    }
+}
+
+// MATLAB round(): halves go away from zero
+double round_half_away(double v) { return std::round(v); }
+
+void unary_scalar(UnaryOp op, const double* x, double* out, size_t n) {
+    switch (op) {
+        case UnaryOp::Neg: unary_loop(x, out, n, [](double v) { return -v; }); break;
+        case UnaryOp::Not: unary_loop(x, out, n, [](double v) { return v == 0.0 ? 1.0 : 0.0; }); break;
+        case UnaryOp::Abs: unary_loop(x, out, n, [](double v) { return std::fabs(v); }); break;
+        case UnaryOp::Sqrt: unary_loop(x, out, n, [](double v) { return std::sqrt(v); }); break;
+        case UnaryOp::Exp: unary_loop(x, out, n, [](double v) { return std::exp(v); }); break;
+        case UnaryOp::Log: unary_loop(x, out, n, [](double v) { return std::log(v); }); break;
+        case UnaryOp::Log10: unary_loop(x, out, n, [](double v) { return std::log10(v); }); break;
+        case UnaryOp::Sin: unary_loop(x, out, n, [](double v) { return std::sin(v); }); break;
+        case UnaryOp::Cos: unary_loop(x, out, n, [](double v) { return std::cos(v); }); break;
+        case UnaryOp::Tan: unary_loop(x, out, n, [](double v) { return std::tan(v); }); break;
+        case UnaryOp::Floor: unary_loop(x, out, n, [](double v) { return std::floor(v); }); break;
+        case UnaryOp::Ceil: unary_loop(x, out, n, [](double v) { return std::ceil(v); }); break;
+        case UnaryOp::Round: unary_loop(x, out, n, round_half_away); break;
+    }
+}
+
+double sum_serial(const double* x, size_t n) {
+    double total = 0.0;
+    for (size_t i = 0; i < n; ++i) total += x[i];
+    return total;
+}
+
+double min_serial(const double* x, size_t n) {
+    double m = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; ++i) {
+        if (x[i] < m) m = x[i];
+    }
+    return m;
+}
+
+double max_serial(const double* x, size_t n) {
+    double m = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; ++i) {
+        if (x[i] > m) m = x[i];
+    }
+    return m;
+}
+
+// out[i] = sum_j h[j] * x[i + j]: the convolution inner loop, with the
+// kernel reversed and the input zero-padded by the caller
+void correlate_scalar(const double* x, const double* h, size_t nh, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        double acc = 0.0;
+        for (size_t j = 0; j < nh; ++j) acc += h[j] * x[i + j];
+        out[i] = acc;
+    }
+}
+
+// Split complex: (cr, ci) = (ar, ai) * (br, bi). Plain formula, no C99
+// inf/NaN recovery. Outputs may alias inputs.
+void complex_multiply_scalar(const double* ar, const double* ai, const double* br, const double* bi,
+                             double* cr, double* ci, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        double re = ar[i] * br[i] - ai[i] * bi[i];
+        double im = ar[i] * bi[i] + ai[i] * br[i];
+        cr[i] = re;
+        ci[i] = im;
+    }
+}
+
+void complex_abs_scalar(const double* re, const double* im, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = std::hypot(re[i], im[i]);
+}
+
+// ========== AVX2 ==========
+
+#ifdef MATLABCPP_AVX2_KERNELS
+
+AVX2_TARGET inline __m256d load(const double* p, size_t stride) {
+    return stride ? _mm256_loadu_pd(p) : _mm256_broadcast_sd(p);
+}
+
+// Four lanes at a time, scalar tail. `a`/`b` are the lane operands in
+// VEC and the element operands in SCALAR.
+#define AVX2_BINARY(VEC, SCALAR)                                            \
+    do {                                                                    \
+        size_t i = 0;                                                       \
+        for (; i + 4 <= n; i += 4) {                                        \
+            __m256d a = load(x + i * xs, xs);                               \
+            __m256d b = load(y + i * ys, ys);                               \
+            _mm256_storeu_pd(out + i, (VEC));                               \
+        }                                                                   \
+        for (; i < n; ++i) {                                                \
+            double a = x[i * xs], b = y[i * ys];                            \
+            out[i] = (SCALAR);                                              \
+        }                                                                   \
+    } while (0)
+
+#define AVX2_COMPARE(PRED, SCALAR) \
+    AVX2_BINARY(_mm256_and_pd(_mm256_cmp_pd(a, b, PRED), one), (SCALAR) ? 1.0 : 0.0)
+
+AVX2_TARGET void binary_avx2(BinaryOp op, const double* x, size_t xs, const double* y, size_t ys, double* out, size_t n) {
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+
+    switch (op) {
+        case BinaryOp::Add: AVX2_BINARY(_mm256_add_pd(a, b), a + b); break;
+        case BinaryOp::Sub: AVX2_BINARY(_mm256_sub_pd(a, b), a - b); break;
+        case BinaryOp::Mul: AVX2_BINARY(_mm256_mul_pd(a, b), a * b); break;
+        case BinaryOp::Div: AVX2_BINARY(_mm256_div_pd(a, b), a / b); break;
+        case BinaryOp::Eq: AVX2_COMPARE(_CMP_EQ_OQ, a == b); break;
+        case BinaryOp::Ne: AVX2_COMPARE(_CMP_NEQ_UQ, a != b); break;
+        case BinaryOp::Lt: AVX2_COMPARE(_CMP_LT_OQ, a < b); break;
+        case BinaryOp::Le: AVX2_COMPARE(_CMP_LE_OQ, a <= b); break;
+        case BinaryOp::Gt: AVX2_COMPARE(_CMP_GT_OQ, a > b); break;
+        case BinaryOp::Ge: AVX2_COMPARE(_CMP_GE_OQ, a >= b); break;
+        case BinaryOp::And:
+            AVX2_BINARY(_mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(a, zero, _CMP_NEQ_UQ),
+                                                    _mm256_cmp_pd(b, zero, _CMP_NEQ_UQ)), one),
+                        a != 0.0 && b != 0.0 ? 1.0 : 0.0);
+            break;
+        case BinaryOp::Or:
+            AVX2_BINARY(_mm256_and_pd(_mm256_or_pd(_mm256_cmp_pd(a, zero, _CMP_NEQ_UQ),
+                                                   _mm256_cmp_pd(b, zero, _CMP_NEQ_UQ)), one),
+                        a != 0.0 || b != 0.0 ? 1.0 : 0.0);
+            break;
+        case BinaryOp::Pow:
+            binary_scalar(op, x, xs, y, ys, out, n);
+            break;
+    }
+}
+
+#undef AVX2_COMPARE
+#undef AVX2_BINARY
+
+// e^x for -708 <= x <= 709 (Cephes): x = k ln2 + r with |r| <= ln2/2,
+// e^r = 1 + 2 r P(r^2) / (Q(r^2) - r P(r^2)), then scale by 2^k through
+// the exponent bits.
+AVX2_TARGET inline __m256d exp_pd(__m256d x) {
+    const __m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(1.4426950408889634)),
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(k, _mm256_set1_pd(6.93145751953125e-1), x);
+    r = _mm256_fnmadd_pd(k, _mm256_set1_pd(1.42860682030941723212e-6), r);
+
+    const __m256d rr = _mm256_mul_pd(r, r);
+    __m256d p = _mm256_fmadd_pd(_mm256_set1_pd(1.26177193074810590878e-4), rr, _mm256_set1_pd(3.02994407707441961300e-2));
+    p = _mm256_fmadd_pd(p, rr, _mm256_set1_pd(9.99999999999999999910e-1));
+    p = _mm256_mul_pd(p, r);
+    __m256d q = _mm256_fmadd_pd(_mm256_set1_pd(3.00198505138664455042e-6), rr, _mm256_set1_pd(2.52448340349684104192e-3));
+    q = _mm256_fmadd_pd(q, rr, _mm256_set1_pd(2.27265548208155028766e-1));
+    q = _mm256_fmadd_pd(q, rr, _mm256_set1_pd(2.00000000000000000009e0));
+    __m256d e = _mm256_div_pd(p, _mm256_sub_pd(q, p));
+    e = _mm256_fmadd_pd(e, _mm256_set1_pd(2.0), _mm256_set1_pd(1.0));
+
+    __m256i bits = _mm256_add_epi64(_mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(k)), _mm256_set1_epi64x(1023));
+    return _mm256_mul_pd(e, _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52)));
+}
+
+AVX2_TARGET void exp_avx2(const double* x, double* out, size_t n) {
+    const __m256d lo = _mm256_set1_pd(-708.0);
+    const __m256d hi = _mm256_set1_pd(709.0);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(x + i);
+        __m256d in_range = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ), _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+        if (_mm256_movemask_pd(in_range) != 0xf) {
+            // Overflow, underflow to subnormal/zero, NaN: let libm handle the block
+            for (size_t k = i; k < i + 4; ++k) out[k] = std::exp(x[k]);
+            continue;
+        }
+        _mm256_storeu_pd(out + i, exp_pd(v));
+    }
+    for (; i < n; ++i) out[i] = std::exp(x[i]);
+}
+
+#define AVX2_UNARY(VEC, SCALAR)                                             \
+    do {                                                                    \
+        size_t i = 0;                                                       \
+        for (; i + 4 <= n; i += 4) {                                        \
+            __m256d a = _mm256_loadu_pd(x + i);                             \
+            _mm256_storeu_pd(out + i, (VEC));                               \
+        }                                                                   \
+        for (; i < n; ++i) {                                                \
+            double a = x[i];                                                \
+            out[i] = (SCALAR);                                              \
+        }                                                                   \
+    } while (0)
+
+AVX2_TARGET __m256d round_half_away_pd(__m256d a) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d t = _mm256_round_pd(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    __m256d frac = _mm256_andnot_pd(sign, _mm256_sub_pd(a, t));  // exact
+    __m256d up = _mm256_cmp_pd(frac, _mm256_set1_pd(0.5), _CMP_GE_OQ);
+    __m256d step = _mm256_or_pd(_mm256_and_pd(a, sign), _mm256_set1_pd(1.0));  // copysign(1, a)
+    return _mm256_add_pd(t, _mm256_and_pd(up, step));
+}
+
+AVX2_TARGET void unary_avx2(UnaryOp op, const double* x, double* out, size_t n) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+
+    switch (op) {
+        case UnaryOp::Neg: AVX2_UNARY(_mm256_xor_pd(a, sign), -a); break;
+        case UnaryOp::Not: AVX2_UNARY(_mm256_and_pd(_mm256_cmp_pd(a, zero, _CMP_EQ_OQ), one), a == 0.0 ? 1.0 : 0.0); break;
+        case UnaryOp::Abs: AVX2_UNARY(_mm256_andnot_pd(sign, a), std::fabs(a)); break;
+        case UnaryOp::Sqrt: AVX2_UNARY(_mm256_sqrt_pd(a), std::sqrt(a)); break;
+        case UnaryOp::Floor: AVX2_UNARY(_mm256_floor_pd(a), std::floor(a)); break;
+        case UnaryOp::Ceil: AVX2_UNARY(_mm256_ceil_pd(a), std::ceil(a)); break;
+        case UnaryOp::Round: AVX2_UNARY(round_half_away_pd(a), round_half_away(a)); break;
+        case UnaryOp::Exp: exp_avx2(x, out, n); break;
+        default: unary_scalar(op, x, out, n); break;
+    }
+}
+
+#undef AVX2_UNARY
+
+// Sixteen outputs per sweep over the kernel, in four accumulators
+AVX2_TARGET void correlate_avx2(const double* x, const double* h, size_t nh, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+        for (size_t j = 0; j < nh; ++j) {
+            const __m256d w = _mm256_broadcast_sd(h + j);
+            const double* p = x + i + j;
+            s0 = _mm256_fmadd_pd(w, _mm256_loadu_pd(p), s0);
+            s1 = _mm256_fmadd_pd(w, _mm256_loadu_pd(p + 4), s1);
+            s2 = _mm256_fmadd_pd(w, _mm256_loadu_pd(p + 8), s2);
+            s3 = _mm256_fmadd_pd(w, _mm256_loadu_pd(p + 12), s3);
+        }
+        _mm256_storeu_pd(out + i, s0);
+        _mm256_storeu_pd(out + i + 4, s1);
+        _mm256_storeu_pd(out + i + 8, s2);
+        _mm256_storeu_pd(out + i + 12, s3);
+    }
+    for (; i + 4 <= n; i += 4) {
+        __m256d s = _mm256_setzero_pd();
+        for (size_t j = 0; j < nh; ++j) s = _mm256_fmadd_pd(_mm256_broadcast_sd(h + j), _mm256_loadu_pd(x + i + j), s);
+        _mm256_storeu_pd(out + i, s);
+    }
+    correlate_scalar(x + i, h, nh, out + i, n - i);
+}
+
+AVX2_TARGET void complex_multiply_avx2(const double* ar, const double* ai, const double* br, const double* bi,
+                                       double* cr, double* ci, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d xr = _mm256_loadu_pd(ar + i), xi = _mm256_loadu_pd(ai + i);
+        __m256d yr = _mm256_loadu_pd(br + i), yi = _mm256_loadu_pd(bi + i);
+        __m256d re = _mm256_fmsub_pd(xr, yr, _mm256_mul_pd(xi, yi));
+        __m256d im = _mm256_fmadd_pd(xr, yi, _mm256_mul_pd(xi, yr));
+        _mm256_storeu_pd(cr + i, re);
+        _mm256_storeu_pd(ci + i, im);
+    }
+    complex_multiply_scalar(ar + i, ai + i, br + i, bi + i, cr + i, ci + i, n - i);
+}
+
+// sqrt(re^2 + im^2), redone with hypot for the lanes where the squares
+// may have overflowed or lost precision to underflow
+AVX2_TARGET void complex_abs_avx2(const double* re, const double* im, double* out, size_t n) {
+    const __m256d huge = _mm256_set1_pd(1e150), tiny = _mm256_set1_pd(1e-150);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_loadu_pd(re + i), y = _mm256_loadu_pd(im + i);
+        __m256d r = _mm256_sqrt_pd(_mm256_fmadd_pd(x, x, _mm256_mul_pd(y, y)));
+        _mm256_storeu_pd(out + i, r);
+        __m256d unsafe = _mm256_or_pd(_mm256_cmp_pd(r, huge, _CMP_NLE_UQ), _mm256_cmp_pd(r, tiny, _CMP_LT_OQ));
+        if (_mm256_movemask_pd(unsafe)) complex_abs_scalar(re + i, im + i, out + i, 4);
+    }
+    complex_abs_scalar(re + i, im + i, out + i, n - i);
+}
+
+#endif // MATLABCPP_AVX2_KERNELS
+
+bool use_avx2() {
+#ifdef MATLABCPP_AVX2_KERNELS
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// Elements per parallel task: 256 KB of doubles, enough to amortize a
+// task hand-off, small enough to balance across cores
+constexpr size_t kParallelChunk = size_t(1) << 15;
+
+void binary_serial(BinaryOp op, const double* x, size_t xs, const double* y, size_t ys, double* out, size_t n) {
+#ifdef MATLABCPP_AVX2_KERNELS
+    if (n >= 4 && use_avx2()) {
+        binary_avx2(op, x, xs, y, ys, out, n);
+        return;
+    }
+#endif
+    binary_scalar(op, x, xs, y, ys, out, n);
+}
+
+void unary_serial(UnaryOp op, const double* x, double* out, size_t n) {
+#ifdef MATLABCPP_AVX2_KERNELS
+    if (n >= 4 && use_avx2()) {
+        unary_avx2(op, x, out, n);
+        return;
+    }
+#endif
+    unary_scalar(op, x, out, n);
+}
+
+void correlate_serial(const double* x, const double* h, size_t nh, double* out, size_t n) {
+#ifdef MATLABCPP_AVX2_KERNELS
+    if (n >= 4 && use_avx2()) {
+        correlate_avx2(x, h, nh, out, n);
+        return;
+    }
+#endif
+    correlate_scalar(x, h, nh, out, n);
+}
+
+// Per-chunk partial results combined in chunk order: the same answer
+// whatever the thread count
+template <typename Serial, typename Combine>
+double reduce(const double* x, size_t n, double identity, Serial serial, Combine combine) {
+    if (n <= kParallelChunk) return n ? serial(x, n) : identity;
+    std::vector<double> partial((n + kParallelChunk - 1) / kParallelChunk);
+    parallel_for(n, kParallelChunk, [&](size_t lo, size_t hi) {
+        partial[lo / kParallelChunk] = serial(x + lo, hi - lo);
+    });
+    double result = partial[0];
+    for (size_t c = 1; c < partial.size(); ++c) result = combine(result, partial[c]);
+    return result;
+}
+
+void complex_multiply_serial(const double* ar, const double* ai, const double* br, const double* bi,
+                             double* cr, double* ci, size_t n) {
+#ifdef MATLABCPP_AVX2_KERNELS
+    if (n >= 4 && use_avx2()) {
+        complex_multiply_avx2(ar, ai, br, bi, cr, ci, n);
+        return;
+    }
+#endif
+    complex_multiply_scalar(ar, ai, br, bi, cr, ci, n);
+}
+
+void complex_abs_serial(const double* re, const double* im, double* out, size_t n) {
+#ifdef MATLABCPP_AVX2_KERNELS
+    if (n >= 4 && use_avx2()) {
+        complex_abs_avx2(re, im, out, n);
+        return;
+    }
+#endif
+    complex_abs_scalar(re, im, out, n);
+}
+
+} // namespace
+
+// ========== DISPATCH ==========
+
+void binary(BinaryOp op, const double* x, size_t x_stride,
+            const double* y, size_t y_stride, double* out, size_t n) {
+    // x.^2 is by far the most common power; keep it off std::pow
+    if (op == BinaryOp::Pow && y_stride == 0 && n > 0 && *y == 2.0) {
+        op = BinaryOp::Mul;
+        y = x;
+        y_stride = x_stride;
+    }
+    if (n > kParallelChunk) {
+        parallel_for(n, kParallelChunk, [&](size_t lo, size_t hi) {
+            binary_serial(op, x + lo * x_stride, x_stride, y + lo * y_stride, y_stride, out + lo, hi - lo);
+        });
+        return;
+    }
+    binary_serial(op, x, x_stride, y, y_stride, out, n);
+}
+
+void unary(UnaryOp op, const double* x, double* out, size_t n) {
+    if (n > kParallelChunk) {
+        parallel_for(n, kParallelChunk, [&](size_t lo, size_t hi) {
+            unary_serial(op, x + lo, out + lo, hi - lo);
+        });
+        return;
+    }
+    unary_serial(op, x, out, n);
+}
+
+double sum(const double* x, size_t n) {
+    return reduce(x, n, 0.0, sum_serial, [](double a, double b) { return a + b; });
+}
+
+double min(const double* x, size_t n) {
+    return reduce(x, n, std::numeric_limits<double>::infinity(), min_serial,
+                  [](double a, double b) { return b < a ? b : a; });
+}
+
+double max(const double* x, size_t n) {
+    return reduce(x, n, -std::numeric_limits<double>::infinity(), max_serial,
+                  [](double a, double b) { return b > a ? b : a; });
+}
+
+void complex_multiply(const double* ar, const double* ai, const double* br, const double* bi,
+                      double* cr, double* ci, size_t n) {
+    parallel_for(n, kParallelChunk, [&](size_t lo, size_t hi) {
+        complex_multiply_serial(ar + lo, ai + lo, br + lo, bi + lo, cr + lo, ci + lo, hi - lo);
+    });
+}
+
+void complex_abs(const double* re, const double* im, double* out, size_t n) {
+    parallel_for(n, kParallelChunk, [&](size_t lo, size_t hi) {
+        complex_abs_serial(re + lo, im + lo, out + lo, hi - lo);
+    });
+}
+
+void convolve(const double* x, size_t nx, const double* h, size_t nh, double* out) {
+    if (nx == 0 || nh == 0) return;
+    const size_t n = nx + nh - 1;
+    std::vector<double> padded(nx + 2 * (nh - 1), 0.0);
+    std::copy(x, x + nx, padded.begin() + static_cast<std::ptrdiff_t>(nh - 1));
+    std::vector<double> reversed(h, h + nh);
+    std::reverse(reversed.begin(), reversed.end());
+
+    // Chunks of about kParallelChunk multiply-adds
+    size_t chunk = std::max<size_t>(64, kParallelChunk / nh);
+    parallel_for(n, chunk, [&](size_t lo, size_t hi) {
+        correlate_serial(padded.data() + lo, reversed.data(), nh, out + lo, hi - lo);
+    });
+}
+
+const UnaryOp* unary_function(const std::string& name) {
+    static const std::unordered_map<std::string, UnaryOp> functions = {
+        {"sqrt", UnaryOp::Sqrt}, {"abs", UnaryOp::Abs},
+        {"exp", UnaryOp::Exp}, {"log", UnaryOp::Log}, {"log10", UnaryOp::Log10},
+        {"sin", UnaryOp::Sin}, {"cos", UnaryOp::Cos}, {"tan", UnaryOp::Tan},
+        {"floor", UnaryOp::Floor}, {"ceil", UnaryOp::Ceil}, {"round", UnaryOp::Round}
+    };
+    auto it = functions.find(name);
+    return it != functions.end() ? &it->second : nullptr;
+}
+
+const char* simd_level() {
+    return use_avx2() ? "avx2" : "scalar";
+}
+
+} // namespace kernels
+} // namespace matlabcpp
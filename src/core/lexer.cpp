@@ -0,0 +1,215 @@
+// MatLabC++ .m Lexer
+// src/core/lexer.cpp
+
+#include "matlabcpp/lexer.hpp"
+#include <cctype>
+
+namespace matlabcpp {
+namespace interpreter {
+
+const std::unordered_map<std::string, TokenType> Lexer::keywords_ = {
+    {"if", TokenType::Keyword_if}, {"elseif", TokenType::Keyword_elseif},
+    {"else", TokenType::Keyword_else}, {"end", TokenType::Keyword_end},
+    {"for", TokenType::Keyword_for}, {"while", TokenType::Keyword_while},
+    {"break", TokenType::Keyword_break}, {"continue", TokenType::Keyword_continue},
+    {"function", TokenType::Keyword_function}, {"return", TokenType::Keyword_return},
+    {"clear", TokenType::Keyword_clear}, {"clc", TokenType::Keyword_clc},
+    {"close", TokenType::Keyword_close}
+};
+
+std::vector<Token> Lexer::tokenize() {
+    std::vector<Token> tokens;
+
+    while (pos_ < source_.size()) {
+        skip_whitespace_no_newline();
+        if (pos_ >= source_.size()) break;
+
+        char c = source_[pos_];
+
+        // Newline
+        if (c == '\n') {
+            tokens.push_back({TokenType::Newline, "\\n", line_, col_});
+            advance();
+            continue;
+        }
+
+        // Section comment %%
+        if (c == '%' && pos_ + 1 < source_.size() && source_[pos_ + 1] == '%') {
+            std::string comment = read_to_eol();
+            tokens.push_back({TokenType::SectionComment, comment, line_, col_});
+            continue;
+        }
+
+        // Line comment %
+        if (c == '%') {
+            std::string comment = read_to_eol();
+            tokens.push_back({TokenType::Comment, comment, line_, col_});
+            continue;
+        }
+
+        // Transpose when glued to a value (x', A(1,:)', [1 2]', x''),
+        // otherwise a string literal
+        if (c == '\'') {
+            if (quote_is_transpose(tokens)) {
+                tokens.push_back({TokenType::Operator, "'", line_, col_});
+                advance();
+            } else {
+                tokens.push_back(read_string());
+            }
+            continue;
+        }
+
+        // Number
+        if (std::isdigit(c) || (c == '.' && pos_ + 1 < source_.size() && std::isdigit(source_[pos_ + 1]))) {
+            tokens.push_back(read_number());
+            continue;
+        }
+
+        // Identifier or keyword
+        if (std::isalpha(c) || c == '_') {
+            tokens.push_back(read_identifier());
+            continue;
+        }
+
+        // Line continuation ...
+        if (c == '.' && pos_ + 2 < source_.size() && 
+            source_[pos_ + 1] == '.' && source_[pos_ + 2] == '.') {
+            pos_ += 3;
+            read_to_eol();  // skip rest of line
+            continue;
+        }
+
+        // Operators and punctuation
+        int start_col = col_;
+        switch (c) {
+            case '=':
+                if (peek() == '=') { advance(); advance(); tokens.push_back({TokenType::Operator, "==", line_, start_col}); }
+                else { advance(); tokens.push_back({TokenType::Assign, "=", line_, start_col}); }
+                break;
+            case '+': advance(); tokens.push_back({TokenType::Operator, "+", line_, start_col}); break;
+            case '-': advance(); tokens.push_back({TokenType::Operator, "-", line_, start_col}); break;
+            case '*': advance(); tokens.push_back({TokenType::Operator, "*", line_, start_col}); break;
+            case '/': advance(); tokens.push_back({TokenType::Operator, "/", line_, start_col}); break;
+            case '\\': advance(); tokens.push_back({TokenType::Operator, "\\", line_, start_col}); break;
+            case '^': advance(); tokens.push_back({TokenType::Operator, "^", line_, start_col}); break;
+            case '<':
+                if (peek() == '=') { advance(); advance(); tokens.push_back({TokenType::Operator, "<=", line_, start_col}); }
+                else { advance(); tokens.push_back({TokenType::Operator, "<", line_, start_col}); }
+                break;
+            case '>':
+                if (peek() == '=') { advance(); advance(); tokens.push_back({TokenType::Operator, ">=", line_, start_col}); }
+                else { advance(); tokens.push_back({TokenType::Operator, ">", line_, start_col}); }
+                break;
+            case '~':
+                if (peek() == '=') { advance(); advance(); tokens.push_back({TokenType::Operator, "~=", line_, start_col}); }
+                else { advance(); tokens.push_back({TokenType::Operator, "~", line_, start_col}); }
+                break;
+            case '&':
+                if (peek() == '&') { advance(); advance(); tokens.push_back({TokenType::Operator, "&&", line_, start_col}); }
+                else { advance(); tokens.push_back({TokenType::Operator, "&", line_, start_col}); }
+                break;
+            case '|':
+                if (peek() == '|') { advance(); advance(); tokens.push_back({TokenType::Operator, "||", line_, start_col}); }
+                else { advance(); tokens.push_back({TokenType::Operator, "|", line_, start_col}); }
+                break;
+            case '.':
+                if (peek() == '*') { advance(); advance(); tokens.push_back({TokenType::Operator, ".*", line_, start_col}); }
+                else if (peek() == '/') { advance(); advance(); tokens.push_back({TokenType::Operator, "./", line_, start_col}); }
+                else if (peek() == '^') { advance(); advance(); tokens.push_back({TokenType::Operator, ".^", line_, start_col}); }
+                else if (peek() == '\'') { advance(); advance(); tokens.push_back({TokenType::Operator, ".'", line_, start_col}); }
+                else { advance(); tokens.push_back({TokenType::Dot, ".", line_, start_col}); }
+                break;
+            case '(': advance(); tokens.push_back({TokenType::LParen, "(", line_, start_col}); break;
+            case ')': advance(); tokens.push_back({TokenType::RParen, ")", line_, start_col}); break;
+            case '[': advance(); tokens.push_back({TokenType::LBracket, "[", line_, start_col}); break;
+            case ']': advance(); tokens.push_back({TokenType::RBracket, "]", line_, start_col}); break;
+            case ';': advance(); tokens.push_back({TokenType::Semicolon, ";", line_, start_col}); break;
+            case ',': advance(); tokens.push_back({TokenType::Comma, ",", line_, start_col}); break;
+            case ':': advance(); tokens.push_back({TokenType::Colon, ":", line_, start_col}); break;
+            default:
+                advance();
+                break;
+        }
+    }
+
+    tokens.push_back({TokenType::EndOfFile, "", line_, col_});
+    return tokens;
+}
+
+bool Lexer::quote_is_transpose(const std::vector<Token>& tokens) const {
+    if (tokens.empty() || pos_ == 0) return false;
+    char prev = source_[pos_ - 1];
+    if (prev == ' ' || prev == '\t') return false;
+    const Token& t = tokens.back();
+    switch (t.type) {
+        case TokenType::Identifier: case TokenType::Number:
+        case TokenType::RParen: case TokenType::RBracket:
+            return true;
+        case TokenType::Operator:
+            return t.value == "'" || t.value == ".'";
+        default:
+            return false;
+    }
+}
+
+void Lexer::skip_whitespace_no_newline() {
+    while (pos_ < source_.size() && (source_[pos_] == ' ' || source_[pos_] == '\t' || source_[pos_] == '\r')) {
+        advance();
+    }
+}
+
+std::string Lexer::read_to_eol() {
+    std::string result;
+    while (pos_ < source_.size() && source_[pos_] != '\n') {
+        result += source_[pos_];
+        advance();
+    }
+    return result;
+}
+
+Token Lexer::read_number() {
+    std::string num;
+    int start_col = col_;
+    while (pos_ < source_.size() && (std::isdigit(source_[pos_]) || source_[pos_] == '.')) {
+        num += source_[pos_]; advance();
+    }
+    // Scientific notation
+    if (pos_ < source_.size() && (source_[pos_] == 'e' || source_[pos_] == 'E')) {
+        num += source_[pos_]; advance();
+        if (pos_ < source_.size() && (source_[pos_] == '+' || source_[pos_] == '-')) {
+            num += source_[pos_]; advance();
+        }
+        while (pos_ < source_.size() && std::isdigit(source_[pos_])) {
+            num += source_[pos_]; advance();
+        }
+    }
+    return {TokenType::Number, num, line_, start_col};
+}
+
+Token Lexer::read_string() {
+    std::string str;
+    int start_col = col_;
+    advance(); // skip opening '
+    while (pos_ < source_.size() && source_[pos_] != '\'') {
+        str += source_[pos_]; advance();
+    }
+    if (pos_ < source_.size()) advance(); // skip closing '
+    return {TokenType::String, str, line_, start_col};
+}
+
+Token Lexer::read_identifier() {
+    std::string id;
+    int start_col = col_;
+    while (pos_ < source_.size() && (std::isalnum(source_[pos_]) || source_[pos_] == '_')) {
+        id += source_[pos_]; advance();
+    }
+    // Check keywords
+    auto it = keywords_.find(id);
+    if (it != keywords_.end()) {
+        return {it->second, id, line_, start_col};
+    }
+    return {TokenType::Identifier, id, line_, start_col};
+}
+
+} // namespace interpreter
+} // namespace matlabcpp
@@ -0,0 +1,406 @@
+// MatLabC++ Dense Linear Algebra
+// src/core/linalg.cpp
+//
+// Right-looking blocked LU with partial pivoting (the LAPACK dgetrf
+// layout). Each step factors a tall panel column by column, applies its
+// row swaps to the rest of the matrix, solves for the block row of U and
+// hands the trailing update to gemm. Triangular solves are blocked the
+// same way, so many right-hand sides also run at gemm speed.
+//
+// Cholesky (dpotrf, lower) has the same shape without pivoting: factor
+// the diagonal block, solve for the panel below it, and update only the
+// lower half of the trailing matrix, one block column per gemm.
+
+#include "matlabcpp/linalg.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace matlabcpp {
+
+namespace {
+
+// Panel width / triangular block size
+constexpr size_t kLUBlock = 64;
+
+// Columns per task for swaps and triangular solves
+constexpr size_t kColumnChunk = 32;
+
+// Rows per task when solving for a Cholesky panel
+constexpr size_t kRowChunk = 64;
+
+// Unblocked LU of the m x nb panel at a. piv[k] is relative to the panel
+// top. Zero pivots are skipped (and reported), like LAPACK.
+bool factor_panel(size_t m, size_t nb, double* a, size_t lda, size_t* piv) {
+    bool singular = false;
+    for (size_t k = 0; k < nb && k < m; ++k) {
+        double* col = a + k * lda;
+        size_t p = k;
+        double best = std::fabs(col[k]);
+        for (size_t i = k + 1; i < m; ++i) {
+            if (std::fabs(col[i]) > best) { best = std::fabs(col[i]); p = i; }
+        }
+        piv[k] = p;
+        if (col[p] == 0.0) {
+            singular = true;
+            continue;
+        }
+        if (p != k) {
+            for (size_t j = 0; j < nb; ++j) std::swap(a[k + j * lda], a[p + j * lda]);
+        }
+        double inv = 1.0 / col[k];
+        for (size_t i = k + 1; i < m; ++i) col[i] *= inv;
+        for (size_t j = k + 1; j < nb; ++j) {
+            double* cj = a + j * lda;
+            double f = cj[k];
+            if (f == 0.0) continue;
+            for (size_t i = k + 1; i < m; ++i) cj[i] -= col[i] * f;
+        }
+    }
+    return singular;
+}
+
+// Swaps rows r and piv[r] for r in [lo, hi), in that order, in each of
+// the columns [c_lo, c_hi)
+void swap_rows(double* a, size_t lda, size_t c_lo, size_t c_hi,
+               const size_t* piv, size_t lo, size_t hi) {
+    if (c_lo >= c_hi) return;
+    parallel_for(c_hi - c_lo, kColumnChunk, [&](size_t b, size_t e) {
+        for (size_t c = c_lo + b; c < c_lo + e; ++c) {
+            double* col = a + c * lda;
+            for (size_t r = lo; r < hi; ++r) {
+                if (piv[r] != r) std::swap(col[r], col[piv[r]]);
+            }
+        }
+    });
+}
+
+// B := inv(L) * B for the n x n lower triangle at l (unit diagonal
+// unless told otherwise)
+void solve_lower(size_t n, size_t nrhs, const double* l, size_t ldl, double* b, size_t ldb,
+                 bool unit_diagonal = true) {
+    for (size_t i = 0; i < n; i += kLUBlock) {
+        size_t ib = std::min(kLUBlock, n - i);
+        parallel_for(nrhs, kColumnChunk, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                double* x = b + c * ldb + i;
+                for (size_t k = 0; k < ib; ++k) {
+                    if (!unit_diagonal) x[k] /= l[(i + k) + (i + k) * ldl];
+                    double xk = x[k];
+                    if (xk == 0.0) continue;
+                    const double* lk = l + i + (i + k) * ldl;
+                    for (size_t r = k + 1; r < ib; ++r) x[r] -= lk[r] * xk;
+                }
+            }
+        });
+        if (i + ib < n) {
+            kernels::gemm(n - i - ib, nrhs, ib, -1.0, l + (i + ib) + i * ldl, ldl,
+                          b + i, ldb, 1.0, b + i + ib, ldb);
+        }
+    }
+}
+
+// B := inv(U) * B for the n x n upper triangle at u
+void solve_upper(size_t n, size_t nrhs, const double* u, size_t ldu, double* b, size_t ldb) {
+    size_t blocks = (n + kLUBlock - 1) / kLUBlock;
+    for (size_t blk = blocks; blk-- > 0;) {
+        size_t i = blk * kLUBlock;
+        size_t ib = std::min(kLUBlock, n - i);
+        parallel_for(nrhs, kColumnChunk, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                double* x = b + c * ldb + i;
+                for (size_t k = ib; k-- > 0;) {
+                    const double* uk = u + i + (i + k) * ldu;
+                    x[k] /= uk[k];
+                    double xk = x[k];
+                    if (xk == 0.0) continue;
+                    for (size_t r = 0; r < k; ++r) x[r] -= uk[r] * xk;
+                }
+            }
+        });
+        if (i > 0) {
+            kernels::gemm(i, nrhs, ib, -1.0, u + i * ldu, ldu, b + i, ldb, 1.0, b, ldb);
+        }
+    }
+}
+
+// B := inv(L') * B for the n x n lower triangle at l
+void solve_lower_transposed(size_t n, size_t nrhs, const double* l, size_t ldl, double* b, size_t ldb) {
+    size_t blocks = (n + kLUBlock - 1) / kLUBlock;
+    for (size_t blk = blocks; blk-- > 0;) {
+        size_t i = blk * kLUBlock;
+        size_t ib = std::min(kLUBlock, n - i);
+        parallel_for(nrhs, kColumnChunk, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                double* x = b + c * ldb + i;
+                for (size_t k = ib; k-- > 0;) {
+                    const double* lk = l + i + (i + k) * ldl;
+                    double xk = x[k];
+                    for (size_t r = k + 1; r < ib; ++r) xk -= lk[r] * x[r];
+                    x[k] = xk / lk[k];
+                }
+            }
+        });
+        if (i > 0) {
+            kernels::gemm(true, false, i, nrhs, ib, -1.0, l + i, ldl, b + i, ldb, 1.0, b, ldb);
+        }
+    }
+}
+
+// Unblocked Cholesky of the n x n lower triangle at a (dpotf2); false at
+// the first pivot that is not positive
+bool factor_cholesky_block(size_t n, double* a, size_t lda) {
+    for (size_t k = 0; k < n; ++k) {
+        double* col = a + k * lda;
+        if (!(col[k] > 0.0)) return false;      // also catches NaN
+        col[k] = std::sqrt(col[k]);
+        double inv = 1.0 / col[k];
+        for (size_t i = k + 1; i < n; ++i) col[i] *= inv;
+        for (size_t j = k + 1; j < n; ++j) {
+            double* cj = a + j * lda;
+            double f = col[j];
+            if (f == 0.0) continue;
+            for (size_t i = j; i < n; ++i) cj[i] -= col[i] * f;
+        }
+    }
+    return true;
+}
+
+enum class Structure { Upper, Lower, Symmetric, General };
+
+// What backslash can exploit. Diagonal matrices count as upper; symmetric
+// needs a positive diagonal to be worth trying Cholesky.
+Structure classify(const Array& A) {
+    const size_t n = A.rows();
+    const double* a = A.data();
+    bool upper = true, lower = true, symmetric = true;
+    for (size_t j = 0; j < n && (upper || lower || symmetric); ++j) {
+        if (!(a[j + j * n] > 0.0)) symmetric = false;
+        for (size_t i = j + 1; i < n; ++i) {
+            double below = a[i + j * n], above = a[j + i * n];
+            if (below != 0.0) upper = false;
+            if (above != 0.0) lower = false;
+            if (below != above) symmetric = false;
+        }
+    }
+    if (upper) return Structure::Upper;
+    if (lower) return Structure::Lower;
+    return symmetric ? Structure::Symmetric : Structure::General;
+}
+
+// Substitution for triangular A; throws like LU when a pivot is zero
+Array solve_triangular(const Array& A, const Array& B, bool upper) {
+    const size_t n = A.rows();
+    for (size_t i = 0; i < n; ++i) {
+        if (A(i, i) == 0.0) throw std::runtime_error("Matrix is singular to working precision");
+    }
+    Array X = B;
+    if (n == 0) return X;
+    if (upper) {
+        solve_upper(n, X.cols(), A.data(), n, X.mutable_data(), n);
+    } else {
+        solve_lower(n, X.cols(), A.data(), n, X.mutable_data(), n, false);
+    }
+    return X;
+}
+
+void require_square(const Array& A, const char* what) {
+    if (A.ndims() > 2 || A.rows() != A.cols()) {
+        throw std::runtime_error(std::string(what) + ": matrix must be square");
+    }
+}
+
+} // namespace
+
+// ========== LU FACTORIZATION ==========
+
+LUFactorization::LUFactorization(Array A) : lu_(std::move(A)) {
+    require_square(lu_, "LU factorization");
+    n_ = lu_.rows();
+    pivots_.resize(n_);
+    if (n_ == 0) return;
+
+    double* a = lu_.mutable_data();
+    const size_t n = n_;
+    for (size_t j = 0; j < n; j += kLUBlock) {
+        size_t jb = std::min(kLUBlock, n - j);
+        double* panel = a + j + j * n;
+
+        if (factor_panel(n - j, jb, panel, n, pivots_.data() + j)) singular_ = true;
+        for (size_t k = j; k < j + jb; ++k) pivots_[k] += j;
+
+        // Same swaps on the columns left and right of the panel
+        swap_rows(a, n, 0, j, pivots_.data(), j, j + jb);
+        swap_rows(a, n, j + jb, n, pivots_.data(), j, j + jb);
+
+        if (j + jb < n) {
+            // U12 = inv(L11) * A12, then A22 -= L21 * U12
+            size_t rest = n - j - jb;
+            double* a12 = a + j + (j + jb) * n;
+            solve_lower(jb, rest, panel, n, a12, n);
+            kernels::gemm(rest, rest, jb, -1.0, panel + jb, n, a12, n, 1.0, a12 + jb, n);
+        }
+    }
+}
+
+void LUFactorization::solve_in_place(double* B, size_t ldb, size_t nrhs) const {
+    if (singular_) throw std::runtime_error("Matrix is singular to working precision");
+    if (n_ == 0 || nrhs == 0) return;
+    swap_rows(B, ldb, 0, nrhs, pivots_.data(), 0, n_);
+    solve_lower(n_, nrhs, lu_.data(), n_, B, ldb);
+    solve_upper(n_, nrhs, lu_.data(), n_, B, ldb);
+}
+
+Array LUFactorization::solve(const Array& B) const {
+    if (B.ndims() > 2 || B.rows() != n_) {
+        throw std::runtime_error("Matrix dimensions must agree");
+    }
+    Array X = B;
+    solve_in_place(X.mutable_data(), n_, X.cols());
+    return X;
+}
+
+Array LUFactorization::inverse() const {
+    Array I(n_, n_);
+    double* p = I.mutable_data();
+    for (size_t i = 0; i < n_; ++i) p[i + i * n_] = 1.0;
+    solve_in_place(p, n_, n_);
+    return I;
+}
+
+double LUFactorization::determinant() const {
+    double det = 1.0;
+    for (size_t i = 0; i < n_; ++i) {
+        det *= lu_(i, i);
+        if (pivots_[i] != i) det = -det;
+    }
+    return det;
+}
+
+// ========== CHOLESKY FACTORIZATION ==========
+
+CholeskyFactorization::CholeskyFactorization(Array A) : l_(std::move(A)) {
+    require_square(l_, "Cholesky factorization");
+    n_ = l_.rows();
+    if (n_ == 0) return;
+
+    double* a = l_.mutable_data();
+    const size_t n = n_;
+    for (size_t j = 0; j < n && positive_definite_; j += kLUBlock) {
+        size_t jb = std::min(kLUBlock, n - j);
+        double* a11 = a + j + j * n;
+        if (!factor_cholesky_block(jb, a11, n)) {
+            positive_definite_ = false;
+            break;
+        }
+        if (j + jb == n) break;
+
+        // L21 = A21 * inv(L11'), by rows
+        size_t rest = n - j - jb;
+        double* a21 = a11 + jb;
+        parallel_for(rest, kRowChunk, [&](size_t lo, size_t hi) {
+            for (size_t k = 0; k < jb; ++k) {
+                double* ck = a21 + k * n;
+                double inv = 1.0 / a11[k + k * n];
+                for (size_t i = lo; i < hi; ++i) ck[i] *= inv;
+                for (size_t c = k + 1; c < jb; ++c) {
+                    double f = a11[c + k * n];
+                    double* cc = a21 + c * n;
+                    for (size_t i = lo; i < hi; ++i) cc[i] -= ck[i] * f;
+                }
+            }
+        });
+
+        // A22 -= L21 * L21' on and below the diagonal
+        double* a22 = a21 + jb * n;
+        for (size_t c = 0; c < rest; c += kLUBlock) {
+            size_t cb = std::min(kLUBlock, rest - c);
+            kernels::gemm(false, true, rest - c, cb, jb, -1.0, a21 + c, n, a21 + c, n,
+                          1.0, a22 + c + c * n, n);
+        }
+    }
+
+    // The diagonal-block updates also wrote above the diagonal
+    for (size_t j = 1; j < n; ++j) std::fill(a + j * n, a + j * n + j, 0.0);
+}
+
+void CholeskyFactorization::solve_in_place(double* B, size_t ldb, size_t nrhs) const {
+    if (!positive_definite_) throw std::runtime_error("Matrix must be positive definite");
+    if (n_ == 0 || nrhs == 0) return;
+    solve_lower(n_, nrhs, l_.data(), n_, B, ldb, false);
+    solve_lower_transposed(n_, nrhs, l_.data(), n_, B, ldb);
+}
+
+Array CholeskyFactorization::solve(const Array& B) const {
+    if (B.ndims() > 2 || B.rows() != n_) {
+        throw std::runtime_error("Matrix dimensions must agree");
+    }
+    Array X = B;
+    solve_in_place(X.mutable_data(), n_, X.cols());
+    return X;
+}
+
+Array CholeskyFactorization::inverse() const {
+    Array I(n_, n_);
+    double* p = I.mutable_data();
+    for (size_t i = 0; i < n_; ++i) p[i + i * n_] = 1.0;
+    solve_in_place(p, n_, n_);
+    return I;
+}
+
+double CholeskyFactorization::determinant() const {
+    if (!positive_definite_) throw std::runtime_error("Matrix must be positive definite");
+    double det = 1.0;
+    for (size_t i = 0; i < n_; ++i) det *= l_(i, i) * l_(i, i);
+    return det;
+}
+
+// ========== OPERATORS ==========
+
+bool is_symmetric(const Array& A) {
+    if (A.ndims() > 2 || A.rows() != A.cols()) return false;
+    const size_t n = A.rows();
+    const double* a = A.data();
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = j + 1; i < n; ++i) {
+            if (a[i + j * n] != a[j + i * n]) return false;
+        }
+    }
+    return true;
+}
+
+Array left_divide(const Array& A, const Array& B) {
+    require_square(A, "Operator '\\'");
+    if (B.ndims() > 2 || B.rows() != A.rows()) {
+        throw std::runtime_error("Operator '\\': matrix dimensions must agree");
+    }
+    switch (classify(A)) {
+        case Structure::Upper:
+            return solve_triangular(A, B, true);
+        case Structure::Lower:
+            return solve_triangular(A, B, false);
+        case Structure::Symmetric: {
+            CholeskyFactorization chol(A);
+            if (chol.positive_definite()) return chol.solve(B);
+            break;
+        }
+        case Structure::General:
+            break;
+    }
+    return LUFactorization(A).solve(B);
+}
+
+// X * A = B  <=>  A' * X' = B'
+Array right_divide(const Array& B, const Array& A) {
+    require_square(A, "Operator '/'");
+    if (B.ndims() > 2 || B.cols() != A.cols()) {
+        throw std::runtime_error("Operator '/': matrix dimensions must agree");
+    }
+    return left_divide(A.transpose(), B.transpose()).transpose();
+}
+
+} // namespace matlabcpp
@@ -0,0 +1,611 @@
+// MatLabC++ Compiled Script Cache
+// src/core/script_cache.cpp
+//
+// Entry file layout (native endianness, one file per key):
+//   EntryHeader
+//   Instruction    code[n_code]
+//   StatementInfo  statements[n_statements]
+//   FusedKernel    fused[n_fused]
+//   uint32_t       fused_inputs[n_fused_inputs]
+//   FusedOp        fused_ops[n_fused_ops]
+//   double         constants[n_constants]
+//   uint32_t       string_sizes[n_strings + n_symbols]
+//   char           string_bytes[...]      (strings, then symbols)
+
+#include "matlabcpp/script_cache.hpp"
+#include "matlabcpp/kernels.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+#ifndef MATLABCPP_VERSION
+#define MATLABCPP_VERSION "unknown"
+#endif
+
+namespace fs = std::filesystem;
+
+namespace matlabcpp {
+namespace interpreter {
+
+namespace {
+
+constexpr char kMagic[8] = {'M', 'L', 'C', 'P', 'P', 'B', 'C', '\0'};
+
+struct EntryHeader {
+    char magic[8];
+    uint32_t format;
+    uint32_t header_size;
+    uint64_t key;
+    uint64_t source_size;
+    uint64_t source_check;  // source_hash(), independent of the FNV key
+    uint64_t source_lines;
+    uint64_t payload_size;
+    uint64_t payload_hash;
+    uint32_t n_code;
+    uint32_t n_statements;
+    uint32_t n_constants;
+    uint32_t n_strings;
+    uint32_t num_registers;
+    uint32_t n_symbols;
+    uint32_t n_fused;
+    uint32_t n_fused_inputs;
+    uint32_t n_fused_ops;
+    uint32_t reserved;
+};
+
+static_assert(std::is_trivially_copyable<Instruction>::value, "Instruction must be POD");
+static_assert(std::is_trivially_copyable<StatementInfo>::value, "StatementInfo must be POD");
+static_assert(std::is_trivially_copyable<FusedKernel>::value, "FusedKernel must be POD");
+static_assert(std::is_trivially_copyable<FusedOp>::value, "FusedOp must be POD");
+static_assert(sizeof(Instruction) == 16, "unexpected Instruction layout");
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t fnv1a(const void* data, size_t size, uint64_t hash = kFnvOffset) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= p[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+// Second hash of the source, so an FNV key collision between two sources
+// of equal length cannot hand one the other's bytecode: 8-byte words
+// folded through the SplitMix64 finalizer
+uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+uint64_t source_hash(const std::string& source) {
+    uint64_t h = mix64(0x9e3779b97f4a7c15ull ^ source.size());
+    size_t i = 0;
+    for (; i + 8 <= source.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, source.data() + i, 8);
+        h = mix64(h ^ word) + 0x9e3779b97f4a7c15ull;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, source.data() + i, source.size() - i);
+    return mix64(h ^ tail);
+}
+
+template <typename T>
+void append(std::string& out, const T* data, size_t count) {
+    if (count) out.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+// Whole entry file in one read; empty if it cannot be read. decode()
+// copies everything it keeps, so a mapping would only add a syscall pair.
+std::string read_file(const fs::path& path) {
+    std::string bytes;
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return bytes;
+    std::streamoff size = in.tellg();
+    if (size <= 0) return bytes;
+    bytes.resize(static_cast<size_t>(size));
+    in.seekg(0);
+    if (!in.read(&bytes[0], size)) bytes.clear();
+    return bytes;
+}
+
+// Every index the VM follows without checking, checked once here, so an
+// entry that passes the hash but was written by a different compiler (or
+// damaged in a way the hash missed) cannot send the VM out of bounds
+bool in_bounds(const CompiledScript& s) {
+    const uint64_t code = s.code.size(), regs = s.num_registers;
+    const uint64_t consts = s.constants.size(), strings = s.strings.size(), symbols = s.symbols.size();
+    auto reg = [&](uint64_t r, uint64_t count = 1) { return r + count <= regs; };
+    auto target = [&](uint64_t pc) { return pc < code; };
+    auto operand = [&](uint32_t op) {
+        if ((op & kConstBit) && (op & kSlotBit)) return false;
+        if (op & kConstBit) return (op & kOperandMask) < consts;
+        if (op & kSlotBit) return (op & kOperandMask) < symbols;
+        return reg(op);
+    };
+
+    if (s.code.empty() || s.code.back().op != OpCode::Halt) return false;
+    for (const auto& st : s.statements) {
+        if (st.begin > st.end || st.end > code || st.resume > code) return false;
+    }
+
+    for (const Instruction& in : s.code) {
+        bool ok = false;
+        switch (in.op) {
+            case OpCode::Nop:
+            case OpCode::Halt:
+                ok = true;
+                break;
+            case OpCode::LoadConst:
+                ok = reg(in.a) && in.b < consts;
+                break;
+            case OpCode::LoadVar:
+                ok = reg(in.a) && in.b < symbols;
+                break;
+            case OpCode::StoreVar:
+                ok = operand(in.a) && in.b < symbols;
+                break;
+            case OpCode::Move:
+                ok = reg(in.a) && ((in.b & kConstBit) ? (in.b & kOperandMask) < consts : reg(in.b));
+                break;
+            case OpCode::Neg: case OpCode::Not: case OpCode::Transpose:
+                ok = reg(in.a) && operand(in.b);
+                break;
+            case OpCode::Add: case OpCode::Sub: case OpCode::Mul: case OpCode::Div: case OpCode::LeftDiv:
+            case OpCode::Pow:
+            case OpCode::ElemMul: case OpCode::ElemDiv: case OpCode::ElemPow:
+            case OpCode::Eq: case OpCode::Ne: case OpCode::Lt: case OpCode::Le: case OpCode::Gt: case OpCode::Ge:
+            case OpCode::And: case OpCode::Or:
+                ok = reg(in.a) && operand(in.b) && operand(in.c);
+                break;
+            case OpCode::Range:
+                ok = reg(in.a) && (in.n == 2 || in.n == 3) && reg(in.b, in.n);
+                break;
+            case OpCode::HorzCat: case OpCode::VertCat:
+                ok = reg(in.a) && reg(in.b, in.c);
+                break;
+            case OpCode::CallOrIndex: case OpCode::StoreIndex:
+                ok = reg(in.a) && reg(in.b, in.n) && in.c < symbols;
+                break;
+            case OpCode::Fused:
+                ok = reg(in.a) && in.b < s.fused.size() && target(in.c);
+                break;
+            case OpCode::EndOf:
+                ok = reg(in.a) && in.b < symbols;
+                break;
+            case OpCode::Jump:
+                ok = target(in.a);
+                break;
+            case OpCode::JumpIfFalse: case OpCode::JumpIfTrue:
+                ok = operand(in.a) && target(in.b);
+                break;
+            case OpCode::ForRangePrep:
+                ok = reg(in.a, 5);
+                break;
+            case OpCode::ForRangeNext:
+                ok = reg(in.a, 5) && in.b < symbols && target(in.c);
+                break;
+            case OpCode::ForEachPrep:
+                ok = reg(in.a, 2);
+                break;
+            case OpCode::ForEachNext:
+                ok = reg(in.a, 2) && in.b < symbols && target(in.c);
+                break;
+            case OpCode::Display:
+                ok = in.b < symbols && in.n <= static_cast<uint8_t>(DisplayMode::Ans);
+                break;
+            case OpCode::Command: case OpCode::EvalText: case OpCode::Section: case OpCode::Raise:
+                ok = in.b < strings;
+                break;
+            default:                    // an opcode this build does not have
+                break;
+        }
+        if (!ok) return false;
+    }
+
+    for (const auto& k : s.fused) {
+        if (k.n_ops == 0 || uint64_t(k.first_input) + k.n_inputs > s.fused_inputs.size() ||
+            uint64_t(k.first_op) + k.n_ops > s.fused_ops.size()) {
+            return false;
+        }
+        for (uint32_t i = 0; i < k.n_inputs; i++) {
+            if (!operand(s.fused_inputs[k.first_input + i])) return false;
+        }
+        // Op j reads leaf operands and the results of ops before it
+        for (uint32_t j = 0; j < k.n_ops; j++) {
+            const FusedOp& op = s.fused_ops[k.first_op + j];
+            const uint64_t values = uint64_t(k.n_inputs) + j;
+            bool ok = op.x < values;
+            switch (op.op) {
+                case OpCode::Neg: case OpCode::Not:
+                    break;
+                case OpCode::CallOrIndex:
+                    ok = ok && op.y < symbols && op.fn <= static_cast<uint8_t>(kernels::UnaryOp::Round);
+                    break;
+                case OpCode::Add: case OpCode::Sub: case OpCode::Mul: case OpCode::Div: case OpCode::Pow:
+                case OpCode::ElemMul: case OpCode::ElemDiv: case OpCode::ElemPow:
+                case OpCode::Eq: case OpCode::Ne: case OpCode::Lt: case OpCode::Le: case OpCode::Gt: case OpCode::Ge:
+                case OpCode::And: case OpCode::Or:
+                    ok = ok && op.y < values;
+                    break;
+                default:
+                    ok = false;
+                    break;
+            }
+            if (!ok) return false;
+        }
+    }
+    return true;
+}
+
+// Parse and validate an entry for `source`; nullopt if anything looks wrong
+std::optional<CompiledScript> decode(const std::string& bytes, uint64_t key,
+                                     const std::string& source) {
+    const char* data = bytes.data();
+    size_t size = bytes.size();
+    if (size < sizeof(EntryHeader)) return std::nullopt;
+
+    EntryHeader h;
+    std::memcpy(&h, data, sizeof h);
+    if (std::memcmp(h.magic, kMagic, sizeof kMagic) != 0 ||
+        h.format != kBytecodeVersion || h.header_size != sizeof(EntryHeader) ||
+        h.key != key || h.source_size != source.size() ||
+        h.source_check != source_hash(source) ||
+        h.payload_size != size - sizeof(EntryHeader)) {
+        return std::nullopt;
+    }
+
+    const char* p = data + sizeof(EntryHeader);
+    const char* end = data + size;
+    if (fnv1a(p, h.payload_size) != h.payload_hash) return std::nullopt;
+
+    uint64_t fixed = uint64_t(h.n_code) * sizeof(Instruction) +
+                     uint64_t(h.n_statements) * sizeof(StatementInfo) +
+                     uint64_t(h.n_fused) * sizeof(FusedKernel) +
+                     uint64_t(h.n_fused_inputs) * sizeof(uint32_t) +
+                     uint64_t(h.n_fused_ops) * sizeof(FusedOp) +
+                     uint64_t(h.n_constants) * sizeof(double) +
+                     (uint64_t(h.n_strings) + h.n_symbols) * sizeof(uint32_t);
+    if (fixed > h.payload_size) return std::nullopt;
+
+    CompiledScript s;
+    s.num_registers = h.num_registers;
+    s.source_lines = static_cast<size_t>(h.source_lines);
+
+    s.code.resize(h.n_code);
+    if (h.n_code) std::memcpy(s.code.data(), p, h.n_code * sizeof(Instruction));
+    p += h.n_code * sizeof(Instruction);
+
+    s.statements.resize(h.n_statements);
+    if (h.n_statements) std::memcpy(s.statements.data(), p, h.n_statements * sizeof(StatementInfo));
+    p += h.n_statements * sizeof(StatementInfo);
+
+    auto read_table = [&p](auto& table, uint32_t count) {
+        using T = typename std::decay_t<decltype(table)>::value_type;
+        table.resize(count);
+        if (count) std::memcpy(table.data(), p, count * sizeof(T));
+        p += count * sizeof(T);
+    };
+    read_table(s.fused, h.n_fused);
+    read_table(s.fused_inputs, h.n_fused_inputs);
+    read_table(s.fused_ops, h.n_fused_ops);
+
+    s.constants.reserve(h.n_constants);
+    for (uint32_t i = 0; i < h.n_constants; ++i, p += sizeof(double)) {
+        double v;
+        std::memcpy(&v, p, sizeof v);
+        s.constants.emplace_back(v);
+    }
+
+    const char* sizes = p;
+    uint64_t n_names = uint64_t(h.n_strings) + h.n_symbols;
+    p += n_names * sizeof(uint32_t);
+    s.strings.reserve(h.n_strings);
+    s.symbols.reserve(h.n_symbols);
+    for (uint64_t i = 0; i < n_names; ++i) {
+        uint32_t len;
+        std::memcpy(&len, sizes + i * sizeof(uint32_t), sizeof len);
+        if (len > static_cast<size_t>(end - p)) return std::nullopt;
+        (i < h.n_strings ? s.strings : s.symbols).emplace_back(p, len);
+        p += len;
+    }
+    if (p != end) return std::nullopt;
+
+    if (!in_bounds(s)) return std::nullopt;
+    return s;
+}
+
+std::string encode(const CompiledScript& s, uint64_t key, const std::string& source) {
+    std::string payload;
+    append(payload, s.code.data(), s.code.size());
+    append(payload, s.statements.data(), s.statements.size());
+    append(payload, s.fused.data(), s.fused.size());
+    append(payload, s.fused_inputs.data(), s.fused_inputs.size());
+    append(payload, s.fused_ops.data(), s.fused_ops.size());
+    for (const auto& c : s.constants) {
+        double v = c.as_scalar();
+        append(payload, &v, 1);
+    }
+    for (const auto* table : {&s.strings, &s.symbols}) {
+        for (const auto& str : *table) {
+            uint32_t len = static_cast<uint32_t>(str.size());
+            append(payload, &len, 1);
+        }
+    }
+    for (const auto& str : s.strings) payload += str;
+    for (const auto& str : s.symbols) payload += str;
+
+    EntryHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof kMagic);
+    h.format = kBytecodeVersion;
+    h.header_size = sizeof(EntryHeader);
+    h.key = key;
+    h.source_size = source.size();
+    h.source_check = source_hash(source);
+    h.source_lines = s.source_lines;
+    h.payload_size = payload.size();
+    h.payload_hash = fnv1a(payload.data(), payload.size());
+    h.n_code = static_cast<uint32_t>(s.code.size());
+    h.n_statements = static_cast<uint32_t>(s.statements.size());
+    h.n_constants = static_cast<uint32_t>(s.constants.size());
+    h.n_strings = static_cast<uint32_t>(s.strings.size());
+    h.num_registers = s.num_registers;
+    h.n_symbols = static_cast<uint32_t>(s.symbols.size());
+    h.n_fused = static_cast<uint32_t>(s.fused.size());
+    h.n_fused_inputs = static_cast<uint32_t>(s.fused_inputs.size());
+    h.n_fused_ops = static_cast<uint32_t>(s.fused_ops.size());
+
+    std::string out(reinterpret_cast<const char*>(&h), sizeof h);
+    out += payload;
+    return out;
+}
+
+ScriptCache::Stats parse_stats(const std::string& text) {
+    ScriptCache::Stats st;
+    std::istringstream in(text);
+    std::string name;
+    uint64_t value;
+    while (in >> name >> value) {
+        if (name == "hits") st.hits = value;
+        else if (name == "misses") st.misses = value;
+        else if (name == "stores") st.stores = value;
+        else if (name == "rejected") st.rejected = value;
+    }
+    return st;
+}
+
+std::string format_stats(const ScriptCache::Stats& st) {
+    std::ostringstream out;
+    out << "hits " << st.hits << "\n"
+        << "misses " << st.misses << "\n"
+        << "stores " << st.stores << "\n"
+        << "rejected " << st.rejected << "\n";
+    return out.str();
+}
+
+} // anonymous namespace
+
+// ========== SCRIPT CACHE ==========
+
+ScriptCache::ScriptCache(fs::path directory, bool record_stats)
+    : dir_(std::move(directory)), record_stats_(record_stats) {}
+
+fs::path ScriptCache::default_directory() {
+    if (const char* dir = std::getenv("MATLABCPP_CACHE_DIR"); dir && *dir) {
+        return fs::path(dir);
+    }
+#ifdef _WIN32
+    const char* home = std::getenv("USERPROFILE");
+#else
+    const char* home = std::getenv("HOME");
+#endif
+    if (!home || !*home) return {};
+    return fs::path(home) / ".matlabcpp" / "cache";
+}
+
+uint64_t ScriptCache::key(const std::string& source) {
+    static const std::string salt = std::string("matlabcpp ") + MATLABCPP_VERSION +
+                                    " bytecode " + std::to_string(kBytecodeVersion);
+    uint64_t h = fnv1a(salt.data(), salt.size() + 1);
+    return fnv1a(source.data(), source.size(), h);
+}
+
+fs::path ScriptCache::entry_path(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof name, "%016llx.mlbc", static_cast<unsigned long long>(key));
+    return dir_ / name;
+}
+
+std::optional<CompiledScript> ScriptCache::load(const std::string& source) {
+    if (!enabled()) return std::nullopt;
+
+    uint64_t k = key(source);
+    fs::path path = entry_path(k);
+    std::error_code ec;
+    if (!fs::exists(path, ec)) {
+        stats_.misses++;
+        record({0, 1, 0, 0});
+        return std::nullopt;
+    }
+
+    std::optional<CompiledScript> script = decode(read_file(path), k, source);
+
+    if (!script) {
+        stats_.misses++;
+        stats_.rejected++;
+        record({0, 1, 0, 1});
+        fs::remove(path, ec);
+        return std::nullopt;
+    }
+
+    stats_.hits++;
+    record({1, 0, 0, 0});
+    return script;
+}
+
+bool ScriptCache::store(const std::string& source, const CompiledScript& script) {
+    if (!enabled()) return false;
+
+    // The entry format only carries scalar constants (all the compiler emits)
+    for (const auto& c : script.constants) {
+        if (!c.is_scalar()) return false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (ec) return false;
+
+    uint64_t k = key(source);
+    std::string bytes = encode(script, k, source);
+
+    // Write then rename, so concurrent runs never read a half-written entry
+    fs::path final_path = entry_path(k);
+    fs::path tmp_path = final_path;
+    tmp_path += ".tmp" + std::to_string(getpid());
+    {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        if (!out) {
+            out.close();
+            fs::remove(tmp_path, ec);
+            return false;
+        }
+    }
+    fs::rename(tmp_path, final_path, ec);
+    if (ec) {
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+
+    stats_.stores++;
+    record({0, 0, 1, 0});
+    return true;
+}
+
+CompiledScript ScriptCache::get_or_compile(const std::string& source, bool* hit) {
+    if (auto cached = load(source)) {
+        if (hit) *hit = true;
+        return std::move(*cached);
+    }
+    if (hit) *hit = false;
+    CompiledScript script = compile(source);
+    store(source, script);
+    return script;
+}
+
+size_t ScriptCache::clear() {
+    if (!enabled()) return 0;
+    size_t removed = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() == ".mlbc" && fs::remove(it->path(), ec)) removed++;
+    }
+    return removed;
+}
+
+// Persistent counters live in <dir>/stats as "name value" lines. Updates
+// are serialized with an advisory lock where the platform has one, and
+// happen only for caches that asked to record.
+void ScriptCache::record(const Stats& delta) {
+    if (!record_stats_) return;
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    if (ec) return;
+    fs::path path = dir_ / "stats";
+
+#ifdef _WIN32
+    Stats st = persistent_stats();
+    st.hits += delta.hits;
+    st.misses += delta.misses;
+    st.stores += delta.stores;
+    st.rejected += delta.rejected;
+    std::ofstream out(path, std::ios::trunc);
+    out << format_stats(st);
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return;
+    if (::flock(fd, LOCK_EX) == 0) {
+        std::string text;
+        char buf[256];
+        ssize_t n;
+        while ((n = ::read(fd, buf, sizeof buf)) > 0) text.append(buf, static_cast<size_t>(n));
+
+        Stats st = parse_stats(text);
+        st.hits += delta.hits;
+        st.misses += delta.misses;
+        st.stores += delta.stores;
+        st.rejected += delta.rejected;
+
+        std::string out = format_stats(st);
+        if (::ftruncate(fd, 0) == 0 && ::lseek(fd, 0, SEEK_SET) == 0) {
+            ssize_t written = ::write(fd, out.data(), out.size());
+            (void)written;
+        }
+        ::flock(fd, LOCK_UN);
+    }
+    ::close(fd);
+#endif
+}
+
+ScriptCache::Stats ScriptCache::persistent_stats() const {
+    if (!enabled()) return {};
+    std::ifstream in(dir_ / "stats");
+    if (!in) return {};
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return parse_stats(text);
+}
+
+void ScriptCache::reset_persistent_stats() {
+    if (!enabled()) return;
+    std::error_code ec;
+    fs::remove(dir_ / "stats", ec);
+}
+
+void ScriptCache::print_stats(std::ostream& os) const {
+    Stats total = persistent_stats();
+    uint64_t lookups = total.hits + total.misses;
+
+    size_t entries = 0;
+    uintmax_t bytes = 0;
+    std::error_code ec;
+    if (enabled()) {
+        for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->path().extension() != ".mlbc") continue;
+            entries++;
+            bytes += it->file_size(ec);
+        }
+    }
+
+    os << "Bytecode cache: " << (enabled() ? dir_.string() : std::string("(disabled)")) << "\n";
+    os << "  Entries:  " << entries << " (" << bytes << " bytes)\n";
+    os << "  Hits:     " << total.hits << "\n";
+    os << "  Misses:   " << total.misses << "\n";
+    os << "  Stores:   " << total.stores << "\n";
+    os << "  Rejected: " << total.rejected << "\n";
+    if (lookups > 0) {
+        std::ostringstream rate;  // independent of the caller's stream formatting
+        rate << (100.0 * total.hits / lookups);
+        os << "  Hit rate: " << rate.str() << "%\n";
+    }
+}
+
+} // namespace interpreter
+} // namespace matlabcpp
@@ -0,0 +1,403 @@
+// MatLabC++ Signal Processing
+// src/core/signal_processing.cpp
+//
+// SignalProcessing and the streaming engines from advanced.hpp. Spectra of
+// real signals go through fft::RealPlan, so only the n/2 + 1
+// non-redundant bins are computed.
+//
+// Butterworth filters are designed from the analog prototype poles
+// exp(i*pi*(2k + N + 1) / 2N), moved to the band (s -> s/w, w/s, or
+// (s^2 + w0^2) / (s*bw)) at prewarped edges w = tan(pi*f/fs), and mapped
+// with the bilinear transform z = (1 + s) / (1 - s). Conjugate pole pairs
+// become biquads, each scaled to unit gain at the middle of the passband.
+
+#include "matlabcpp/advanced.hpp"
+#include "matlabcpp/fft.hpp"
+#include "matlabcpp/kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace matlabcpp {
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Smallest FFT used by StreamingConvolver when it picks the block size
+constexpr size_t kMinConvolutionFFT = 256;
+
+// Kernels up to this length are convolved directly
+constexpr size_t kDirectConvolutionTaps = 128;
+
+using Complex = std::complex<double>;
+
+enum class Band { Low, High, Pass };
+
+double prewarp(double f, double fs) {
+    if (!(fs > 0.0) || !(f > 0.0 && f < fs / 2.0)) {
+        throw std::runtime_error("Butterworth: cutoff must lie strictly between 0 and fs/2");
+    }
+    return std::tan(kPi * f / fs);
+}
+
+Complex response(const Biquad& s, Complex z) {
+    Complex zi = 1.0 / z;
+    return (s.b0 + zi * (s.b1 + zi * s.b2)) / (1.0 + zi * (s.a1 + zi * s.a2));
+}
+
+std::vector<Biquad> butterworth(int order, Band band, double w1, double w2 = 0.0) {
+    if (order < 1) throw std::runtime_error("Butterworth: order must be positive");
+    const size_t n = static_cast<size_t>(order);
+
+    std::vector<Complex> poles;
+    for (size_t k = 0; k < n; ++k) {
+        Complex p = std::polar(1.0, kPi * static_cast<double>(2 * k + n + 1) / static_cast<double>(2 * n));
+        if (band == Band::Low) {
+            poles.push_back(w1 * p);
+        } else if (band == Band::High) {
+            poles.push_back(w1 / p);
+        } else {
+            double w0 = std::sqrt(w1 * w2), bw = w2 - w1;
+            Complex d = std::sqrt(p * p * bw * bw - 4.0 * w0 * w0);
+            poles.push_back((p * bw + d) / 2.0);
+            poles.push_back((p * bw - d) / 2.0);
+        }
+    }
+
+    // Upper-half-plane poles pair with their conjugates; real ones pair up
+    // with each other, and an odd one out is a first-order section
+    std::vector<Complex> upper;
+    std::vector<double> real;
+    for (Complex s : poles) {
+        Complex z = (1.0 + s) / (1.0 - s);
+        if (std::abs(z.imag()) <= 1e-12 * std::abs(z)) {
+            real.push_back(z.real());
+        } else if (z.imag() > 0.0) {
+            upper.push_back(z);
+        }
+    }
+
+    Complex reference = band == Band::Low ? 1.0 : band == Band::High ? -1.0
+                                             : std::polar(1.0, 2.0 * std::atan(std::sqrt(w1 * w2)));
+    double zero_sign = band == Band::Low ? 1.0 : -1.0;      // (1 +- z^-1)
+    auto section = [&](double a1, double a2, bool first_order) {
+        Biquad s{};
+        if (first_order) {
+            s = {1.0, zero_sign, 0.0, a1, 0.0};
+        } else if (band == Band::Pass) {
+            s = {1.0, 0.0, -1.0, a1, a2};
+        } else {
+            s = {1.0, 2.0 * zero_sign, 1.0, a1, a2};
+        }
+        double g = 1.0 / std::abs(response(s, reference));
+        s.b0 *= g;
+        s.b1 *= g;
+        s.b2 *= g;
+        return s;
+    };
+
+    std::vector<Biquad> sos;
+    for (Complex z : upper) sos.push_back(section(-2.0 * z.real(), std::norm(z), false));
+    size_t i = 0;
+    for (; i + 1 < real.size(); i += 2) sos.push_back(section(-(real[i] + real[i + 1]), real[i] * real[i + 1], false));
+    if (i < real.size()) sos.push_back(section(-real[i], 0.0, true));
+    return sos;
+}
+
+// Direct form II transposed, one section at a time over the whole buffer.
+// With x0 != 0 each section starts in the steady state for a constant
+// input x0 (the lfilter_zi / filtfilt initial conditions).
+void filter_in_place(const std::vector<Biquad>& sos, double* x, size_t n, double x0) {
+    double level = x0;
+    for (const Biquad& s : sos) {
+        double z1 = 0.0, z2 = 0.0;
+        if (level != 0.0) {
+            double g = (s.b0 + s.b1 + s.b2) / (1.0 + s.a1 + s.a2);
+            z1 = (g - s.b0) * level;
+            z2 = (s.b2 - s.a2 * g) * level;
+            level *= g;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            double in = x[i];
+            double out = s.b0 * in + z1;
+            z1 = s.b1 * in - s.a1 * out + z2;
+            z2 = s.b2 * in - s.a2 * out;
+            x[i] = out;
+        }
+    }
+}
+
+} // namespace
+
+// Single-sided spectrum: bin k is at k * fs / n, magnitude is the
+// amplitude of that component (|X| / n, doubled for bins that also
+// appear mirrored above Nyquist)
+FFTResult SignalProcessing::fft(const std::vector<double>& signal, double fs) {
+    FFTResult result{};
+    const size_t n = signal.size();
+    if (n == 0) return result;
+
+    auto plan = fft::RealPlan::get(n);
+    std::vector<fft::Complex> spectrum(plan->spectrum_size());
+    plan->forward(signal.data(), spectrum.data());
+
+    const size_t bins = spectrum.size();
+    result.frequency.resize(bins);
+    result.magnitude.resize(bins);
+    result.phase.resize(bins);
+    for (size_t k = 0; k < bins; ++k) {
+        bool mirrored = k != 0 && 2 * k != n;
+        result.frequency[k] = static_cast<double>(k) * fs / static_cast<double>(n);
+        result.magnitude[k] = std::abs(spectrum[k]) / static_cast<double>(n) * (mirrored ? 2.0 : 1.0);
+        result.phase[k] = std::arg(spectrum[k]);
+    }
+
+    // Strongest component, ignoring the DC offset unless that is all there is
+    size_t peak = bins > 1 ? 1 : 0;
+    for (size_t k = peak; k < bins; ++k) {
+        if (result.magnitude[k] > result.magnitude[peak]) peak = k;
+    }
+    result.peak_frequency = result.frequency[peak];
+    return result;
+}
+
+// ========== FILTERS ==========
+
+std::vector<Biquad> SignalProcessing::butter_lowpass(int order, double cutoff, double fs) {
+    return butterworth(order, Band::Low, prewarp(cutoff, fs));
+}
+
+std::vector<Biquad> SignalProcessing::butter_highpass(int order, double cutoff, double fs) {
+    return butterworth(order, Band::High, prewarp(cutoff, fs));
+}
+
+std::vector<Biquad> SignalProcessing::butter_bandpass(int order, double low, double high, double fs) {
+    if (!(low < high)) throw std::runtime_error("Butterworth: band edges must satisfy low < high");
+    return butterworth(order, Band::Pass, prewarp(low, fs), prewarp(high, fs));
+}
+
+std::vector<double> SignalProcessing::sosfilt(const std::vector<Biquad>& sos, const std::vector<double>& signal) {
+    std::vector<double> y = signal;
+    filter_in_place(sos, y.data(), y.size(), 0.0);
+    return y;
+}
+
+// Forward, then backward over the reversed output. Each end is extended
+// by an odd reflection of 3 * (filter order) samples so the start-up
+// transients fall outside the returned range.
+std::vector<double> SignalProcessing::filtfilt(const std::vector<Biquad>& sos, const std::vector<double>& signal) {
+    const size_t n = signal.size();
+    if (n == 0 || sos.empty()) return signal;
+    const size_t edge = std::min(6 * sos.size(), n - 1);
+
+    std::vector<double> ext(n + 2 * edge);
+    for (size_t i = 0; i < edge; ++i) {
+        ext[i] = 2.0 * signal[0] - signal[edge - i];
+        ext[edge + n + i] = 2.0 * signal[n - 1] - signal[n - 2 - i];
+    }
+    std::copy(signal.begin(), signal.end(), ext.begin() + static_cast<std::ptrdiff_t>(edge));
+
+    filter_in_place(sos, ext.data(), ext.size(), ext.front());
+    std::reverse(ext.begin(), ext.end());
+    filter_in_place(sos, ext.data(), ext.size(), ext.front());
+    std::reverse(ext.begin(), ext.end());
+    return std::vector<double>(ext.begin() + static_cast<std::ptrdiff_t>(edge),
+                               ext.begin() + static_cast<std::ptrdiff_t>(edge + n));
+}
+
+std::vector<double> SignalProcessing::lowpass(const std::vector<double>& signal,
+                                              double cutoff, double fs, int order) {
+    return filtfilt(butter_lowpass(order, cutoff, fs), signal);
+}
+
+std::vector<double> SignalProcessing::highpass(const std::vector<double>& signal,
+                                               double cutoff, double fs, int order) {
+    return filtfilt(butter_highpass(order, cutoff, fs), signal);
+}
+
+std::vector<double> SignalProcessing::bandpass(const std::vector<double>& signal,
+                                               double low, double high, double fs, int order) {
+    return filtfilt(butter_bandpass(order, low, high, fs), signal);
+}
+
+// ========== CONVOLUTION ==========
+
+std::vector<double> SignalProcessing::convolve(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.empty() || b.empty()) return {};
+    const std::vector<double>& signal = a.size() >= b.size() ? a : b;
+    const std::vector<double>& kernel = a.size() >= b.size() ? b : a;
+
+    std::vector<double> out;
+    if (kernel.size() <= kDirectConvolutionTaps) {
+        out.resize(a.size() + b.size() - 1);
+        kernels::convolve(signal.data(), signal.size(), kernel.data(), kernel.size(), out.data());
+        return out;
+    }
+    StreamingConvolver conv(kernel);
+    out.reserve(a.size() + b.size() - 1);
+    conv.push(signal, out);
+    conv.flush(out);
+    return out;
+}
+
+// ========== STREAMING STFT ==========
+
+// Periodic windows, so frames overlapped at hop = size/2 (Hann) sum flat
+StreamingSTFT::StreamingSTFT(size_t frame_size, size_t hop, Window window)
+    : frame_size_(frame_size), hop_(hop) {
+    if (frame_size == 0 || hop == 0) {
+        throw std::runtime_error("StreamingSTFT: frame size and hop must be positive");
+    }
+    plan_ = fft::RealPlan::get(frame_size);
+    window_.resize(frame_size);
+    for (size_t i = 0; i < frame_size; ++i) {
+        double c = std::cos(2.0 * kPi * static_cast<double>(i) / static_cast<double>(frame_size));
+        switch (window) {
+            case Window::Rectangular: window_[i] = 1.0; break;
+            case Window::Hann: window_[i] = 0.5 - 0.5 * c; break;
+            case Window::Hamming: window_[i] = 0.54 - 0.46 * c; break;
+        }
+    }
+    pending_.reserve(frame_size);
+    frame_.resize(frame_size);
+    spectrum_.resize(bins());
+}
+
+void StreamingSTFT::push(const double* samples, size_t count, const FrameCallback& on_frame) {
+    while (count > 0) {
+        if (skip_ > 0) {
+            size_t n = std::min(skip_, count);
+            skip_ -= n;
+            samples += n;
+            count -= n;
+            continue;
+        }
+        size_t n = std::min(frame_size_ - pending_.size(), count);
+        pending_.insert(pending_.end(), samples, samples + n);
+        fresh_ = true;
+        samples += n;
+        count -= n;
+        if (pending_.size() < frame_size_) break;
+
+        emit(on_frame);
+        if (hop_ >= frame_size_) {
+            pending_.clear();
+            skip_ = hop_ - frame_size_;
+        } else {
+            pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(hop_));
+        }
+        fresh_ = false;
+    }
+}
+
+void StreamingSTFT::flush(const FrameCallback& on_frame) {
+    if (fresh_) {
+        pending_.resize(frame_size_, 0.0);
+        emit(on_frame);
+    }
+    reset();
+}
+
+void StreamingSTFT::reset() {
+    pending_.clear();
+    skip_ = 0;
+    frames_ = 0;
+    fresh_ = false;
+}
+
+void StreamingSTFT::emit(const FrameCallback& on_frame) {
+    for (size_t i = 0; i < frame_size_; ++i) frame_[i] = pending_[i] * window_[i];
+    plan_->forward(frame_.data(), spectrum_.data());
+    on_frame(frames_++, spectrum_);
+}
+
+// ========== STREAMING CONVOLUTION ==========
+//
+// Overlap-save transforms the last fft_size samples of input and keeps
+// the final block_size outputs, whose windows never wrap around.
+// Overlap-add transforms the new block alone, zero-padded, and carries
+// the taps - 1 samples that spill past it into the next block.
+
+StreamingConvolver::StreamingConvolver(std::vector<double> kernel, size_t block_size, Method method)
+    : taps_(kernel.size()), method_(method) {
+    if (kernel.empty()) throw std::runtime_error("StreamingConvolver: kernel must not be empty");
+    if (block_size == 0) {
+        size_ = fft::next_power_of_two(std::max(4 * taps_, kMinConvolutionFFT));
+        block_ = size_ - taps_ + 1;
+    } else {
+        block_ = block_size;
+        size_ = fft::next_power_of_two(block_ + taps_ - 1);
+    }
+    plan_ = fft::RealPlan::get(size_);
+
+    kernel.resize(size_, 0.0);
+    kernel_spectrum_.resize(plan_->spectrum_size());
+    plan_->forward(kernel.data(), kernel_spectrum_.data());
+    for (auto& v : kernel_spectrum_) v /= static_cast<double>(size_);
+
+    spectrum_.resize(plan_->spectrum_size());
+    frame_.resize(size_);
+    reset();
+}
+
+void StreamingConvolver::push(const double* samples, size_t count, std::vector<double>& out) {
+    const size_t offset = input_.size() - block_;
+    while (count > 0) {
+        size_t n = std::min(block_ - filled_, count);
+        std::copy(samples, samples + n, input_.begin() + static_cast<std::ptrdiff_t>(offset + filled_));
+        filled_ += n;
+        samples += n;
+        count -= n;
+        if (filled_ == block_) {
+            process_block(out, block_);
+            filled_ = 0;
+        }
+    }
+}
+
+void StreamingConvolver::flush(std::vector<double>& out) {
+    size_t remaining = filled_ + taps_ - 1;
+    while (remaining > 0) {
+        size_t keep = std::min(block_, remaining);
+        process_block(out, keep);
+        filled_ = 0;
+        remaining -= keep;
+    }
+    reset();
+}
+
+void StreamingConvolver::reset() {
+    input_.assign(method_ == Method::OverlapSave ? size_ : block_, 0.0);
+    tail_.assign(method_ == Method::OverlapAdd ? taps_ - 1 : 0, 0.0);
+    filled_ = 0;
+}
+
+// Runs the current block (zero-filled past filled_) and appends the first
+// `keep` of its block_ outputs
+void StreamingConvolver::process_block(std::vector<double>& out, size_t keep) {
+    const size_t offset = input_.size() - block_;
+    std::fill(input_.begin() + static_cast<std::ptrdiff_t>(offset + filled_), input_.end(), 0.0);
+
+    std::copy(input_.begin(), input_.end(), frame_.begin());
+    std::fill(frame_.begin() + static_cast<std::ptrdiff_t>(input_.size()), frame_.end(), 0.0);
+    plan_->forward(frame_.data(), spectrum_.data());
+    for (size_t k = 0; k < spectrum_.size(); ++k) spectrum_[k] *= kernel_spectrum_[k];
+    plan_->inverse(spectrum_.data(), frame_.data());
+
+    if (method_ == Method::OverlapSave) {
+        out.insert(out.end(), frame_.begin() + static_cast<std::ptrdiff_t>(offset),
+                   frame_.begin() + static_cast<std::ptrdiff_t>(offset + keep));
+        std::copy(input_.begin() + static_cast<std::ptrdiff_t>(block_), input_.end(), input_.begin());
+    } else {
+        for (size_t i = 0; i < tail_.size(); ++i) frame_[i] += tail_[i];
+        out.insert(out.end(), frame_.begin(), frame_.begin() + static_cast<std::ptrdiff_t>(keep));
+        std::copy(frame_.begin() + static_cast<std::ptrdiff_t>(block_),
+                  frame_.begin() + static_cast<std::ptrdiff_t>(block_ + tail_.size()), tail_.begin());
+    }
+}
+
+} // namespace matlabcpp
@@ -0,0 +1,556 @@
+// MatLabC++ Symmetric Eigensolver
+// src/core/symmetric_eigen.cpp
+//
+// eig_symmetric runs in three stages, the LAPACK dsyevd pipeline:
+//
+// 1. Householder reduction to tridiagonal form, blocked like dsytrd: a
+//    panel of kTridiagonalBlock reflectors is built with the trailing
+//    matrix left untouched (its updates are carried in two n x nb blocks
+//    V and W), then the trailing matrix takes A -= V W' + W V' as two
+//    gemms. Half of the flops run at gemm speed.
+//
+// 2. Cuppen's divide and conquer on the tridiagonal matrix. Tearing out
+//    one off-diagonal entry leaves two halves plus a rank-one term; the
+//    halves recurse, and their eigensystems merge by solving the secular
+//    equation 1 + rho * sum z_j^2 / (d_j - x) = 0 once per root. Roots that
+//    the rank-one term barely moves are deflated up front. The eigenvectors
+//    are rebuilt from Gu and Eisenstat's recomputed z, which keeps them
+//    orthogonal to working precision, and merged into the halves' vectors
+//    with one gemm. Small blocks use implicit QL instead.
+//
+// 3. The reflectors from step 1 are applied to the eigenvectors in
+//    compact WY blocks (dormtr), again through gemm.
+//
+// Without eigenvectors, the tridiagonal matrix goes straight to QL,
+// which is O(n^2).
+
+#include "matlabcpp/linalg.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace matlabcpp {
+
+namespace {
+
+// Reflectors per tridiagonalization panel and per back-transform block
+constexpr size_t kTridiagonalBlock = 32;
+
+// Tridiagonal blocks this small are solved by QL, not split further
+constexpr size_t kDivideLeaf = 32;
+
+// QL sweeps allowed per eigenvalue, and secular iterations per root
+constexpr int kMaxQLSweeps = 30;
+constexpr int kMaxSecularIterations = 100;
+
+// Secular roots per task
+constexpr size_t kRootChunk = 16;
+
+constexpr double kEps = std::numeric_limits<double>::epsilon();
+
+// ========== TRIDIAGONAL REDUCTION ==========
+
+// dlarfg: tau and v with (I - tau [1; v] [1; v]') [alpha; x] = [beta; 0].
+// alpha <- beta, x <- v.
+double householder(size_t n, double& alpha, double* x) {
+    double xnorm = 0.0;
+    for (size_t i = 0; i < n; ++i) xnorm = std::hypot(xnorm, x[i]);
+    if (xnorm == 0.0) return 0.0;
+    double beta = -std::copysign(std::hypot(alpha, xnorm), alpha);
+    double tau = (beta - alpha) / beta;
+    double scale = 1.0 / (alpha - beta);
+    for (size_t i = 0; i < n; ++i) x[i] *= scale;
+    alpha = beta;
+    return tau;
+}
+
+// dsytrd (lower): Q' A Q = T for the full symmetric n x n a. d and e get
+// T; reflector j is stored below a(j + 1, j) with tau[j].
+void tridiagonalize(size_t n, double* a, double* d, double* e, double* tau) {
+    const size_t nb = kTridiagonalBlock;
+    std::vector<double> V(n * nb), W(n * nb), t(nb);
+
+    for (size_t j0 = 0; j0 < n; j0 += nb) {
+        const size_t N = n - j0;
+        const size_t jb = std::min(nb, N);
+        double* sub = a + j0 + j0 * n;
+        std::fill(V.begin(), V.end(), 0.0);
+        std::fill(W.begin(), W.end(), 0.0);
+
+        for (size_t i = 0; i < jb; ++i) {
+            double* col = sub + i * n;
+            if (i > 0) {
+                // Bring column i up to date with the panel so far
+                kernels::gemm(false, true, N - i, 1, i, -1.0, V.data() + i, n, W.data() + i, n,
+                              1.0, col + i, n);
+                kernels::gemm(false, true, N - i, 1, i, -1.0, W.data() + i, n, V.data() + i, n,
+                              1.0, col + i, n);
+            }
+            d[j0 + i] = col[i];
+            if (i + 1 == N) break;
+
+            const size_t len = N - i - 1;
+            double alpha = col[i + 1];
+            double tj = householder(len - 1, alpha, col + i + 2);
+            e[j0 + i] = alpha;
+            tau[j0 + i] = tj;
+
+            double* v = V.data() + i * n + i + 1;
+            v[0] = 1.0;
+            std::copy(col + i + 2, col + N, v + 1);
+
+            // w = tau * (A - V W' - W V') v, then w -= (tau / 2)(w'v) v
+            double* w = W.data() + i * n + i + 1;
+            const double* a22 = sub + (i + 1) + (i + 1) * n;
+            kernels::gemm(len, 1, len, tj, a22, n, v, len, 0.0, w, len);
+            if (i > 0) {
+                kernels::gemm(true, false, i, 1, len, 1.0, W.data() + i + 1, n, v, len, 0.0, t.data(), i);
+                kernels::gemm(len, 1, i, -tj, V.data() + i + 1, n, t.data(), i, 1.0, w, len);
+                kernels::gemm(true, false, i, 1, len, 1.0, V.data() + i + 1, n, v, len, 0.0, t.data(), i);
+                kernels::gemm(len, 1, i, -tj, W.data() + i + 1, n, t.data(), i, 1.0, w, len);
+            }
+            double wv = 0.0;
+            for (size_t r = 0; r < len; ++r) wv += w[r] * v[r];
+            double f = -0.5 * tj * wv;
+            for (size_t r = 0; r < len; ++r) w[r] += f * v[r];
+        }
+
+        if (jb < N) {
+            // Trailing matrix, both triangles (the matrix-vector products
+            // above read it in full)
+            size_t rest = N - jb;
+            double* a22 = sub + jb + jb * n;
+            kernels::gemm(false, true, rest, rest, jb, -1.0, V.data() + jb, n, W.data() + jb, n, 1.0, a22, n);
+            kernels::gemm(false, true, rest, rest, jb, -1.0, W.data() + jb, n, V.data() + jb, n, 1.0, a22, n);
+        }
+    }
+}
+
+// dormtr: Z := Q Z for the n x n z, Q = H(0) ... H(n-2) from
+// tridiagonalize. Blocks of reflectors are applied last to first as
+// I - V T V' (dlarft / dlarfb).
+void apply_reflectors(size_t n, const double* a, const double* tau, double* z) {
+    if (n < 3) return;
+    const size_t count = n - 2;     // H(n-2) has tau 0: nothing below it
+    const size_t nb = kTridiagonalBlock;
+    std::vector<double> V, T(nb * nb), VtZ, TVtZ;
+
+    size_t blocks = (count + nb - 1) / nb;
+    for (size_t blk = blocks; blk-- > 0;) {
+        const size_t b = blk * nb;
+        const size_t kb = std::min(nb, count - b);
+        const size_t m = n - b - 1;                 // rows b + 1 .. n - 1
+
+        // V: unit lower trapezoid, column c is reflector b + c
+        V.assign(m * kb, 0.0);
+        for (size_t c = 0; c < kb; ++c) {
+            double* vc = V.data() + c * m;
+            vc[c] = 1.0;
+            const double* src = a + (b + c) * n;
+            for (size_t r = c + 1; r < m; ++r) vc[r] = src[b + 1 + r];
+        }
+
+        // T upper triangular: T(0:c, c) = -tau_c T(0:c, 0:c) V(:, 0:c)' v_c
+        std::fill(T.begin(), T.end(), 0.0);
+        kernels::gemm(true, false, kb, kb, m, 1.0, V.data(), m, V.data(), m, 0.0, T.data(), nb);
+        for (size_t c = 0; c < kb; ++c) {
+            double tc = tau[b + c];
+            double* col = T.data() + c * nb;
+            // col[0:c] holds V(:, 0:c)' v_c; multiply by the finished block
+            for (size_t r = 0; r < c; ++r) {
+                double s = 0.0;
+                for (size_t q = r; q < c; ++q) s += T[r + q * nb] * col[q];
+                col[r] = -tc * s;
+            }
+            col[c] = tc;
+            for (size_t r = c + 1; r < kb; ++r) col[r] = 0.0;
+        }
+
+        // Z(b+1:, :) -= V (T (V' Z(b+1:, :)))
+        double* zb = z + b + 1;
+        VtZ.resize(kb * n);
+        TVtZ.resize(kb * n);
+        kernels::gemm(true, false, kb, n, m, 1.0, V.data(), m, zb, n, 0.0, VtZ.data(), kb);
+        kernels::gemm(kb, n, kb, 1.0, T.data(), nb, VtZ.data(), kb, 0.0, TVtZ.data(), kb);
+        kernels::gemm(m, n, kb, -1.0, V.data(), m, TVtZ.data(), kb, 1.0, zb, n);
+    }
+}
+
+// ========== TRIDIAGONAL EIGENSOLVERS ==========
+
+// Implicit QL with Wilkinson shifts (tql2). e[i] couples rows i and i + 1
+// and needs n entries; z, when given, must hold the starting basis and
+// has its columns rotated along.
+bool tridiagonal_ql(size_t n, double* d, double* e, double* z, size_t ldz) {
+    if (n == 0) return true;
+    e[n - 1] = 0.0;
+    for (size_t l = 0; l < n; ++l) {
+        int sweeps = 0;
+        for (;;) {
+            size_t m = l;
+            for (; m + 1 < n; ++m) {
+                double dd = std::fabs(d[m]) + std::fabs(d[m + 1]);
+                if (std::fabs(e[m]) <= kEps * dd) break;
+            }
+            if (m == l) break;
+            if (sweeps++ == kMaxQLSweeps) return false;
+
+            double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+            double r = std::hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+            double s = 1.0, c = 1.0, p = 0.0;
+            bool underflow = false;
+            for (size_t i = m; i-- > l;) {
+                double f = s * e[i], b = c * e[i];
+                r = std::hypot(f, g);
+                e[i + 1] = r;
+                if (r == 0.0) {
+                    // Split at i: recover and restart
+                    d[i + 1] -= p;
+                    e[m] = 0.0;
+                    underflow = true;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2.0 * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+                if (z) {
+                    double* zi = z + i * ldz;
+                    double* zi1 = z + (i + 1) * ldz;
+                    for (size_t k = 0; k < n; ++k) {
+                        double t = zi1[k];
+                        zi1[k] = s * zi[k] + c * t;
+                        zi[k] = c * zi[k] - s * t;
+                    }
+                }
+            }
+            if (underflow) continue;
+            d[l] -= p;
+            e[l] = g;
+            e[m] = 0.0;
+        }
+    }
+    return true;
+}
+
+// Sorts d ascending, permuting the n columns of z (leading dimension
+// ldz) along with it
+void sort_eigenpairs(size_t n, double* d, double* z, size_t ldz) {
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return d[x] < d[y]; });
+    std::vector<double> values(n), columns(z ? n * n : 0);
+    for (size_t k = 0; k < n; ++k) {
+        values[k] = d[order[k]];
+        if (z) {
+            const double* src = z + order[k] * ldz;
+            std::copy(src, src + n, columns.begin() + k * n);
+        }
+    }
+    std::copy(values.begin(), values.end(), d);
+    if (z) {
+        for (size_t k = 0; k < n; ++k) {
+            std::copy(columns.begin() + k * n, columns.begin() + (k + 1) * n, z + k * ldz);
+        }
+    }
+}
+
+// Root i of 1 + rho * sum_j z2[j] / (p[j] - x) for ascending poles p (k
+// of them, all weights positive): it lies in (p[i], p[i + 1]), or in
+// (p[k-1], p[k-1] + rho * sum z2) for the last one. Fills delta[j] =
+// p[j] - x without cancellation by measuring from the nearer pole, and
+// returns x.
+double secular_root(size_t k, size_t i, const double* p, const double* z2, double rho,
+                    double znorm2, double* delta) {
+    const bool last = i + 1 == k;
+    size_t origin = i;
+    double lo, hi;                  // bracket for tau = x - p[origin]
+    if (last) {
+        lo = 0.0;
+        hi = rho * znorm2;
+    } else {
+        double gap = p[i + 1] - p[i];
+        double mid = 0.5 * gap, f = 1.0;
+        for (size_t j = 0; j < k; ++j) f += rho * z2[j] / ((p[j] - p[i]) - mid);
+        if (f >= 0.0) {
+            lo = 0.0;
+            hi = mid;
+        } else {
+            origin = i + 1;
+            lo = -mid;
+            hi = 0.0;
+        }
+    }
+    const double base = p[origin];
+    auto fill = [&](double tau) {
+        for (size_t j = 0; j < k; ++j) delta[j] = (p[j] - base) - tau;
+    };
+
+    double tau = 0.5 * (lo + hi);
+    for (int iter = 0; iter < kMaxSecularIterations; ++iter) {
+        fill(tau);
+        // f = 1 + psi + phi, split at the root's interval
+        double psi = 0.0, dpsi = 0.0, phi = 0.0, dphi = 0.0;
+        for (size_t j = 0; j <= i; ++j) {
+            double q = z2[j] / delta[j];
+            psi += q;
+            dpsi += q / delta[j];
+        }
+        for (size_t j = i + 1; j < k; ++j) {
+            double q = z2[j] / delta[j];
+            phi += q;
+            dphi += q / delta[j];
+        }
+        double f = 1.0 + rho * (psi + phi);
+        if (f == 0.0) break;
+        if (f < 0.0) lo = tau; else hi = tau;
+
+        // Rational model C + A / delta_i + B / delta_{i+1} matching f and
+        // f' at tau (the "middle way"), solved for the step eta
+        double di = delta[i];
+        double A = rho * dpsi * di * di;
+        double step;
+        if (last) {
+            double C = f - A / di;
+            step = C != 0.0 ? di + A / C : 0.5 * (lo + hi) - tau;
+        } else {
+            double di1 = delta[i + 1];
+            double B = rho * dphi * di1 * di1;
+            double C = f - A / di - B / di1;
+            double qa = C, qb = C * (di + di1) + A + B, qc = C * di * di1 + A * di1 + B * di;
+            if (qa == 0.0) {
+                step = qc / qb;
+            } else {
+                double disc = std::sqrt(std::max(qb * qb - 4.0 * qa * qc, 0.0));
+                double q = 0.5 * (qb + std::copysign(disc, qb));
+                double r1 = q / qa, r2 = q != 0.0 ? qc / q : r1;
+                step = (r1 > di && r1 < di1) ? r1 : r2;
+            }
+        }
+        double next = tau + step;
+        if (!(next > lo && next < hi)) next = 0.5 * (lo + hi);     // bisect
+        double change = std::fabs(next - tau);
+        tau = next;
+        if (change <= 2.0 * kEps * std::fabs(tau) ||
+            hi - lo <= 4.0 * kEps * std::max(std::fabs(lo), std::fabs(hi))) {
+            break;
+        }
+    }
+    fill(tau);
+    return base + tau;
+}
+
+void divide_and_conquer(size_t n, double* d, const double* e, double* q, size_t ldq);
+
+// Eigensystem of diag(d) Q' + rho u u' merged into the block-diagonal
+// eigenvectors at q (n x n), where the first m columns come from the
+// top half and u = e(m-1) + sign(rho) e(m). dlaed1 .. dlaed3.
+void merge(size_t n, size_t m, double* d, double* q, size_t ldq, double rho) {
+    // z = Q' u / sqrt(2), with the matching weight 2 |rho|
+    std::vector<double> z(n);
+    for (size_t j = 0; j < m; ++j) z[j] = q[(m - 1) + j * ldq];
+    for (size_t j = m; j < n; ++j) z[j] = std::copysign(1.0, rho) * q[m + j * ldq];
+    const double half = std::sqrt(0.5);
+    for (double& v : z) v *= half;
+    const double weight = 2.0 * std::fabs(rho);
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) { return d[x] < d[y]; });
+
+    double dmax = 0.0, zmax = 0.0;
+    for (size_t j = 0; j < n; ++j) {
+        dmax = std::max(dmax, std::fabs(d[j]));
+        zmax = std::max(zmax, std::fabs(z[j]));
+    }
+    const double tol = 8.0 * kEps * std::max(dmax, zmax);
+
+    // Deflation (dlaed2): a negligible z component leaves its pair alone;
+    // two nearly equal poles are rotated so one of them has z = 0
+    std::vector<size_t> kept, deflated;
+    size_t pending = n;             // last undecided kept candidate
+    for (size_t idx : order) {
+        if (weight * std::fabs(z[idx]) <= tol) {
+            deflated.push_back(idx);
+            continue;
+        }
+        if (pending == n) {
+            pending = idx;
+            continue;
+        }
+        double s = z[pending], c = z[idx];
+        double tau = std::hypot(c, s);
+        double t = d[idx] - d[pending];
+        c /= tau;
+        s = -s / tau;
+        if (std::fabs(t * c * s) <= tol) {
+            z[idx] = tau;
+            z[pending] = 0.0;
+            double* qp = q + pending * ldq;
+            double* qn = q + idx * ldq;
+            for (size_t r = 0; r < n; ++r) {
+                double x = qp[r], y = qn[r];
+                qp[r] = c * x + s * y;
+                qn[r] = c * y - s * x;
+            }
+            double dp = d[pending], dn = d[idx];
+            d[pending] = dp * c * c + dn * s * s;
+            d[idx] = dp * s * s + dn * c * c;
+            deflated.push_back(pending);
+        } else {
+            kept.push_back(pending);
+        }
+        pending = idx;
+    }
+    if (pending != n) kept.push_back(pending);
+    std::stable_sort(kept.begin(), kept.end(), [&](size_t x, size_t y) { return d[x] < d[y]; });
+
+    const size_t k = kept.size();
+    std::vector<double> values(n), columns(n * n);
+    if (k > 0) {
+        std::vector<double> p(k), z2(k), zk(k);
+        double znorm2 = 0.0;
+        for (size_t j = 0; j < k; ++j) {
+            p[j] = d[kept[j]];
+            zk[j] = z[kept[j]];
+            z2[j] = zk[j] * zk[j];
+            znorm2 += z2[j];
+        }
+
+        // delta(:, i) = p - lambda_i for each root
+        std::vector<double> delta(k * k), lambda(k);
+        parallel_for(k, kRootChunk, [&](size_t lo, size_t hi) {
+            for (size_t i = lo; i < hi; ++i) {
+                lambda[i] = secular_root(k, i, p.data(), z2.data(), weight, znorm2, delta.data() + i * k);
+            }
+        });
+
+        // Gu-Eisenstat: the z for which the computed roots are exact
+        std::vector<double> zhat(k);
+        for (size_t j = 0; j < k; ++j) {
+            double prod = -delta[j + j * k] / weight;
+            for (size_t i = 0; i < k; ++i) {
+                if (i != j) prod *= -delta[j + i * k] / (p[i] - p[j]);
+            }
+            zhat[j] = std::copysign(std::sqrt(std::fabs(prod)), zk[j]);
+        }
+
+        // Eigenvectors of the rank-one problem, then through the halves'
+        std::vector<double> U(k * k), G(n * k);
+        for (size_t i = 0; i < k; ++i) {
+            double* u = U.data() + i * k;
+            double norm = 0.0;
+            for (size_t j = 0; j < k; ++j) {
+                u[j] = zhat[j] / delta[j + i * k];
+                norm = std::hypot(norm, u[j]);
+            }
+            for (size_t j = 0; j < k; ++j) u[j] /= norm;
+        }
+        for (size_t j = 0; j < k; ++j) {
+            const double* src = q + kept[j] * ldq;
+            std::copy(src, src + n, G.begin() + j * n);
+        }
+        kernels::gemm(n, k, k, 1.0, G.data(), n, U.data(), k, 0.0, columns.data(), n);
+        std::copy(lambda.begin(), lambda.end(), values.begin());
+    }
+    for (size_t j = 0; j < deflated.size(); ++j) {
+        values[k + j] = d[deflated[j]];
+        const double* src = q + deflated[j] * ldq;
+        std::copy(src, src + n, columns.begin() + (k + j) * n);
+    }
+
+    std::copy(values.begin(), values.end(), d);
+    for (size_t j = 0; j < n; ++j) {
+        std::copy(columns.begin() + j * n, columns.begin() + (j + 1) * n, q + j * ldq);
+    }
+    sort_eigenpairs(n, d, q, ldq);
+}
+
+// dstedc: eigenvalues (ascending) into d and eigenvectors into the n x n
+// block at q for the tridiagonal (d, e)
+void divide_and_conquer(size_t n, double* d, const double* e, double* q, size_t ldq) {
+    for (size_t j = 0; j < n; ++j) {
+        std::fill(q + j * ldq, q + j * ldq + n, 0.0);
+        q[j + j * ldq] = 1.0;
+    }
+    if (n <= kDivideLeaf) {
+        std::vector<double> work(e, e + (n > 0 ? n - 1 : 0));
+        work.push_back(0.0);
+        if (!tridiagonal_ql(n, d, work.data(), q, ldq)) {
+            throw std::runtime_error("eig: tridiagonal QL iteration did not converge");
+        }
+        sort_eigenpairs(n, d, q, ldq);
+        return;
+    }
+
+    // Tear out e[m-1]: T = diag(T1, T2) + rho u u'
+    const size_t m = n / 2;
+    const double rho = e[m - 1];
+    d[m - 1] -= std::fabs(rho);
+    d[m] -= std::fabs(rho);
+    divide_and_conquer(m, d, e, q, ldq);
+    divide_and_conquer(n - m, d + m, e + m, q + m + m * ldq, ldq);
+    if (rho != 0.0) {
+        merge(n, m, d, q, ldq, rho);
+    } else {
+        sort_eigenpairs(n, d, q, ldq);
+    }
+}
+
+} // namespace
+
+void tridiagonal_eigen(size_t n, double* d, double* e, double* z, size_t ldz) {
+    if (n == 0) return;
+    if (z) {
+        divide_and_conquer(n, d, e, z, ldz);
+        return;
+    }
+    std::vector<double> work(e, e + n - 1);
+    work.push_back(0.0);
+    if (!tridiagonal_ql(n, d, work.data(), nullptr, 0)) {
+        throw std::runtime_error("eig: tridiagonal QL iteration did not converge");
+    }
+    std::sort(d, d + n);
+}
+
+SymmetricEigen eig_symmetric(const Array& A, bool want_vectors) {
+    if (A.ndims() > 2 || A.rows() != A.cols()) {
+        throw std::runtime_error("eig: matrix must be square");
+    }
+    const size_t n = A.rows();
+    SymmetricEigen result;
+    result.values.resize(n);
+    if (n == 0) return result;
+
+    // Full symmetric copy from the lower triangle
+    std::vector<double> a(A.data(), A.data() + n * n);
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = j + 1; i < n; ++i) a[j + i * n] = a[i + j * n];
+    }
+    std::vector<double> e(n, 0.0), tau(n, 0.0);
+    double* d = result.values.data();
+    tridiagonalize(n, a.data(), d, e.data(), tau.data());
+
+    if (!want_vectors) {
+        tridiagonal_eigen(n, d, e.data(), nullptr, 0);
+        return result;
+    }
+    result.vectors = Array::uninitialized(n, n);
+    double* z = result.vectors.mutable_data();
+    tridiagonal_eigen(n, d, e.data(), z, n);
+    apply_reflectors(n, a.data(), tau.data(), z);
+    return result;
+}
+
+} // namespace matlabcpp
@@ -0,0 +1,182 @@
+// MatLabC++ Thread Pool
+// src/core/thread_pool.cpp
+
+#include "matlabcpp/thread_pool.hpp"
+#include <cstdlib>
+#include <exception>
+#include <limits>
+
+namespace matlabcpp {
+
+namespace {
+
+size_t default_threads() {
+    if (const char* env = std::getenv("MATLABCPP_NUM_THREADS")) {
+        long n = std::strtol(env, nullptr, 10);
+        if (n > 0) return static_cast<size_t>(n);
+    }
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw ? hw : 1;
+}
+
+constexpr size_t kNoWorker = std::numeric_limits<size_t>::max();
+
+} // namespace
+
+struct ThreadPool::Batch {
+    const std::function<void(size_t)>* task = nullptr;
+    size_t remaining = 0;           // guarded by mutex
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+};
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool(default_threads());
+    return pool;
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+    start(threads > 1 ? threads - 1 : 0);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+void ThreadPool::set_threads(size_t threads) {
+    if (threads < 1) threads = 1;
+    std::unique_lock<std::mutex> lock(resize_mutex_);
+    idle_.wait(lock, [&] { return running_ == 0; });
+    if (threads == this->threads()) return;
+    stop();
+    start(threads - 1);
+}
+
+void ThreadPool::start(size_t workers) {
+    stopping_ = false;
+    workers_.clear();
+    for (size_t i = 0; i < workers; ++i) workers_.push_back(std::make_unique<Worker>());
+    for (size_t i = 0; i < workers; ++i) {
+        workers_[i]->thread = std::thread(&ThreadPool::worker_loop, this, i);
+    }
+    threads_.store(workers + 1, std::memory_order_release);
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& w : workers_) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+    workers_.clear();
+    threads_.store(1, std::memory_order_release);
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+
+    // Keeps set_threads from replacing workers_ under this batch
+    struct Running {
+        ThreadPool& pool;
+        explicit Running(ThreadPool& p) : pool(p) {
+            std::lock_guard<std::mutex> lock(pool.resize_mutex_);
+            pool.running_++;
+        }
+        ~Running() {
+            std::lock_guard<std::mutex> lock(pool.resize_mutex_);
+            if (--pool.running_ == 0) pool.idle_.notify_all();
+        }
+    } running(*this);
+
+    Batch batch;
+    batch.task = &task;
+    batch.remaining = count;
+
+    if (workers_.empty()) {
+        for (size_t i = 0; i < count; ++i) execute({&batch, i});
+    } else {
+        {
+            // Raised first (and under the lock) so a sleeping worker can't
+            // miss the batch and the count never dips below zero
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            pending_ += count;
+        }
+        // Deal contiguous blocks of indices to the workers; idle ones steal
+        size_t w = workers_.size();
+        for (size_t k = 0; k < w; ++k) {
+            std::lock_guard<std::mutex> lock(workers_[k]->mutex);
+            for (size_t i = k * count / w; i < (k + 1) * count / w; ++i) {
+                workers_[k]->tasks.push_back({&batch, i});
+            }
+        }
+        wake_.notify_all();
+
+        // Help out, then wait for tasks still running elsewhere
+        Task t;
+        while (try_pop(kNoWorker, t)) execute(t);
+    }
+
+    // Also makes sure the last executor has let go of `batch`
+    std::unique_lock<std::mutex> lock(batch.mutex);
+    batch.done.wait(lock, [&] { return batch.remaining == 0; });
+    if (batch.error) std::rethrow_exception(batch.error);
+}
+
+void ThreadPool::worker_loop(size_t self) {
+    Task t;
+    for (;;) {
+        if (try_pop(self, t)) {
+            execute(t);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_.wait(lock, [&] { return stopping_ || pending_.load() > 0; });
+        if (stopping_) return;
+    }
+}
+
+bool ThreadPool::try_pop(size_t self, Task& out) {
+    size_t w = workers_.size();
+    if (self < w) {
+        Worker& own = *workers_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = own.tasks.front();
+            own.tasks.pop_front();
+            --pending_;
+            return true;
+        }
+    }
+    for (size_t k = 0; k < w; ++k) {
+        size_t victim = self < w ? (self + 1 + k) % w : k;
+        if (victim == self) continue;
+        Worker& other = *workers_[victim];
+        std::lock_guard<std::mutex> lock(other.mutex);
+        if (!other.tasks.empty()) {
+            out = other.tasks.back();
+            other.tasks.pop_back();
+            --pending_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::execute(const Task& task) {
+    Batch& batch = *task.batch;
+    std::exception_ptr error;
+    try {
+        (*batch.task)(task.index);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (error && !batch.error) batch.error = error;
+    if (--batch.remaining == 0) batch.done.notify_all();
+}
+
+} // namespace matlabcpp
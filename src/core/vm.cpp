@@ -0,0 +1,834 @@
+// MatLabC++ Bytecode Virtual Machine
+// src/core/vm.cpp
+//
+// Register-based dispatch loop for CompiledScript. Workspace reads and
+// writes go through ActiveWindow so scripts and the REPL share variables.
+
+#include "matlabcpp/bytecode.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/linalg.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace matlabcpp {
+namespace interpreter {
+
+namespace {
+
+// ========== VARIABLE HELPERS ==========
+// Variables are addressed in MATLAB's column-major element order.
+
+size_t rows_of(const Variable& v) {
+    return v.rows();
+}
+
+// Columns of the 2-D view A(:,:) (trailing dimensions folded in)
+size_t cols_of(const Variable& v) {
+    return v.rows() ? v.numel() / v.rows() : v.cols();
+}
+
+size_t numel(const Variable& v) {
+    return v.numel();
+}
+
+double element(const Variable& v, size_t k) {
+    return v.data()[k];
+}
+
+Variable from_column_major(size_t rows, size_t cols, AlignedVector data) {
+    return Variable(rows, cols, std::move(data));
+}
+
+double scalar_of(const Variable& v, const char* what) {
+    if (numel(v) == 1) return element(v, 0);
+    throw std::runtime_error(std::string(what) + " only supports scalar operands for now");
+}
+
+bool truthy(const Variable& v) {
+    size_t n = numel(v);
+    if (n == 0) return false;
+    for (size_t k = 0; k < n; k++) {
+        if (element(v, k) == 0.0) return false;
+    }
+    return true;
+}
+
+const char* op_symbol(OpCode op) {
+    switch (op) {
+        case OpCode::Add: return "Operator '+'";
+        case OpCode::Sub: return "Operator '-'";
+        case OpCode::Mul: return "Operator '*'";
+        case OpCode::Div: return "Operator '/'";
+        case OpCode::LeftDiv: return "Operator '\\'";
+        case OpCode::Pow: return "Operator '^'";
+        case OpCode::ElemMul: return "Operator '.*'";
+        case OpCode::ElemDiv: return "Operator './'";
+        case OpCode::ElemPow: return "Operator '.^'";
+        case OpCode::Eq: return "Operator '=='";
+        case OpCode::Ne: return "Operator '~='";
+        case OpCode::Lt: return "Operator '<'";
+        case OpCode::Le: return "Operator '<='";
+        case OpCode::Gt: return "Operator '>'";
+        case OpCode::Ge: return "Operator '>='";
+        case OpCode::And: return "Operator '&'";
+        case OpCode::Or: return "Operator '|'";
+        case OpCode::Neg: return "Unary '-'";
+        case OpCode::Not: return "Operator '~'";
+        case OpCode::Transpose: return "Transpose";
+        default: return "Operator";
+    }
+}
+
+double apply_binary(OpCode op, double x, double y) {
+    switch (op) {
+        case OpCode::Add: return x + y;
+        case OpCode::Sub: return x - y;
+        case OpCode::Mul: case OpCode::ElemMul: return x * y;
+        case OpCode::Div: case OpCode::ElemDiv: return x / y;
+        case OpCode::LeftDiv: return y / x;
+        case OpCode::Pow: case OpCode::ElemPow: return std::pow(x, y);
+        case OpCode::Eq: return x == y;
+        case OpCode::Ne: return x != y;
+        case OpCode::Lt: return x < y;
+        case OpCode::Le: return x <= y;
+        case OpCode::Gt: return x > y;
+        case OpCode::Ge: return x >= y;
+        case OpCode::And: return (x != 0.0) && (y != 0.0);
+        case OpCode::Or: return (x != 0.0) || (y != 0.0);
+        default: throw std::logic_error("apply_binary: not a binary opcode");
+    }
+}
+
+// ========== ARRAY OPERATORS ==========
+
+kernels::BinaryOp kernel_op(OpCode op) {
+    switch (op) {
+        case OpCode::Add: return kernels::BinaryOp::Add;
+        case OpCode::Sub: return kernels::BinaryOp::Sub;
+        case OpCode::Mul: case OpCode::ElemMul: return kernels::BinaryOp::Mul;
+        case OpCode::Div: case OpCode::ElemDiv: return kernels::BinaryOp::Div;
+        case OpCode::Pow: case OpCode::ElemPow: return kernels::BinaryOp::Pow;
+        case OpCode::Eq: return kernels::BinaryOp::Eq;
+        case OpCode::Ne: return kernels::BinaryOp::Ne;
+        case OpCode::Lt: return kernels::BinaryOp::Lt;
+        case OpCode::Le: return kernels::BinaryOp::Le;
+        case OpCode::Gt: return kernels::BinaryOp::Gt;
+        case OpCode::Ge: return kernels::BinaryOp::Ge;
+        case OpCode::And: return kernels::BinaryOp::And;
+        case OpCode::Or: return kernels::BinaryOp::Or;
+        default: throw std::logic_error("kernel_op: not an elementwise opcode");
+    }
+}
+
+// Elementwise a <op> b with implicit expansion: each dimension must match
+// or be 1 in one operand (scalars, row + column, ...).
+Variable elementwise(OpCode op, const Variable& a, const Variable& b) {
+    kernels::BinaryOp k = kernel_op(op);
+    size_t na = numel(a), nb = numel(b);
+
+    if (na == 1 || nb == 1 || a.dims() == b.dims()) {
+        Variable out = Variable::uninitialized(na == 1 ? b.dims() : a.dims());
+        kernels::binary(k, a.data(), na == 1 ? 0 : 1, b.data(), nb == 1 ? 0 : 1,
+                        out.mutable_data(), numel(out));
+        return out;
+    }
+
+    std::vector<size_t> da = a.dims(), db = b.dims();
+    size_t nd = std::max(da.size(), db.size());
+    da.resize(nd, 1);
+    db.resize(nd, 1);
+    std::vector<size_t> dc(nd), sa(nd), sb(nd);
+    size_t pa = 1, pb = 1;
+    for (size_t d = 0; d < nd; d++) {
+        if (da[d] != db[d] && da[d] != 1 && db[d] != 1) {
+            throw std::runtime_error(std::string(op_symbol(op)) + ": arrays have incompatible sizes");
+        }
+        dc[d] = da[d] == 1 ? db[d] : da[d];
+        sa[d] = da[d] == 1 ? 0 : pa;
+        sb[d] = db[d] == 1 ? 0 : pb;
+        pa *= da[d];
+        pb *= db[d];
+    }
+
+    Variable out = Variable::uninitialized(dc);
+    if (numel(out) == 0) return out;
+
+    // One kernel call per output column; an odometer walks dims 2..N
+    const double* x = a.data();
+    const double* y = b.data();
+    double* o = out.mutable_data();
+    size_t rows = dc[0], columns = numel(out) / rows;
+    std::vector<size_t> idx(nd, 0);
+    size_t oa = 0, ob = 0;
+    for (size_t c = 0; c < columns; c++) {
+        kernels::binary(k, x + oa, sa[0] ? 1 : 0, y + ob, sb[0] ? 1 : 0, o + c * rows, rows);
+        for (size_t d = 1; d < nd; d++) {
+            if (++idx[d] < dc[d]) {
+                oa += sa[d];
+                ob += sb[d];
+                break;
+            }
+            oa -= sa[d] * (dc[d] - 1);
+            ob -= sb[d] * (dc[d] - 1);
+            idx[d] = 0;
+        }
+    }
+    return out;
+}
+
+Variable unary_elementwise(kernels::UnaryOp op, const Variable& x) {
+    Variable out = Variable::uninitialized(x.dims());
+    kernels::unary(op, x.data(), out.mutable_data(), numel(x));
+    return out;
+}
+
+Variable identity(size_t n) {
+    Variable eye(n, n);
+    double* p = eye.mutable_data();
+    for (size_t i = 0; i < n; i++) p[i + i * n] = 1.0;
+    return eye;
+}
+
+// A^p for square A and integer p, by repeated squaring (of inv(A) when
+// p < 0)
+Variable matrix_power(const Variable& a, double p) {
+    if (a.ndims() > 2 || a.rows() != a.cols()) {
+        throw std::runtime_error("Operator '^': matrix must be square");
+    }
+    if (p != std::floor(p)) {
+        throw std::runtime_error("Operator '^' only supports integer powers of a matrix for now");
+    }
+    Variable result = identity(a.rows());
+    Variable base = p < 0.0 ? LUFactorization(a).inverse() : a;
+    for (auto e = static_cast<unsigned long long>(std::fabs(p)); e; e >>= 1) {
+        if (e & 1) result = result * base;
+        if (e > 1) base = base * base;
+    }
+    return result;
+}
+
+// Array operands: * is a matrix product, / and \ solve linear systems
+// (LU), ^ needs a scalar exponent, everything else is elementwise
+Variable apply_array(OpCode op, const Variable& a, const Variable& b) {
+    bool a_scalar = numel(a) == 1, b_scalar = numel(b) == 1;
+    switch (op) {
+        case OpCode::Mul:
+            if (a_scalar || b_scalar) break;
+            return a * b;
+        case OpCode::Div:
+            if (b_scalar) break;
+            return right_divide(a, b);
+        case OpCode::LeftDiv:
+            if (a_scalar) return elementwise(OpCode::Div, b, a);
+            return left_divide(a, b);
+        case OpCode::Pow:
+            if (b_scalar && !a_scalar) return matrix_power(a, element(b, 0));
+            if (!b_scalar) throw std::runtime_error("Operator '^' only supports scalar exponents for now");
+            break;
+        default:
+            break;
+    }
+    return elementwise(op, a, b);
+}
+
+size_t range_count(double start, double step, double stop) {
+    if (step == 0.0 || !std::isfinite(start) || !std::isfinite(stop)) return 0;
+    double n = std::floor((stop - start) / step + 1e-10);
+    return n < 0.0 ? 0 : static_cast<size_t>(n) + 1;
+}
+
+// 1-based subscripts -> 0-based positions
+std::vector<size_t> subscript_positions(const Variable& sub) {
+    std::vector<size_t> out(numel(sub));
+    for (size_t k = 0; k < out.size(); k++) {
+        double v = element(sub, k);
+        if (v < 1.0 || v != std::floor(v)) {
+            throw std::runtime_error("Index must be a positive integer");
+        }
+        out[k] = static_cast<size_t>(v) - 1;
+    }
+    return out;
+}
+
+// Linear indexing shapes the result like MATLAB: x(:) is a column; a
+// vector indexed by a vector keeps the source's orientation; anything
+// else takes the shape of the index
+Variable index_variable(const Variable& v, const Variable* subs, size_t count, bool colon) {
+    size_t rows = rows_of(v), cols = cols_of(v), total = rows * cols;
+    if (count == 0) return v;
+
+    if (count == 1) {
+        auto idx = subscript_positions(subs[0]);
+        AlignedVector out(idx.size());
+        for (size_t k = 0; k < idx.size(); k++) {
+            if (idx[k] >= total) throw std::runtime_error("Index exceeds array bounds");
+            out[k] = element(v, idx[k]);
+        }
+        size_t n = out.size();
+        if (colon) return from_column_major(n, 1, std::move(out));
+        size_t irows = rows_of(subs[0]), icols = cols_of(subs[0]);
+        bool vector_source = (rows == 1) != (cols == 1);
+        bool vector_index = irows == 1 || icols == 1;
+        if (vector_source && vector_index) {
+            return cols == 1 ? from_column_major(n, 1, std::move(out)) : from_column_major(1, n, std::move(out));
+        }
+        return from_column_major(irows, icols, std::move(out));
+    }
+
+    for (size_t d = 2; d < count; d++) {
+        for (size_t p : subscript_positions(subs[d])) {
+            if (p != 0) throw std::runtime_error("Index exceeds array bounds");
+        }
+    }
+    auto ri = subscript_positions(subs[0]);
+    auto ci = subscript_positions(subs[1]);
+    AlignedVector out(ri.size() * ci.size());
+    for (size_t j = 0; j < ci.size(); j++) {
+        if (ci[j] >= cols) throw std::runtime_error("Index exceeds array bounds");
+        for (size_t i = 0; i < ri.size(); i++) {
+            if (ri[i] >= rows) throw std::runtime_error("Index exceeds array bounds");
+            out[i + j * ri.size()] = element(v, ri[i] + ci[j] * rows);
+        }
+    }
+    return from_column_major(ri.size(), ci.size(), std::move(out));
+}
+
+// x(i) = v / M(i, j) = v with a scalar v: write straight into the target's
+// buffer (detaching it first only if another variable still shares it).
+// Vectors grow in place; anything else that needs reshaping returns false
+// and takes the general path.
+bool assign_in_place(Variable& target, const Variable* subs, size_t count, const Variable& value) {
+    if (numel(value) != 1 || count == 0 || count > 2) return false;
+    size_t rows = rows_of(target), cols = cols_of(target);
+
+    std::vector<size_t> linear;
+    if (count == 1) {
+        linear = subscript_positions(subs[0]);
+        size_t needed = linear.empty() ? 0 : *std::max_element(linear.begin(), linear.end()) + 1;
+        if (needed > rows * cols) {
+            // Growing a vector: extend its buffer (amortized) instead of rebuilding it
+            if (target.ndims() > 2 || (rows > 1 && cols > 1)) return false;
+            target.resize_vector(needed);
+            rows = rows_of(target);
+            cols = cols_of(target);
+        }
+    } else {
+        auto ri = subscript_positions(subs[0]);
+        auto ci = subscript_positions(subs[1]);
+        linear.reserve(ri.size() * ci.size());
+        for (size_t c : ci) {
+            for (size_t r : ri) {
+                if (r >= rows || c >= cols) return false;
+                linear.push_back(r + c * rows);
+            }
+        }
+    }
+    for (size_t k : linear) {
+        if (k >= rows * cols) return false;
+    }
+
+    double x = element(value, 0);
+    double* data = target.mutable_data();
+    for (size_t k : linear) data[k] = x;
+    return true;
+}
+
+Variable assign_indexed(const Variable* target, const Variable* subs, size_t count, const Variable& value) {
+    size_t rows = target ? rows_of(*target) : 0;
+    size_t cols = target ? cols_of(*target) : 0;
+    AlignedVector data = target ? AlignedVector(target->begin(), target->end()) : AlignedVector();
+    size_t value_count = numel(value);
+
+    auto value_at = [&](size_t k, size_t targets) {
+        if (value_count == 1) return element(value, 0);
+        if (value_count != targets) {
+            throw std::runtime_error("Assignment dimension mismatch");
+        }
+        return element(value, k);
+    };
+
+    if (count == 1) {
+        auto idx = subscript_positions(subs[0]);
+        size_t needed = idx.empty() ? 0 : *std::max_element(idx.begin(), idx.end()) + 1;
+        if (needed > rows * cols) {
+            if (rows <= 1) { rows = 1; cols = needed; }
+            else if (cols == 1) { rows = needed; }
+            else throw std::runtime_error("Attempt to grow matrix with a linear index");
+            data.resize(rows * cols, 0.0);
+        }
+        for (size_t k = 0; k < idx.size(); k++) data[idx[k]] = value_at(k, idx.size());
+        return from_column_major(rows, cols, std::move(data));
+    }
+
+    if (count > 2) throw std::runtime_error("Only 1-D and 2-D indexed assignment is supported");
+    auto ri = subscript_positions(subs[0]);
+    auto ci = subscript_positions(subs[1]);
+    size_t new_rows = rows, new_cols = cols;
+    for (size_t r : ri) new_rows = std::max(new_rows, r + 1);
+    for (size_t c : ci) new_cols = std::max(new_cols, c + 1);
+    if (new_rows != rows || new_cols != cols) {
+        AlignedVector grown(new_rows * new_cols, 0.0);
+        for (size_t j = 0; j < cols; j++) {
+            for (size_t i = 0; i < rows; i++) grown[i + j * new_rows] = data[i + j * rows];
+        }
+        data.swap(grown);
+        rows = new_rows;
+        cols = new_cols;
+    }
+    size_t targets = ri.size() * ci.size();
+    for (size_t j = 0; j < ci.size(); j++) {
+        for (size_t i = 0; i < ri.size(); i++) {
+            data[ri[i] + ci[j] * rows] = value_at(i + j * ri.size(), targets);
+        }
+    }
+    return from_column_major(rows, cols, std::move(data));
+}
+
+Variable horzcat(const Variable* parts, size_t count) {
+    size_t rows = 0, cols = 0;
+    AlignedVector data;
+    for (size_t p = 0; p < count; p++) {
+        size_t r = rows_of(parts[p]), c = cols_of(parts[p]);
+        if (r * c == 0) continue;
+        if (rows == 0) rows = r;
+        else if (r != rows) throw std::runtime_error("Dimensions of arrays being concatenated are not consistent");
+        // Column-major: horizontal concatenation is just appending data
+        data.insert(data.end(), parts[p].begin(), parts[p].end());
+        cols += c;
+    }
+    if (data.empty()) return Variable(std::vector<double>());
+    return from_column_major(rows, cols, std::move(data));
+}
+
+Variable vertcat(const Variable* parts, size_t count) {
+    size_t rows = 0, cols = 0;
+    for (size_t p = 0; p < count; p++) {
+        size_t r = rows_of(parts[p]), c = cols_of(parts[p]);
+        if (r * c == 0) continue;
+        if (cols == 0) cols = c;
+        else if (c != cols) throw std::runtime_error("Dimensions of arrays being concatenated are not consistent");
+        rows += r;
+    }
+    if (rows == 0) return Variable(std::vector<double>());
+
+    AlignedVector data(rows * cols);
+    size_t row_offset = 0;
+    for (size_t p = 0; p < count; p++) {
+        size_t r = rows_of(parts[p]), c = cols_of(parts[p]);
+        if (r * c == 0) continue;
+        for (size_t j = 0; j < c; j++) {
+            for (size_t i = 0; i < r; i++) data[row_offset + i + j * rows] = element(parts[p], i + j * r);
+        }
+        row_offset += r;
+    }
+    return from_column_major(rows, cols, std::move(data));
+}
+
+// ========== FUSED KERNELS ==========
+
+constexpr size_t kFusedTile = 512;  // doubles per scratch tile: 4 KB, stays in L1
+constexpr size_t kFusedChunk = 64 * kFusedTile;   // tiles per thread-pool task
+
+AlignedVector& tile_scratch() {
+    thread_local AlignedVector scratch;
+    return scratch;
+}
+
+enum FusedKind : uint8_t { FusedScalar, FusedInput, FusedTemp };
+
+bool is_unary(OpCode op) {
+    return op == OpCode::Neg || op == OpCode::Not || op == OpCode::CallOrIndex;
+}
+
+double apply_unary(const FusedOp& op, double x) {
+    switch (op.op) {
+        case OpCode::Neg: return -x;
+        case OpCode::Not: return x == 0.0 ? 1.0 : 0.0;
+        default: kernels::unary(static_cast<kernels::UnaryOp>(op.fn), &x, &x, 1); return x;
+    }
+}
+
+bool same_shape(const Variable& a, const Variable& b) {
+    if (a.ndims() != b.ndims()) return false;
+    for (size_t d = 0; d < a.ndims(); d++) {
+        if (a.dim(d) != b.dim(d)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Runs kernel `k` tile by tile. Returns false (without side effects) when
+// the operands need something the kernel can't express - implicit
+// expansion, a matrix product or power, a builtin shadowed by a variable -
+// and the caller falls through to the unfused code.
+bool VM::run_fused(const CompiledScript& s, const FusedKernel& k, Variable& result) {
+    const uint32_t* inputs = s.fused_inputs.data() + k.first_input;
+    const FusedOp* ops = s.fused_ops.data() + k.first_op;
+    fused_values_.resize(k.n_inputs + k.n_ops);
+    FusedValue* values = fused_values_.data();
+
+    // Scalars broadcast; arrays must all have the same shape
+    const Variable* shape = nullptr;
+    for (uint32_t i = 0; i < k.n_inputs; i++) {
+        const Variable& v = operand(s, inputs[i]);
+        if (numel(v) == 1) {
+            values[i] = {nullptr, element(v, 0), 0, FusedScalar};
+            continue;
+        }
+        if (!shape) shape = &v;
+        else if (!same_shape(v, *shape)) return false;
+        values[i] = {v.data(), 0.0, 0, FusedInput};
+    }
+    if (shape && numel(*shape) == 0) return false;
+
+    // Scalar subtrees are folded once; array ops get a scratch tile
+    uint32_t tiles = 0;
+    for (uint32_t j = 0; j < k.n_ops; j++) {
+        const FusedOp& op = ops[j];
+        const FusedValue& x = values[op.x];
+        bool unary = is_unary(op.op);
+        const FusedValue& y = unary ? x : values[op.y];
+        bool scalar = x.kind == FusedScalar && y.kind == FusedScalar;
+
+        switch (op.op) {
+            case OpCode::Mul:
+                if (x.kind != FusedScalar && y.kind != FusedScalar) return false;
+                break;
+            case OpCode::Div:
+                if (y.kind != FusedScalar) return false;
+                break;
+            case OpCode::Pow:
+                if (!scalar) return false;
+                break;
+            case OpCode::CallOrIndex:
+                if (ws_->find(slots_[op.y])) return false;
+                break;
+            default:
+                break;
+        }
+
+        FusedValue& out = values[k.n_inputs + j];
+        if (scalar) {
+            double v = unary ? apply_unary(op, x.scalar) : apply_binary(op.op, x.scalar, y.scalar);
+            out = {nullptr, v, 0, FusedScalar};
+        } else {
+            out = {nullptr, 0.0, tiles++, FusedTemp};
+        }
+    }
+
+    const FusedValue& root = values[k.n_inputs + k.n_ops - 1];
+    if (!shape) {
+        result = Variable(root.scalar);
+        return true;
+    }
+
+    Variable out = Variable::uninitialized(shape->dims());
+    double* dest = out.mutable_data();
+    size_t n = numel(out);
+
+    // Chunks of whole tiles go to the thread pool; each thread has its own
+    // scratch tiles
+    parallel_for(n, kFusedChunk, [&](size_t lo, size_t hi) {
+        AlignedVector& scratch = tile_scratch();
+        if (scratch.size() < static_cast<size_t>(tiles) * kFusedTile) scratch.resize(tiles * kFusedTile);
+
+        auto source = [&scratch](const FusedValue& v, size_t base) -> const double* {
+            switch (v.kind) {
+                case FusedScalar: return &v.scalar;
+                case FusedInput: return v.data + base;
+                default: return scratch.data() + v.tile * kFusedTile;
+            }
+        };
+
+        for (size_t base = lo; base < hi; base += kFusedTile) {
+            size_t m = std::min(kFusedTile, hi - base);
+            for (uint32_t j = 0; j < k.n_ops; j++) {
+                const FusedValue& v = values[k.n_inputs + j];
+                if (v.kind == FusedScalar) continue;
+                const FusedOp& op = ops[j];
+                double* dst = j + 1 == k.n_ops ? dest + base : scratch.data() + v.tile * kFusedTile;
+                const FusedValue& x = values[op.x];
+                switch (op.op) {
+                    case OpCode::Neg:
+                        kernels::unary(kernels::UnaryOp::Neg, source(x, base), dst, m);
+                        break;
+                    case OpCode::Not:
+                        kernels::unary(kernels::UnaryOp::Not, source(x, base), dst, m);
+                        break;
+                    case OpCode::CallOrIndex:
+                        kernels::unary(static_cast<kernels::UnaryOp>(op.fn), source(x, base), dst, m);
+                        break;
+                    default: {
+                        const FusedValue& y = values[op.y];
+                        kernels::binary(kernel_op(op.op), source(x, base), x.kind == FusedScalar ? 0 : 1,
+                                        source(y, base), y.kind == FusedScalar ? 0 : 1, dst, m);
+                        break;
+                    }
+                }
+            }
+        }
+    });
+
+    result = std::move(out);
+    return true;
+}
+
+// ========== DISPATCH LOOP ==========
+
+void VM::bind(const CompiledScript& s) {
+    regs_.assign(s.num_registers, Variable());
+
+    // Resolve every identifier once; the dispatch loop only uses slot numbers
+    ws_ = &window_.workspace();
+    slots_.resize(s.symbols.size());
+    for (size_t i = 0; i < s.symbols.size(); i++) slots_[i] = ws_->slot(s.symbols[i]);
+}
+
+VM::Result VM::run(const CompiledScript& script) {
+    Result result;
+    bind(script);
+
+    uint32_t pc = 0;
+    while (pc < script.code.size()) {
+        try {
+            execute(script, pc, result);
+            break;  // Halt
+        } catch (const std::exception& e) {
+            // Map the faulting instruction back to its statement
+            const auto& stmts = script.statements;
+            auto it = std::upper_bound(stmts.begin(), stmts.end(), pc,
+                                       [](uint32_t p, const StatementInfo& s) { return p < s.begin; });
+            uint32_t line = 0;
+            uint32_t resume = pc + 1;
+            if (it != stmts.begin()) {
+                --it;
+                if (pc < it->end) {
+                    line = it->line;
+                    resume = it->resume;
+                }
+            }
+            result.errors.push_back("Line " + std::to_string(line) + ": " + e.what());
+            if (verbose_) {
+                std::cerr << "Error at line " << line << ": " << e.what() << "\n";
+            }
+            pc = resume;
+        }
+    }
+
+    regs_.clear();
+    return result;
+}
+
+Variable VM::evaluate(const CompiledScript& expression) {
+    Result result;
+    bind(expression);
+    uint32_t pc = 0;
+    execute(expression, pc, result);
+    Variable value = std::move(regs_.at(0));
+    regs_.clear();
+    return value;
+}
+
+void VM::execute(const CompiledScript& s, uint32_t& pc, Result& result) {
+    const Instruction* code = s.code.data();
+    Workspace& ws = *ws_;
+
+    for (;;) {
+        const Instruction& in = code[pc];
+        switch (in.op) {
+            case OpCode::Nop:
+                break;
+
+            case OpCode::LoadConst:
+                regs_[in.a] = s.constants[in.b];
+                break;
+
+            case OpCode::LoadVar:
+                regs_[in.a] = ws.get(slots_[in.b]);
+                break;
+
+            case OpCode::StoreVar:
+                if (in.a & (kConstBit | kSlotBit)) ws.set(slots_[in.b], operand(s, in.a));
+                else ws.set(slots_[in.b], std::move(regs_[in.a]));
+                break;
+
+            case OpCode::Move:
+                if (in.b & kConstBit) regs_[in.a] = s.constants[in.b & kOperandMask];
+                else regs_[in.a] = std::move(regs_[in.b]);
+                break;
+
+            case OpCode::Neg: {
+                const Variable& x = operand(s, in.b);
+                if (numel(x) == 1) regs_[in.a] = Variable(-element(x, 0));
+                else regs_[in.a] = unary_elementwise(kernels::UnaryOp::Neg, x);
+                break;
+            }
+
+            case OpCode::Not: {
+                const Variable& x = operand(s, in.b);
+                if (numel(x) == 1) regs_[in.a] = Variable(element(x, 0) == 0.0 ? 1.0 : 0.0);
+                else regs_[in.a] = unary_elementwise(kernels::UnaryOp::Not, x);
+                break;
+            }
+
+            case OpCode::Transpose:
+                regs_[in.a] = operand(s, in.b).transpose();
+                break;
+
+            case OpCode::Add: case OpCode::Sub: case OpCode::Mul: case OpCode::Div: case OpCode::LeftDiv:
+            case OpCode::Pow:
+            case OpCode::ElemMul: case OpCode::ElemDiv: case OpCode::ElemPow:
+            case OpCode::Eq: case OpCode::Ne: case OpCode::Lt: case OpCode::Le: case OpCode::Gt: case OpCode::Ge:
+            case OpCode::And: case OpCode::Or: {
+                const Variable& x = operand(s, in.b);
+                const Variable& y = operand(s, in.c);
+                if (numel(x) == 1 && numel(y) == 1) {
+                    regs_[in.a] = Variable(apply_binary(in.op, element(x, 0), element(y, 0)));
+                } else {
+                    regs_[in.a] = apply_array(in.op, x, y);
+                }
+                break;
+            }
+
+            case OpCode::Range: {
+                double start = scalar_of(regs_[in.b], "Range");
+                double step = in.n == 3 ? scalar_of(regs_[in.b + 1], "Range") : 1.0;
+                double stop = scalar_of(regs_[in.b + in.n - 1], "Range");
+                size_t count = range_count(start, step, stop);
+                AlignedVector values(count);
+                for (size_t k = 0; k < count; k++) values[k] = start + static_cast<double>(k) * step;
+                regs_[in.a] = from_column_major(1, count, std::move(values));
+                break;
+            }
+
+            case OpCode::HorzCat:
+                regs_[in.a] = horzcat(regs_.data() + in.b, in.c);
+                break;
+
+            case OpCode::VertCat:
+                regs_[in.a] = vertcat(regs_.data() + in.b, in.c);
+                break;
+
+            case OpCode::CallOrIndex: {
+                if (const Variable* v = ws.find(slots_[in.c])) {
+                    regs_[in.a] = index_variable(*v, regs_.data() + in.b, in.n, in.flags & kColonIndex);
+                } else {
+                    std::vector<Variable> args;
+                    args.reserve(in.n);
+                    for (uint32_t i = 0; i < in.n; i++) args.push_back(std::move(regs_[in.b + i]));
+                    regs_[in.a] = window_.call_function(s.symbols[in.c], args);
+                }
+                break;
+            }
+
+            case OpCode::Fused:
+                if (run_fused(s, s.fused[in.b], regs_[in.a])) { pc = in.c; continue; }
+                break;
+
+            case OpCode::StoreIndex: {
+                Workspace::Slot slot = slots_[in.c];
+                Variable* target = ws.find_mutable(slot);
+                if (target && assign_in_place(*target, regs_.data() + in.b, in.n, regs_[in.a])) break;
+                Variable updated = assign_indexed(ws.find(slot), regs_.data() + in.b, in.n, regs_[in.a]);
+                ws.set(slot, std::move(updated));
+                break;
+            }
+
+            case OpCode::EndOf: {
+                const Variable* v = &ws.get(slots_[in.b]);
+                uint32_t dim = in.c >> 8, count = in.c & 0xff;
+                size_t extent;
+                if (count == 1) extent = numel(*v);
+                else if (dim == 0) extent = rows_of(*v);
+                else if (dim == 1) extent = cols_of(*v);
+                else extent = 1;
+                regs_[in.a] = Variable(static_cast<double>(extent));
+                break;
+            }
+
+            case OpCode::Jump:
+                pc = in.a;
+                continue;
+
+            case OpCode::JumpIfFalse:
+                if (!truthy(operand(s, in.a))) { pc = in.b; continue; }
+                break;
+
+            case OpCode::JumpIfTrue:
+                if (truthy(operand(s, in.a))) { pc = in.b; continue; }
+                break;
+
+            case OpCode::ForRangePrep: {
+                double start = scalar_of(regs_[in.a], "for range");
+                double step = scalar_of(regs_[in.a + 1], "for range");
+                double stop = scalar_of(regs_[in.a + 2], "for range");
+                regs_[in.a] = Variable(start);
+                regs_[in.a + 1] = Variable(step);
+                regs_[in.a + 3] = Variable(static_cast<double>(range_count(start, step, stop)));
+                regs_[in.a + 4] = Variable(0.0);
+                break;
+            }
+
+            case OpCode::ForRangeNext: {
+                double k = regs_[in.a + 4].as_scalar();
+                if (k >= regs_[in.a + 3].as_scalar()) { pc = in.c; continue; }
+                double value = regs_[in.a].as_scalar() + k * regs_[in.a + 1].as_scalar();
+                ws.set(slots_[in.b], Variable(value));
+                regs_[in.a + 4] = Variable(k + 1.0);
+                break;
+            }
+
+            case OpCode::ForEachPrep:
+                regs_[in.a + 1] = Variable(0.0);
+                break;
+
+            case OpCode::ForEachNext: {
+                const Variable& iterable = regs_[in.a];
+                size_t k = static_cast<size_t>(regs_[in.a + 1].as_scalar());
+                size_t rows = rows_of(iterable);
+                if (rows == 0 || k >= cols_of(iterable)) { pc = in.c; continue; }
+                AlignedVector column(rows);
+                for (size_t i = 0; i < rows; i++) column[i] = element(iterable, i + k * rows);
+                ws.set(slots_[in.b], from_column_major(rows, 1, std::move(column)));
+                regs_[in.a + 1] = Variable(static_cast<double>(k + 1));
+                break;
+            }
+
+            case OpCode::Display: {
+                const Variable& v = ws.get(slots_[in.b]);
+                auto mode = static_cast<DisplayMode>(in.n);
+                if (mode == DisplayMode::Named) window_.show_variable(s.symbols[in.b], v);
+                else if (mode == DisplayMode::Ans) window_.show_ans(v);
+                break;
+            }
+
+            case OpCode::Command:
+            case OpCode::EvalText:
+                window_.process_command_external(s.strings[in.b]);
+                break;
+
+            case OpCode::Section: {
+                const std::string& title = s.strings[in.b];
+                result.sections.push_back(title);
+                if (verbose_ && !title.empty()) {
+                    std::cout << "\n── " << title << " ──\n";
+                }
+                break;
+            }
+
+            case OpCode::Raise:
+                throw std::runtime_error(s.strings[in.b]);
+
+            case OpCode::Halt:
+                return;
+        }
+        pc++;
+    }
+}
+
+} // namespace interpreter
+} // namespace matlabcpp
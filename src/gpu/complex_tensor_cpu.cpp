@@ -4,16 +4,23 @@
 // Complete CPU-side implementation of the ComplexTensor class.
 // When CUDA is available, operations dispatch to GPU kernels.
 // When CUDA is absent, all operations use optimised CPU routines.
+//
+// Planar tensors run elementwise work on whole planes through the double
+// kernels (kernels.hpp), so complex products need no lane shuffles and
+// real operands skip their missing imaginary plane. Matrix products of
+// planar tensors are up to four real gemms, one when both are real.
 
 #include "matlabcpp/complex_tensor.hpp"
+#include "matlabcpp/fft.hpp"
+#include "matlabcpp/kernels.hpp"
 #include <algorithm>
-#include <numeric>
 #include <random>
 #include <cmath>
 #include <cassert>
 #include <sstream>
 #include <iomanip>
 #include <stdexcept>
+#include <utility>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -21,48 +28,159 @@
 
 namespace matlabcpp {
 
+// Elementwise operands, in-place targets and output parameters are
+// checked in every build: a mismatch would read past a buffer
+void check_same_shape(const char* op, size_t rows, size_t cols, size_t depth,
+                      size_t other_rows, size_t other_cols, size_t other_depth) {
+    if (rows != other_rows || cols != other_cols || depth != other_depth) {
+        throw std::invalid_argument(std::string(op) + ": operands are " + std::to_string(rows) + "x" +
+                                    std::to_string(cols) + "x" + std::to_string(depth) + " and " +
+                                    std::to_string(other_rows) + "x" + std::to_string(other_cols) + "x" +
+                                    std::to_string(other_depth));
+    }
+}
+
+void check_inner_dims(const char* op, size_t cols, size_t other_rows) {
+    if (cols != other_rows) {
+        throw std::invalid_argument(std::string(op) + ": inner dimensions " + std::to_string(cols) + " and " +
+                                    std::to_string(other_rows) + " differ");
+    }
+}
+
+namespace {
+
+void check_same_shape(const ComplexTensor& a, const ComplexTensor& b, const char* op) {
+    matlabcpp::check_same_shape(op, a.rows(), a.cols(), a.depth(), b.rows(), b.cols(), b.depth());
+}
+
+void check_inner_dims(const ComplexTensor& a, const ComplexTensor& b) {
+    matlabcpp::check_inner_dims("mtimes", a.cols(), b.rows());
+}
+
+} // namespace
+
 // ========== CPU STORAGE ==========
 
 CPUStorage::CPUStorage(size_t size) : data_(size, {0.0, 0.0}) {}
-CPUStorage::CPUStorage(const std::vector<Complex>& data) : data_(data) {}
+CPUStorage::CPUStorage(Buffer data) : data_(std::move(data)) {}
 
+// Storage cannot change its own kind: ComplexTensor::to_gpu swaps it for
+// a GPUStorage instead
 void CPUStorage::to_gpu() {
-#ifdef HAVE_CUDA
-    // Implemented in complex_tensor_kernels.cu
-#else
-    throw std::runtime_error("GPU support not available (compiled without CUDA)");
-#endif
+    throw std::logic_error("CPU storage cannot move itself to a device: use ComplexTensor::to_gpu()");
 }
 
 std::unique_ptr<TensorStorage> CPUStorage::clone() const {
     return std::make_unique<CPUStorage>(data_);
 }
 
-// ========== GPU STORAGE (stub for non-CUDA builds) ==========
+// ========== PLANAR STORAGE ==========
+
+PlanarStorage::PlanarStorage(size_t size) : re_(size, 0.0) {}
+PlanarStorage::PlanarStorage(AlignedVector re, AlignedVector im)
+    : re_(std::move(re)), im_(std::move(im)) {}
+
+double* PlanarStorage::imag() {
+    if (im_.size() != re_.size()) im_.assign(re_.size(), 0.0);
+    return im_.data();
+}
+
+void PlanarStorage::to_gpu() {
+    throw std::logic_error("Planar storage cannot move itself to a device: use ComplexTensor::to_gpu()");
+}
+
+std::unique_ptr<TensorStorage> PlanarStorage::clone() const {
+    return std::make_unique<PlanarStorage>(re_, im_);
+}
+
+// ========== GPU STORAGE ==========
+
+GPUStorage::GPUStorage(size_t size) : GPUStorage(size, Uninitialized{}) {
+    if (size_) stream().zero(gpu_data_, bytes());
+}
+
+GPUStorage::GPUStorage(const Complex* host_data, size_t size) : GPUStorage(size, Uninitialized{}) {
+    if (size_) stream().copy_to_device(gpu_data_, host_data, bytes());
+}
+
+// No host copy yet, which counts as a stale one
+GPUStorage::GPUStorage(size_t size, Uninitialized)
+    : backend_(DeviceBackend::current()), gpu_data_(nullptr), size_(size),
+      host_dirty_(false), gpu_dirty_(true) {
+    allocate_gpu();
+}
+
+std::unique_ptr<GPUStorage> GPUStorage::uninitialized(size_t size) {
+    return std::unique_ptr<GPUStorage>(new GPUStorage(size, Uninitialized{}));
+}
+
+GPUStorage::~GPUStorage() { free_gpu(); }
+
+GPUStorage::Complex* GPUStorage::gpu_ptr() {
+    sync_to_gpu();
+    gpu_dirty_ = true;
+    return gpu_data_;
+}
+
+const GPUStorage::Complex* GPUStorage::gpu_ptr() const {
+    sync_to_gpu();
+    return gpu_data_;
+}
+
+GPUStorage::Complex* GPUStorage::data() {
+    sync_to_host();
+    host_dirty_ = true;
+    return host_cache_.data();
+}
+
+const GPUStorage::Complex* GPUStorage::data() const {
+    sync_to_host();
+    return host_cache_.data();
+}
 
-#ifndef HAVE_CUDA
+void GPUStorage::to_gpu() { sync_to_gpu(); }
+void GPUStorage::to_cpu() { sync_to_host(); }
+
+std::unique_ptr<TensorStorage> GPUStorage::clone() const {
+    auto copy = uninitialized(size_);
+    if (size_) stream().copy(copy->gpu_data_, gpu_ptr(), bytes());
+    return copy;
+}
 
-GPUStorage::GPUStorage(size_t size) : gpu_data_(nullptr), size_(size), host_dirty_(false), gpu_dirty_(false) {
-    throw std::runtime_error("GPU support not available (compiled without CUDA)");
+CPUStorage::Buffer GPUStorage::release_host() {
+    sync_to_host();
+    CPUStorage::Buffer host = std::move(host_cache_);
+    host_cache_ = CPUStorage::Buffer();
+    host_dirty_ = false;
+    gpu_dirty_ = true;
+    return host;
 }
 
-GPUStorage::GPUStorage(const Complex* host_data, size_t size)
-    : gpu_data_(nullptr), size_(size), host_dirty_(false), gpu_dirty_(false) {
-    throw std::runtime_error("GPU support not available (compiled without CUDA)");
+void GPUStorage::sync_to_host() const {
+    if (!gpu_dirty_) return;
+    host_cache_.resize(size_);
+    if (size_) {
+        stream().copy_to_host(host_cache_.data(), gpu_data_, bytes());
+        stream().synchronize();
+    }
+    gpu_dirty_ = false;
 }
 
-GPUStorage::~GPUStorage() {}
+// Asynchronous: the stream stages the host copy before returning
+void GPUStorage::sync_to_gpu() const {
+    if (!host_dirty_) return;
+    if (size_) stream().copy_to_device(gpu_data_, host_cache_.data(), bytes());
+    host_dirty_ = false;
+}
 
-GPUStorage::Complex* GPUStorage::data() { return nullptr; }
-const GPUStorage::Complex* GPUStorage::data() const { return nullptr; }
-void GPUStorage::to_cpu() {}
-std::unique_ptr<TensorStorage> GPUStorage::clone() const { return nullptr; }
-void GPUStorage::sync_to_host() const {}
-void GPUStorage::sync_to_gpu() {}
-void GPUStorage::allocate_gpu() {}
-void GPUStorage::free_gpu() {}
+void GPUStorage::allocate_gpu() {
+    gpu_data_ = size_ ? static_cast<Complex*>(backend_->allocate(bytes())) : nullptr;
+}
 
-#endif // !HAVE_CUDA
+void GPUStorage::free_gpu() {
+    if (gpu_data_) stream().release(gpu_data_, bytes());
+    gpu_data_ = nullptr;
+}
 
 // ========== COMPLEX TENSOR ==========
 
@@ -87,11 +205,18 @@ ComplexTensor::ComplexTensor(size_t rows, size_t cols, size_t depth, Device devi
     }
 }
 
+ComplexTensor ComplexTensor::planar(size_t rows, size_t cols, size_t depth) {
+    ComplexTensor t;
+    t.rows_ = rows;
+    t.cols_ = cols;
+    t.depth_ = depth;
+    t.storage_ = std::make_unique<PlanarStorage>(rows * cols * depth);
+    return t;
+}
+
 ComplexTensor ComplexTensor::from_real(const std::vector<double>& data, size_t rows, size_t cols) {
-    ComplexTensor t(rows, cols);
-    for (size_t i = 0; i < data.size() && i < rows * cols; i++) {
-        t.data()[i] = {data[i], 0.0};
-    }
+    ComplexTensor t = planar(rows, cols);
+    std::copy_n(data.begin(), std::min(data.size(), rows * cols), t.real_data());
     return t;
 }
 
@@ -103,180 +228,810 @@ ComplexTensor ComplexTensor::from_complex(const std::vector<Complex>& data, size
 
 // Data access
 ComplexTensor::Complex& ComplexTensor::operator()(size_t i, size_t j) {
-    ensure_cpu();
+    ensure_layout(Layout::Interleaved);
     return storage_->data()[i * cols_ + j];
 }
 
 ComplexTensor::Complex ComplexTensor::operator()(size_t i, size_t j) const {
-    ensure_cpu();
-    return storage_->data()[i * cols_ + j];
+    return (*this)(i, j, 0);
 }
 
 ComplexTensor::Complex& ComplexTensor::operator()(size_t i, size_t j, size_t k) {
-    ensure_cpu();
+    ensure_layout(Layout::Interleaved);
     return storage_->data()[(k * rows_ + i) * cols_ + j];
 }
 
+// A GPU tensor reads its host copy, downloading it if needed
 ComplexTensor::Complex ComplexTensor::operator()(size_t i, size_t j, size_t k) const {
-    ensure_cpu();
-    return storage_->data()[(k * rows_ + i) * cols_ + j];
+    size_t index = (k * rows_ + i) * cols_ + j;
+    if (layout() == Layout::Planar) {
+        const PlanarStorage& p = planes();
+        return {p.real()[index], p.imag() ? p.imag()[index] : 0.0};
+    }
+    return std::as_const(*storage_).data()[index];
 }
 
 const ComplexTensor::Complex* ComplexTensor::data() const {
-    ensure_cpu();
-    return storage_->data();
+    ensure_layout(Layout::Interleaved);
+    return storage_ ? std::as_const(*storage_).data() : nullptr;
 }
 
 ComplexTensor::Complex* ComplexTensor::data() {
-    ensure_cpu();
-    return storage_->data();
+    ensure_layout(Layout::Interleaved);
+    return storage_ ? storage_->data() : nullptr;
+}
+
+const double* ComplexTensor::real_data() const {
+    ensure_layout(Layout::Planar);
+    return planes().real();
+}
+
+double* ComplexTensor::real_data() {
+    ensure_layout(Layout::Planar);
+    return planes().real();
+}
+
+const double* ComplexTensor::imag_data() const {
+    ensure_layout(Layout::Planar);
+    return static_cast<const PlanarStorage&>(planes()).imag();
+}
+
+double* ComplexTensor::imag_data() {
+    ensure_layout(Layout::Planar);
+    return planes().imag();
+}
+
+// Layout management
+Layout ComplexTensor::layout() const {
+    return storage_ ? storage_->layout() : Layout::Interleaved;
+}
+
+void ComplexTensor::to_planar() { ensure_layout(Layout::Planar); }
+void ComplexTensor::to_interleaved() { ensure_layout(Layout::Interleaved); }
+
+bool ComplexTensor::is_real() const {
+    return layout() == Layout::Planar && planes().is_real();
+}
+
+size_t ComplexTensor::memory_bytes() const {
+    if (layout() == Layout::Planar) return size() * sizeof(double) * (is_real() ? 1 : 2);
+    return size() * sizeof(Complex);
+}
+
+// Converts in place, like ensure_cpu: the layout is a cache property,
+// not part of the value
+// A GPU tensor's host copy is interleaved; planar moves it to the CPU.
+void ComplexTensor::ensure_layout(Layout target) const {
+    if (device_ == Device::GPU) {
+        if (target == Layout::Interleaved) return;
+        ensure_cpu();
+    }
+    if (!storage_ || storage_->layout() == target) return;
+    auto* self = const_cast<ComplexTensor*>(this);
+    const size_t n = size();
+    if (target == Layout::Planar) {
+        const Complex* z = storage_->data();
+        AlignedVector re(n), im;
+        bool real = true;
+        for (size_t i = 0; i < n; i++) {
+            re[i] = z[i].real();
+            if (z[i].imag() != 0.0) real = false;
+        }
+        if (!real) {
+            im.resize(n);
+            for (size_t i = 0; i < n; i++) im[i] = z[i].imag();
+        }
+        self->storage_ = std::make_unique<PlanarStorage>(std::move(re), std::move(im));
+    } else {
+        const PlanarStorage& p = planes();
+        const double* re = p.real();
+        const double* im = p.imag();
+        CPUStorage::Buffer z(n);
+        for (size_t i = 0; i < n; i++) z[i] = {re[i], im ? im[i] : 0.0};
+        self->storage_ = std::make_unique<CPUStorage>(std::move(z));
+    }
+}
+
+PlanarStorage& ComplexTensor::planes() const {
+    assert(layout() == Layout::Planar);
+    return static_cast<PlanarStorage&>(*storage_);
 }
 
 // Device management
-void ComplexTensor::to_gpu() { storage_->to_gpu(); device_ = Device::GPU; }
-void ComplexTensor::to_cpu() { storage_->to_cpu(); device_ = Device::CPU; }
+void ComplexTensor::to_gpu() {
+    if (device_ == Device::GPU) return;
+    ensure_layout(Layout::Interleaved);
+    const Complex* host = storage_ ? std::as_const(*storage_).data() : nullptr;
+    storage_ = std::make_unique<GPUStorage>(host, size());
+    device_ = Device::GPU;
+}
+
+void ComplexTensor::to_cpu() {
+    if (device_ == Device::CPU) return;
+    storage_ = std::make_unique<CPUStorage>(device_storage().release_host());
+    device_ = Device::CPU;
+}
 
 ComplexTensor ComplexTensor::on_gpu() const {
-    ComplexTensor copy(rows_, cols_, Device::GPU);
-    // Copy data
-    auto cloned = storage_->clone();
-    cloned->to_gpu();
-    copy.storage_ = std::move(cloned);
+    ComplexTensor copy;
+    copy.rows_ = rows_;
+    copy.cols_ = cols_;
+    copy.depth_ = depth_;
+    copy.device_ = Device::GPU;
+    if (device_ == Device::GPU) {
+        copy.storage_ = storage_->clone();
+    } else {
+        copy.storage_ = std::make_unique<GPUStorage>(data(), size());
+    }
     return copy;
 }
 
 ComplexTensor ComplexTensor::on_cpu() const {
-    ComplexTensor copy(rows_, cols_, Device::CPU);
-    auto cloned = storage_->clone();
-    cloned->to_cpu();
-    copy.storage_ = std::move(cloned);
+    ComplexTensor copy;
+    copy.rows_ = rows_;
+    copy.cols_ = cols_;
+    copy.depth_ = depth_;
+    if (device_ == Device::GPU) {
+        const Complex* host = data();
+        copy.storage_ = std::make_unique<CPUStorage>(CPUStorage::Buffer(host, host + size()));
+    } else if (storage_) {
+        copy.storage_ = storage_->clone();
+    }
     return copy;
 }
 
+GPUStorage& ComplexTensor::device_storage() const {
+    assert(device_ == Device::GPU);
+    return static_cast<GPUStorage&>(*storage_);
+}
+
+// ========== DEVICE OPERATIONS ==========
+
+ComplexTensor ComplexTensor::device_tensor(size_t rows, size_t cols, size_t depth) {
+    ComplexTensor t;
+    t.rows_ = rows;
+    t.cols_ = cols;
+    t.depth_ = depth;
+    t.device_ = Device::GPU;
+    t.storage_ = GPUStorage::uninitialized(rows * cols * depth);
+    return t;
+}
+
+// Host operands are uploaded for the call (copies, so out may be either
+// operand); out keeps its device buffer when it already has this shape
+void ComplexTensor::device_elementwise(DeviceOp op, const ComplexTensor& other, ComplexTensor& out) const {
+    check_same_shape(*this, other, "elementwise");
+    ComplexTensor a_copy, b_copy;
+    const ComplexTensor& a = device_ == Device::GPU ? *this : (a_copy = on_gpu());
+    const ComplexTensor& b = other.device_ == Device::GPU ? other : (b_copy = other.on_gpu());
+    if (out.device_ != Device::GPU || out.rows_ != rows_ || out.cols_ != cols_ || out.depth_ != depth_) {
+        out = device_tensor(rows_, cols_, depth_);
+    }
+    const Complex* pa = std::as_const(a.device_storage()).gpu_ptr();
+    const Complex* pb = std::as_const(b.device_storage()).gpu_ptr();
+    GPUStorage& result = out.device_storage();
+    result.stream().elementwise(op, pa, pb, result.gpu_ptr(), size());
+}
+
+void ComplexTensor::device_scale(const Complex& scalar, ComplexTensor& out) const {
+    ComplexTensor a_copy;
+    const ComplexTensor& a = device_ == Device::GPU ? *this : (a_copy = on_gpu());
+    if (out.device_ != Device::GPU || out.rows_ != rows_ || out.cols_ != cols_ || out.depth_ != depth_) {
+        out = device_tensor(rows_, cols_, depth_);
+    }
+    const Complex* pa = std::as_const(a.device_storage()).gpu_ptr();
+    GPUStorage& result = out.device_storage();
+    result.stream().scale(pa, scalar, result.gpu_ptr(), size());
+}
+
+void ComplexTensor::device_conj(ComplexTensor& out) const {
+    ComplexTensor a_copy;
+    const ComplexTensor& a = device_ == Device::GPU ? *this : (a_copy = on_gpu());
+    if (out.device_ != Device::GPU || out.rows_ != rows_ || out.cols_ != cols_ || out.depth_ != depth_) {
+        out = device_tensor(rows_, cols_, depth_);
+    }
+    const Complex* pa = std::as_const(a.device_storage()).gpu_ptr();
+    GPUStorage& result = out.device_storage();
+    result.stream().conj(pa, result.gpu_ptr(), size());
+}
+
+void ComplexTensor::device_mtimes(const ComplexTensor& other, ComplexTensor& out) const {
+    check_inner_dims(*this, other);
+    const size_t m = rows_, k = cols_, n = other.cols_;
+    // gemm cannot write over its inputs
+    if (&out == this || &out == &other || out.device_ != Device::GPU || out.rows_ != m ||
+        out.cols_ != n || out.depth_ != 1) {
+        ComplexTensor fresh = device_tensor(m, n, 1);
+        device_mtimes(other, fresh);
+        out = std::move(fresh);
+        return;
+    }
+    ComplexTensor a_copy, b_copy;
+    const ComplexTensor& a = device_ == Device::GPU ? *this : (a_copy = on_gpu());
+    const ComplexTensor& b = other.device_ == Device::GPU ? other : (b_copy = other.on_gpu());
+    const Complex* pa = std::as_const(a.device_storage()).gpu_ptr();
+    const Complex* pb = std::as_const(b.device_storage()).gpu_ptr();
+    GPUStorage& result = out.device_storage();
+    // Row-major storage: C' = B' * A' in gemm's column-major terms
+    result.stream().gemm(n, m, k, pb, n, pa, k, result.gpu_ptr(), n);
+}
+
 // ========== ELEMENT-WISE OPERATIONS ==========
 
+namespace {
+
+using Complex = ComplexTensor::Complex;
+using kernels::BinaryOp;
+
+// Element i of either layout, without converting the tensor
+class Elements {
+public:
+    explicit Elements(const ComplexTensor& t) {
+        if (t.layout() == Layout::Planar) {
+            re_ = t.real_data();
+            im_ = t.imag_data();
+        } else {
+            z_ = t.data();
+        }
+    }
+    Complex operator[](size_t i) const {
+        if (z_) return z_[i];
+        return {re_[i], im_ ? im_[i] : 0.0};
+    }
+
+private:
+    const Complex* z_ = nullptr;
+    const double* re_ = nullptr;
+    const double* im_ = nullptr;
+};
+
+bool both_planar(const ComplexTensor& a, const ComplexTensor& b) {
+    return a.layout() == Layout::Planar && b.layout() == Layout::Planar;
+}
+
+// Whether out can take a rows x cols x depth result in its current buffer.
+// A real planar result cannot go where an imaginary plane already is.
+bool fits(const ComplexTensor& out, size_t rows, size_t cols, size_t depth,
+          Layout layout, bool real) {
+    if (out.device() != Device::CPU || out.rows() != rows || out.cols() != cols ||
+        out.depth() != depth || out.layout() != layout) {
+        return false;
+    }
+    return layout == Layout::Interleaved || !real || out.is_real() || out.size() == 0;
+}
+
+ComplexTensor make(size_t rows, size_t cols, size_t depth, Layout layout) {
+    if (layout == Layout::Planar) return ComplexTensor::planar(rows, cols, depth);
+    return ComplexTensor(rows, cols, depth);
+}
+
+enum class Elementwise { Add, Sub, Mul, Div };
+
+// out = a op b, elementwise. Planar operands give a planar result, and
+// real operands a real one. The loops only touch index i for element i,
+// so out may alias either operand.
+void elementwise(Elementwise op, const ComplexTensor& a, const ComplexTensor& b, ComplexTensor& out) {
+    check_same_shape(a, b, "elementwise");
+    const bool planar = both_planar(a, b);
+    const Layout layout = planar ? Layout::Planar : Layout::Interleaved;
+    if (!fits(out, a.rows(), a.cols(), a.depth(), layout, a.is_real() && b.is_real())) {
+        ComplexTensor fresh = make(a.rows(), a.cols(), a.depth(), layout);
+        elementwise(op, a, b, fresh);
+        out = std::move(fresh);
+        return;
+    }
+    const size_t n = a.size();
+    if (n == 0) return;
+    if (!planar) {
+        Elements x(a), y(b);
+        Complex* c = out.data();
+        switch (op) {
+            case Elementwise::Add: for (size_t i = 0; i < n; i++) c[i] = x[i] + y[i]; break;
+            case Elementwise::Sub: for (size_t i = 0; i < n; i++) c[i] = x[i] - y[i]; break;
+            case Elementwise::Mul: for (size_t i = 0; i < n; i++) c[i] = x[i] * y[i]; break;
+            case Elementwise::Div: for (size_t i = 0; i < n; i++) c[i] = x[i] / y[i]; break;
+        }
+        return;
+    }
+
+    const double* ar = a.real_data();
+    const double* ai = a.imag_data();
+    const double* br = b.real_data();
+    const double* bi = b.imag_data();
+    double* cr = out.real_data();
+    switch (op) {
+        case Elementwise::Add:
+        case Elementwise::Sub: {
+            BinaryOp k = op == Elementwise::Add ? BinaryOp::Add : BinaryOp::Sub;
+            kernels::binary(k, ar, 1, br, 1, cr, n);
+            if (ai && bi) {
+                kernels::binary(k, ai, 1, bi, 1, out.imag_data(), n);
+            } else if (ai) {
+                std::copy(ai, ai + n, out.imag_data());
+            } else if (bi && op == Elementwise::Add) {
+                std::copy(bi, bi + n, out.imag_data());
+            } else if (bi) {
+                kernels::unary(kernels::UnaryOp::Neg, bi, out.imag_data(), n);
+            }
+            break;
+        }
+        case Elementwise::Mul:
+            if (ai && bi) {
+                kernels::complex_multiply(ar, ai, br, bi, cr, out.imag_data(), n);
+            } else if (ai) {
+                kernels::binary(BinaryOp::Mul, ai, 1, br, 1, out.imag_data(), n);
+                kernels::binary(BinaryOp::Mul, ar, 1, br, 1, cr, n);
+            } else if (bi) {
+                kernels::binary(BinaryOp::Mul, ar, 1, bi, 1, out.imag_data(), n);
+                kernels::binary(BinaryOp::Mul, ar, 1, br, 1, cr, n);
+            } else {
+                kernels::binary(BinaryOp::Mul, ar, 1, br, 1, cr, n);
+            }
+            break;
+        case Elementwise::Div:
+            if (!bi) {
+                if (ai) kernels::binary(BinaryOp::Div, ai, 1, br, 1, out.imag_data(), n);
+                kernels::binary(BinaryOp::Div, ar, 1, br, 1, cr, n);
+                break;
+            }
+            {
+                double* ci = out.imag_data();
+                for (size_t i = 0; i < n; i++) {
+                    Complex q = Complex(ar[i], ai ? ai[i] : 0.0) / Complex(br[i], bi[i]);
+                    cr[i] = q.real();
+                    ci[i] = q.imag();
+                }
+            }
+            break;
+    }
+}
+
+// out = a * s or a / s; out may be a
+void scalar_op(const ComplexTensor& a, Complex s, bool divide, ComplexTensor& out) {
+    const Layout layout = a.layout() == Layout::Planar ? Layout::Planar : Layout::Interleaved;
+    const bool real = a.is_real() && s.imag() == 0.0;
+    if (!fits(out, a.rows(), a.cols(), a.depth(), layout, real)) {
+        ComplexTensor fresh = make(a.rows(), a.cols(), a.depth(), layout);
+        scalar_op(a, s, divide, fresh);
+        out = std::move(fresh);
+        return;
+    }
+    const size_t n = a.size();
+    if (n == 0) return;
+    if (layout == Layout::Interleaved) {
+        const Complex* x = a.data();
+        Complex* c = out.data();
+        if (divide) {
+            for (size_t i = 0; i < n; i++) c[i] = x[i] / s;
+        } else {
+            for (size_t i = 0; i < n; i++) c[i] = x[i] * s;
+        }
+        return;
+    }
+
+    const double* ar = a.real_data();
+    const double* ai = a.imag_data();
+    double* cr = out.real_data();
+    if (s.imag() == 0.0) {
+        double k = s.real();
+        BinaryOp op = divide ? BinaryOp::Div : BinaryOp::Mul;
+        kernels::binary(op, ar, 1, &k, 0, cr, n);
+        if (ai) kernels::binary(op, ai, 1, &k, 0, out.imag_data(), n);
+        return;
+    }
+    double* ci = out.imag_data();
+    for (size_t i = 0; i < n; i++) {
+        Complex x(ar[i], ai ? ai[i] : 0.0);
+        Complex q = divide ? x / s : x * s;
+        cr[i] = q.real();
+        ci[i] = q.imag();
+    }
+}
+
+// a += sign * b in place
+void accumulate(ComplexTensor& a, const ComplexTensor& b, double sign) {
+    check_same_shape(a, b, sign > 0 ? "add_inplace" : "sub_inplace");
+    const size_t n = a.size();
+    if (n == 0) return;
+    BinaryOp op = sign > 0 ? BinaryOp::Add : BinaryOp::Sub;
+    if (both_planar(a, b)) {
+        kernels::binary(op, a.real_data(), 1, b.real_data(), 1, a.real_data(), n);
+        if (const double* bi = b.imag_data()) {
+            kernels::binary(op, a.imag_data(), 1, bi, 1, a.imag_data(), n);
+        }
+        return;
+    }
+    Elements y(b);
+    if (a.layout() == Layout::Planar) {
+        double* re = a.real_data();
+        double* im = a.imag_data();
+        for (size_t i = 0; i < n; i++) {
+            Complex v = y[i];
+            re[i] += sign * v.real();
+            im[i] += sign * v.imag();
+        }
+        return;
+    }
+    Complex* z = a.data();
+    for (size_t i = 0; i < n; i++) z[i] += sign * y[i];
+}
+
+// Copies the elements, interleaved, to out
+void copy_elements(const ComplexTensor& t, Complex* out) {
+    if (t.layout() != Layout::Planar) {
+        std::copy(t.data(), t.data() + t.size(), out);
+        return;
+    }
+    Elements x(t);
+    for (size_t i = 0; i < t.size(); i++) out[i] = x[i];
+}
+
+} // namespace
+
 ComplexTensor ComplexTensor::real() const {
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) {
-        result.data()[i] = {data()[i].real(), 0.0};
+    ComplexTensor result = planar(rows_, cols_, depth_);
+    if (layout() == Layout::Planar) {
+        std::copy(real_data(), real_data() + size(), result.real_data());
+    } else {
+        const Complex* z = data();
+        double* re = result.real_data();
+        for (size_t i = 0; i < size(); i++) re[i] = z[i].real();
     }
     return result;
 }
 
 ComplexTensor ComplexTensor::imag() const {
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) {
-        result.data()[i] = {data()[i].imag(), 0.0};
+    ComplexTensor result = planar(rows_, cols_, depth_);
+    if (layout() == Layout::Planar) {
+        if (const double* im = imag_data()) std::copy(im, im + size(), result.real_data());
+    } else {
+        const Complex* z = data();
+        double* re = result.real_data();
+        for (size_t i = 0; i < size(); i++) re[i] = z[i].imag();
     }
     return result;
 }
 
-ComplexTensor ComplexTensor::conj() const {
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) {
-        result.data()[i] = std::conj(data()[i]);
-    }
+ComplexTensor ComplexTensor::conj() const & {
+    ComplexTensor result;
+    conj(result);
     return result;
 }
 
-ComplexTensor ComplexTensor::abs() const {
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) {
-        result.data()[i] = {std::abs(data()[i]), 0.0};
+ComplexTensor ComplexTensor::conj() && {
+    conj_inplace();
+    return std::move(*this);
+}
+
+void ComplexTensor::conj(ComplexTensor& out) const {
+    if (device_ == Device::GPU) {
+        device_conj(out);
+        return;
     }
+    if (&out == this) {
+        out.conj_inplace();
+        return;
+    }
+    const Layout target = layout() == Layout::Planar ? Layout::Planar : Layout::Interleaved;
+    if (!fits(out, rows_, cols_, depth_, target, is_real())) out = make(rows_, cols_, depth_, target);
+    if (size() == 0) return;
+    if (target == Layout::Planar) {
+        std::copy(real_data(), real_data() + size(), out.real_data());
+        if (const double* im = imag_data()) {
+            kernels::unary(kernels::UnaryOp::Neg, im, out.imag_data(), size());
+        }
+        return;
+    }
+    const Complex* z = data();
+    Complex* c = out.data();
+    for (size_t i = 0; i < size(); i++) c[i] = std::conj(z[i]);
+}
+
+ComplexTensor ComplexTensor::abs() const {
+    ComplexTensor result;
+    abs(result);
     return result;
 }
 
+// Always a real planar result
+void ComplexTensor::abs(ComplexTensor& out) const {
+    if (&out == this) {
+        if (layout() != Layout::Planar) {
+            ComplexTensor fresh;
+            abs(fresh);
+            out = std::move(fresh);
+            return;
+        }
+        // The magnitudes replace the real plane, then the imaginary one goes
+        PlanarStorage& p = planes();
+        if (p.is_real()) {
+            kernels::unary(kernels::UnaryOp::Abs, p.real(), p.real(), size());
+        } else {
+            kernels::complex_abs(p.real(), p.imag(), p.real(), size());
+            p.clear_imag();
+        }
+        return;
+    }
+    if (!fits(out, rows_, cols_, depth_, Layout::Planar, true)) {
+        out = planar(rows_, cols_, depth_);
+    }
+    if (size() == 0) return;
+    double* result = out.real_data();
+    if (layout() == Layout::Planar) {
+        if (const double* im = imag_data()) {
+            kernels::complex_abs(real_data(), im, result, size());
+        } else {
+            kernels::unary(kernels::UnaryOp::Abs, real_data(), result, size());
+        }
+    } else {
+        const Complex* z = data();
+        for (size_t i = 0; i < size(); i++) result[i] = std::abs(z[i]);
+    }
+}
+
 ComplexTensor ComplexTensor::angle() const {
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) {
-        result.data()[i] = {std::arg(data()[i]), 0.0};
+    ComplexTensor result = planar(rows_, cols_, depth_);
+    double* out = result.real_data();
+    if (layout() == Layout::Planar) {
+        const double* re = real_data();
+        const double* im = imag_data();
+        for (size_t i = 0; i < size(); i++) out[i] = std::atan2(im ? im[i] : 0.0, re[i]);
+    } else {
+        const Complex* z = data();
+        for (size_t i = 0; i < size(); i++) out[i] = std::arg(z[i]);
     }
     return result;
 }
 
 // ========== ARITHMETIC ==========
 
-ComplexTensor ComplexTensor::operator+(const ComplexTensor& other) const {
-    assert(rows_ == other.rows_ && cols_ == other.cols_);
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) {
-        result.data()[i] = data()[i] + other.data()[i];
-    }
+ComplexTensor ComplexTensor::operator+(const ComplexTensor& other) const & {
+    ComplexTensor result;
+    plus(other, result);
     return result;
 }
 
-ComplexTensor ComplexTensor::operator-(const ComplexTensor& other) const {
-    assert(rows_ == other.rows_ && cols_ == other.cols_);
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) {
-        result.data()[i] = data()[i] - other.data()[i];
-    }
+ComplexTensor ComplexTensor::operator+(const ComplexTensor& other) && {
+    plus(other, *this);
+    return std::move(*this);
+}
+
+ComplexTensor ComplexTensor::operator-(const ComplexTensor& other) const & {
+    ComplexTensor result;
+    minus(other, result);
     return result;
 }
 
+ComplexTensor ComplexTensor::operator-(const ComplexTensor& other) && {
+    minus(other, *this);
+    return std::move(*this);
+}
+
 ComplexTensor ComplexTensor::operator*(const ComplexTensor& other) const {
     // Matrix multiplication
-    assert(cols_ == other.rows_);
-    ComplexTensor result(rows_, other.cols_);
-    
-    for (size_t i = 0; i < rows_; i++) {
-        for (size_t j = 0; j < other.cols_; j++) {
-            Complex sum = {0.0, 0.0};
-            for (size_t k = 0; k < cols_; k++) {
-                sum += (*this)(i, k) * other(k, j);
-            }
-            result(i, j) = sum;
-        }
-    }
+    ComplexTensor result;
+    mtimes(other, result);
     return result;
 }
 
-ComplexTensor ComplexTensor::operator/(const ComplexTensor& other) const {
-    assert(rows_ == other.rows_ && cols_ == other.cols_);
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) {
-        result.data()[i] = data()[i] / other.data()[i];
+void ComplexTensor::mtimes(const ComplexTensor& other, ComplexTensor& out) const {
+    if (on_device(other)) {
+        device_mtimes(other, out);
+        return;
+    }
+    check_inner_dims(*this, other);
+    const size_t m = rows_, k = cols_, n = other.cols_;
+    const bool planar = both_planar(*this, other);
+    const Layout layout = planar ? Layout::Planar : Layout::Interleaved;
+    // gemm cannot write over its inputs
+    if (&out == this || &out == &other || !fits(out, m, n, 1, layout, is_real() && other.is_real())) {
+        ComplexTensor fresh = make(m, n, 1, layout);
+        mtimes(other, fresh);
+        out = std::move(fresh);
+        return;
+    }
+
+    // Row-major storage: C' = B' * A' in gemm's column-major terms
+    if (!planar) {
+        kernels::gemm(n, m, k, other.data(), n, data(), k, out.data(), n);
+        return;
+    }
+
+    // (Ar + i Ai)(Br + i Bi) as real products, skipping absent planes
+    const double* ar = real_data();
+    const double* ai = imag_data();
+    const double* br = other.real_data();
+    const double* bi = other.imag_data();
+    double* cr = out.real_data();
+    kernels::gemm(n, m, k, 1.0, br, n, ar, k, 0.0, cr, n);
+    if (ai && bi) kernels::gemm(n, m, k, -1.0, bi, n, ai, k, 1.0, cr, n);
+    if (ai || bi) {
+        double* ci = out.imag_data();
+        if (bi) kernels::gemm(n, m, k, 1.0, bi, n, ar, k, 0.0, ci, n);
+        if (ai) kernels::gemm(n, m, k, 1.0, br, n, ai, k, bi ? 1.0 : 0.0, ci, n);
     }
+}
+
+ComplexTensor ComplexTensor::operator/(const ComplexTensor& other) const & {
+    ComplexTensor result;
+    rdivide(other, result);
     return result;
 }
 
+ComplexTensor ComplexTensor::operator/(const ComplexTensor& other) && {
+    rdivide(other, *this);
+    return std::move(*this);
+}
+
 ComplexTensor& ComplexTensor::operator+=(const ComplexTensor& other) {
-    for (size_t i = 0; i < size(); i++) data()[i] += other.data()[i];
-    return *this;
+    return add_inplace(other);
 }
 
 ComplexTensor& ComplexTensor::operator-=(const ComplexTensor& other) {
-    for (size_t i = 0; i < size(); i++) data()[i] -= other.data()[i];
-    return *this;
+    return sub_inplace(other);
 }
 
-ComplexTensor ComplexTensor::operator*(const Complex& scalar) const {
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) result.data()[i] = data()[i] * scalar;
+ComplexTensor ComplexTensor::operator*(const Complex& scalar) const & {
+    ComplexTensor result;
+    times(scalar, result);
     return result;
 }
 
-ComplexTensor ComplexTensor::operator/(const Complex& scalar) const {
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) result.data()[i] = data()[i] / scalar;
+ComplexTensor ComplexTensor::operator*(const Complex& scalar) && {
+    return std::move(scale_inplace(scalar));
+}
+
+ComplexTensor ComplexTensor::operator/(const Complex& scalar) const & {
+    ComplexTensor result;
+    if (device_ == Device::GPU) {
+        device_scale(1.0 / scalar, result);
+    } else {
+        scalar_op(*this, scalar, true, result);
+    }
     return result;
 }
 
-ComplexTensor ComplexTensor::times(const ComplexTensor& other) const {
-    assert(rows_ == other.rows_ && cols_ == other.cols_);
-    ComplexTensor result(rows_, cols_);
-    for (size_t i = 0; i < size(); i++) result.data()[i] = data()[i] * other.data()[i];
+ComplexTensor ComplexTensor::operator/(const Complex& scalar) && {
+    if (device_ == Device::GPU) {
+        device_scale(1.0 / scalar, *this);
+    } else {
+        scalar_op(*this, scalar, true, *this);
+    }
+    return std::move(*this);
+}
+
+ComplexTensor ComplexTensor::times(const ComplexTensor& other) const & {
+    ComplexTensor result;
+    times(other, result);
     return result;
 }
 
-ComplexTensor ComplexTensor::rdivide(const ComplexTensor& other) const {
+ComplexTensor ComplexTensor::times(const ComplexTensor& other) && {
+    return std::move(times_inplace(other));
+}
+
+ComplexTensor ComplexTensor::rdivide(const ComplexTensor& other) const & {
     return *this / other;
 }
 
+ComplexTensor ComplexTensor::rdivide(const ComplexTensor& other) && {
+    return std::move(*this) / other;
+}
+
+// ========== IN PLACE ==========
+
+// A GPU operand moves the result to the device
+ComplexTensor& ComplexTensor::add_inplace(const ComplexTensor& other) {
+    if (on_device(other)) {
+        device_elementwise(DeviceOp::Add, other, *this);
+    } else {
+        accumulate(*this, other, 1.0);
+    }
+    return *this;
+}
+
+ComplexTensor& ComplexTensor::sub_inplace(const ComplexTensor& other) {
+    if (on_device(other)) {
+        device_elementwise(DeviceOp::Sub, other, *this);
+    } else {
+        accumulate(*this, other, -1.0);
+    }
+    return *this;
+}
+
+ComplexTensor& ComplexTensor::times_inplace(const ComplexTensor& other) {
+    times(other, *this);
+    return *this;
+}
+
+ComplexTensor& ComplexTensor::scale_inplace(const Complex& scalar) {
+    times(scalar, *this);
+    return *this;
+}
+
+ComplexTensor& ComplexTensor::conj_inplace() {
+    if (device_ == Device::GPU) {
+        device_conj(*this);
+        return *this;
+    }
+    if (layout() == Layout::Planar) {
+        PlanarStorage& p = planes();
+        if (!p.is_real()) kernels::unary(kernels::UnaryOp::Neg, p.imag(), p.imag(), size());
+        return *this;
+    }
+    Complex* z = data();
+    for (size_t i = 0; i < size(); i++) z[i] = std::conj(z[i]);
+    return *this;
+}
+
+// ========== OUTPUT PARAMETERS ==========
+
+// With either operand on the GPU the work runs there and out becomes a GPU
+// tensor; host operands are uploaded for the call
+
+void ComplexTensor::plus(const ComplexTensor& other, ComplexTensor& out) const {
+    if (on_device(other)) {
+        device_elementwise(DeviceOp::Add, other, out);
+    } else {
+        elementwise(Elementwise::Add, *this, other, out);
+    }
+}
+
+void ComplexTensor::minus(const ComplexTensor& other, ComplexTensor& out) const {
+    if (on_device(other)) {
+        device_elementwise(DeviceOp::Sub, other, out);
+    } else {
+        elementwise(Elementwise::Sub, *this, other, out);
+    }
+}
+
+void ComplexTensor::times(const ComplexTensor& other, ComplexTensor& out) const {
+    if (on_device(other)) {
+        device_elementwise(DeviceOp::Mul, other, out);
+    } else {
+        elementwise(Elementwise::Mul, *this, other, out);
+    }
+}
+
+void ComplexTensor::times(const Complex& scalar, ComplexTensor& out) const {
+    if (device_ == Device::GPU) {
+        device_scale(scalar, out);
+    } else {
+        scalar_op(*this, scalar, false, out);
+    }
+}
+
+void ComplexTensor::rdivide(const ComplexTensor& other, ComplexTensor& out) const {
+    if (on_device(other)) {
+        device_elementwise(DeviceOp::Div, other, out);
+    } else {
+        elementwise(Elementwise::Div, *this, other, out);
+    }
+}
+
 // ========== LINEAR ALGEBRA ==========
 
+// Planes of an m x n planar matrix into an n x m one; negate the imaginary
+// plane for the conjugate transpose
+static ComplexTensor transpose_planes(const ComplexTensor& a, bool conjugate) {
+    const size_t m = a.rows(), n = a.cols();
+    ComplexTensor result = ComplexTensor::planar(n, m);
+    const double* re = a.real_data();
+    const double* im = a.imag_data();
+    double* tr = result.real_data();
+    double* ti = im ? result.imag_data() : nullptr;
+    double sign = conjugate ? -1.0 : 1.0;
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            tr[j * m + i] = re[i * n + j];
+            if (ti) ti[j * m + i] = sign * im[i * n + j];
+        }
+    }
+    return result;
+}
+
 ComplexTensor ComplexTensor::transpose() const {
+    if (layout() == Layout::Planar) return transpose_planes(*this, true);
     ComplexTensor result(cols_, rows_);
     for (size_t i = 0; i < rows_; i++) {
         for (size_t j = 0; j < cols_; j++) {
@@ -287,6 +1042,7 @@ ComplexTensor ComplexTensor::transpose() const {
 }
 
 ComplexTensor ComplexTensor::transpose_no_conj() const {
+    if (layout() == Layout::Planar) return transpose_planes(*this, false);
     ComplexTensor result(cols_, rows_);
     for (size_t i = 0; i < rows_; i++) {
         for (size_t j = 0; j < cols_; j++) {
@@ -296,122 +1052,16 @@ ComplexTensor ComplexTensor::transpose_no_conj() const {
     return result;
 }
 
-ComplexTensor ComplexTensor::inv() const {
-    assert(rows_ == cols_);
-    size_t n = rows_;
-    
-    // Augmented matrix [A | I]
-    ComplexTensor aug(n, 2 * n);
-    for (size_t i = 0; i < n; i++) {
-        for (size_t j = 0; j < n; j++) {
-            aug(i, j) = (*this)(i, j);
-        }
-        aug(i, n + i) = {1.0, 0.0};
-    }
-    
-    // Gauss-Jordan elimination
-    for (size_t k = 0; k < n; k++) {
-        // Partial pivoting
-        size_t max_row = k;
-        double max_val = std::abs(aug(k, k));
-        for (size_t i = k + 1; i < n; i++) {
-            if (std::abs(aug(i, k)) > max_val) {
-                max_val = std::abs(aug(i, k));
-                max_row = i;
-            }
-        }
-        
-        if (max_val < 1e-14) throw std::runtime_error("Matrix is singular");
-        
-        // Swap rows
-        if (max_row != k) {
-            for (size_t j = 0; j < 2 * n; j++) {
-                std::swap(aug(k, j), aug(max_row, j));
-            }
-        }
-        
-        // Scale pivot row
-        Complex pivot = aug(k, k);
-        for (size_t j = 0; j < 2 * n; j++) aug(k, j) /= pivot;
-        
-        // Eliminate column
-        for (size_t i = 0; i < n; i++) {
-            if (i == k) continue;
-            Complex factor = aug(i, k);
-            for (size_t j = 0; j < 2 * n; j++) {
-                aug(i, j) -= factor * aug(k, j);
-            }
-        }
-    }
-    
-    // Extract inverse
-    ComplexTensor result(n, n);
-    for (size_t i = 0; i < n; i++) {
-        for (size_t j = 0; j < n; j++) {
-            result(i, j) = aug(i, n + j);
-        }
-    }
-    return result;
-}
-
-ComplexTensor ComplexTensor::solve(const ComplexTensor& b) const {
-    // A\b using LU decomposition
-    assert(rows_ == cols_ && rows_ == b.rows_);
-    size_t n = rows_;
-    
-    // Copy A and b
-    ComplexTensor A_copy(n, n);
-    ComplexTensor b_copy(n, b.cols_);
-    for (size_t i = 0; i < n * n; i++) A_copy.data()[i] = data()[i];
-    for (size_t i = 0; i < b.size(); i++) b_copy.data()[i] = b.data()[i];
-    
-    // LU with partial pivoting (in-place)
-    std::vector<size_t> perm(n);
-    std::iota(perm.begin(), perm.end(), 0);
-    
-    for (size_t k = 0; k < n; k++) {
-        size_t max_row = k;
-        double max_val = std::abs(A_copy(k, k));
-        for (size_t i = k + 1; i < n; i++) {
-            if (std::abs(A_copy(i, k)) > max_val) {
-                max_val = std::abs(A_copy(i, k));
-                max_row = i;
-            }
-        }
-        
-        if (max_val < 1e-14) throw std::runtime_error("Singular matrix in solve()");
-        
-        if (max_row != k) {
-            std::swap(perm[k], perm[max_row]);
-            for (size_t j = 0; j < n; j++) std::swap(A_copy(k, j), A_copy(max_row, j));
-            for (size_t j = 0; j < b.cols_; j++) std::swap(b_copy(k, j), b_copy(max_row, j));
-        }
-        
-        for (size_t i = k + 1; i < n; i++) {
-            Complex factor = A_copy(i, k) / A_copy(k, k);
-            for (size_t j = k + 1; j < n; j++) A_copy(i, j) -= factor * A_copy(k, j);
-            for (size_t j = 0; j < b.cols_; j++) b_copy(i, j) -= factor * b_copy(k, j);
-        }
-    }
-    
-    // Back substitution
-    ComplexTensor x(n, b.cols_);
-    for (size_t col = 0; col < b.cols_; col++) {
-        for (int i = static_cast<int>(n) - 1; i >= 0; i--) {
-            Complex sum = b_copy(i, col);
-            for (size_t j = i + 1; j < n; j++) sum -= A_copy(i, j) * x(j, col);
-            x(i, col) = sum / A_copy(i, i);
-        }
-    }
-    
-    return x;
-}
-
 // ========== REDUCTIONS ==========
 
 ComplexTensor::Complex ComplexTensor::sum() const {
+    if (layout() == Layout::Planar) {
+        const double* im = imag_data();
+        return {kernels::sum(real_data(), size()), im ? kernels::sum(im, size()) : 0.0};
+    }
     Complex total = {0.0, 0.0};
-    for (size_t i = 0; i < size(); i++) total += data()[i];
+    const Complex* z = data();
+    for (size_t i = 0; i < size(); i++) total += z[i];
     return total;
 }
 
@@ -428,245 +1078,111 @@ ComplexTensor::Complex ComplexTensor::trace() const {
 
 double ComplexTensor::norm() const {
     double sum_sq = 0.0;
+    if (layout() == Layout::Planar) {
+        const double* re = real_data();
+        const double* im = imag_data();
+        for (size_t i = 0; i < size(); i++) sum_sq += re[i] * re[i];
+        if (im) {
+            for (size_t i = 0; i < size(); i++) sum_sq += im[i] * im[i];
+        }
+        return std::sqrt(sum_sq);
+    }
+    const Complex* z = data();
     for (size_t i = 0; i < size(); i++) {
-        sum_sq += std::norm(data()[i]);  // |z|^2
+        sum_sq += std::norm(z[i]);  // |z|^2
     }
     return std::sqrt(sum_sq);
 }
 
-// ========== FFT (CPU Cooley-Tukey) ==========
-
-static void fft_recursive(std::vector<ComplexTensor::Complex>& x) {
-    size_t n = x.size();
-    if (n <= 1) return;
-    
-    std::vector<ComplexTensor::Complex> even(n / 2), odd(n / 2);
-    for (size_t i = 0; i < n / 2; i++) {
-        even[i] = x[2 * i];
-        odd[i] = x[2 * i + 1];
-    }
-    
-    fft_recursive(even);
-    fft_recursive(odd);
-    
-    for (size_t k = 0; k < n / 2; k++) {
-        double angle = -2.0 * M_PI * k / n;
-        ComplexTensor::Complex w = {std::cos(angle), std::sin(angle)};
-        x[k] = even[k] + w * odd[k];
-        x[k + n / 2] = even[k] - w * odd[k];
-    }
-}
+// ========== FFT ==========
 
+// Exact length, like MATLAB: no padding to a power of two
 ComplexTensor ComplexTensor::fft() const {
     assert(is_vector());
-    size_t n = size();
-    
-    // Pad to next power of 2
-    size_t n2 = 1;
-    while (n2 < n) n2 <<= 1;
-    
-    std::vector<Complex> x(n2, {0.0, 0.0});
-    for (size_t i = 0; i < n; i++) x[i] = data()[i];
-    
-    fft_recursive(x);
-    
-    return ComplexTensor::from_complex(x, 1, n2);
+    ComplexTensor result(rows_, cols_, depth_);
+    copy_elements(*this, result.data());
+    fft::transform(result.data(), size());
+    return result;
 }
 
 ComplexTensor ComplexTensor::ifft() const {
-    // ifft = conj(fft(conj(x))) / n
-    auto conj_data = this->conj();
-    auto fft_result = conj_data.fft();
-    auto result = fft_result.conj();
-    Complex scale = {1.0 / static_cast<double>(result.size()), 0.0};
-    return result * scale;
+    assert(is_vector());
+    ComplexTensor result(rows_, cols_, depth_);
+    copy_elements(*this, result.data());
+    fft::transform(result.data(), size(), true);
+    Complex scale = {1.0 / static_cast<double>(size()), 0.0};
+    result.scale_inplace(scale);
+    return result;
 }
 
-// ========== DECOMPOSITIONS (CPU) ==========
-
-void ComplexTensor::lu(ComplexTensor& L, ComplexTensor& U, ComplexTensor& P) const {
-    assert(rows_ == cols_);
-    size_t n = rows_;
-    
-    U = ComplexTensor(n, n);
-    L = ComplexTensor(n, n);
-    P = ComplexTensor(n, n);
-    
-    // Copy to U
-    for (size_t i = 0; i < n * n; i++) U.data()[i] = data()[i];
-    
-    // Initialize P = I
-    for (size_t i = 0; i < n; i++) P(i, i) = {1.0, 0.0};
-    // Initialize L = I
-    for (size_t i = 0; i < n; i++) L(i, i) = {1.0, 0.0};
-    
-    for (size_t k = 0; k < n; k++) {
-        // Pivot
-        size_t max_row = k;
-        double max_val = std::abs(U(k, k));
-        for (size_t i = k + 1; i < n; i++) {
-            if (std::abs(U(i, k)) > max_val) {
-                max_val = std::abs(U(i, k));
-                max_row = i;
-            }
-        }
-        
-        if (max_row != k) {
-            for (size_t j = 0; j < n; j++) {
-                std::swap(U(k, j), U(max_row, j));
-                std::swap(P(k, j), P(max_row, j));
-            }
-            for (size_t j = 0; j < k; j++) {
-                std::swap(L(k, j), L(max_row, j));
-            }
-        }
-        
-        for (size_t i = k + 1; i < n; i++) {
-            Complex factor = U(i, k) / U(k, k);
-            L(i, k) = factor;
-            for (size_t j = k; j < n; j++) {
-                U(i, j) -= factor * U(k, j);
-            }
-        }
-    }
+ComplexTensor ComplexTensor::rfft(const std::vector<double>& signal) {
+    auto plan = fft::RealPlan::get(signal.size());
+    ComplexTensor result(1, signal.empty() ? 0 : plan->spectrum_size());
+    plan->forward(signal.data(), result.data());
+    return result;
 }
 
-void ComplexTensor::eig(std::vector<Complex>& eigenvalues, ComplexTensor& eigenvectors) const {
-    assert(rows_ == cols_);
-    size_t n = rows_;
-    
-    // Simple QR algorithm for eigenvalues
-    ComplexTensor A(n, n);
-    for (size_t i = 0; i < n * n; i++) A.data()[i] = data()[i];
-    
-    eigenvectors = ComplexTensor(n, n);
-    for (size_t i = 0; i < n; i++) eigenvectors(i, i) = {1.0, 0.0};
-    
-    // QR iteration (simplified)
-    for (int iter = 0; iter < 100; iter++) {
-        // Compute QR via Gram-Schmidt
-        ComplexTensor Q(n, n), R(n, n);
-        A.qr(Q, R);
-        A = R * Q;
-        eigenvectors = eigenvectors * Q;
-    }
-    
-    eigenvalues.resize(n);
-    for (size_t i = 0; i < n; i++) {
-        eigenvalues[i] = A(i, i);
+std::vector<double> ComplexTensor::irfft(size_t n) const {
+    auto plan = fft::RealPlan::get(n);
+    if (!is_vector() || size() != plan->spectrum_size()) {
+        throw std::invalid_argument("irfft: a " + std::to_string(n) + "-point signal needs " +
+                                    std::to_string(plan->spectrum_size()) + " bins, got " +
+                                    std::to_string(rows_) + "x" + std::to_string(cols_) + "x" +
+                                    std::to_string(depth_));
     }
+    std::vector<double> signal(n);
+    plan->inverse(data(), signal.data());
+    double scale = 1.0 / static_cast<double>(n);
+    for (double& v : signal) v *= scale;
+    return signal;
 }
 
-void ComplexTensor::qr(ComplexTensor& Q, ComplexTensor& R) const {
-    size_t m = rows_, n = cols_;
-    Q = ComplexTensor(m, m);
-    R = ComplexTensor(m, n);
-    
-    // Modified Gram-Schmidt
-    std::vector<std::vector<Complex>> columns(n);
-    for (size_t j = 0; j < n; j++) {
-        columns[j].resize(m);
-        for (size_t i = 0; i < m; i++) columns[j][i] = (*this)(i, j);
-    }
-    
-    std::vector<std::vector<Complex>> q_cols(n);
-    for (size_t j = 0; j < n; j++) {
-        q_cols[j] = columns[j];
-        
-        for (size_t k = 0; k < j; k++) {
-            Complex dot = {0.0, 0.0};
-            for (size_t i = 0; i < m; i++) dot += std::conj(q_cols[k][i]) * q_cols[j][i];
-            R(k, j) = dot;
-            for (size_t i = 0; i < m; i++) q_cols[j][i] -= dot * q_cols[k][i];
-        }
-        
-        double col_norm = 0.0;
-        for (size_t i = 0; i < m; i++) col_norm += std::norm(q_cols[j][i]);
-        col_norm = std::sqrt(col_norm);
-        R(j, j) = {col_norm, 0.0};
-        
-        if (col_norm > 1e-14) {
-            for (size_t i = 0; i < m; i++) q_cols[j][i] /= col_norm;
-        }
-    }
-    
-    for (size_t j = 0; j < std::min(m, n); j++) {
-        for (size_t i = 0; i < m; i++) Q(i, j) = q_cols[j][i];
-    }
-}
+// ========== 2D / N-D FFT ==========
 
-void ComplexTensor::svd(ComplexTensor& U_out, std::vector<double>& S, ComplexTensor& V_out) const {
-    // SVD via eigendecomposition of A'A
-    ComplexTensor AtA = this->transpose() * (*this);
-    
-    std::vector<Complex> eigenvalues;
-    ComplexTensor eigenvectors(1, 1);
-    AtA.eig(eigenvalues, eigenvectors);
-    
-    size_t n = std::min(rows_, cols_);
-    S.resize(n);
-    for (size_t i = 0; i < n; i++) {
-        S[i] = std::sqrt(std::max(0.0, eigenvalues[i].real()));
-    }
-    
-    V_out = eigenvectors;
-    
-    // U = A * V * S^(-1)
-    U_out = ComplexTensor(rows_, n);
-    for (size_t j = 0; j < n; j++) {
-        if (S[j] > 1e-14) {
-            for (size_t i = 0; i < rows_; i++) {
-                Complex sum = {0.0, 0.0};
-                for (size_t k = 0; k < cols_; k++) {
-                    sum += (*this)(i, k) * V_out(k, j);
-                }
-                U_out(i, j) = sum / Complex(S[j], 0.0);
-            }
-        }
+// Rows of every page in one batch, then the columns of each page
+static void fft2_in_place(ComplexTensor::Complex* x, size_t rows, size_t cols, size_t depth,
+                          fft::Direction direction) {
+    bool inverse = direction == fft::Direction::Inverse;
+    fft::transform_batch(x, cols, rows * depth, 1, cols, inverse);
+    for (size_t k = 0; k < depth; k++) {
+        fft::transform_batch(x + k * rows * cols, rows, cols, cols, 1, inverse);
     }
 }
 
-// ========== 2D FFT ==========
-
+// Page-wise for 3-D tensors, like MATLAB's fft2
 ComplexTensor ComplexTensor::fft2() const {
-    assert(depth_ == 1);
-    ComplexTensor result(rows_, cols_);
-    
-    // FFT along rows
-    for (size_t i = 0; i < rows_; i++) {
-        std::vector<Complex> row(cols_);
-        for (size_t j = 0; j < cols_; j++) row[j] = (*this)(i, j);
-        
-        size_t n2 = 1;
-        while (n2 < cols_) n2 <<= 1;
-        row.resize(n2, {0.0, 0.0});
-        fft_recursive(row);
-        
-        for (size_t j = 0; j < cols_; j++) result(i, j) = row[j];
-    }
-    
-    // FFT along columns
-    for (size_t j = 0; j < cols_; j++) {
-        std::vector<Complex> col(rows_);
-        for (size_t i = 0; i < rows_; i++) col[i] = result(i, j);
-        
-        size_t n2 = 1;
-        while (n2 < rows_) n2 <<= 1;
-        col.resize(n2, {0.0, 0.0});
-        fft_recursive(col);
-        
-        for (size_t i = 0; i < rows_; i++) result(i, j) = col[i];
-    }
-    
+    ComplexTensor result(rows_, cols_, depth_);
+    copy_elements(*this, result.data());
+    if (size() > 0) fft2_in_place(result.data(), rows_, cols_, depth_, fft::Direction::Forward);
     return result;
 }
 
 ComplexTensor ComplexTensor::ifft2() const {
-    auto conj_data = this->conj();
-    auto fft_result = conj_data.fft2();
-    auto result = fft_result.conj();
+    ComplexTensor result(rows_, cols_, depth_);
+    copy_elements(*this, result.data());
+    if (size() > 0) fft2_in_place(result.data(), rows_, cols_, depth_, fft::Direction::Inverse);
+    Complex scale = {1.0 / static_cast<double>(rows_ * cols_), 0.0};
+    result.scale_inplace(scale);
+    return result;
+}
+
+// fft2 of every page, then along the depth dimension
+ComplexTensor ComplexTensor::fftn() const {
+    ComplexTensor result = fft2();
+    fft::transform_batch(result.data(), depth_, rows_ * cols_, rows_ * cols_, 1);
+    return result;
+}
+
+ComplexTensor ComplexTensor::ifftn() const {
+    ComplexTensor result(rows_, cols_, depth_);
+    copy_elements(*this, result.data());
+    if (size() > 0) {
+        fft2_in_place(result.data(), rows_, cols_, depth_, fft::Direction::Inverse);
+        fft::transform_batch(result.data(), depth_, rows_ * cols_, rows_ * cols_, 1, true);
+    }
     Complex scale = {1.0 / static_cast<double>(size()), 0.0};
-    return result * scale;
+    result.scale_inplace(scale);
+    return result;
 }
 
 // ========== DISPLAY ==========
@@ -676,7 +1192,7 @@ std::string ComplexTensor::to_string() const {
     ss << std::fixed << std::setprecision(4);
     
     if (is_scalar()) {
-        Complex v = data()[0];
+        Complex v = (*this)(0, 0);
         ss << v.real();
         if (v.imag() != 0.0) ss << " + " << v.imag() << "i";
     } else {
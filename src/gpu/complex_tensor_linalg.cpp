@@ -0,0 +1,1029 @@
+// MatLabC++ Complex Dense Linear Algebra
+// src/gpu/complex_tensor_linalg.cpp
+//
+// ComplexTensor decompositions. Tensors are row-major; each routine
+// copies its input into a column-major work array so the LAPACK-style
+// algorithms below (and kernels::gemm) run down unit-stride columns.
+//
+// lu: right-looking blocked LU with partial pivoting (zgetrf), the same
+// scheme as the real LUFactorization: unblocked panel, row swaps across
+// the rest, a triangular solve for the block row of U, and a gemm for the
+// trailing matrix. inv, solve and det all start from it, and the
+// blocked triangular solves put many right-hand sides through gemm too.
+//
+// qr: blocked Householder (zgeqrf). A panel of kQRBlock columns is
+// factored one reflector at a time, its reflectors are combined into the
+// compact WY form I - V T V^H (zlarft), and the trailing columns are
+// updated with three matrix products instead of kQRBlock rank-1 updates.
+//
+// eig: Householder reduction to upper Hessenberg form, then single-shift
+// implicit QR on the Hessenberg matrix (zlahqr): Wilkinson shifts,
+// deflation as soon as a subdiagonal entry is negligible, and exceptional
+// shifts when an eigenvalue stalls. Each sweep is O(n^2) Givens work on
+// the Hessenberg matrix in place. Eigenvectors come from back
+// substitution on the triangular Schur factor, mapped back through the
+// accumulated unitary Z. A Hermitian matrix comes out of the Hessenberg
+// reduction tridiagonal; a diagonal unitary scaling makes that real, and
+// the real divide-and-conquer solver (linalg.hpp) finishes it.
+//
+// svd: QR first (of A, or of A^H when A is wide), then one-sided
+// (Hestenes) Jacobi on the small square R: plane rotations applied to
+// pairs of columns until all columns are mutually orthogonal. The column
+// norms are then the singular values. Pairs are visited in round-robin
+// order, so each round is a set of disjoint rotations spread over the
+// thread pool. A is never squared into A^H A.
+
+#include "matlabcpp/complex_tensor.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/linalg.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace matlabcpp {
+
+namespace {
+
+using Complex = ComplexTensor::Complex;
+
+// Columns per LU panel / triangular block, and per task for swaps and
+// triangular solves
+constexpr size_t kLUBlock = 64;
+constexpr size_t kLUColumnChunk = 16;
+
+// Columns per QR panel, and per unblocked leaf of a panel
+constexpr size_t kQRBlock = 32;
+constexpr size_t kQRLeaf = 8;
+
+// QR sweeps allowed per eigenvalue are kQRSweepFactor * max(10, n), with
+// an exceptional shift every kExceptionalShift sweeps (LAPACK's limits)
+constexpr size_t kQRSweepFactor = 30;
+constexpr size_t kExceptionalShift = 10;
+
+// Jacobi sweeps before svd gives up (it normally needs fewer than ten)
+constexpr size_t kMaxJacobiSweeps = 60;
+
+// Column pairs per task in a Jacobi round
+constexpr size_t kJacobiPairChunk = 8;
+
+constexpr double kEps = std::numeric_limits<double>::epsilon();
+constexpr double kTiny = std::numeric_limits<double>::min();
+
+double abs1(Complex z) { return std::fabs(z.real()) + std::fabs(z.imag()); }
+
+// Plain complex products for the O(n^3) loops: std::complex's operator*
+// takes a slow path for inf/NaN corner cases and blocks vectorization
+inline Complex mul(Complex a, Complex b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+inline Complex conj_mul(Complex a, Complex b) {     // conj(a) * b
+    return {a.real() * b.real() + a.imag() * b.imag(), a.real() * b.imag() - a.imag() * b.real()};
+}
+inline Complex scale(double c, Complex a) { return {c * a.real(), c * a.imag()}; }
+
+// Column-major copy of a row-major matrix, and back
+std::vector<Complex> to_columns(const ComplexTensor& A) {
+    const size_t m = A.rows(), n = A.cols();
+    const Complex* p = A.data();
+    std::vector<Complex> a(m * n);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) a[i + j * m] = p[i * n + j];
+    }
+    return a;
+}
+
+ComplexTensor from_columns(const Complex* a, size_t m, size_t n, size_t lda) {
+    ComplexTensor A(m, n);
+    Complex* p = A.data();
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) p[i * n + j] = a[i + j * lda];
+    }
+    return A;
+}
+
+// ========== HOUSEHOLDER REFLECTORS ==========
+
+// zlarfg: picks tau and v so that H^H [alpha; x] = [beta; 0] with
+// H = I - tau [1; v] [1; v]^H and beta real. alpha <- beta, x <- v.
+Complex householder(size_t n, Complex& alpha, Complex* x) {
+    double xnorm = 0.0;
+    for (size_t i = 0; i < n; ++i) xnorm = std::hypot(xnorm, std::abs(x[i]));
+    if (xnorm == 0.0 && alpha.imag() == 0.0) return 0.0;
+    double beta = -std::copysign(std::hypot(std::abs(alpha), xnorm), alpha.real());
+    Complex tau = (beta - alpha) / beta;
+    Complex scale = 1.0 / (alpha - beta);
+    for (size_t i = 0; i < n; ++i) x[i] *= scale;
+    alpha = beta;
+    return tau;
+}
+
+// C := (I - tau v v^H) C for the m x n block at c, v[0] = 1 implicit.
+// Pass conj(tau) to apply H^H.
+void reflect_left(size_t m, size_t n, const Complex* v, Complex tau, Complex* c, size_t ldc) {
+    if (tau == 0.0) return;
+    for (size_t j = 0; j < n; ++j) {
+        Complex* col = c + j * ldc;
+        Complex w = col[0];
+        for (size_t i = 1; i < m; ++i) w += conj_mul(v[i], col[i]);
+        w = mul(w, tau);
+        col[0] -= w;
+        for (size_t i = 1; i < m; ++i) col[i] -= mul(v[i], w);
+    }
+}
+
+// C := C (I - tau v v^H) for the m x n block at c; w holds m values
+void reflect_right(size_t m, size_t n, const Complex* v, Complex tau, Complex* c, size_t ldc, Complex* w) {
+    if (tau == 0.0) return;
+    std::copy(c, c + m, w);
+    for (size_t j = 1; j < n; ++j) {
+        const Complex* col = c + j * ldc;
+        for (size_t i = 0; i < m; ++i) w[i] += mul(col[i], v[j]);
+    }
+    for (size_t j = 0; j < n; ++j) {
+        Complex* col = c + j * ldc;
+        Complex f = tau * (j == 0 ? Complex(1.0) : std::conj(v[j]));
+        for (size_t i = 0; i < m; ++i) col[i] -= mul(w[i], f);
+    }
+}
+
+// The k reflectors stored below the diagonal of the m x k panel at a, as
+// a dense unit lower trapezoid V and the triangular T of I - V T V^H
+struct BlockReflector {
+    size_t m = 0, k = 0;
+    std::vector<Complex> v;     // m x k
+    std::vector<Complex> vh;    // k x m, V^H
+    std::vector<Complex> t;     // k x k upper triangular
+
+    void build(size_t rows, size_t cols, const Complex* a, size_t lda, const Complex* tau) {
+        m = rows;
+        k = cols;
+        v.assign(m * k, 0.0);
+        vh.resize(k * m);
+        t.assign(k * k, 0.0);
+        for (size_t r = 0; r < k; ++r) {
+            v[r + r * m] = 1.0;
+            for (size_t l = r + 1; l < m; ++l) v[l + r * m] = a[l + r * lda];
+        }
+        for (size_t r = 0; r < k; ++r) {
+            for (size_t l = 0; l < m; ++l) vh[r + l * k] = std::conj(v[l + r * m]);
+        }
+        // zlarft, forward columnwise: T(0:i, i) = -tau_i T(0:i, 0:i) V(:, 0:i)^H v_i,
+        // with all the V^H V products from one gemm
+        std::vector<Complex> g(k * k), col(k);
+        kernels::gemm(k, k, m, vh.data(), k, v.data(), m, g.data(), k);
+        for (size_t i = 0; i < k; ++i) {
+            t[i + i * k] = tau[i];
+            for (size_t r = 0; r < i; ++r) col[r] = -mul(tau[i], g[r + i * k]);
+            for (size_t r = 0; r < i; ++r) {
+                Complex s = 0.0;
+                for (size_t l = r; l < i; ++l) s += mul(t[r + l * k], col[l]);
+                t[r + i * k] = s;
+            }
+        }
+    }
+
+    // C := (I - V T V^H) C, or its adjoint, for the m x n block at c
+    void apply(bool adjoint, size_t n, Complex* c, size_t ldc) const {
+        if (n == 0) return;
+        std::vector<Complex> w(k * n);
+        kernels::gemm(k, n, m, vh.data(), k, c, ldc, w.data(), k);
+        for (size_t j = 0; j < n; ++j) {
+            Complex* x = w.data() + j * k;
+            if (adjoint) {
+                // T^H is lower triangular: bottom up
+                for (size_t r = k; r-- > 0;) {
+                    Complex s = 0.0;
+                    for (size_t l = 0; l <= r; ++l) s += std::conj(t[l + r * k]) * x[l];
+                    x[r] = s;
+                }
+            } else {
+                for (size_t r = 0; r < k; ++r) {
+                    Complex s = 0.0;
+                    for (size_t l = r; l < k; ++l) s += t[r + l * k] * x[l];
+                    x[r] = s;
+                }
+            }
+        }
+        kernels::gemm(m, n, k, -1.0, v.data(), m, w.data(), k, 1.0, c, ldc);
+    }
+};
+
+// ========== LU ==========
+
+// Unblocked LU of the m x nb panel at a. piv[k] is relative to the panel
+// top. Zero pivots are skipped (and reported), like LAPACK.
+bool lu_panel(size_t m, size_t nb, Complex* a, size_t lda, size_t* piv) {
+    bool singular = false;
+    for (size_t k = 0; k < nb && k < m; ++k) {
+        Complex* col = a + k * lda;
+        size_t p = k;
+        double best = abs1(col[k]);
+        for (size_t i = k + 1; i < m; ++i) {
+            if (abs1(col[i]) > best) { best = abs1(col[i]); p = i; }
+        }
+        piv[k] = p;
+        if (col[p] == 0.0) {
+            singular = true;
+            continue;
+        }
+        if (p != k) {
+            for (size_t j = 0; j < nb; ++j) std::swap(a[k + j * lda], a[p + j * lda]);
+        }
+        Complex inv = 1.0 / col[k];
+        for (size_t i = k + 1; i < m; ++i) col[i] = mul(col[i], inv);
+        for (size_t j = k + 1; j < nb; ++j) {
+            Complex* cj = a + j * lda;
+            Complex f = cj[k];
+            if (f == 0.0) continue;
+            for (size_t i = k + 1; i < m; ++i) cj[i] -= mul(col[i], f);
+        }
+    }
+    return singular;
+}
+
+// Swaps rows r and piv[r] for r in [lo, hi), in that order, in each of
+// the columns [c_lo, c_hi)
+void lu_swap_rows(Complex* a, size_t lda, size_t c_lo, size_t c_hi,
+                  const size_t* piv, size_t lo, size_t hi) {
+    if (c_lo >= c_hi) return;
+    parallel_for(c_hi - c_lo, kLUColumnChunk, [&](size_t b, size_t e) {
+        for (size_t c = c_lo + b; c < c_lo + e; ++c) {
+            Complex* col = a + c * lda;
+            for (size_t r = lo; r < hi; ++r) {
+                if (piv[r] != r) std::swap(col[r], col[piv[r]]);
+            }
+        }
+    });
+}
+
+// B := inv(L) * B for the n x n unit lower triangle at l
+void lu_solve_lower(size_t n, size_t nrhs, const Complex* l, size_t ldl, Complex* b, size_t ldb) {
+    for (size_t i = 0; i < n; i += kLUBlock) {
+        size_t ib = std::min(kLUBlock, n - i);
+        parallel_for(nrhs, kLUColumnChunk, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                Complex* x = b + c * ldb + i;
+                for (size_t k = 0; k < ib; ++k) {
+                    Complex xk = x[k];
+                    if (xk == 0.0) continue;
+                    const Complex* lk = l + i + (i + k) * ldl;
+                    for (size_t r = k + 1; r < ib; ++r) x[r] -= mul(lk[r], xk);
+                }
+            }
+        });
+        if (i + ib < n) {
+            kernels::gemm(n - i - ib, nrhs, ib, -1.0, l + (i + ib) + i * ldl, ldl,
+                          b + i, ldb, 1.0, b + i + ib, ldb);
+        }
+    }
+}
+
+// B := inv(U) * B for the n x n upper triangle at u
+void lu_solve_upper(size_t n, size_t nrhs, const Complex* u, size_t ldu, Complex* b, size_t ldb) {
+    size_t blocks = (n + kLUBlock - 1) / kLUBlock;
+    for (size_t blk = blocks; blk-- > 0;) {
+        size_t i = blk * kLUBlock;
+        size_t ib = std::min(kLUBlock, n - i);
+        parallel_for(nrhs, kLUColumnChunk, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                Complex* x = b + c * ldb + i;
+                for (size_t k = ib; k-- > 0;) {
+                    const Complex* uk = u + i + (i + k) * ldu;
+                    x[k] /= uk[k];
+                    Complex xk = x[k];
+                    if (xk == 0.0) continue;
+                    for (size_t r = 0; r < k; ++r) x[r] -= mul(uk[r], xk);
+                }
+            }
+        });
+        if (i > 0) {
+            kernels::gemm(i, nrhs, ib, -1.0, u + i * ldu, ldu, b + i, ldb, 1.0, b, ldb);
+        }
+    }
+}
+
+// ========== CHOLESKY ==========
+
+// What solve() tries Cholesky on: Hermitian with a real, positive
+// diagonal (the real backslash's test, with conjugate symmetry)
+bool hermitian_positive_diagonal(size_t n, const Complex* a) {
+    for (size_t j = 0; j < n; ++j) {
+        Complex d = a[j + j * n];
+        if (!(d.real() > 0.0) || d.imag() != 0.0) return false;
+        for (size_t i = j + 1; i < n; ++i) {
+            if (a[i + j * n] != std::conj(a[j + i * n])) return false;
+        }
+    }
+    return true;
+}
+
+// zpotrf, lower, in place on the n x n column-major a: A = L L^H, blocked
+// like the real CholeskyFactorization. Only the lower triangle is read
+// or meaningful afterwards. false at the first pivot that is not
+// positive, i.e. A is not positive definite.
+bool cholesky_factor(size_t n, Complex* a) {
+    for (size_t j = 0; j < n; j += kLUBlock) {
+        size_t jb = std::min(kLUBlock, n - j);
+        Complex* a11 = a + j + j * n;
+        for (size_t k = 0; k < jb; ++k) {
+            Complex* col = a11 + k * n;
+            double d = col[k].real();
+            if (!(d > 0.0)) return false;       // also catches NaN
+            d = std::sqrt(d);
+            col[k] = d;
+            for (size_t i = k + 1; i < jb; ++i) col[i] = scale(1.0 / d, col[i]);
+            for (size_t c = k + 1; c < jb; ++c) {
+                Complex f = std::conj(col[c]);
+                if (f == 0.0) continue;
+                Complex* cc = a11 + c * n;
+                for (size_t i = c; i < jb; ++i) cc[i] -= mul(col[i], f);
+            }
+        }
+        if (j + jb == n) break;
+
+        // L21 = A21 * inv(L11^H), by rows
+        size_t rest = n - j - jb;
+        Complex* a21 = a11 + jb;
+        parallel_for(rest, kLUBlock, [&](size_t lo, size_t hi) {
+            for (size_t k = 0; k < jb; ++k) {
+                Complex* ck = a21 + k * n;
+                double inv = 1.0 / a11[k + k * n].real();
+                for (size_t i = lo; i < hi; ++i) ck[i] = scale(inv, ck[i]);
+                for (size_t c = k + 1; c < jb; ++c) {
+                    Complex f = std::conj(a11[c + k * n]);
+                    Complex* cc = a21 + c * n;
+                    for (size_t i = lo; i < hi; ++i) cc[i] -= mul(ck[i], f);
+                }
+            }
+        });
+
+        // A22 -= L21 * L21^H on and below the diagonal, one block column per gemm
+        Complex* a22 = a21 + jb * n;
+        for (size_t c = 0; c < rest; c += kLUBlock) {
+            size_t cb = std::min(kLUBlock, rest - c);
+            kernels::gemm(kernels::MatrixOp::None, kernels::MatrixOp::ConjTranspose, rest - c, cb, jb, -1.0,
+                          a21 + c, n, a21 + c, n, 1.0, a22 + c + c * n, n);
+        }
+    }
+    return true;
+}
+
+// B := inv(L^H) * inv(L) * B for cholesky_factor's n x n factor at l
+void cholesky_solve(size_t n, size_t nrhs, const Complex* l, Complex* b, size_t ldb) {
+    for (size_t i = 0; i < n; i += kLUBlock) {
+        size_t ib = std::min(kLUBlock, n - i);
+        parallel_for(nrhs, kLUColumnChunk, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                Complex* x = b + c * ldb + i;
+                for (size_t k = 0; k < ib; ++k) {
+                    const Complex* lk = l + i + (i + k) * n;
+                    x[k] = scale(1.0 / lk[k].real(), x[k]);
+                    Complex xk = x[k];
+                    if (xk == 0.0) continue;
+                    for (size_t r = k + 1; r < ib; ++r) x[r] -= mul(lk[r], xk);
+                }
+            }
+        });
+        if (i + ib < n) {
+            kernels::gemm(n - i - ib, nrhs, ib, -1.0, l + (i + ib) + i * n, n, b + i, ldb, 1.0, b + i + ib, ldb);
+        }
+    }
+
+    // L^H is upper triangular with (L^H)(r, k) = conj(L(k, r))
+    size_t blocks = (n + kLUBlock - 1) / kLUBlock;
+    for (size_t blk = blocks; blk-- > 0;) {
+        size_t i = blk * kLUBlock;
+        size_t ib = std::min(kLUBlock, n - i);
+        parallel_for(nrhs, kLUColumnChunk, [&](size_t lo, size_t hi) {
+            for (size_t c = lo; c < hi; ++c) {
+                Complex* x = b + c * ldb + i;
+                for (size_t k = ib; k-- > 0;) {
+                    const Complex* row = l + (i + k) + i * n;     // L(i + k, i + r) at row[r * n]
+                    x[k] = scale(1.0 / row[k * n].real(), x[k]);
+                    Complex xk = x[k];
+                    if (xk == 0.0) continue;
+                    for (size_t r = 0; r < k; ++r) x[r] -= conj_mul(row[r * n], xk);
+                }
+            }
+        });
+        if (i > 0) {
+            kernels::gemm(kernels::MatrixOp::ConjTranspose, kernels::MatrixOp::None, i, nrhs, ib, -1.0,
+                          l + i, n, b + i, ldb, 1.0, b, ldb);
+        }
+    }
+}
+
+// ========== QR ==========
+
+// QR of the m x n panel at a (n <= kQRBlock), recursively: factor the
+// left half, apply its block reflector to the right half, factor what is
+// left of the right half. Tall panels then stream through memory a few
+// times instead of once per column.
+void qr_panel(size_t m, size_t n, Complex* a, size_t lda, Complex* tau) {
+    if (n <= kQRLeaf) {
+        for (size_t c = 0; c < n && c < m; ++c) {
+            Complex* col = a + c + c * lda;
+            tau[c] = householder(m - c - 1, col[0], col + 1);
+            reflect_left(m - c, n - c - 1, col, std::conj(tau[c]), col + lda, lda);
+        }
+        return;
+    }
+    const size_t n1 = n / 2;
+    qr_panel(m, n1, a, lda, tau);
+    BlockReflector left;
+    left.build(m, n1, a, lda, tau);
+    left.apply(true, n - n1, a + n1 * lda, lda);
+    if (m > n1) qr_panel(m - n1, n - n1, a + n1 + n1 * lda, lda, tau + n1);
+}
+
+// zgeqrf on the m x n column-major a: R on and above the diagonal,
+// reflectors below it, tau[0..min(m, n))
+void qr_factor(size_t m, size_t n, Complex* a, std::vector<Complex>& tau) {
+    const size_t kmax = std::min(m, n);
+    tau.assign(kmax, 0.0);
+    BlockReflector block;
+    for (size_t j = 0; j < kmax; j += kQRBlock) {
+        const size_t jb = std::min(kQRBlock, kmax - j);
+        Complex* panel = a + j + j * m;
+        qr_panel(m - j, jb, panel, m, tau.data() + j);
+        if (j + jb < n) {
+            block.build(m - j, jb, panel, m, tau.data() + j);
+            block.apply(true, n - j - jb, panel + jb * m, m);
+        }
+    }
+}
+
+// First q columns of Q = H_0 H_1 ... H_(k-1) from qr_factor's output
+std::vector<Complex> qr_form_q(size_t m, size_t q, const Complex* a, const std::vector<Complex>& tau) {
+    std::vector<Complex> Q(m * q, 0.0);
+    for (size_t i = 0; i < std::min(m, q); ++i) Q[i + i * m] = 1.0;
+    const size_t kmax = tau.size();
+    BlockReflector block;
+    size_t blocks = (kmax + kQRBlock - 1) / kQRBlock;
+    for (size_t b = blocks; b-- > 0;) {
+        const size_t j = b * kQRBlock;
+        const size_t jb = std::min(kQRBlock, kmax - j);
+        block.build(m - j, jb, a + j + j * m, m, tau.data() + j);
+        block.apply(false, q - j, Q.data() + j + j * m, m);
+    }
+    return Q;
+}
+
+// ========== EIGENVALUES ==========
+
+// zgehrd: A = Z H Z^H with H upper Hessenberg, in place on the n x n
+// column-major a; z <- Z
+void hessenberg_reduce(size_t n, Complex* a, Complex* z) {
+    std::vector<Complex> tau(n > 1 ? n - 1 : 0, 0.0), w(n);
+    for (size_t k = 0; k + 2 < n; ++k) {
+        Complex* col = a + (k + 1) + k * n;
+        tau[k] = householder(n - k - 2, col[0], col + 1);
+        reflect_left(n - k - 1, n - k - 1, col, std::conj(tau[k]), a + (k + 1) + (k + 1) * n, n);
+        reflect_right(n, n - k - 1, col, tau[k], a + (k + 1) * n, n, w.data());
+    }
+
+    std::fill(z, z + n * n, Complex(0.0));
+    for (size_t i = 0; i < n; ++i) z[i + i * n] = 1.0;
+    for (size_t k = n < 2 ? 0 : n - 2; k-- > 0;) {
+        const Complex* col = a + (k + 1) + k * n;
+        reflect_left(n - k - 1, n - k - 1, col, tau[k], z + (k + 1) + (k + 1) * n, n);
+    }
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = j + 2; i < n; ++i) a[i + j * n] = 0.0;
+    }
+}
+
+// zlartg: c real, s complex with [c s; -conj(s) c] [f; g] = [r; 0]
+void givens(Complex f, Complex g, double& c, Complex& s, Complex& r) {
+    if (g == 0.0) {
+        c = 1.0;
+        s = 0.0;
+        r = f;
+        return;
+    }
+    if (f == 0.0) {
+        c = 0.0;
+        s = std::conj(g) / std::abs(g);
+        r = std::abs(g);
+        return;
+    }
+    double fa = std::abs(f), norm = std::hypot(fa, std::abs(g));
+    Complex phase = f / fa;
+    c = fa / norm;
+    s = phase * std::conj(g) / norm;
+    r = phase * norm;
+}
+
+// [x y] := [x y] G^H for the rotation G of givens()
+void rotate_columns(size_t n, double c, Complex s, Complex* x, Complex* y) {
+    for (size_t i = 0; i < n; ++i) {
+        Complex t1 = x[i], t2 = y[i];
+        x[i] = scale(c, t1) + conj_mul(s, t2);
+        y[i] = scale(c, t2) - mul(s, t1);
+    }
+}
+
+// zlahqr: reduces the upper Hessenberg h to upper triangular T = Q^H h Q
+// and z <- z Q. The eigenvalues are the diagonal of T. Returns false if
+// some eigenvalue did not converge.
+bool hessenberg_qr(size_t n, Complex* h, Complex* z) {
+    auto H = [&](size_t i, size_t j) -> Complex& { return h[i + j * n]; };
+    const size_t max_sweeps = kQRSweepFactor * std::max<size_t>(10, n);
+
+    size_t end = n;      // rows end..n-1 have converged
+    size_t sweeps = 0;
+    while (end > 0) {
+        const size_t i = end - 1;
+
+        // Start of the unreduced block that ends at row i
+        size_t l = i;
+        for (; l > 0; --l) {
+            double tst = abs1(H(l - 1, l - 1)) + abs1(H(l, l));
+            if (abs1(H(l, l - 1)) <= std::max(kEps * tst, kTiny)) {
+                H(l, l - 1) = 0.0;
+                break;
+            }
+        }
+        if (l == i) {
+            --end;
+            sweeps = 0;
+            continue;
+        }
+        if (++sweeps > max_sweeps) return false;
+
+        // Wilkinson shift: the eigenvalue of the trailing 2 x 2 nearer H(i, i)
+        Complex mu;
+        if (sweeps % kExceptionalShift == 0) {
+            mu = H(i, i) + 0.75 * std::fabs(H(i, i - 1).real());
+        } else {
+            Complex a = H(i - 1, i - 1), b = H(i - 1, i), c = H(i, i - 1), d = H(i, i);
+            Complex half = 0.5 * (a - d);
+            Complex disc = std::sqrt(half * half + b * c);
+            Complex m1 = d + half + disc, m2 = d + half - disc;
+            mu = std::abs(m1 - d) < std::abs(m2 - d) ? m1 : m2;
+        }
+
+        // Chase the bulge from row l down to row i
+        Complex x = H(l, l) - mu, y = H(l + 1, l);
+        for (size_t k = l; k < i; ++k) {
+            if (k > l) {
+                x = H(k, k - 1);
+                y = H(k + 1, k - 1);
+            }
+            double c;
+            Complex s, r;
+            givens(x, y, c, s, r);
+            if (k > l) {
+                H(k, k - 1) = r;
+                H(k + 1, k - 1) = 0.0;
+            }
+            for (size_t j = k; j < n; ++j) {
+                Complex t1 = H(k, j), t2 = H(k + 1, j);
+                H(k, j) = scale(c, t1) + mul(s, t2);
+                H(k + 1, j) = scale(c, t2) - conj_mul(s, t1);
+            }
+            const size_t last = std::min(k + 2, i);
+            rotate_columns(last + 1, c, s, h + k * n, h + (k + 1) * n);
+            rotate_columns(n, c, s, z + k * n, z + (k + 1) * n);
+        }
+    }
+    return true;
+}
+
+// Eigenvectors of the upper triangular t (ztrevc), as the columns of the
+// upper triangular x
+void triangular_eigenvectors(size_t n, const Complex* t, Complex* x) {
+    std::fill(x, x + n * n, Complex(0.0));
+    double tnorm = 0.0;
+    for (size_t i = 0; i < n * n; ++i) tnorm = std::max(tnorm, abs1(t[i]));
+    const double small = std::max(kEps * tnorm, kTiny);
+
+    for (size_t k = 0; k < n; ++k) {
+        Complex* v = x + k * n;
+        const Complex lambda = t[k + k * n];
+        v[k] = 1.0;
+        for (size_t i = 0; i < k; ++i) v[i] = -t[i + k * n];
+        for (size_t j = k; j-- > 0;) {
+            Complex d = t[j + j * n] - lambda;
+            if (abs1(d) < small) d = small;      // repeated eigenvalue
+            v[j] /= d;
+            const Complex* tj = t + j * n;
+            for (size_t i = 0; i < j; ++i) v[i] -= mul(v[j], tj[i]);
+        }
+    }
+}
+
+// ========== SINGULAR VALUES ==========
+
+// One-sided Jacobi on the m x n column-major a (m >= n): afterwards the
+// columns of a are orthogonal, and a_in * V = a. v (n x n) may be null.
+// Returns false if the sweeps did not converge.
+bool jacobi_orthogonalize(size_t m, size_t n, Complex* a, Complex* v) {
+    if (v) {
+        std::fill(v, v + n * n, Complex(0.0));
+        for (size_t i = 0; i < n; ++i) v[i + i * n] = 1.0;
+    }
+    if (n < 2) return true;
+
+    // Round-robin pairing: slot 0 stays, the rest rotate; an odd n gets a
+    // dummy column that sits out one pair per round
+    const size_t slots = n + (n % 2);
+    std::vector<size_t> order(slots);
+    for (size_t i = 0; i < slots; ++i) order[i] = i;
+    const double tol = kEps * static_cast<double>(m);
+
+    for (size_t sweep = 0; sweep < kMaxJacobiSweeps; ++sweep) {
+        std::vector<char> rotated(slots / 2);
+        bool any = false;
+        for (size_t round = 0; round + 1 < slots; ++round) {
+            parallel_for(slots / 2, kJacobiPairChunk, [&](size_t lo, size_t hi) {
+                for (size_t pair = lo; pair < hi; ++pair) {
+                    size_t p = order[pair], q = order[slots - 1 - pair];
+                    rotated[pair] = 0;
+                    if (p >= n || q >= n) continue;
+                    Complex* ap = a + p * m;
+                    Complex* aq = a + q * m;
+                    double alpha = 0.0, beta = 0.0;
+                    Complex gamma = 0.0;
+                    for (size_t i = 0; i < m; ++i) {
+                        alpha += std::norm(ap[i]);
+                        beta += std::norm(aq[i]);
+                        gamma += conj_mul(ap[i], aq[i]);
+                    }
+                    double g = std::abs(gamma);
+                    if (g <= tol * std::sqrt(alpha * beta) || g < kTiny) continue;
+                    rotated[pair] = 1;
+
+                    // Real rotation of (a_p, a_q * conj(e)) with e = gamma / |gamma|
+                    double zeta = (beta - alpha) / (2.0 * g);
+                    double t = std::copysign(1.0, zeta) / (std::fabs(zeta) + std::hypot(1.0, zeta));
+                    double c = 1.0 / std::hypot(1.0, t), sn = c * t;
+                    Complex e = std::conj(gamma) / g;
+                    auto rotate = [&](Complex* x, Complex* y, size_t len) {
+                        for (size_t i = 0; i < len; ++i) {
+                            Complex yp = mul(y[i], e);
+                            Complex xp = x[i];
+                            x[i] = scale(c, xp) - scale(sn, yp);
+                            y[i] = scale(sn, xp) + scale(c, yp);
+                        }
+                    };
+                    rotate(ap, aq, m);
+                    if (v) rotate(v + p * n, v + q * n, n);
+                }
+            });
+            for (char r : rotated) any |= r != 0;
+            std::rotate(order.begin() + 1, order.end() - 1, order.end());
+        }
+        if (!any) return true;
+    }
+    return false;
+}
+
+// Replaces the columns flagged in `empty` by unit vectors orthogonal to
+// every other column of the m x k column-major u
+void complete_orthonormal(size_t m, size_t k, Complex* u, const std::vector<char>& empty) {
+    std::vector<Complex> cand(m);
+    size_t next = 0;
+    for (size_t j = 0; j < k; ++j) {
+        if (!empty[j]) continue;
+        for (; next < m; ++next) {
+            std::fill(cand.begin(), cand.end(), Complex(0.0));
+            cand[next] = 1.0;
+            for (int pass = 0; pass < 2; ++pass) {
+                for (size_t l = 0; l < k; ++l) {
+                    if (l == j || (empty[l] && l > j)) continue;
+                    const Complex* col = u + l * m;
+                    Complex d = 0.0;
+                    for (size_t i = 0; i < m; ++i) d += conj_mul(col[i], cand[i]);
+                    for (size_t i = 0; i < m; ++i) cand[i] -= mul(d, col[i]);
+                }
+            }
+            double norm = 0.0;
+            for (Complex c : cand) norm = std::hypot(norm, std::abs(c));
+            if (norm > 0.5) {
+                for (size_t i = 0; i < m; ++i) u[i + j * m] = cand[i] / norm;
+                ++next;
+                break;
+            }
+        }
+    }
+}
+
+struct SVDResult {
+    std::vector<double> s;
+    std::vector<Complex> u, v;      // column-major, m x ucols and n x k
+    size_t ucols = 0;
+};
+
+// SVD of the m x n column-major a with m >= n, singular values descending.
+// want_vectors false leaves u and v empty; full gives u all m columns.
+SVDResult svd_tall(size_t m, size_t n, std::vector<Complex> a, bool want_vectors, bool full) {
+    SVDResult out;
+    std::vector<Complex> tau;
+    qr_factor(m, n, a.data(), tau);
+    std::vector<Complex> r(n * n, 0.0);
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = 0; i <= j; ++i) r[i + j * n] = a[i + j * m];
+    }
+
+    std::vector<Complex> w(want_vectors ? n * n : 0);
+    if (!jacobi_orthogonalize(n, n, r.data(), want_vectors ? w.data() : nullptr)) {
+        throw std::runtime_error("svd: Jacobi sweeps did not converge");
+    }
+
+    std::vector<double> norms(n);
+    for (size_t j = 0; j < n; ++j) {
+        double s = 0.0;
+        for (size_t i = 0; i < n; ++i) s = std::hypot(s, std::abs(r[i + j * n]));
+        norms[j] = s;
+    }
+    std::vector<size_t> perm(n);
+    for (size_t j = 0; j < n; ++j) perm[j] = j;
+    std::stable_sort(perm.begin(), perm.end(), [&](size_t x, size_t y) { return norms[x] > norms[y]; });
+    out.s.resize(n);
+    for (size_t j = 0; j < n; ++j) out.s[j] = norms[perm[j]];
+    if (!want_vectors) return out;
+
+    // R W = U_R S: U_R's columns are R's normalized; near-zero ones are completed
+    const double cutoff = n > 0 ? out.s[0] * kEps * static_cast<double>(m) : 0.0;
+    std::vector<Complex> ur(n * n), vs(n * n);
+    std::vector<char> empty(n, 0);
+    for (size_t j = 0; j < n; ++j) {
+        size_t src = perm[j];
+        double sj = out.s[j];
+        empty[j] = sj <= cutoff || sj == 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            ur[i + j * n] = empty[j] ? Complex(0.0) : r[i + src * n] / sj;
+            vs[i + j * n] = w[i + src * n];
+        }
+    }
+    complete_orthonormal(n, n, ur.data(), empty);
+    out.v = std::move(vs);
+
+    // U = Q [U_R 0; 0 I]
+    out.ucols = full ? m : n;
+    std::vector<Complex> q = qr_form_q(m, out.ucols, a.data(), tau);
+    out.u.resize(m * out.ucols);
+    if (n > 0) kernels::gemm(m, n, n, q.data(), m, ur.data(), n, out.u.data(), m);
+    std::copy(q.begin() + static_cast<std::ptrdiff_t>(m * n), q.end(),
+              out.u.begin() + static_cast<std::ptrdiff_t>(m * n));
+    return out;
+}
+
+// SVD of any m x n tensor; wide matrices go through A^H = V S U^H
+SVDResult svd_any(const ComplexTensor& A, bool want_vectors, bool full) {
+    const size_t m = A.rows(), n = A.cols();
+    if (m >= n) return svd_tall(m, n, to_columns(A), want_vectors, full);
+
+    std::vector<Complex> ah(n * m);      // A^H, n x m column-major
+    const Complex* p = A.data();
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) ah[j + i * n] = std::conj(p[i * n + j]);
+    }
+    SVDResult t = svd_tall(n, m, std::move(ah), want_vectors, full);
+    SVDResult out;
+    out.s = std::move(t.s);
+    out.u = std::move(t.v);
+    out.ucols = m;
+    out.v = std::move(t.u);
+    return out;
+}
+
+// Finishes eig for Hermitian A once hessenberg_reduce has left the
+// tridiagonal T = Z^H A Z in h. With D = diag(p), p[k+1] = p[k] s_k / |s_k|
+// for the subdiagonal s, D^H T D is real symmetric; its eigenvectors Y
+// give A's as Z D Y. Values ascend, like the real symmetric solver.
+void hermitian_tridiagonal_eig(size_t n, const Complex* h, const Complex* z,
+                               std::vector<Complex>& eigenvalues, ComplexTensor& eigenvectors) {
+    std::vector<double> d(n), e(n > 0 ? n - 1 : 0), y(n * n);
+    std::vector<Complex> zd(z, z + n * n), yc(n * n), v(n * n);
+    Complex p = 1.0;
+    for (size_t k = 0; k < n; k++) {
+        d[k] = h[k + k * n].real();
+        if (k > 0) {
+            Complex* col = zd.data() + k * n;
+            for (size_t i = 0; i < n; i++) col[i] = mul(col[i], p);
+        }
+        if (k + 1 < n) {
+            Complex s = h[(k + 1) + k * n];
+            double r = std::abs(s);
+            e[k] = r;
+            if (r > 0.0) p = mul(p, s / r);
+        }
+    }
+    tridiagonal_eigen(n, d.data(), e.data(), y.data(), n);
+    for (size_t i = 0; i < n * n; i++) yc[i] = y[i];
+    if (n > 0) kernels::gemm(n, n, n, zd.data(), n, yc.data(), n, v.data(), n);
+
+    eigenvalues.assign(d.begin(), d.end());
+    eigenvectors = from_columns(v.data(), n, n, n);
+}
+
+} // namespace
+
+// ========== LU FACTORIZATION ==========
+
+ComplexLUFactorization::ComplexLUFactorization(const ComplexTensor& A) {
+    if (A.rows() != A.cols() || A.depth() != 1) {
+        throw std::runtime_error("LU factorization: matrix must be square");
+    }
+    n_ = A.rows();
+    lu_ = to_columns(A);
+    pivots_.resize(n_);
+
+    Complex* a = lu_.data();
+    const size_t n = n_;
+    for (size_t j = 0; j < n; j += kLUBlock) {
+        size_t jb = std::min(kLUBlock, n - j);
+        Complex* panel = a + j + j * n;
+
+        if (lu_panel(n - j, jb, panel, n, pivots_.data() + j)) singular_ = true;
+        for (size_t k = j; k < j + jb; ++k) pivots_[k] += j;
+
+        // Same swaps on the columns left and right of the panel
+        lu_swap_rows(a, n, 0, j, pivots_.data(), j, j + jb);
+        lu_swap_rows(a, n, j + jb, n, pivots_.data(), j, j + jb);
+
+        if (j + jb < n) {
+            // U12 = inv(L11) * A12, then A22 -= L21 * U12
+            size_t rest = n - j - jb;
+            Complex* a12 = a + j + (j + jb) * n;
+            lu_solve_lower(jb, rest, panel, n, a12, n);
+            kernels::gemm(rest, rest, jb, -1.0, panel + jb, n, a12, n, 1.0, a12 + jb, n);
+        }
+    }
+}
+
+void ComplexLUFactorization::solve_in_place(Complex* B, size_t ldb, size_t nrhs) const {
+    if (singular_) throw std::runtime_error("Matrix is singular to working precision");
+    if (n_ == 0 || nrhs == 0) return;
+    lu_swap_rows(B, ldb, 0, nrhs, pivots_.data(), 0, n_);
+    lu_solve_lower(n_, nrhs, lu_.data(), n_, B, ldb);
+    lu_solve_upper(n_, nrhs, lu_.data(), n_, B, ldb);
+}
+
+ComplexTensor ComplexLUFactorization::solve(const ComplexTensor& B) const {
+    if (B.rows() != n_ || B.depth() != 1) {
+        throw std::runtime_error("Matrix dimensions must agree");
+    }
+    std::vector<Complex> x = to_columns(B);
+    solve_in_place(x.data(), n_, B.cols());
+    return from_columns(x.data(), n_, B.cols(), n_);
+}
+
+ComplexTensor ComplexLUFactorization::inverse() const {
+    std::vector<Complex> x(n_ * n_, 0.0);
+    for (size_t i = 0; i < n_; ++i) x[i + i * n_] = 1.0;
+    solve_in_place(x.data(), n_, n_);
+    return from_columns(x.data(), n_, n_, n_);
+}
+
+ComplexLUFactorization::Complex ComplexLUFactorization::determinant() const {
+    Complex det = 1.0;
+    for (size_t i = 0; i < n_; ++i) {
+        det = mul(det, lu_[i + i * n_]);
+        if (pivots_[i] != i) det = -det;
+    }
+    return det;
+}
+
+ComplexTensor ComplexLUFactorization::lower() const {
+    ComplexTensor L(n_, n_);
+    for (size_t i = 0; i < n_; ++i) {
+        for (size_t j = 0; j < i; ++j) L(i, j) = lu_[i + j * n_];
+        L(i, i) = 1.0;
+    }
+    return L;
+}
+
+ComplexTensor ComplexLUFactorization::upper() const {
+    ComplexTensor U(n_, n_);
+    for (size_t i = 0; i < n_; ++i) {
+        for (size_t j = i; j < n_; ++j) U(i, j) = lu_[i + j * n_];
+    }
+    return U;
+}
+
+std::vector<size_t> ComplexLUFactorization::permutation() const {
+    std::vector<size_t> p(n_);
+    for (size_t i = 0; i < n_; ++i) p[i] = i;
+    for (size_t i = 0; i < n_; ++i) std::swap(p[i], p[pivots_[i]]);
+    return p;
+}
+
+// ========== DECOMPOSITIONS (CPU) ==========
+
+void ComplexTensor::lu(ComplexTensor& L, ComplexTensor& U, std::vector<size_t>& p) const {
+    assert(rows_ == cols_ && depth_ == 1);
+    ComplexLUFactorization f(*this);
+    L = f.lower();
+    U = f.upper();
+    p = f.permutation();
+}
+
+ComplexTensor ComplexTensor::inv() const {
+    assert(rows_ == cols_ && depth_ == 1);
+    return ComplexLUFactorization(*this).inverse();
+}
+
+// Hermitian positive definite A takes Cholesky, half the work of LU and
+// no pivoting, like the real backslash; anything else, or a Cholesky
+// that meets a non-positive pivot, takes LU
+ComplexTensor ComplexTensor::solve(const ComplexTensor& b) const {
+    if (b.rows_ != rows_ || b.depth_ != 1) throw std::runtime_error("Matrix dimensions must agree");
+    if (rows_ == cols_ && depth_ == 1) {
+        const size_t n = rows_;
+        std::vector<Complex> a = to_columns(*this);
+        if (hermitian_positive_diagonal(n, a.data()) && cholesky_factor(n, a.data())) {
+            std::vector<Complex> x = to_columns(b);
+            cholesky_solve(n, b.cols_, a.data(), x.data(), n);
+            return from_columns(x.data(), n, b.cols_, n);
+        }
+    }
+    return ComplexLUFactorization(*this).solve(b);
+}
+
+ComplexTensor::Complex ComplexTensor::det() const {
+    assert(rows_ == cols_ && depth_ == 1);
+    return ComplexLUFactorization(*this).determinant();
+}
+
+void ComplexTensor::qr(ComplexTensor& Q, ComplexTensor& R, bool economy) const {
+    assert(depth_ == 1);
+    const size_t m = rows_, n = cols_, k = std::min(m, n);
+    std::vector<Complex> a = to_columns(*this);
+    std::vector<Complex> tau;
+    qr_factor(m, n, a.data(), tau);
+
+    const size_t q = economy ? k : m;
+    std::vector<Complex> qa = qr_form_q(m, q, a.data(), tau);
+    Q = from_columns(qa.data(), m, q, m);
+    R = ComplexTensor(q, n);
+    for (size_t i = 0; i < q; i++) {
+        for (size_t j = i; j < n; j++) R(i, j) = a[i + j * m];
+    }
+}
+
+void ComplexTensor::eig(std::vector<Complex>& eigenvalues, ComplexTensor& eigenvectors) const {
+    assert(rows_ == cols_ && depth_ == 1);
+    const size_t n = rows_;
+    std::vector<Complex> h = to_columns(*this), z(n * n);
+    bool hermitian = true;
+    for (size_t j = 0; j < n && hermitian; j++) {
+        for (size_t i = j; i < n; i++) {
+            if (h[i + j * n] != std::conj(h[j + i * n])) { hermitian = false; break; }
+        }
+    }
+    hessenberg_reduce(n, h.data(), z.data());
+    if (hermitian) {
+        hermitian_tridiagonal_eig(n, h.data(), z.data(), eigenvalues, eigenvectors);
+        return;
+    }
+    if (!hessenberg_qr(n, h.data(), z.data())) {
+        throw std::runtime_error("eig: QR iteration did not converge");
+    }
+
+    eigenvalues.resize(n);
+    for (size_t i = 0; i < n; i++) eigenvalues[i] = h[i + i * n];
+
+    // Unit-norm columns of Z X
+    std::vector<Complex> x(n * n), v(n * n);
+    triangular_eigenvectors(n, h.data(), x.data());
+    if (n > 0) kernels::gemm(n, n, n, z.data(), n, x.data(), n, v.data(), n);
+    for (size_t j = 0; j < n; j++) {
+        Complex* col = v.data() + j * n;
+        double norm = 0.0;
+        for (size_t i = 0; i < n; i++) norm = std::hypot(norm, std::abs(col[i]));
+        if (norm > 0.0) {
+            for (size_t i = 0; i < n; i++) col[i] /= norm;
+        }
+    }
+    eigenvectors = from_columns(v.data(), n, n, n);
+}
+
+void ComplexTensor::svd(ComplexTensor& U, std::vector<double>& S, ComplexTensor& V, bool economy) const {
+    assert(depth_ == 1);
+    const size_t m = rows_, n = cols_, k = std::min(m, n);
+    SVDResult r = svd_any(*this, true, !economy);
+    S = std::move(r.s);
+    if (m >= n) {
+        U = from_columns(r.u.data(), m, r.ucols, m);
+        V = from_columns(r.v.data(), n, k, n);
+    } else {
+        // r.v holds the n x (economy ? m : n) factor from the A^H side
+        size_t vcols = economy ? k : n;
+        U = from_columns(r.u.data(), m, k, m);
+        V = from_columns(r.v.data(), n, vcols, n);
+    }
+}
+
+std::vector<double> ComplexTensor::singular_values() const {
+    assert(depth_ == 1);
+    return svd_any(*this, false, false).s;
+}
+
+} // namespace matlabcpp
@@ -0,0 +1,483 @@
+// MatLabC++ Lazy Tensors
+// src/gpu/lazy_tensor.cpp
+//
+// An evaluation has three passes over the nodes the requested value
+// depends on, skipping any that already have a value:
+//   rewrite   post-order; simplifies operand edges (conj and transpose
+//             pairs, scaling by 1) and rewrites nodes in place into
+//             cheaper equivalents (conj/fft/conj, scale after fft,
+//             transposes into gemm operand flags). A rewrite never
+//             changes what a node computes, so nodes shared with other
+//             graphs stay valid.
+//   count     consumers of each intermediate in the rewritten graph
+//   execute   post-order; an elementwise node inlines every elementwise
+//             operand with a single consumer into one fused program,
+//             run over blocks of kBlock elements per thread-pool task
+// Intermediates live in a table until their last consumer has run.
+
+#include "matlabcpp/lazy_tensor.hpp"
+#include "matlabcpp/fft.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace matlabcpp {
+
+namespace {
+
+using Complex = ComplexTensor::Complex;
+
+enum class LazyOp : uint8_t {
+    Input,                                  // a tensor: an input or an evaluated node
+    Add, Sub, Mul, Div, Scale, Conj,        // elementwise
+    Transpose, TransposeNoConj,
+    MatMul,
+    FFT                                     // unnormalized transform, then * scalar
+};
+
+bool is_elementwise(LazyOp op) {
+    return op >= LazyOp::Add && op <= LazyOp::Conj;
+}
+
+bool is_binary(LazyOp op) {
+    return op >= LazyOp::Add && op <= LazyOp::Div;
+}
+
+constexpr size_t kBlock = 256;              // elements per fused-kernel block
+constexpr size_t kParallelChunk = 1 << 14;
+
+} // namespace
+
+struct LazyTensor::Node {
+    LazyOp op = LazyOp::Input;
+    size_t rows = 0, cols = 0, depth = 1;
+    std::shared_ptr<Node> a, b;             // operands
+    Complex scalar = 1.0;                   // Scale; FFT: applied after the transform
+    bool inverse = false;                   // FFT direction
+    kernels::MatrixOp op_a = kernels::MatrixOp::None;   // MatMul: folded transposes
+    kernels::MatrixOp op_b = kernels::MatrixOp::None;
+    const ComplexTensor* tensor = nullptr;  // Input: the referenced or owned tensor
+    std::unique_ptr<ComplexTensor> value;   // owned input, or the evaluated result
+    LazyStats stats;
+
+    bool done() const { return op == LazyOp::Input; }
+    size_t size() const { return rows * cols * depth; }
+
+    static std::shared_ptr<Node> make(LazyOp op, size_t rows, size_t cols, size_t depth,
+                                      std::shared_ptr<Node> a, std::shared_ptr<Node> b = nullptr) {
+        auto n = std::make_shared<Node>();
+        n->op = op;
+        n->rows = rows;
+        n->cols = cols;
+        n->depth = depth;
+        n->a = std::move(a);
+        n->b = std::move(b);
+        return n;
+    }
+
+    // A pending node of this kind (evaluated nodes are inputs)
+    static bool pending(const std::shared_ptr<Node>& n, LazyOp op) { return n && n->op == op; }
+};
+
+// ========== RECORDING ==========
+
+LazyTensor::LazyTensor(const ComplexTensor& t) : node_(std::make_shared<Node>()) {
+    node_->rows = t.rows();
+    node_->cols = t.cols();
+    node_->depth = t.depth();
+    node_->tensor = &t;
+}
+
+LazyTensor::LazyTensor(ComplexTensor&& t) : node_(std::make_shared<Node>()) {
+    node_->rows = t.rows();
+    node_->cols = t.cols();
+    node_->depth = t.depth();
+    node_->value = std::make_unique<ComplexTensor>(std::move(t));
+    node_->tensor = node_->value.get();
+}
+
+// Shapes are checked when an operation is recorded, in every build, so a
+// graph that evaluates never reads past an operand
+void LazyTensor::check_same_shape(const LazyTensor& other, const char* op) const {
+    matlabcpp::check_same_shape(op, rows(), cols(), depth(), other.rows(), other.cols(), other.depth());
+}
+
+size_t LazyTensor::rows() const { return node_->rows; }
+size_t LazyTensor::cols() const { return node_->cols; }
+size_t LazyTensor::depth() const { return node_->depth; }
+
+LazyTensor LazyTensor::operator+(const LazyTensor& other) const {
+    check_same_shape(other, "plus");
+    return LazyTensor(Node::make(LazyOp::Add, rows(), cols(), depth(), node_, other.node_));
+}
+
+LazyTensor LazyTensor::operator-(const LazyTensor& other) const {
+    check_same_shape(other, "minus");
+    return LazyTensor(Node::make(LazyOp::Sub, rows(), cols(), depth(), node_, other.node_));
+}
+
+LazyTensor LazyTensor::times(const LazyTensor& other) const {
+    check_same_shape(other, "times");
+    return LazyTensor(Node::make(LazyOp::Mul, rows(), cols(), depth(), node_, other.node_));
+}
+
+LazyTensor LazyTensor::rdivide(const LazyTensor& other) const {
+    check_same_shape(other, "rdivide");
+    return LazyTensor(Node::make(LazyOp::Div, rows(), cols(), depth(), node_, other.node_));
+}
+
+LazyTensor LazyTensor::operator/(const LazyTensor& other) const {
+    return rdivide(other);
+}
+
+LazyTensor LazyTensor::operator*(const LazyTensor& other) const {
+    check_inner_dims("mtimes", cols(), other.rows());
+    assert(depth() == 1 && other.depth() == 1);
+    return LazyTensor(Node::make(LazyOp::MatMul, rows(), other.cols(), 1, node_, other.node_));
+}
+
+LazyTensor LazyTensor::operator*(const Complex& scalar) const {
+    auto n = Node::make(LazyOp::Scale, rows(), cols(), depth(), node_);
+    n->scalar = scalar;
+    return LazyTensor(std::move(n));
+}
+
+LazyTensor LazyTensor::operator/(const Complex& scalar) const {
+    return *this * (1.0 / scalar);
+}
+
+LazyTensor LazyTensor::conj() const {
+    return LazyTensor(Node::make(LazyOp::Conj, rows(), cols(), depth(), node_));
+}
+
+LazyTensor LazyTensor::transpose() const {
+    assert(depth() == 1);
+    return LazyTensor(Node::make(LazyOp::Transpose, cols(), rows(), 1, node_));
+}
+
+LazyTensor LazyTensor::transpose_no_conj() const {
+    assert(depth() == 1);
+    return LazyTensor(Node::make(LazyOp::TransposeNoConj, cols(), rows(), 1, node_));
+}
+
+LazyTensor LazyTensor::fft() const {
+    assert((rows() == 1 || cols() == 1) && depth() == 1);
+    return LazyTensor(Node::make(LazyOp::FFT, rows(), cols(), 1, node_));
+}
+
+LazyTensor LazyTensor::ifft() const {
+    assert((rows() == 1 || cols() == 1) && depth() == 1);
+    auto n = Node::make(LazyOp::FFT, rows(), cols(), 1, node_);
+    n->inverse = true;
+    n->scalar = size() ? 1.0 / static_cast<double>(size()) : 1.0;
+    return LazyTensor(std::move(n));
+}
+
+// ========== EVALUATION ==========
+
+class LazyTensor::Evaluator {
+    using NodePtr = std::shared_ptr<Node>;
+
+public:
+    explicit Evaluator(Node& root) : root_(root) {}
+
+    ComplexTensor run() {
+        count(&root_);
+        stats_.nodes = uses_.size() + 1;
+        visited_.clear();
+        rewrite(&root_);
+        visited_.clear();
+        uses_.clear();
+        count(&root_);
+        execute(&root_);
+        ComplexTensor result = std::move(temps_.at(&root_));
+        temps_.clear();
+        return result;
+    }
+
+    const LazyStats& stats() const { return stats_; }
+
+private:
+    // A fused program: operand references are inputs or earlier steps
+    struct Ref {
+        bool step;
+        uint32_t index;
+    };
+    struct Step {
+        LazyOp op;
+        Ref a, b;
+        Complex scalar;
+    };
+    struct Program {
+        std::vector<Node*> edges;           // one per input edge, with repeats
+        std::vector<Node*> inputs;          // distinct
+        std::vector<Step> steps;
+    };
+
+    Node& root_;
+    LazyStats stats_;
+    std::unordered_map<Node*, size_t> uses_;    // consumers of pending nodes
+    std::unordered_set<Node*> visited_;
+    std::unordered_map<Node*, ComplexTensor> temps_;
+
+    // Consumer counts over pending nodes; every pending node but the root
+    // gets an entry
+    void count(Node* n) {
+        if (!visited_.insert(n).second) return;
+        for (Node* o : {n->a.get(), n->b.get()}) {
+            if (!o || o->done()) continue;
+            uses_[o]++;
+            count(o);
+        }
+    }
+
+    // conj(conj(x)), transpose pairs and * 1 on an operand edge
+    void simplify(NodePtr& edge) {
+        for (;;) {
+            Node* n = edge.get();
+            if (n->done()) return;
+            bool pair = (n->op == LazyOp::Conj || n->op == LazyOp::Transpose ||
+                         n->op == LazyOp::TransposeNoConj) && Node::pending(n->a, n->op);
+            if (pair) {
+                edge = n->a->a;
+                stats_.eliminated += 2;
+            } else if (n->op == LazyOp::Scale && n->scalar == Complex(1.0)) {
+                edge = n->a;
+                stats_.eliminated += 1;
+            } else {
+                return;
+            }
+        }
+    }
+
+    bool single_use(const NodePtr& n) {
+        auto it = uses_.find(n.get());
+        return it != uses_.end() && it->second == 1;
+    }
+
+    void rewrite(Node* n) {
+        if (n->done() || !visited_.insert(n).second) return;
+        for (NodePtr* edge : {&n->a, &n->b}) {
+            if (!*edge) continue;
+            rewrite(edge->get());
+            simplify(*edge);
+        }
+        // Counts are from before rewriting: still right for the single-use
+        // tests, as rewriting only ever removes consumers
+        if (n->op == LazyOp::Conj && Node::pending(n->a, LazyOp::FFT) && single_use(n->a) &&
+            Node::pending(n->a->a, LazyOp::Conj)) {
+            // conj(s * F(conj(x))) = conj(s) * F'(x), F' the opposite direction
+            NodePtr f = n->a;
+            stats_.eliminated += single_use(f->a) ? 2 : 1;
+            n->op = LazyOp::FFT;
+            n->inverse = !f->inverse;
+            n->scalar = std::conj(f->scalar);
+            n->a = f->a->a;
+        }
+        if (n->op == LazyOp::Scale && Node::pending(n->a, LazyOp::FFT) && single_use(n->a)) {
+            NodePtr f = n->a;
+            stats_.eliminated += 1;
+            n->op = LazyOp::FFT;
+            n->inverse = f->inverse;
+            n->scalar = f->scalar * n->scalar;
+            n->a = f->a;
+        }
+        if (n->op == LazyOp::MatMul) {
+            fold_transpose(n->a, n->op_a);
+            fold_transpose(n->b, n->op_b);
+        }
+    }
+
+    void fold_transpose(NodePtr& edge, kernels::MatrixOp& op) {
+        if (Node::pending(edge, LazyOp::Transpose)) {
+            op = kernels::MatrixOp::ConjTranspose;
+        } else if (Node::pending(edge, LazyOp::TransposeNoConj)) {
+            op = kernels::MatrixOp::Transpose;
+        } else {
+            return;
+        }
+        edge = edge->a;
+        stats_.folded_transposes++;
+    }
+
+    const ComplexTensor& value(Node* n) {
+        return n->done() ? *n->tensor : temps_.at(n);
+    }
+
+    // An operand edge has been consumed: free the intermediate after its
+    // last consumer
+    void release(Node* n) {
+        if (n->done()) return;
+        if (--uses_.at(n) == 0) temps_.erase(n);
+    }
+
+    // A new result tensor, or the buffer of an intermediate whose every
+    // remaining use is one of edges
+    ComplexTensor output(Node* n, const std::vector<Node*>& edges) {
+        for (Node* in : edges) {
+            if (in->done() || in->rows != n->rows || in->cols != n->cols || in->depth != n->depth) continue;
+            size_t mine = static_cast<size_t>(std::count(edges.begin(), edges.end(), in));
+            ComplexTensor& t = temps_.at(in);
+            if (mine == uses_.at(in) && t.device() == Device::CPU && t.layout() == Layout::Interleaved) {
+                return std::move(t);
+            }
+        }
+        if (n != &root_) stats_.temporaries++;
+        return ComplexTensor(n->rows, n->cols, n->depth);
+    }
+
+    void execute(Node* n) {
+        if (n->done() || temps_.count(n)) return;
+        ComplexTensor result;
+        if (is_elementwise(n->op)) {
+            result = run_fused(n);
+        } else if (n->op == LazyOp::MatMul) {
+            result = run_matmul(n);
+        } else if (n->op == LazyOp::FFT) {
+            result = run_fft(n);
+        } else {
+            execute(n->a.get());
+            const ComplexTensor& x = value(n->a.get());
+            result = n->op == LazyOp::Transpose ? x.transpose() : x.transpose_no_conj();
+            release(n->a.get());
+            if (n != &root_) stats_.temporaries++;
+        }
+        stats_.kernels++;
+        temps_[n] = std::move(result);
+    }
+
+    // Inlines single-consumer elementwise operands; anything else is
+    // executed first and read as an input
+    Ref emit(Node* n, Program& p, bool top) {
+        bool inline_here = top || (is_elementwise(n->op) && !n->done() && uses_.at(n) == 1);
+        if (!inline_here) {
+            execute(n);
+            p.edges.push_back(n);
+            auto it = std::find(p.inputs.begin(), p.inputs.end(), n);
+            if (it == p.inputs.end()) it = p.inputs.insert(it, n);
+            return {false, static_cast<uint32_t>(it - p.inputs.begin())};
+        }
+        if (!top) stats_.fused++;
+        Step s{n->op, emit(n->a.get(), p, false), {false, 0}, n->scalar};
+        if (n->b) s.b = emit(n->b.get(), p, false);
+        p.steps.push_back(s);
+        return {true, static_cast<uint32_t>(p.steps.size() - 1)};
+    }
+
+    ComplexTensor run_fused(Node* n) {
+        Program p;
+        emit(n, p, true);
+        std::vector<const Complex*> data;
+        for (Node* in : p.inputs) data.push_back(value(in).data());
+        ComplexTensor out = output(n, p.edges);
+        Complex* result = out.data();
+
+        const size_t steps = p.steps.size();
+        parallel_for(n->size(), kParallelChunk, [&](size_t lo, size_t hi) {
+            std::vector<Complex> regs(steps > 1 ? (steps - 1) * kBlock : 0);
+            for (size_t base = lo; base < hi; base += kBlock) {
+                size_t len = std::min(kBlock, hi - base);
+                auto operand = [&](Ref r) -> const Complex* {
+                    return r.step ? regs.data() + r.index * kBlock : data[r.index] + base;
+                };
+                for (size_t k = 0; k < steps; k++) {
+                    const Step& s = p.steps[k];
+                    Complex* d = k + 1 == steps ? result + base : regs.data() + k * kBlock;
+                    const Complex* x = operand(s.a);
+                    const Complex* y = is_binary(s.op) ? operand(s.b) : nullptr;
+                    apply(s, x, y, d, len);
+                }
+            }
+        });
+        for (Node* in : p.edges) release(in);
+        return out;
+    }
+
+    static void apply(const Step& s, const Complex* x, const Complex* y, Complex* d, size_t len) {
+        switch (s.op) {
+            case LazyOp::Add: for (size_t i = 0; i < len; i++) d[i] = x[i] + y[i]; break;
+            case LazyOp::Sub: for (size_t i = 0; i < len; i++) d[i] = x[i] - y[i]; break;
+            case LazyOp::Mul: for (size_t i = 0; i < len; i++) d[i] = x[i] * y[i]; break;
+            case LazyOp::Div: for (size_t i = 0; i < len; i++) d[i] = x[i] / y[i]; break;
+            case LazyOp::Scale: for (size_t i = 0; i < len; i++) d[i] = x[i] * s.scalar; break;
+            case LazyOp::Conj: for (size_t i = 0; i < len; i++) d[i] = std::conj(x[i]); break;
+            default: assert(false);
+        }
+    }
+
+    // Row-major C = op(A) * op(B) is column-major C' = op(B)' * op(A)';
+    // a stored row-major matrix read column-major is its transpose, so a
+    // folded transpose becomes a transposed gemm operand
+    ComplexTensor run_matmul(Node* n) {
+        execute(n->a.get());
+        execute(n->b.get());
+        const ComplexTensor& A = value(n->a.get());
+        const ComplexTensor& B = value(n->b.get());
+        ComplexTensor out;
+        if (n->op_a == kernels::MatrixOp::None && n->op_b == kernels::MatrixOp::None) {
+            A.mtimes(B, out);
+        } else {
+            const size_t m = n->rows, k = n->op_a == kernels::MatrixOp::None ? A.cols() : A.rows();
+            const size_t nc = n->cols;
+            // op(A) is m x k and op(B) k x nc once the transposes are folded
+            const bool b_plain = n->op_b == kernels::MatrixOp::None;
+            if ((n->op_a == kernels::MatrixOp::None ? A.rows() : A.cols()) != m ||
+                (b_plain ? B.cols() : B.rows()) != nc) {
+                throw std::logic_error("LazyTensor: folded product does not match its recorded shape");
+            }
+            check_inner_dims("mtimes", k, b_plain ? B.rows() : B.cols());
+            out = ComplexTensor(m, nc);
+            const size_t lda = n->op_a == kernels::MatrixOp::None ? k : m;
+            const size_t ldb = n->op_b == kernels::MatrixOp::None ? nc : k;
+            kernels::gemm(n->op_b, n->op_a, nc, m, k, 1.0, B.data(), ldb, A.data(), lda,
+                          0.0, out.data(), nc);
+        }
+        if (n != &root_) stats_.temporaries++;
+        release(n->a.get());
+        release(n->b.get());
+        return out;
+    }
+
+    // In place on the operand's buffer when this is its last consumer
+    ComplexTensor run_fft(Node* n) {
+        Node* x = n->a.get();
+        execute(x);
+        const Complex* in = value(x).data();
+        ComplexTensor out = output(n, {x});
+        if (out.data() != in) std::copy(in, in + n->size(), out.data());
+        if (n->size()) fft::transform(out.data(), n->size(), n->inverse);
+        if (n->scalar != Complex(1.0)) out.scale_inplace(n->scalar);
+        release(x);
+        return out;
+    }
+};
+
+const ComplexTensor& LazyTensor::eval() const {
+    Node& n = *node_;
+    if (n.done()) return *n.tensor;
+    Evaluator evaluator(n);
+    ComplexTensor result = evaluator.run();
+    n.value = std::make_unique<ComplexTensor>(std::move(result));
+    n.tensor = n.value.get();
+    n.stats = evaluator.stats();
+    n.op = LazyOp::Input;
+    n.a.reset();
+    n.b.reset();
+    return *n.tensor;
+}
+
+bool LazyTensor::evaluated() const {
+    return node_->done();
+}
+
+const LazyStats& LazyTensor::stats() const {
+    return node_->stats;
+}
+
+} // namespace matlabcpp
@@ -0,0 +1,360 @@
+// MatLabC++ Virtual Device
+// src/gpu/virtual_device.cpp
+//
+// The CPU reference backend of device.hpp: an arena standing in for device
+// memory and a worker thread per stream running its commands in order.
+
+#include "matlabcpp/device.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <new>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace matlabcpp {
+
+namespace {
+
+constexpr size_t kDeviceAlignment = 256;        // like cudaMalloc
+constexpr size_t kParallelChunk = 1 << 14;      // complex elements per task
+
+size_t round_up(size_t bytes) {
+    return (bytes + kDeviceAlignment - 1) / kDeviceAlignment * kDeviceAlignment;
+}
+
+VirtualDevice::Options default_options() {
+    VirtualDevice::Options options;
+    if (const char* env = std::getenv("MATLABCPP_DEVICE_MB")) {
+        long mb = std::strtol(env, nullptr, 10);
+        if (mb > 0) options.memory_bytes = static_cast<size_t>(mb) << 20;
+    }
+    return options;
+}
+
+using Clock = std::chrono::steady_clock;
+
+// Holds a command back until the modelled time has passed
+void wait_until(Clock::time_point start, double seconds) {
+    if (seconds > 0.0) std::this_thread::sleep_until(start + std::chrono::duration<double>(seconds));
+}
+
+} // namespace
+
+// ========== ARENA ==========
+
+// Mapped without reserving swap on Linux, so an unused arena costs
+// address space only
+VirtualDevice::Arena::Arena(size_t capacity) : capacity_(round_up(capacity)) {
+#if defined(__linux__)
+    void* p = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    base_ = static_cast<char*>(p);
+#else
+    base_ = static_cast<char*>(::operator new(capacity_, std::align_val_t(kDeviceAlignment)));
+#endif
+    if (capacity_) free_[0] = capacity_;
+}
+
+VirtualDevice::Arena::~Arena() {
+#if defined(__linux__)
+    munmap(base_, capacity_);
+#else
+    ::operator delete(base_, std::align_val_t(kDeviceAlignment));
+#endif
+}
+
+void* VirtualDevice::Arena::allocate(size_t bytes) {
+    size_t size = round_up(bytes ? bytes : 1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = free_.begin(); it != free_.end(); ++it) {
+        if (it->second < size) continue;
+        size_t offset = it->first, rest = it->second - size;
+        free_.erase(it);
+        if (rest) free_[offset + size] = rest;
+        in_use_ += size;
+        peak_ = std::max(peak_, in_use_);
+        return base_ + offset;
+    }
+    return nullptr;
+}
+
+void VirtualDevice::Arena::deallocate(void* p, size_t bytes) {
+    size_t size = round_up(bytes ? bytes : 1);
+    size_t offset = static_cast<size_t>(static_cast<char*>(p) - base_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_use_ -= size;
+    auto next = free_.lower_bound(offset);
+    if (next != free_.end() && next->first == offset + size) {
+        size += next->second;
+        next = free_.erase(next);
+    }
+    if (next != free_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            return;
+        }
+    }
+    free_[offset] = size;
+}
+
+size_t VirtualDevice::Arena::in_use() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_use_;
+}
+
+size_t VirtualDevice::Arena::peak() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peak_;
+}
+
+void VirtualDevice::Arena::reset_peak() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peak_ = in_use_;
+}
+
+// ========== STREAM ==========
+
+class VirtualDevice::Stream : public DeviceStream {
+public:
+    explicit Stream(VirtualDevice& device) : device_(device), worker_(&Stream::run, this) {}
+
+    ~Stream() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_one();
+        worker_.join();
+    }
+
+    // Staged like a pageable cudaMemcpyAsync: the host buffer is read now
+    void copy_to_device(void* device, const void* host, size_t bytes) override {
+        auto staging = std::make_shared<std::vector<char>>(static_cast<const char*>(host),
+                                                           static_cast<const char*>(host) + bytes);
+        count([&](DeviceStats& s) { s.bytes_to_device += bytes; s.transfers_to_device++; });
+        submit([this, device, staging] {
+            Clock::time_point start = Clock::now();
+            std::memcpy(device, staging->data(), staging->size());
+            wait_until(start, transfer_seconds(staging->size()));
+        });
+    }
+
+    void copy_to_host(void* host, const void* device, size_t bytes) override {
+        count([&](DeviceStats& s) { s.bytes_to_host += bytes; s.transfers_to_host++; });
+        submit([this, host, device, bytes] {
+            Clock::time_point start = Clock::now();
+            std::memcpy(host, device, bytes);
+            wait_until(start, transfer_seconds(bytes));
+        });
+    }
+
+    void copy(void* dst, const void* src, size_t bytes) override {
+        launch([=] { std::memmove(dst, src, bytes); });
+    }
+
+    void zero(void* device, size_t bytes) override {
+        launch([=] { std::memset(device, 0, bytes); });
+    }
+
+    void elementwise(DeviceOp op, const Complex* a, const Complex* b, Complex* out, size_t n) override {
+        launch([=] {
+            parallel_for(n, kParallelChunk, [&](size_t lo, size_t hi) {
+                switch (op) {
+                    case DeviceOp::Add: for (size_t i = lo; i < hi; i++) out[i] = a[i] + b[i]; break;
+                    case DeviceOp::Sub: for (size_t i = lo; i < hi; i++) out[i] = a[i] - b[i]; break;
+                    case DeviceOp::Mul: for (size_t i = lo; i < hi; i++) out[i] = a[i] * b[i]; break;
+                    case DeviceOp::Div: for (size_t i = lo; i < hi; i++) out[i] = a[i] / b[i]; break;
+                }
+            });
+        });
+    }
+
+    void scale(const Complex* a, Complex s, Complex* out, size_t n) override {
+        launch([=] {
+            parallel_for(n, kParallelChunk, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; i++) out[i] = a[i] * s;
+            });
+        });
+    }
+
+    void conj(const Complex* a, Complex* out, size_t n) override {
+        launch([=] {
+            parallel_for(n, kParallelChunk, [&](size_t lo, size_t hi) {
+                for (size_t i = lo; i < hi; i++) out[i] = std::conj(a[i]);
+            });
+        });
+    }
+
+    void gemm(size_t m, size_t n, size_t k, const Complex* a, size_t lda,
+              const Complex* b, size_t ldb, Complex* c, size_t ldc) override {
+        launch([=] { kernels::gemm(m, n, k, a, lda, b, ldb, c, ldc); });
+    }
+
+    void release(void* device, size_t bytes) override {
+        submit([this, device, bytes] { device_.arena_.deallocate(device, bytes); });
+    }
+
+    void synchronize() override {
+        count([](DeviceStats& s) { s.synchronizations++; });
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [&] { return queue_.empty() && !busy_; });
+        if (error_) {
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    VirtualDevice& device_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable idle_;
+    std::deque<std::function<void()>> queue_;
+    bool busy_ = false;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    std::thread worker_;            // last: starts once the rest exists
+
+    template <typename F>
+    void count(F update) {
+        std::lock_guard<std::mutex> lock(device_.stats_mutex_);
+        update(device_.counters_);
+    }
+
+    double transfer_seconds(size_t bytes) const {
+        double gbps = device_.options_.transfer_gbps;
+        return gbps > 0.0 ? static_cast<double>(bytes) / (gbps * 1e9) : 0.0;
+    }
+
+    // A kernel: counted, and held to the modelled launch latency
+    void launch(std::function<void()> kernel) {
+        count([](DeviceStats& s) { s.kernel_launches++; });
+        double latency = device_.options_.launch_latency_us * 1e-6;
+        submit([kernel = std::move(kernel), latency] {
+            Clock::time_point start = Clock::now();
+            kernel();
+            wait_until(start, latency);
+        });
+    }
+
+    void submit(std::function<void()> command) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(command));
+        }
+        ready_.notify_one();
+    }
+
+    // Commands after a failed one still run, so releases are not lost;
+    // the first failure is reported by the next synchronize
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            ready_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;            // stopping, and drained
+            std::function<void()> command = std::move(queue_.front());
+            queue_.pop_front();
+            busy_ = true;
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                command();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            busy_ = false;
+            if (error && !error_) error_ = error;
+            if (queue_.empty()) idle_.notify_all();
+        }
+    }
+};
+
+// ========== VIRTUAL DEVICE ==========
+
+VirtualDevice::VirtualDevice() : VirtualDevice(default_options()) {}
+
+VirtualDevice::VirtualDevice(const Options& options)
+    : options_(options), arena_(options.memory_bytes), default_stream_(std::make_unique<Stream>(*this)) {
+    counters_.memory_capacity = arena_.capacity();
+}
+
+// The default stream drains (running its pending releases) before the
+// arena goes
+VirtualDevice::~VirtualDevice() = default;
+
+// A full arena may only be waiting on stream-ordered releases
+void* VirtualDevice::allocate(size_t bytes) {
+    void* p = arena_.allocate(bytes);
+    if (!p) {
+        default_stream_->synchronize();
+        p = arena_.allocate(bytes);
+    }
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+DeviceStream& VirtualDevice::default_stream() {
+    return *default_stream_;
+}
+
+std::unique_ptr<DeviceStream> VirtualDevice::create_stream() {
+    return std::make_unique<Stream>(*this);
+}
+
+DeviceStats VirtualDevice::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    DeviceStats s = counters_;
+    s.memory_in_use = arena_.in_use();
+    s.peak_memory_in_use = arena_.peak();
+    return s;
+}
+
+void VirtualDevice::reset_stats() {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    counters_ = DeviceStats();
+    counters_.memory_capacity = arena_.capacity();
+    arena_.reset_peak();
+}
+
+// ========== CURRENT BACKEND ==========
+
+namespace {
+
+std::mutex& backend_mutex() {
+    static std::mutex m;
+    return m;
+}
+
+std::shared_ptr<DeviceBackend>& backend_slot() {
+    static std::shared_ptr<DeviceBackend> backend;
+    return backend;
+}
+
+} // namespace
+
+std::shared_ptr<DeviceBackend> DeviceBackend::current() {
+    std::lock_guard<std::mutex> lock(backend_mutex());
+    auto& backend = backend_slot();
+    if (!backend) backend = std::make_shared<VirtualDevice>();
+    return backend;
+}
+
+void DeviceBackend::set_current(std::shared_ptr<DeviceBackend> backend) {
+    std::lock_guard<std::mutex> lock(backend_mutex());
+    backend_slot() = std::move(backend);
+}
+
+} // namespace matlabcpp
@@ -4,11 +4,13 @@
 #include <iostream>
 #include <string>
 #include <filesystem>
+#include <vector>
 #include "matlabcpp/active_window.hpp"
+#include "matlabcpp/script_cache.hpp"
 
 // Forward declaration from interpreter
 namespace matlabcpp { namespace interpreter {
-    int run_script(const std::string& path);
+    int run_script(const std::string& path, bool use_cache, bool record_stats);
 }}
 
 // Forward declaration from publisher
@@ -24,9 +26,13 @@ void print_usage() {
     std::cout << "Usage:\n";
     std::cout << "  mlab++                    Run interactive active window\n";
     std::cout << "  mlab++ script.m           Execute MATLAB script\n";
+    std::cout << "  mlab++ script.m --no-cache  Execute without the bytecode cache\n";
+    std::cout << "  mlab++ script.m --cache-stats  Execute and record cache statistics\n";
     std::cout << "  mlab++ publish script.m   Generate HTML report (MATLAB theme)\n";
     std::cout << "  mlab++ publish script.m --theme dark\n";
     std::cout << "  mlab++ publish script.m --font Arial --fontsize 14\n";
+    std::cout << "  mlab++ --cache-stats      Show bytecode cache hit/miss statistics\n";
+    std::cout << "  mlab++ --clear-cache      Remove cached bytecode\n";
     std::cout << "  mlab++ --version          Show version information\n";
     std::cout << "  mlab++ --help             Show this help\n";
     std::cout << "\n";
@@ -38,14 +44,33 @@ void print_usage() {
 }
 
 int main(int argc, char** argv) {
+    // --no-cache and --cache-stats may appear anywhere; collect the
+    // remaining arguments without touching argv
+    bool use_cache = true;
+    bool cache_stats = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--no-cache") use_cache = false;
+        else if (a == "--cache-stats") cache_stats = true;
+        else args.push_back(a);
+    }
+
+    // --cache-stats alone: report what earlier --cache-stats runs recorded
+    if (args.empty() && cache_stats) {
+        matlabcpp::interpreter::ScriptCache cache;
+        cache.print_stats(std::cout);
+        return 0;
+    }
+
     // No arguments: start interactive active window
-    if (argc == 1) {
+    if (args.empty()) {
         matlabcpp::ActiveWindow window;
         window.start();
         return 0;
     }
 
-    std::string arg = argv[1];
+    std::string arg = args[0];
 
     if (arg == "--version" || arg == "-v") {
         std::cout << "MatLabC++ version 0.5.0\n";
@@ -58,30 +83,38 @@ int main(int argc, char** argv) {
         return 0;
     }
 
+    if (arg == "--clear-cache") {
+        matlabcpp::interpreter::ScriptCache cache;
+        size_t removed = cache.clear();
+        cache.reset_persistent_stats();
+        std::cout << "Removed " << removed << " cached script(s)\n";
+        return 0;
+    }
+
     // publish command: mlab++ publish script.m [format] [options]
-    if (arg == "publish" && argc >= 3) {
-        std::string script = argv[2];
+    if (arg == "publish" && args.size() >= 2) {
+        std::string script = args[1];
         std::string format = "html";
         std::string theme = "default";
         std::string font = "";
         int fontsize = 0;
 
         // Parse optional arguments
-        for (int i = 3; i < argc; i++) {
-            std::string opt = argv[i];
+        for (size_t i = 2; i < args.size(); i++) {
+            std::string opt = args[i];
 
             if (opt == "--help" || opt == "-h") {
                 matlabcpp::publishing::print_style_options();
                 return 0;
             }
-            else if (opt == "--theme" && i + 1 < argc) {
-                theme = argv[++i];
+            else if (opt == "--theme" && i + 1 < args.size()) {
+                theme = args[++i];
             }
-            else if (opt == "--font" && i + 1 < argc) {
-                font = argv[++i];
+            else if (opt == "--font" && i + 1 < args.size()) {
+                font = args[++i];
             }
-            else if (opt == "--fontsize" && i + 1 < argc) {
-                fontsize = std::stoi(argv[++i]);
+            else if (opt == "--fontsize" && i + 1 < args.size()) {
+                fontsize = std::stoi(args[++i]);
             }
             else if (opt[0] != '-') {
                 format = opt;
@@ -102,7 +135,12 @@ int main(int argc, char** argv) {
             std::cerr << "Error: File not found: " << arg << "\n";
             return 1;
         }
-        return matlabcpp::interpreter::run_script(arg);
+        int status = matlabcpp::interpreter::run_script(arg, use_cache, cache_stats);
+        if (cache_stats) {
+            std::cout << "\n";
+            matlabcpp::interpreter::ScriptCache().print_stats(std::cout);
+        }
+        return status;
     }
 
     // Unknown argument
@@ -10,6 +10,7 @@
 #include <memory>
 #include <sstream>
 #include <iomanip>
+#include <iostream>
 
 #ifdef HAVE_CAIRO
 #include <cairo/cairo.h>
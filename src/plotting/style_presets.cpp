@@ -1,6 +1,7 @@
 // Style Presets - Publication-quality plot styles
 // src/plotting/style_presets.cpp
 
+#include "matlabcpp/plotting.hpp"
 #include <map>
 #include <string>
 #include <vector>
@@ -8,11 +9,6 @@
 namespace matlabcpp {
 namespace plotting {
 
-// Forward declarations from plot_spec.cpp
-struct Color;
-struct PlotSpec;
-struct FigureSpec;
-
 // Style preset definitions
 struct StylePreset {
     std::string name;
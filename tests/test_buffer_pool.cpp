@@ -0,0 +1,129 @@
+// Test Buffer Pool - size-class reuse behind AlignedAllocator
+// tests/test_buffer_pool.cpp
+
+#undef NDEBUG  // the checks below are the test; keep them in Release builds
+
+#include "matlabcpp/array.hpp"
+#include "matlabcpp/buffer_pool.hpp"
+#include "matlabcpp/complex_tensor.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <cassert>
+#include <thread>
+
+using namespace matlabcpp;
+
+void test_buffer_pool() {
+    std::cout << "Testing the buffer pool...\n";
+
+    size_t limit = buffer_pool::cache_limit();
+    buffer_pool::set_cache_limit(size_t(64) << 20);
+
+    // Sizes round up to a class; a freed block serves the next request of its class
+    BufferPoolStats before = buffer_pool::stats();
+    void* a = buffer_pool::allocate(1000);
+    assert(reinterpret_cast<uintptr_t>(a) % 64 == 0);
+    BufferPoolStats held = buffer_pool::stats();
+    assert(held.bytes_in_use - before.bytes_in_use == 1024);     // 896 < 1000 <= 1024
+    assert(held.bytes_requested - before.bytes_requested == 1000);
+    buffer_pool::deallocate(a, 1000);
+    void* b = buffer_pool::allocate(1010);
+    assert(b == a && buffer_pool::stats().hits == held.hits + 1);
+    buffer_pool::deallocate(b, 1010);
+
+    // Arrays and tensors of one shape, over and over: no new system blocks
+    for (int pass = 0; pass < 2; ++pass) {
+        Array x(200, 150);
+        ComplexTensor z(64, 64);
+        Array y = Array::uninitialized(200, 150);
+    }
+    BufferPoolStats warm = buffer_pool::stats();
+    for (int pass = 0; pass < 50; ++pass) {
+        Array x(200, 150);
+        ComplexTensor z(64, 64);
+        Array y = Array::uninitialized(200, 150);
+        assert(x.data() != y.data());
+    }
+    BufferPoolStats after = buffer_pool::stats();
+    assert(after.system_allocations == warm.system_allocations);
+    assert(after.allocations - warm.allocations == 150 && after.hits - warm.hits == 150);
+    assert(after.bytes_in_use == warm.bytes_in_use);
+
+    // Huge blocks are 2 MiB aligned; peak and fragmentation track them
+    buffer_pool::reset_peak();
+    size_t huge = (size_t(5) << 20) + 8;
+    void* h = buffer_pool::allocate(huge);
+    assert(reinterpret_cast<uintptr_t>(h) % (size_t(2) << 20) == 0);
+    static_cast<char*>(h)[huge - 1] = 1;                          // the whole block is usable
+    BufferPoolStats big = buffer_pool::stats();
+    assert(big.peak_bytes_in_use >= big.bytes_in_use && big.bytes_in_use >= huge);
+    assert(big.fragmentation() > 0.0 && big.fragmentation() < 0.25);
+    buffer_pool::deallocate(h, huge);
+    assert(buffer_pool::stats().bytes_cached >= huge);
+
+    // The cache limit and trim give idle blocks back
+    buffer_pool::set_cache_limit(0);
+    assert(buffer_pool::stats().bytes_cached < huge);
+    buffer_pool::set_cache_limit(limit);
+    void* small = buffer_pool::allocate(100);
+    buffer_pool::deallocate(small, 100);                          // into this thread's cache
+    size_t cached = buffer_pool::stats().bytes_cached;
+    uint64_t frees = buffer_pool::stats().system_frees;
+    buffer_pool::trim();
+    BufferPoolStats trimmed = buffer_pool::stats();
+    assert(trimmed.bytes_cached < cached && trimmed.system_frees > frees);
+
+    // Another thread's cache survives trim until that thread calls again
+    const size_t block = 4096, count = 8;
+    std::atomic<int> step{0};
+    std::thread worker([&] {
+        void* p[count];
+        for (auto& q : p) q = buffer_pool::allocate(block);
+        for (auto& q : p) buffer_pool::deallocate(q, block);
+        step = 1;
+        while (step != 2) std::this_thread::yield();
+        buffer_pool::deallocate(buffer_pool::allocate(64), 64);
+    });
+    while (step != 1) std::this_thread::yield();
+    BufferPoolStats parked = buffer_pool::stats();
+    assert(parked.bytes_thread_cached >= count * block);
+    buffer_pool::trim();
+    assert(buffer_pool::stats().bytes_thread_cached == parked.bytes_thread_cached);
+    step = 2;
+    worker.join();
+    assert(buffer_pool::stats().bytes_thread_cached + count * block <= parked.bytes_thread_cached + 64);
+
+    // Thread caches count against the limit
+    const size_t tight = 2 * block;
+    buffer_pool::set_cache_limit(tight);
+    BufferPoolStats limited = buffer_pool::stats();
+    void* p[count];
+    for (auto& q : p) q = buffer_pool::allocate(block);
+    for (auto& q : p) buffer_pool::deallocate(q, block);
+    BufferPoolStats full = buffer_pool::stats();
+    assert(full.bytes_cached <= std::max(tight, limited.bytes_cached));
+    assert(full.system_frees >= limited.system_frees + count - 2);
+    buffer_pool::set_cache_limit(limit);
+
+    std::cout << "✓ Buffer pool tests passed\n\n";
+}
+
+int main() {
+    std::cout << "\n";
+    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║  MatLabC++ Buffer Pool Test Suite                          ║\n";
+    std::cout << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+    try {
+        test_buffer_pool();
+
+        std::cout << "════════════════════════════════════════════════════════════\n";
+        std::cout << "  ALL TESTS PASSED ✓\n";
+        std::cout << "════════════════════════════════════════════════════════════\n\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "\n✗ TEST FAILED: " << e.what() << "\n\n";
+        return 1;
+    }
+}
@@ -0,0 +1,222 @@
+// Test Complex Tensor - storage layouts and arithmetic
+// tests/test_complex_tensor.cpp
+
+#undef NDEBUG  // the checks below are the test; keep them in Release builds
+
+#include "matlabcpp/complex_tensor.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+using namespace matlabcpp;
+
+void test_planar_storage() {
+    std::cout << "Testing planar complex storage...\n";
+
+    using C = std::complex<double>;
+    using matlabcpp::Layout;
+    const size_t m = 37, n = 29;
+    auto close = [](C a, C b) { return std::abs(a - b) <= 1e-12 * (1.0 + std::abs(b)); };
+
+    // Same values, both layouts
+    ComplexTensor A(m, n), B(m, n);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            A(i, j) = {std::sin(0.3 * i + j), std::cos(0.7 * j - i)};
+            B(i, j) = {1.5 + std::cos(0.2 * i * j), std::sin(0.9 * i) - 0.4};
+        }
+    }
+    ComplexTensor Ap = A.on_cpu(), Bp = B.on_cpu();
+    Ap.to_planar();
+    Bp.to_planar();
+    assert(Ap.layout() == Layout::Planar && A.layout() == Layout::Interleaved);
+    assert(!Ap.is_real() && Ap.memory_bytes() == A.memory_bytes());
+
+    ComplexTensor sum = Ap + Bp, diff = Ap - Bp, prod = Ap.times(Bp), quot = Ap / Bp;
+    ComplexTensor scaled = Ap * C(0.5, -2.0), mixed = Ap.times(B);
+    assert(sum.layout() == Layout::Planar && prod.layout() == Layout::Planar);
+    ComplexTensor At = Ap.transpose(), absA = Ap.abs();
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            C a = A(i, j), b = B(i, j);
+            assert(sum(i, j) == a + b && diff(i, j) == a - b);
+            assert(close(prod(i, j), a * b) && close(quot(i, j), a / b));
+            assert(close(scaled(i, j), a * C(0.5, -2.0)) && close(mixed(i, j), a * b));
+            assert(close(absA(i, j), std::abs(a)));
+            assert(At(j, i) == std::conj(a));
+        }
+    }
+    assert(close(Ap.sum(), A.sum()) && std::abs(Ap.norm() - A.norm()) < 1e-12);
+
+    // Matrix products: four real gemms, two when one side is real, one when both are
+    ComplexTensor Bt = B.transpose_no_conj(), Btp = Bt.on_cpu();
+    Btp.to_planar();
+    ComplexTensor P = A * Bt, Pp = Ap * Btp;
+    assert(Pp.layout() == Layout::Planar && Pp.rows() == m && Pp.cols() == m);
+    ComplexTensor R = ComplexTensor::from_real(std::vector<double>(n * m, 0.25), n, m);
+    ComplexTensor RR = R.transpose_no_conj() * R, AR = Ap * R;
+    assert(RR.is_real() && !AR.is_real());
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+            assert(close(Pp(i, j), P(i, j)));
+            assert(RR(i, j) == C(0.0625 * n));
+            C expected = 0.0;
+            for (size_t k = 0; k < n; ++k) expected += A(i, k) * 0.25;
+            assert(close(AR(i, j), expected));
+        }
+    }
+
+    // Real tensors carry no imaginary plane until one is needed
+    ComplexTensor X = ComplexTensor::from_real({3.0, -4.0, 1e300, -1e-300}, 2, 2);
+    const ComplexTensor& Xc = X;
+    assert(X.is_real() && X.memory_bytes() == 4 * sizeof(double) && Xc.imag_data() == nullptr);
+    ComplexTensor Y = X + X;
+    assert(Y.is_real() && Y(1, 0) == C(2e300));
+    ComplexTensor Z = X * C(0.0, 1.0);
+    assert(!Z.is_real() && Z(0, 1) == C(0.0, -4.0));
+    X(0, 0) = C(0.0, 1.0);                      // writable reference: interleaved
+    assert(X.layout() == Layout::Interleaved && X(0, 0) == C(0.0, 1.0));
+    X(0, 0) = 3.0;
+    X.to_planar();                              // zero imaginary parts dropped again
+    assert(X.is_real());
+
+    // |z| neither overflows nor underflows at the range ends
+    ComplexTensor W = ComplexTensor::planar(1, 3);
+    double* wr = W.real_data();
+    double* wi = W.imag_data();
+    wr[0] = 3e200;  wi[0] = 4e200;
+    wr[1] = 3e-200; wi[1] = -4e-200;
+    wr[2] = 3.0;    wi[2] = 4.0;
+    ComplexTensor absW = W.abs();
+    assert(std::abs(absW(0, 0).real() / 5e200 - 1.0) < 1e-15);
+    assert(std::abs(absW(0, 1).real() / 5e-200 - 1.0) < 1e-15);
+    assert(absW(0, 2) == C(5.0));
+
+    std::cout << "✓ Planar storage tests passed\n\n";
+}
+
+void test_inplace_arithmetic() {
+    std::cout << "Testing in-place and output-parameter arithmetic...\n";
+
+    using C = std::complex<double>;
+    using matlabcpp::Layout;
+    const size_t m = 21, n = 13;
+    auto close = [](C a, C b) { return std::abs(a - b) <= 1e-12 * (1.0 + std::abs(b)); };
+    ComplexTensor A(m, n), B(m, n);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            A(i, j) = {std::sin(0.5 * i + j), std::cos(0.3 * j - i)};
+            B(i, j) = {1.0 + std::cos(0.2 * i * j), std::sin(0.8 * i) - 0.5};
+        }
+    }
+
+    // A preallocated output keeps its buffer, whatever the operation
+    ComplexTensor out(m, n);
+    const C* buffer = out.data();
+    A.plus(B, out);
+    A.times(B, out);
+    A.rdivide(B, out);
+    A.times(C(2.0, -1.0), out);
+    A.conj(out);
+    assert(out.data() == buffer);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) assert(out(i, j) == std::conj(A(i, j)));
+    }
+
+    // In place, and out aliasing an operand
+    ComplexTensor X = A.on_cpu();
+    buffer = X.data();
+    X.add_inplace(B).times_inplace(B).scale_inplace(C(0.0, 2.0)).sub_inplace(A).conj_inplace();
+    ComplexTensor Y = A.on_cpu();
+    Y.times(B, Y);
+    B.plus(Y, Y);
+    assert(X.data() == buffer);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            C a = A(i, j), b = B(i, j);
+            assert(close(X(i, j), std::conj((a + b) * b * C(0.0, 2.0) - a)));
+            assert(close(Y(i, j), b + a * b));
+        }
+    }
+
+    // Temporaries lend their buffers to the next operation
+    ComplexTensor T = A.times(B);
+    buffer = T.data();
+    ComplexTensor U = (std::move(T) + A - B).conj() * C(0.5);
+    assert(U.data() == buffer);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            C a = A(i, j), b = B(i, j);
+            assert(close(U(i, j), std::conj(a * b + a - b) * 0.5));
+        }
+    }
+
+    // Planar outputs keep both planes
+    ComplexTensor Ap = A.on_cpu(), Bp = B.on_cpu(), P = ComplexTensor::planar(m, n);
+    Ap.to_planar();
+    Bp.to_planar();
+    Ap.times(Bp, P);
+    const double* re = P.real_data();
+    const double* im = P.imag_data();
+    for (int pass = 0; pass < 3; ++pass) {
+        Ap.times(Bp, P);
+        P.add_inplace(Ap);
+    }
+    assert(P.layout() == Layout::Planar && P.real_data() == re && P.imag_data() == im);
+    const ComplexTensor& Pc = P;                // reads that keep the layout
+    assert(close(Pc(4, 7), A(4, 7) * B(4, 7) + A(4, 7)));
+    P.abs(P);                                   // in place; real afterwards
+    assert(P.is_real() && P.real_data() == re && close(Pc(4, 7), std::abs(A(4, 7) * B(4, 7) + A(4, 7))));
+
+    // Matrix products into a preallocated result; out may not alias for gemm
+    ComplexTensor Bt = B.transpose(), M(m, m);
+    buffer = M.data();
+    A.mtimes(Bt, M);
+    assert(M.data() == buffer);
+    ComplexTensor S = A * Bt;
+    ComplexTensor Q = A.on_cpu();
+    Q.mtimes(Bt, Q);
+    assert(Q.rows() == m && Q.cols() == m);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < m; ++j) assert(M(i, j) == S(i, j) && Q(i, j) == S(i, j));
+    }
+
+    // Shape mismatches are errors in every build
+    auto rejects = [](auto&& f) {
+        try {
+            f();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    ComplexTensor wide(m, m + 1), scratch;
+    assert(rejects([&] { A.plus(wide, scratch); }));
+    assert(rejects([&] { Q.add_inplace(wide); }));
+    assert(rejects([&] { A.mtimes(A, scratch); }));
+
+    std::cout << "✓ In-place arithmetic tests passed\n\n";
+}
+
+int main() {
+    std::cout << "\n";
+    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║  MatLabC++ Complex Tensor Test Suite                       ║\n";
+    std::cout << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+    try {
+        test_planar_storage();
+        test_inplace_arithmetic();
+
+        std::cout << "════════════════════════════════════════════════════════════\n";
+        std::cout << "  ALL TESTS PASSED ✓\n";
+        std::cout << "════════════════════════════════════════════════════════════\n\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "\n✗ TEST FAILED: " << e.what() << "\n\n";
+        return 1;
+    }
+}
@@ -0,0 +1,217 @@
+// Test FFT - complex, real and batched transforms
+// tests/test_fft.cpp
+
+#undef NDEBUG  // the checks below are the test; keep them in Release builds
+
+#include "matlabcpp/advanced.hpp"
+#include "matlabcpp/complex_tensor.hpp"
+#include "matlabcpp/fft.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+using namespace matlabcpp;
+
+void test_fft() {
+    std::cout << "Testing FFT plans against a direct DFT...\n";
+
+    using C = std::complex<double>;
+    auto dft = [](const std::vector<C>& x, double sign) {
+        size_t n = x.size();
+        std::vector<C> out(n);
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t j = 0; j < n; ++j) out[k] += x[j] * std::polar(1.0, sign * 2.0 * M_PI * double(j * k % n) / double(n));
+        }
+        return out;
+    };
+
+    // Powers of two, smooth lengths (radix 2..13) and primes (Bluestein)
+    for (size_t n : {1, 2, 8, 32, 1024, 6, 12, 15, 49, 77, 1000, 97, 1009}) {
+        std::vector<C> x(n);
+        for (size_t i = 0; i < n; ++i) x[i] = {std::sin(0.3 * i) + 0.1 * i, std::cos(1.7 * i)};
+        std::vector<C> ref = dft(x, -1.0);
+        std::vector<C> y = x;
+        fft::transform(y.data(), n);
+        for (size_t k = 0; k < n; ++k) assert(std::abs(y[k] - ref[k]) < 1e-9 * n);
+        ref = dft(x, 1.0);
+        y = x;
+        fft::Plan::get(n, fft::Direction::Inverse)->execute(y.data());
+        for (size_t k = 0; k < n; ++k) assert(std::abs(y[k] - ref[k]) < 1e-9 * n);
+    }
+    assert(fft::Plan::get(4096)->algorithm() == fft::Plan::Algorithm::Radix4);
+    assert(fft::Plan::get(44100)->algorithm() == fft::Plan::Algorithm::MixedRadix);
+    assert(fft::Plan::get(1009)->algorithm() == fft::Plan::Algorithm::Bluestein);
+    assert(fft::Plan::get(1000) == fft::Plan::get(1000));
+
+    // One plan shared by concurrent callers
+    std::vector<std::vector<C>> lines(16, std::vector<C>(1009));
+    for (size_t i = 0; i < lines.size(); ++i) {
+        for (size_t j = 0; j < 1009; ++j) lines[i][j] = {double((i + j) % 7), 0.0};
+    }
+    size_t previous = ThreadPool::global().threads();
+    ThreadPool::global().set_threads(4);
+    auto plan = fft::Plan::get(1009);
+    ThreadPool::global().run(lines.size(), [&](size_t i) { plan->execute(lines[i].data()); });
+    ThreadPool::global().set_threads(previous);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        std::vector<C> y(1009);
+        for (size_t j = 0; j < 1009; ++j) y[j] = {double((i + j) % 7), 0.0};
+        plan->execute(y.data());
+        assert(y == lines[i]);
+    }
+
+    // Tensor API keeps the exact length and shape
+    ComplexTensor t = ComplexTensor::from_real({1, 2, 3}, 3, 1);
+    ComplexTensor f = t.fft();
+    assert(f.rows() == 3 && f.cols() == 1);
+    assert(std::abs(f(0, 0) - C(6, 0)) < 1e-12 && std::abs(f(1, 0) - C(-1.5, std::sqrt(0.75))) < 1e-12);
+    ComplexTensor back = f.ifft();
+    assert(std::abs(back(2, 0) - C(3, 0)) < 1e-12);
+    ComplexTensor img = ComplexTensor::from_real({1, 2, 3, 4, 5, 6}, 2, 3);
+    ComplexTensor spec = img.fft2();
+    assert(std::abs(spec(0, 0) - C(21, 0)) < 1e-12 && std::abs(spec(1, 0) - C(-9, 0)) < 1e-12);
+    ComplexTensor img2 = spec.ifft2();
+    assert(std::abs(img2(1, 2) - C(6, 0)) < 1e-12);
+
+    std::cout << "✓ FFT tests passed\n\n";
+}
+
+void test_real_fft() {
+    std::cout << "Testing real-input FFT...\n";
+
+    using C = std::complex<double>;
+    // Even (packed half-length) and odd (full complex) lengths
+    for (size_t n : {1, 2, 3, 4, 6, 10, 15, 64, 1000, 1009, 2018}) {
+        std::vector<double> x(n);
+        for (size_t i = 0; i < n; ++i) x[i] = std::sin(0.3 * i) + 0.1 * i - 0.5 * ((i * 7) % 3);
+        std::vector<C> full(x.begin(), x.end());
+        fft::transform(full.data(), n);
+
+        auto plan = fft::RealPlan::get(n);
+        assert(plan->spectrum_size() == n / 2 + 1);
+        std::vector<C> half(plan->spectrum_size());
+        plan->forward(x.data(), half.data());
+        for (size_t k = 0; k < half.size(); ++k) assert(std::abs(half[k] - full[k]) < 1e-9 * n);
+
+        std::vector<double> y(n);
+        plan->inverse(half.data(), y.data());
+        for (size_t i = 0; i < n; ++i) assert(std::abs(y[i] / n - x[i]) < 1e-10 * n);
+    }
+
+    ComplexTensor spec = ComplexTensor::rfft({1, 2, 3, 4});
+    assert(spec.rows() == 1 && spec.cols() == 3);
+    assert(std::abs(spec(0, 0) - C(10, 0)) < 1e-12 && std::abs(spec(0, 1) - C(-2, 2)) < 1e-12);
+    assert(std::abs(spec(0, 2) - C(-2, 0)) < 1e-12);
+    std::vector<double> back = spec.irfft(4);
+    for (size_t i = 0; i < 4; ++i) assert(std::abs(back[i] - (i + 1.0)) < 1e-12);
+    bool rejected = false;
+    try {
+        spec.irfft(8);                      // needs 5 bins
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    assert(rejected);
+
+    // Single-sided amplitude spectrum of 1.5 + 2 sin(2 pi 50 t) + 0.5 cos(2 pi 120 t)
+    const double fs = 1000.0;
+    std::vector<double> signal(1000);
+    for (size_t i = 0; i < signal.size(); ++i) {
+        double t = i / fs;
+        signal[i] = 1.5 + 2.0 * std::sin(2 * M_PI * 50 * t) + 0.5 * std::cos(2 * M_PI * 120 * t);
+    }
+    FFTResult r = SignalProcessing::fft(signal, fs);
+    assert(r.frequency.size() == 501 && r.magnitude.size() == 501 && r.phase.size() == 501);
+    assert(std::abs(r.frequency[50] - 50.0) < 1e-12 && std::abs(r.frequency[500] - 500.0) < 1e-12);
+    assert(std::abs(r.magnitude[0] - 1.5) < 1e-9);
+    assert(std::abs(r.magnitude[50] - 2.0) < 1e-9 && std::abs(r.magnitude[120] - 0.5) < 1e-9);
+    assert(std::abs(r.phase[50] + M_PI / 2) < 1e-9 && std::abs(r.phase[120]) < 1e-9);
+    assert(r.magnitude[7] < 1e-9);
+    assert(r.peak_frequency == 50.0);
+
+    std::cout << "✓ Real FFT tests passed\n\n";
+}
+
+void test_batched_fft() {
+    std::cout << "Testing batched FFT over rows, columns and pages...\n";
+
+    using C = std::complex<double>;
+    // Strided batches match line-by-line transforms, with any thread count
+    const size_t rows = 37, cols = 48;
+    std::vector<C> x(rows * cols);
+    for (size_t i = 0; i < x.size(); ++i) x[i] = {std::sin(0.11 * i), double(i % 5)};
+    std::vector<C> ref = x;
+    for (size_t j = 0; j < cols; ++j) {
+        std::vector<C> line(rows);
+        for (size_t i = 0; i < rows; ++i) line[i] = ref[i * cols + j];
+        fft::transform(line.data(), rows);
+        for (size_t i = 0; i < rows; ++i) ref[i * cols + j] = line[i];
+    }
+    size_t previous = ThreadPool::global().threads();
+    for (size_t threads : {1, 4}) {
+        ThreadPool::global().set_threads(threads);
+        std::vector<C> y = x;
+        fft::transform_batch(y.data(), rows, cols, cols, 1);
+        assert(y == ref);
+    }
+    ThreadPool::global().set_threads(previous);
+
+    // fft2 of a 3-D tensor works page by page; fftn also runs along depth
+    const size_t r = 6, c = 10, d = 3;
+    ComplexTensor t(r, c, d);
+    for (size_t k = 0; k < d; ++k) {
+        for (size_t i = 0; i < r; ++i) {
+            for (size_t j = 0; j < c; ++j) t(i, j, k) = {double((i + 2 * j + 5 * k) % 7), double(k)};
+        }
+    }
+    ComplexTensor f = t.fft2();
+    assert(f.rows() == r && f.cols() == c && f.depth() == d);
+    for (size_t k = 0; k < d; ++k) {
+        std::vector<C> page(r * c);
+        for (size_t i = 0; i < r; ++i) {
+            for (size_t j = 0; j < c; ++j) page[i * c + j] = t(i, j, k);
+        }
+        ComplexTensor p = ComplexTensor::from_complex(page, r, c).fft2();
+        for (size_t i = 0; i < r; ++i) {
+            for (size_t j = 0; j < c; ++j) assert(std::abs(f(i, j, k) - p(i, j)) < 1e-10);
+        }
+    }
+    ComplexTensor g = t.fftn();
+    C dc = 0.0;
+    for (size_t i = 0; i < t.size(); ++i) dc += t.data()[i];
+    assert(std::abs(g(0, 0, 0) - dc) < 1e-10);
+    C along_depth = f(1, 2, 0) + f(1, 2, 1) * std::polar(1.0, -2 * M_PI / 3) + f(1, 2, 2) * std::polar(1.0, -4 * M_PI / 3);
+    assert(std::abs(g(1, 2, 1) - along_depth) < 1e-10);
+    ComplexTensor back = g.ifftn();
+    ComplexTensor back2 = f.ifft2();
+    for (size_t i = 0; i < t.size(); ++i) {
+        assert(std::abs(back.data()[i] - t.data()[i]) < 1e-12);
+        assert(std::abs(back2.data()[i] - t.data()[i]) < 1e-12);
+    }
+
+    std::cout << "✓ Batched FFT tests passed\n\n";
+}
+
+int main() {
+    std::cout << "\n";
+    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║  MatLabC++ FFT Test Suite                                  ║\n";
+    std::cout << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+    try {
+        test_fft();
+        test_real_fft();
+        test_batched_fft();
+
+        std::cout << "════════════════════════════════════════════════════════════\n";
+        std::cout << "  ALL TESTS PASSED ✓\n";
+        std::cout << "════════════════════════════════════════════════════════════\n\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "\n✗ TEST FAILED: " << e.what() << "\n\n";
+        return 1;
+    }
+}
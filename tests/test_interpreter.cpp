@@ -0,0 +1,596 @@
+// Test Script Interpreter - compiler + bytecode VM
+// tests/test_interpreter.cpp
+
+#undef NDEBUG  // the checks below are the test; keep them in Release builds
+
+#include "matlabcpp/active_window.hpp"
+#include "matlabcpp/bytecode.hpp"
+#include "matlabcpp/complex_tensor.hpp"
+#include "matlabcpp/script_cache.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include "matlabcpp/kernels.hpp"
+#include "matlabcpp/linalg.hpp"
+#include <iostream>
+#include <fstream>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+using namespace matlabcpp;
+using namespace matlabcpp::interpreter;
+
+static VM::Result run_source(ActiveWindow& window, const std::string& source) {
+    CompiledScript script = compile(source);
+    VM vm(window, false);
+    return vm.run(script);
+}
+
+void test_arithmetic() {
+    std::cout << "Testing arithmetic and precedence...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window,
+        "a = 1 + 2 * 3;\n"
+        "b = -2^2;\n"
+        "c = 2^-1;\n"
+        "d = (1 + 2) * 3;\n"
+        "e = 7 > 3 && 2 ~= 2;\n");
+
+    assert(result.errors.empty());
+    assert(window.get_scalar("a") == 7.0);
+    assert(window.get_scalar("b") == -4.0);
+    assert(window.get_scalar("c") == 0.5);
+    assert(window.get_scalar("d") == 9.0);
+    assert(window.get_scalar("e") == 0.0);
+
+    std::cout << "✓ Arithmetic tests passed\n\n";
+}
+
+void test_control_flow() {
+    std::cout << "Testing loops and branches...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window,
+        "total = 0;\n"
+        "for i = 1:100\n"
+        "    if i > 50, break, end\n"
+        "    if mod_skip == 1 && i == 2, continue; end\n"
+        "    total = total + i;\n"
+        "end\n"
+        "n = 0;\n"
+        "while n < 10\n"
+        "    n = n + 3;\n"
+        "end\n"
+        "down = 0;\n"
+        "for k = 10:-2:1, down = down + k; end\n");
+
+    // mod_skip is undefined: the inner condition errors (treated as false) on every pass
+    assert(window.get_scalar("total") == 1275.0);
+    assert(window.get_scalar("n") == 12.0);
+    assert(window.get_scalar("down") == 30.0);
+    assert(result.errors.size() == 50);
+    assert(result.errors[0].find("Line 4") == 0);
+
+    std::cout << "✓ Control flow tests passed\n\n";
+}
+
+void test_arrays_and_indexing() {
+    std::cout << "Testing matrix literals and indexing...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window,
+        "v = [1 -2 3];\n"
+        "M = [1 2; 3 4];\n"
+        "a = v(end);\n"
+        "b = M(2, 1);\n"
+        "c = sum(v);\n"
+        "for i = 1:4\n"
+        "    sq(i) = i^2;\n"
+        "end\n"
+        "d = sq(4);\n");
+
+    assert(result.errors.empty());
+    assert(window.get_scalar("a") == 3.0);
+    assert(window.get_scalar("b") == 3.0);
+    assert(window.get_scalar("c") == 2.0);
+    assert(window.get_scalar("d") == 16.0);
+    const Variable* sq = window.find_variable("sq");
+    assert(sq && sq->is_vector() && sq->size_string() == "1x4");
+
+    // Linear indexing: (:) is a column, a vector keeps its orientation,
+    // and a matrix source takes the shape of the index
+    result = run_source(window,
+        "A = [1 2; 3 4];\n"
+        "c = A(:);\n"
+        "r = [5 6 7];\n"
+        "rc = r(:);\n"
+        "rr = r([3 1]);\n"
+        "cc = rc([3; 1]');\n"
+        "m = A([1 2; 3 4]);\n"
+        "k = A([4; 1]);\n");
+    assert(result.errors.empty());
+    const Variable& c = *window.find_variable("c");
+    assert(c.size_string() == "4x1");
+    assert(c(0) == 1.0 && c(1) == 3.0 && c(2) == 2.0 && c(3) == 4.0);
+    const Variable& rc = *window.find_variable("rc");
+    assert(rc.size_string() == "3x1" && rc(2) == 7.0);
+    assert(window.find_variable("rr")->size_string() == "1x2");
+    assert(window.find_variable("cc")->size_string() == "2x1");
+    const Variable& m = *window.find_variable("m");
+    assert(m.size_string() == "2x2");
+    assert(m(0, 0) == 1.0 && m(0, 1) == 3.0 && m(1, 0) == 2.0 && m(1, 1) == 4.0);   // A(idx(i, j))
+    assert(window.find_variable("k")->size_string() == "2x1");
+
+    std::cout << "✓ Array tests passed\n\n";
+}
+
+void test_array_operators() {
+    std::cout << "Testing elementwise operators on arrays...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window,
+        "A = [1 2; 3 4];\n"
+        "B = 2 * A' - 1;\n"
+        "C = A * A;\n"
+        "D = (1:3)' + [10 20];\n"
+        "E = A >= 2 & A < 4;\n"
+        "F = exp(-(0:9)) .* 2;\n"
+        "G = A ^ 2;\n"
+        "H = round([-2.5 2.5 0.4]);\n"
+        "v = [1 2 3];\n"
+        "w = v';\n");
+    assert(result.errors.empty());
+
+    const Variable& b = *window.find_variable("B");
+    assert(b(0, 1) == 5.0 && b(1, 0) == 3.0);
+
+    const Variable& c = *window.find_variable("C");
+    const Variable& g = *window.find_variable("G");
+    assert(c(0, 0) == 7.0 && c(1, 1) == 22.0);
+    assert(c.as_vector() == g.as_vector());
+
+    const Variable& d = *window.find_variable("D");
+    assert(d.rows() == 3 && d.cols() == 2);
+    assert(d(2, 0) == 13.0 && d(0, 1) == 21.0);
+
+    const Variable& e = *window.find_variable("E");
+    assert((e.as_vector() == std::vector<double>{0, 1, 1, 0}));
+
+    const Variable& f = *window.find_variable("F");
+    for (size_t k = 0; k < 10; k++) {
+        double expected = 2.0 * std::exp(-static_cast<double>(k));
+        assert(std::abs(f(k) - expected) <= 1e-15 * expected);
+    }
+
+    const Variable& h = *window.find_variable("H");
+    assert((h.as_vector() == std::vector<double>{-3, 3, 0}));
+
+    // Transposing a vector shares its buffer
+    const Variable& w = *window.find_variable("w");
+    assert(w.rows() == 3 && w.shares_data_with(*window.find_variable("v")));
+
+    result = run_source(window, "bad = [1 2 3] + [1 2];\n");
+    assert(result.errors.size() == 1);
+    assert(!window.find_variable("bad"));
+
+    std::cout << "✓ Array operator tests passed\n\n";
+}
+
+void test_fusion() {
+    std::cout << "Testing fused elementwise expressions...\n";
+
+    CompiledScript script = compile("y = a.*x.^2 + b.*x + c;\n");
+    assert(script.fused.size() == 1);
+    assert(script.fused[0].n_ops == 5);
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window,
+        "x = (0:2999) / 1000;\n"
+        "a = 2; b = -3; c = 0.5;\n"
+        "y = a.*x.^2 + b.*x + c;\n"
+        "t1 = x .^ 2; t2 = a .* t1; t3 = b .* x; t4 = t2 + t3;\n"
+        "ref = t4 + c;\n"
+        "z = exp(-x) .* sin(3*x) + 1;\n"
+        "s = 2 * 3 + 1;\n"
+        "M = [1 2; 3 4];\n"
+        "P = M * M + 1;\n"           // matrix product: falls back to unfused code
+        "B = (1:3)' + [10 20] .* 2;\n" // implicit expansion: falls back too
+        "sin = [5 6 7];\n"
+        "q = sin(2) * 2 + 1;\n");     // variable shadows the builtin
+    assert(result.errors.empty());
+
+    const Variable& y = *window.find_variable("y");
+    const Variable& ref = *window.find_variable("ref");
+    assert(y.numel() == 3000 && y.as_vector() == ref.as_vector());
+
+    const Variable& z = *window.find_variable("z");
+    for (size_t k = 0; k < z.numel(); k++) {
+        double x = k / 1000.0;
+        assert(std::abs(z(k) - (std::exp(-x) * std::sin(3 * x) + 1)) < 1e-14);
+    }
+
+    assert(window.get_scalar("s") == 7.0);
+    const Variable& p = *window.find_variable("P");
+    assert(p(0, 0) == 8.0 && p(1, 1) == 23.0);
+    const Variable& bx = *window.find_variable("B");
+    assert(bx.rows() == 3 && bx.cols() == 2 && bx(2, 1) == 43.0);
+    assert(window.get_scalar("q") == 13.0);
+
+    std::cout << "✓ Fusion tests passed\n\n";
+}
+
+void test_parallel_kernels() {
+    std::cout << "Testing thread pool kernels are deterministic...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    const std::string source =
+        "x = (1:300000) / 7;\n"
+        "s = sum(sin(x));\n"
+        "m = mean(x);\n"
+        "lo = min(-x);\n"
+        "y = x .* x + 3 * x;\n";
+
+    run_source(window, "p = maxNumCompThreads(1);\n");
+    double previous = window.get_scalar("p");
+    assert(previous >= 1.0);
+    run_source(window, source);
+    double s1 = window.get_scalar("s");
+    double m1 = window.get_scalar("m");
+    Variable y1 = *window.find_variable("y");
+
+    run_source(window, "maxNumCompThreads(4);\n");
+    assert(ThreadPool::global().threads() == 4);
+    auto result = run_source(window, source);
+    assert(result.errors.empty());
+    assert(window.get_scalar("s") == s1);   // bit-identical, not just close
+    assert(window.get_scalar("m") == m1);
+    assert(window.get_scalar("lo") == -300000.0 / 7);
+    assert(window.find_variable("y")->as_vector() == y1.as_vector());
+
+    // Nested batches and exceptions
+    std::vector<int> hits(64, 0);
+    ThreadPool::global().run(8, [&](size_t i) {
+        ThreadPool::global().run(8, [&](size_t j) { hits[i * 8 + j]++; });
+    });
+    for (int h : hits) assert(h == 1);
+    bool threw = false;
+    try {
+        ThreadPool::global().run(16, [](size_t i) {
+            if (i == 5) throw std::runtime_error("task failed");
+        });
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+
+    ThreadPool::global().set_threads(static_cast<size_t>(previous));
+
+    std::cout << "✓ Parallel kernel tests passed\n\n";
+}
+
+void test_matrix_multiply() {
+    std::cout << "Testing blocked matrix multiply (" << kernels::gemm_level() << ")...\n";
+
+    // Odd sizes exercise edge tiles and more than one KC slice
+    const size_t m = 37, k = 300, n = 53;
+    Array a(m, k), b(k, n);
+    for (size_t i = 0; i < a.numel(); ++i) a(i) = std::sin(0.1 * i);
+    for (size_t i = 0; i < b.numel(); ++i) b(i) = std::cos(0.3 * i);
+
+    size_t previous = ThreadPool::global().threads();
+    ThreadPool::global().set_threads(1);
+    Array c1 = a * b;
+    ThreadPool::global().set_threads(4);
+    Array c4 = a * b;
+    assert(c1.rows() == m && c1.cols() == n);
+    assert(c1.as_vector() == c4.as_vector());
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            double ref = 0.0;
+            for (size_t p = 0; p < k; ++p) ref += a(i, p) * b(p, j);
+            assert(std::abs(c1(i, j) - ref) < 1e-10);
+        }
+    }
+
+    // Script operator
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window, "A = [1 2; 3 4];\nB = A * [5 6; 7 8];\nv = [1 2 3] * [4; 5; 6];\n");
+    assert(result.errors.empty());
+    assert((window.find_variable("B")->as_vector() == std::vector<double>{19, 43, 22, 50}));
+    assert(window.get_scalar("v") == 32.0);
+
+    // Complex product, row-major storage
+    ComplexTensor x(40, 70), y(70, 45);
+    for (size_t i = 0; i < x.size(); ++i) x.data()[i] = {std::sin(0.2 * i), std::cos(0.7 * i)};
+    for (size_t i = 0; i < y.size(); ++i) y.data()[i] = {std::cos(0.1 * i), -std::sin(0.5 * i)};
+    ComplexTensor z = x * y;
+    for (size_t i = 0; i < 40; ++i) {
+        for (size_t j = 0; j < 45; ++j) {
+            std::complex<double> ref = 0.0;
+            for (size_t p = 0; p < 70; ++p) ref += x(i, p) * y(p, j);
+            assert(std::abs(z(i, j) - ref) < 1e-10);
+        }
+    }
+
+    ThreadPool::global().set_threads(previous);
+    std::cout << "✓ Matrix multiply tests passed\n\n";
+}
+
+void test_linear_solve() {
+    std::cout << "Testing LU factorization and matrix division...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window,
+        "A = [4 -2 1; -2 4 -2; 1 -2 4];\n"
+        "b = [11; -16; 17];\n"
+        "x = A \\ b;\n"
+        "X = A \\ [b 2*b];\n"
+        "y = b' / A;\n"
+        "h = 2 \\ [4 6];\n"
+        "d = det(A);\n"
+        "P = A^(-2) * A * A;\n");
+    assert(result.errors.empty());
+    std::vector<double> x = window.find_variable("x")->as_vector();
+    const double expected[] = {1, -2, 3};
+    for (size_t i = 0; i < 3; ++i) {
+        assert(std::abs(x[i] - expected[i]) < 1e-12);
+        assert(std::abs((*window.find_variable("X"))(i, 1) - 2 * expected[i]) < 1e-12);
+        assert(std::abs(window.find_variable("y")->as_vector()[i] - expected[i]) < 1e-12);  // A is symmetric
+    }
+    assert((window.find_variable("h")->as_vector() == std::vector<double>{2, 3}));
+    assert(std::abs(window.get_scalar("d") - 36.0) < 1e-12);
+    const Variable& P = *window.find_variable("P");
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 3; ++j) assert(std::abs(P(i, j) - (i == j ? 1.0 : 0.0)) < 1e-12);
+    }
+
+    result = run_source(window, "z = [1 2; 2 4] \\ [1; 1];\n");
+    assert(result.errors.size() == 1);
+
+    // Several panels, factored once and reused for different right-hand sides
+    const size_t n = 150;
+    Array A(n, n);
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = 0; i < n; ++i) A(i, j) = std::sin(0.37 * i + 1.3 * j) + (i == j ? 4.0 : 0.0);
+    }
+    LUFactorization lu(A);
+    assert(!lu.singular() && lu.size() == n);
+    for (size_t rhs : {size_t(1), size_t(7)}) {
+        Array B(n, rhs);
+        for (size_t i = 0; i < B.numel(); ++i) B(i) = std::cos(0.1 * i);
+        Array R = A * lu.solve(B);
+        for (size_t i = 0; i < B.numel(); ++i) assert(std::abs(R(i) - B(i)) < 1e-10);
+    }
+    Array I = A * lu.inverse();
+    for (size_t i = 0; i < n; ++i) assert(std::abs(I(i, i) - 1.0) < 1e-10);
+
+    std::cout << "✓ LU tests passed\n\n";
+}
+
+void test_repl_expressions() {
+    std::cout << "Testing REPL expression evaluation...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    window.process_command_external("x = [1 2 3 4];");
+    window.process_command_external("y = sqrt(x .* x) + 2 ^ 3 / 4;");
+    window.process_command_external("z = sum(x) * (x(2) - 1);");
+    window.process_command_external("t = x == 3;");
+
+    assert((window.find_variable("y")->as_vector() == std::vector<double>{3, 4, 5, 6}));
+    assert(window.get_scalar("z") == 10.0);
+    assert((window.find_variable("t")->as_vector() == std::vector<double>{0, 0, 1, 0}));
+
+    std::cout << "✓ REPL expression tests passed\n\n";
+}
+
+void test_copy_on_write() {
+    std::cout << "Testing copy-on-write workspace values...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window,
+        "a = [1 2 3 4];\n"
+        "b = a;\n");
+    assert(result.errors.empty());
+
+    // b = a shares the buffer
+    const Variable* a = window.find_variable("a");
+    const Variable* b = window.find_variable("b");
+    assert(a->shares_data_with(*b));
+
+    // First write to b materializes its own copy; a is untouched
+    result = run_source(window, "b(2) = 20;\nc = a(2);\nd = b(2);\n");
+    assert(result.errors.empty());
+    a = window.find_variable("a");
+    b = window.find_variable("b");
+    assert(!a->shares_data_with(*b));
+    assert(window.get_scalar("c") == 2.0);
+    assert(window.get_scalar("d") == 20.0);
+
+    // Unshared in-bounds writes stay in the same buffer
+    const double* before = b->data();
+    run_source(window, "b(3) = 30;\n");
+    assert(window.find_variable("b")->data() == before);
+
+    std::cout << "✓ Copy-on-write tests passed\n\n";
+}
+
+void test_compiles_once() {
+    std::cout << "Testing loop body is compiled, not re-parsed...\n";
+
+    CompiledScript script = compile(
+        "acc = 0;\n"
+        "for i = 1:1000000\n"
+        "    acc = acc + i;\n"
+        "end\n");
+
+    // The loop is a handful of instructions regardless of trip count
+    assert(script.code.size() < 20);
+    assert(script.source_lines == 4);
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    VM vm(window, false);
+    auto result = vm.run(script);
+    assert(result.errors.empty());
+    assert(window.get_scalar("acc") == 500000500000.0);
+
+    std::cout << "✓ Compile-once tests passed\n\n";
+}
+
+void test_fallback() {
+    std::cout << "Testing unsupported syntax falls back to ActiveWindow...\n";
+
+    CompiledScript script = compile("f = @(x) x.^2;\ny = 2;\n");
+    bool has_fallback = false;
+    for (const auto& in : script.code) {
+        if (in.op == OpCode::EvalText) has_fallback = true;
+    }
+    assert(has_fallback);
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    VM vm(window, false);
+    vm.run(script);
+    assert(window.get_scalar("y") == 2.0);
+
+    std::cout << "✓ Fallback tests passed\n\n";
+}
+
+void test_bytecode_cache() {
+    std::cout << "Testing on-disk bytecode cache...\n";
+
+    auto dir = std::filesystem::temp_directory_path() / "matlabcpp_test_cache";
+    std::filesystem::remove_all(dir);
+
+    const std::string source =
+        "x = 0;\n"
+        "for k = 1:5, x = x + k; end\n"
+        "fprintf('%d\\n', x);\n";
+
+    ScriptCache cache(dir, true);
+    bool hit = true;
+    CompiledScript first = cache.get_or_compile(source, &hit);
+    assert(!hit);
+    CompiledScript second = cache.get_or_compile(source, &hit);
+    assert(hit);
+    assert(disassemble(first) == disassemble(second));
+    assert(cache.stats().hits == 1 && cache.stats().misses == 1 && cache.stats().stores == 1);
+
+    // Different source -> different entry
+    assert(ScriptCache::key(source) != ScriptCache::key(source + " "));
+
+    // Corrupt the entry: it must be rejected and recompiled, not trusted
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().extension() != ".mlbc") continue;
+        std::fstream f(entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-3, std::ios::end);
+        f.put('#');
+    }
+    CompiledScript third = cache.get_or_compile(source, &hit);
+    assert(!hit);
+    assert(cache.stats().rejected == 1);
+    assert(disassemble(third) == disassemble(first));
+
+    ScriptCache::Stats total = cache.persistent_stats();
+    assert(total.hits == 1 && total.misses == 2);
+
+    // An entry whose FNV key and length match but whose source differs
+    // (forged here by renaming and patching the key) is not trusted
+    const std::string other =
+        "y = 0;\n"
+        "for k = 1:5, y = y + k; end\n"
+        "fprintf('%d\\n', y);\n";
+    assert(other.size() == source.size());
+    uint64_t forged = ScriptCache::key(other);
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (entry.path().extension() != ".mlbc") continue;
+        char name[32];
+        std::snprintf(name, sizeof name, "%016llx.mlbc", static_cast<unsigned long long>(forged));
+        std::filesystem::copy_file(entry.path(), dir / name);
+        std::fstream f(dir / name, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(16);  // EntryHeader::key
+        f.write(reinterpret_cast<const char*>(&forged), sizeof forged);
+    }
+    ScriptCache quiet(dir);
+    assert(!quiet.load(other) && quiet.stats().rejected == 1);
+    assert(quiet.load(source));
+
+    // A register operand past num_registers is rejected even when the
+    // payload hash (FNV-1a, patched here) says the entry is intact
+    {
+        char name[32];
+        std::snprintf(name, sizeof name, "%016llx.mlbc",
+                      static_cast<unsigned long long>(ScriptCache::key(source)));
+        std::fstream f(dir / name, std::ios::in | std::ios::out | std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        uint32_t header_size;
+        std::memcpy(&header_size, bytes.data() + 12, sizeof header_size);  // EntryHeader::header_size
+        uint32_t bad_register = 0x3fffffffu;
+        std::memcpy(&bytes[header_size + 4], &bad_register, sizeof bad_register);  // code[0].a
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = header_size; i < bytes.size(); i++) {
+            hash ^= static_cast<unsigned char>(bytes[i]);
+            hash *= 1099511628211ull;
+        }
+        std::memcpy(&bytes[56], &hash, sizeof hash);  // EntryHeader::payload_hash
+        f.seekp(0);
+        f.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    assert(!quiet.load(source) && quiet.stats().rejected == 2);
+
+    // Only recording caches touch the persistent counters
+    assert(cache.persistent_stats().hits == total.hits);
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    VM vm(window, false);
+    vm.run(second);
+    assert(window.get_scalar("x") == 15.0);
+
+    std::filesystem::remove_all(dir);
+
+    std::cout << "✓ Bytecode cache tests passed\n\n";
+}
+
+int main() {
+    std::cout << "\n";
+    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║  MatLabC++ Script Interpreter Test Suite                  ║\n";
+    std::cout << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+    try {
+        test_arithmetic();
+        test_control_flow();
+        test_arrays_and_indexing();
+        test_array_operators();
+        test_fusion();
+        test_parallel_kernels();
+        test_matrix_multiply();
+        test_linear_solve();
+        test_repl_expressions();
+        test_copy_on_write();
+        test_compiles_once();
+        test_fallback();
+        test_bytecode_cache();
+
+        std::cout << "════════════════════════════════════════════════════════════\n";
+        std::cout << "  ALL TESTS PASSED ✓\n";
+        std::cout << "════════════════════════════════════════════════════════════\n\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "\n✗ TEST FAILED: " << e.what() << "\n\n";
+        return 1;
+    }
+}
@@ -0,0 +1,130 @@
+// Test Lazy Tensor - deferred evaluation and fusion
+// tests/test_lazy_tensor.cpp
+
+#undef NDEBUG  // the checks below are the test; keep them in Release builds
+
+#include "matlabcpp/complex_tensor.hpp"
+#include "matlabcpp/lazy_tensor.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+using namespace matlabcpp;
+
+void test_lazy_tensor() {
+    std::cout << "Testing lazy tensors...\n";
+
+    using C = ComplexTensor::Complex;
+    ComplexTensor A(6, 4), B(6, 4), D(6, 5), x(1, 12);
+    for (size_t i = 0; i < 6; i++) {
+        for (size_t j = 0; j < 4; j++) {
+            A(i, j) = {double(i) - 0.5 * double(j), double(i * j % 5)};
+            B(i, j) = {1.0 + double(j), double(i) - 2.0};
+        }
+        for (size_t j = 0; j < 5; j++) D(i, j) = {double(i + 2 * j), -double(j)};
+    }
+    for (size_t j = 0; j < 12; j++) x(0, j) = {std::sin(double(j)), double(j % 3)};
+    auto close = [](const ComplexTensor& p, const ComplexTensor& q) {
+        if (p.rows() != q.rows() || p.cols() != q.cols()) return false;
+        for (size_t i = 0; i < p.rows(); i++) {
+            for (size_t j = 0; j < p.cols(); j++) {
+                if (std::abs(p(i, j) - q(i, j)) > 1e-10) return false;
+            }
+        }
+        return true;
+    };
+
+    // Recording runs nothing; an elementwise tree is one kernel, no temporaries
+    LazyTensor a = lazy(A), b = lazy(B);
+    LazyTensor y = ((a.times(b) + a) * C(0.5, 1.0) - b.conj()) / b;
+    assert(!y.evaluated() && y.rows() == 6 && y.cols() == 4);
+    ComplexTensor expected = ((A.times(B) + A) * C(0.5, 1.0) - B.conj()) / B;
+    assert(close(y.eval(), expected));
+    assert(y.stats().kernels == 1 && y.stats().fused == 5 && y.stats().temporaries == 0);
+    const ComplexTensor* first = &y.eval();
+    assert(&y.eval() == first && y.evaluated());      // cached
+
+    // A' * D and A.' * D: the transpose is read through gemm strides
+    LazyTensor g = a.transpose() * lazy(D);
+    assert(close(g.eval(), A.transpose() * D));
+    assert(g.stats().kernels == 1 && g.stats().folded_transposes == 1);
+    LazyTensor h = lazy(D).transpose_no_conj() * a;
+    assert(close(h.eval(), D.transpose_no_conj() * A));
+    LazyTensor gram = a.transpose() * a;
+    assert(close(gram.eval(), A.transpose() * A) && gram.stats().folded_transposes == 1);
+    LazyTensor both = lazy(D).transpose() * a.transpose_no_conj().transpose_no_conj();
+    assert(close(both.eval(), D.transpose() * A));
+    assert(both.stats().eliminated == 2 && both.stats().kernels == 1);
+
+    // conj / fft / conj / scale is a single inverse transform
+    LazyTensor lx = lazy(x);
+    LazyTensor inv = lx.conj().fft().conj() / C(12.0);
+    assert(close(inv.eval(), x.ifft()));
+    assert(inv.stats().kernels == 1 && inv.stats().eliminated == 3);
+    assert(close(lx.ifft().fft().eval(), x));
+    // An elementwise input to a transform is written into the transform's buffer
+    LazyTensor spectrum = (lx * C(2.0) + lx).fft();
+    assert(close(spectrum.eval(), (x * C(3.0)).fft()));
+    assert(spectrum.stats().kernels == 2 && spectrum.stats().temporaries == 1);
+
+    // Dead results: only what the value depends on runs
+    LazyTensor unused = a.times(b) * C(3.0);
+    LazyTensor identity = (a.conj().conj() * C(1.0)) + b;
+    assert(close(identity.eval(), A + B));
+    assert(identity.stats().kernels == 1 && identity.stats().eliminated == 3);
+    assert(!unused.evaluated());
+
+    // Shared subexpressions run once; evaluated values are reused
+    LazyTensor t = a + b;
+    LazyTensor sq = t.times(t) - t;
+    assert(close(sq.eval(), (A + B).times(A + B) - (A + B)));
+    assert(sq.stats().kernels == 2 && sq.stats().temporaries == 1);
+    assert(!t.evaluated());
+    t.eval();
+    LazyTensor reuse = t * C(2.0);
+    reuse.eval();
+    assert(reuse.stats().nodes == 1 && reuse.stats().kernels == 1);
+
+    // Owned inputs, and the text of a value
+    LazyTensor owned = lazy(A.on_cpu()) + b;
+    assert(owned.to_string() == (A + B).to_string());
+    assert(std::abs(owned(2, 3) - (A(2, 3) + B(2, 3))) < 1e-12);
+
+    // Mismatched shapes are rejected when recorded, in every build
+    auto rejects = [](auto f) {
+        try {
+            f();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    LazyTensor d = lazy(D);
+    assert(rejects([&] { return a + d; }));
+    assert(rejects([&] { return a.times(d); }));
+    assert(rejects([&] { return a * b; }));
+    assert(rejects([&] { return a.transpose() * b.transpose(); }));
+    assert(close((a.transpose() * d).eval(), A.transpose() * D));
+
+    std::cout << "✓ Lazy tensor tests passed\n\n";
+}
+
+int main() {
+    std::cout << "\n";
+    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║  MatLabC++ Lazy Tensor Test Suite                          ║\n";
+    std::cout << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+    try {
+        test_lazy_tensor();
+
+        std::cout << "════════════════════════════════════════════════════════════\n";
+        std::cout << "  ALL TESTS PASSED ✓\n";
+        std::cout << "════════════════════════════════════════════════════════════\n\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "\n✗ TEST FAILED: " << e.what() << "\n\n";
+        return 1;
+    }
+}
@@ -0,0 +1,396 @@
+// Test Linear Algebra - factorizations, solvers and eigensolvers
+// tests/test_linalg.cpp
+
+#undef NDEBUG  // the checks below are the test; keep them in Release builds
+
+#include "matlabcpp/active_window.hpp"
+#include "matlabcpp/array.hpp"
+#include "matlabcpp/bytecode.hpp"
+#include "matlabcpp/complex_tensor.hpp"
+#include "matlabcpp/linalg.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+using namespace matlabcpp;
+using namespace matlabcpp::interpreter;
+
+static VM::Result run_source(ActiveWindow& window, const std::string& source) {
+    CompiledScript script = compile(source);
+    VM vm(window, false);
+    return vm.run(script);
+}
+
+void test_complex_decompositions() {
+    std::cout << "Testing complex QR and eigenvalues...\n";
+
+    using C = std::complex<double>;
+    auto sample = [](size_t m, size_t n, double seed) {
+        ComplexTensor A(m, n);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < n; ++j) A(i, j) = {std::sin(seed * (i + 1) + 0.7 * j), std::cos(1.3 * i - seed * j)};
+        }
+        return A;
+    };
+    auto max_diff = [](const ComplexTensor& a, const ComplexTensor& b) {
+        double d = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) d = std::max(d, std::abs(a.data()[i] - b.data()[i]));
+        return d;
+    };
+
+    // Tall, wide and square, across several panels
+    for (auto [m, n] : {std::pair<size_t, size_t>{70, 45}, {30, 80}, {64, 64}, {5, 1}}) {
+        ComplexTensor A = sample(m, n, 0.37);
+        for (bool economy : {false, true}) {
+            ComplexTensor Q, R;
+            A.qr(Q, R, economy);
+            size_t q = economy ? std::min(m, n) : m;
+            assert(Q.rows() == m && Q.cols() == q && R.rows() == q && R.cols() == n);
+            assert(max_diff(Q * R, A) < 1e-12 * m);
+            ComplexTensor QhQ = Q.transpose() * Q;
+            for (size_t i = 0; i < q; ++i) {
+                for (size_t j = 0; j < q; ++j) assert(std::abs(QhQ(i, j) - C(i == j ? 1.0 : 0.0)) < 1e-12 * m);
+            }
+            for (size_t i = 0; i < q; ++i) {
+                for (size_t j = 0; j < std::min(i, n); ++j) assert(R(i, j) == C(0.0));
+            }
+        }
+    }
+
+    // A v = lambda v for every pair, eigenvalues summing to the trace
+    for (size_t n : {1, 2, 7, 60}) {
+        ComplexTensor A = sample(n, n, 0.91);
+        std::vector<C> lambda;
+        ComplexTensor V;
+        A.eig(lambda, V);
+        assert(lambda.size() == n && V.rows() == n && V.cols() == n);
+        C sum = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            sum += lambda[k];
+            double norm = 0.0, residual = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                C av = 0.0;
+                for (size_t j = 0; j < n; ++j) av += A(i, j) * V(j, k);
+                residual = std::max(residual, std::abs(av - lambda[k] * V(i, k)));
+                norm += std::norm(V(i, k));
+            }
+            assert(std::abs(norm - 1.0) < 1e-12 && residual < 1e-10 * n);
+        }
+        assert(std::abs(sum - A.trace()) < 1e-10 * n);
+    }
+
+    // Real matrices with complex and known eigenvalues
+    ComplexTensor rot = ComplexTensor::from_real({0, -1, 1, 0}, 2, 2);
+    std::vector<C> lambda;
+    ComplexTensor V;
+    rot.eig(lambda, V);
+    assert(std::abs(std::abs(lambda[0].imag()) - 1.0) < 1e-14 && std::abs(lambda[0] + lambda[1]) < 1e-14);
+    // Companion matrix of (x - 1)(x - 2)...(x - 6)
+    std::vector<double> coeffs = {1, -21, 175, -735, 1624, -1764, 720};
+    std::vector<double> companion(36, 0.0);
+    for (size_t j = 0; j < 6; ++j) companion[j] = -coeffs[j + 1];
+    for (size_t i = 1; i < 6; ++i) companion[i * 6 + i - 1] = 1.0;
+    ComplexTensor::from_real(companion, 6, 6).eig(lambda, V);
+    std::sort(lambda.begin(), lambda.end(), [](C a, C b) { return a.real() < b.real(); });
+    for (size_t k = 0; k < 6; ++k) assert(std::abs(lambda[k] - C(k + 1.0)) < 1e-8);
+
+    std::cout << "✓ Complex decomposition tests passed\n\n";
+}
+
+void test_svd() {
+    std::cout << "Testing SVD...\n";
+
+    using C = std::complex<double>;
+    auto check_unitary_columns = [](const ComplexTensor& Q) {
+        ComplexTensor G = Q.transpose() * Q;
+        for (size_t i = 0; i < G.rows(); ++i) {
+            for (size_t j = 0; j < G.cols(); ++j) assert(std::abs(G(i, j) - C(i == j ? 1.0 : 0.0)) < 1e-11);
+        }
+    };
+
+    // Tall, wide, square and rank-deficient (rank 2), full and economy
+    for (auto [m, n] : {std::pair<size_t, size_t>{90, 40}, {25, 60}, {33, 33}, {20, 12}}) {
+        ComplexTensor A(m, n);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                A(i, j) = m == 20 ? C(std::sin(i + 1.0) * std::cos(0.5 * j), 0.0) + C(0.0, double(i % 3) * (j % 2))
+                                  : C(std::sin(0.3 * i * j + i), std::cos(0.7 * j - 0.2 * i));
+            }
+        }
+        const size_t k = std::min(m, n);
+        for (bool economy : {false, true}) {
+            ComplexTensor U, V;
+            std::vector<double> S;
+            A.svd(U, S, V, economy);
+            assert(S.size() == k);
+            assert(U.rows() == m && U.cols() == (economy ? k : m));
+            assert(V.rows() == n && V.cols() == (economy ? k : n));
+            for (size_t i = 1; i < k; ++i) assert(S[i] <= S[i - 1] && S[i] >= 0.0);
+            check_unitary_columns(U);
+            check_unitary_columns(V);
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = 0; j < n; ++j) {
+                    C a = 0.0;
+                    for (size_t l = 0; l < k; ++l) a += U(i, l) * S[l] * std::conj(V(j, l));
+                    assert(std::abs(a - A(i, j)) < 1e-11 * k);
+                }
+            }
+            std::vector<double> values = A.singular_values();
+            for (size_t i = 0; i < k; ++i) assert(std::abs(values[i] - S[i]) < 1e-11 * S[0]);
+        }
+        if (m == 20) {
+            std::vector<double> values = A.singular_values();
+            assert(values[1] > 1e-3 && values[2] < 1e-12 * values[0]);
+        }
+    }
+
+    std::vector<double> s = ComplexTensor::from_real({3, 0, 4, 5}, 2, 2).singular_values();
+    assert(std::abs(s[0] - 3 * std::sqrt(5.0)) < 1e-13 && std::abs(s[1] - std::sqrt(5.0)) < 1e-13);
+
+    std::cout << "✓ SVD tests passed\n\n";
+}
+
+void test_symmetric_solvers() {
+    std::cout << "Testing Cholesky and the symmetric eigensolver...\n";
+
+    ActiveWindow window;
+    window.set_fancy_mode(false);
+    auto result = run_source(window,
+        "A = [4 -2 1; -2 4 -2; 1 -2 4];\n"
+        "R = chol(A);\n"
+        "E = R' * R;\n"
+        "e = eig(A);\n"
+        "x = [2 1; 0 4] \\ [3; 4];\n"
+        "y = [2 0; 1 4] \\ [2; 5];\n");
+    assert(result.errors.empty());
+    const Variable& R = *window.find_variable("R");
+    const Variable& E = *window.find_variable("E");
+    assert(R(1, 0) == 0.0 && R(2, 0) == 0.0 && R(2, 1) == 0.0);
+    const double A3[] = {4, -2, 1, -2, 4, -2, 1, -2, 4};
+    for (size_t i = 0; i < 9; ++i) assert(std::abs(E(i) - A3[i]) < 1e-12);
+    std::vector<double> e = window.find_variable("e")->as_vector();
+    assert(e.size() == 3 && window.find_variable("e")->rows() == 3);
+    assert(e[0] <= e[1] && e[1] <= e[2]);
+    assert(std::abs(e[0] + e[1] + e[2] - 12.0) < 1e-12);
+    assert(std::abs(e[0] * e[1] * e[2] - 36.0) < 1e-10);
+    assert((window.find_variable("x")->as_vector() == std::vector<double>{1, 1}));
+    assert((window.find_variable("y")->as_vector() == std::vector<double>{1, 1}));
+    assert(run_source(window, "R = chol([1 2; 2 1]);\n").errors.size() == 1);
+    assert(run_source(window, "e = eig([1 2; 3 4]);\n").errors.size() == 1);
+
+    // Several blocks: SPD A = B'B + n I, factored once for many right-hand sides
+    const size_t n = 150;
+    Array B(n, n);
+    for (size_t i = 0; i < B.numel(); ++i) B(i) = std::sin(0.37 * i) + std::cos(1.3 * i * i);
+    Array A = B.transpose() * B;
+    for (size_t i = 0; i < n; ++i) A(i, i) += static_cast<double>(n);
+    CholeskyFactorization chol(A);
+    assert(chol.positive_definite() && chol.size() == n);
+    Array rhs(n, 5);
+    for (size_t i = 0; i < rhs.numel(); ++i) rhs(i) = std::cos(0.1 * i);
+    Array residual = A * chol.solve(rhs);
+    for (size_t i = 0; i < rhs.numel(); ++i) assert(std::abs(residual(i) - rhs(i)) < 1e-10);
+    Array LLt = chol.factor() * chol.factor().transpose();
+    for (size_t i = 0; i < A.numel(); ++i) assert(std::abs(LLt(i) - A(i)) < 1e-9 * A(0, 0));
+    assert(std::abs(CholeskyFactorization(Array(3, 3, std::vector<double>(A3, A3 + 9))).determinant() - 36.0) < 1e-12);
+    Array backslash = left_divide(A, rhs);
+    for (size_t i = 0; i < rhs.numel(); ++i) assert(std::abs((A * backslash)(i) - rhs(i)) < 1e-10);
+
+    // Symmetric but indefinite: Cholesky fails, backslash falls back to LU
+    Array S = A;
+    S(n - 1, n - 1) = -1e4;
+    assert(!CholeskyFactorization(S).positive_definite());
+    Array xs = left_divide(S, rhs);
+    for (size_t i = 0; i < rhs.numel(); ++i) assert(std::abs((S * xs)(i) - rhs(i)) < 1e-9);
+
+    // Dense eigenproblem: several panels and divide-and-conquer levels
+    for (size_t threads : {size_t(1), size_t(4)}) {
+        size_t previous = ThreadPool::global().threads();
+        ThreadPool::global().set_threads(threads);
+        SymmetricEigen eig = eig_symmetric(S);
+        ThreadPool::global().set_threads(previous);
+        const Array& V = eig.vectors;
+        Array AV = S * V, VtV = V.transpose() * V;
+        double scale = std::max(std::abs(eig.values.front()), std::abs(eig.values.back()));
+        for (size_t j = 0; j < n; ++j) {
+            if (j > 0) assert(eig.values[j - 1] <= eig.values[j]);
+            for (size_t i = 0; i < n; ++i) {
+                assert(std::abs(AV(i, j) - eig.values[j] * V(i, j)) < 1e-12 * scale);
+                assert(std::abs(VtV(i, j) - (i == j ? 1.0 : 0.0)) < 1e-12);
+            }
+        }
+        std::vector<double> values = eig_symmetric(S, false).values;
+        for (size_t j = 0; j < n; ++j) assert(std::abs(values[j] - eig.values[j]) < 1e-12 * scale);
+    }
+
+    // Repeated eigenvalues exercise deflation: 2 I + ones(m) has 2 (m - 1
+    // times) and m + 2
+    const size_t m = 100;
+    Array J(m, m);
+    for (size_t i = 0; i < J.numel(); ++i) J(i) = 1.0;
+    for (size_t i = 0; i < m; ++i) J(i, i) = 3.0;
+    SymmetricEigen repeated = eig_symmetric(J);
+    for (size_t j = 0; j + 1 < m; ++j) assert(std::abs(repeated.values[j] - 2.0) < 1e-12);
+    assert(std::abs(repeated.values[m - 1] - (m + 2.0)) < 1e-11);
+    Array JV = J * repeated.vectors, VtV = repeated.vectors.transpose() * repeated.vectors;
+    for (size_t j = 0; j < m; ++j) {
+        for (size_t i = 0; i < m; ++i) {
+            assert(std::abs(JV(i, j) - repeated.values[j] * repeated.vectors(i, j)) < 1e-11);
+            assert(std::abs(VtV(i, j) - (i == j ? 1.0 : 0.0)) < 1e-12);
+        }
+    }
+
+    // Tridiagonal [-1 2 -1]: eigenvalues 2 - 2 cos(k pi / (t + 1))
+    const size_t t = 200;
+    std::vector<double> d(t, 2.0), off(t - 1, -1.0), z(t * t);
+    tridiagonal_eigen(t, d.data(), off.data(), z.data(), t);
+    for (size_t k = 0; k < t; ++k) {
+        assert(std::abs(d[k] - (2.0 - 2.0 * std::cos((k + 1) * M_PI / (t + 1)))) < 1e-13);
+    }
+
+    // Hermitian ComplexTensor: real eigenvalues, ascending
+    const size_t h = 60;
+    ComplexTensor H(h, h);
+    for (size_t i = 0; i < h; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            std::complex<double> v(std::sin(0.3 * i + 0.7 * j), i == j ? 0.0 : std::cos(1.1 * i - 0.2 * j));
+            H(i, j) = v;
+            H(j, i) = std::conj(v);
+        }
+    }
+    std::vector<std::complex<double>> lambda;
+    ComplexTensor X;
+    H.eig(lambda, X);
+    for (size_t j = 0; j < h; ++j) {
+        assert(lambda[j].imag() == 0.0);
+        if (j > 0) assert(lambda[j - 1].real() <= lambda[j].real());
+        for (size_t i = 0; i < h; ++i) {
+            std::complex<double> hx = 0.0;
+            for (size_t k = 0; k < h; ++k) hx += H(i, k) * X(k, j);
+            assert(std::abs(hx - lambda[j] * X(i, j)) < 1e-11);
+        }
+    }
+
+    // Hermitian positive definite solve (Cholesky, several blocks), and a
+    // Hermitian matrix with a positive diagonal that is indefinite (LU)
+    auto residual_ok = [](const ComplexTensor& M, const ComplexTensor& Xs, const ComplexTensor& Rs, double tol) {
+        ComplexTensor MX = M * Xs;
+        for (size_t i = 0; i < MX.rows(); ++i) {
+            for (size_t j = 0; j < MX.cols(); ++j) {
+                if (std::abs(MX(i, j) - Rs(i, j)) > tol) return false;
+            }
+        }
+        return true;
+    };
+    const size_t p = 150;
+    ComplexTensor G(p, p), rhs_c(p, 3);
+    for (size_t i = 0; i < p; ++i) {
+        for (size_t j = 0; j < p; ++j) G(i, j) = {std::sin(0.37 * i + 1.3 * j), std::cos(0.11 * i * j)};
+        for (size_t j = 0; j < 3; ++j) rhs_c(i, j) = {std::cos(0.1 * i + j), 0.5 * j};
+    }
+    ComplexTensor P = G.transpose() * G;
+    for (size_t i = 0; i < p; ++i) {
+        P(i, i) = P(i, i).real() + static_cast<double>(p);
+        for (size_t j = 0; j < i; ++j) P(j, i) = std::conj(P(i, j));  // exactly Hermitian
+    }
+    assert(residual_ok(P, P.solve(rhs_c), rhs_c, 1e-9));
+    ComplexTensor Q(h, h);
+    for (size_t i = 0; i < h; ++i) {
+        for (size_t j = 0; j < h; ++j) Q(i, j) = i == j ? std::complex<double>(1.0) : H(i, j);
+    }
+    ComplexTensor rq(h, 2);
+    for (size_t i = 0; i < h; ++i) rq(i, 0) = rq(i, 1) = {1.0, double(i)};
+    assert(residual_ok(Q, Q.solve(rq), rq, 1e-8));
+
+    std::cout << "✓ Symmetric solver tests passed\n\n";
+}
+
+void test_complex_lu() {
+    std::cout << "Testing complex LU, solve, inv and det...\n";
+
+    using C = std::complex<double>;
+    const size_t n = 150;       // several panels
+    ComplexTensor A(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) A(i, j) = {std::sin(0.37 * i + 1.3 * j), std::cos(0.11 * i * j)};
+        A(i, i) += 8.0;
+    }
+
+    // A(p, :) = L * U with unit lower L and a permutation p
+    ComplexTensor L, U;
+    std::vector<size_t> p;
+    A.lu(L, U, p);
+    ComplexTensor LU = L * U;
+    std::vector<bool> seen(n, false);
+    for (size_t i = 0; i < n; ++i) {
+        assert(p[i] < n && !seen[p[i]]);
+        seen[p[i]] = true;
+        assert(L(i, i) == C(1.0));
+        for (size_t j = 0; j < n; ++j) {
+            if (j > i) assert(L(i, j) == C(0.0));
+            if (j < i) assert(U(i, j) == C(0.0) && std::abs(L(i, j)) <= std::sqrt(2.0) + 1e-12);  // |re| + |im| pivoting
+            assert(std::abs(LU(i, j) - A(p[i], j)) < 1e-12);
+        }
+    }
+
+    // Wide right-hand side, one factorization reused
+    ComplexLUFactorization lu(A);
+    assert(!lu.singular() && lu.size() == n);
+    for (size_t k : {size_t(1), size_t(40)}) {
+        ComplexTensor B(n, k);
+        for (size_t i = 0; i < B.size(); ++i) B.data()[i] = {std::cos(0.1 * i), std::sin(0.3 * i)};
+        ComplexTensor R = A * lu.solve(B);
+        for (size_t i = 0; i < B.size(); ++i) assert(std::abs(R.data()[i] - B.data()[i]) < 1e-10);
+        ComplexTensor X = A.solve(B);
+        assert(X.rows() == n && X.cols() == k);
+    }
+    ComplexTensor I = A * A.inv();
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) assert(std::abs(I(i, j) - C(i == j ? 1.0 : 0.0)) < 1e-10);
+    }
+
+    // det([2 i 0; 1 3 1; 0 -i 1]) = 2 (3 + i) - i (1) = 6 + i
+    ComplexTensor D(3, 3);
+    D(0, 0) = 2.0; D(0, 1) = C(0, 1);
+    D(1, 0) = 1.0; D(1, 1) = 3.0; D(1, 2) = 1.0;
+    D(2, 1) = C(0, -1); D(2, 2) = 1.0;
+    assert(std::abs(D.det() - C(6, 1)) < 1e-12);
+
+    ComplexTensor S(2, 2);
+    S(0, 0) = 1.0; S(0, 1) = C(0, 2);
+    S(1, 0) = C(0, 1); S(1, 1) = -2.0;      // rows are proportional
+    ComplexLUFactorization singular(S);
+    assert(singular.singular() && singular.determinant() == C(0.0));
+    bool threw = false;
+    try { S.inv(); } catch (const std::runtime_error&) { threw = true; }
+    assert(threw);
+
+    std::cout << "✓ Complex LU tests passed\n\n";
+}
+
+int main() {
+    std::cout << "\n";
+    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║  MatLabC++ Linear Algebra Test Suite                       ║\n";
+    std::cout << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+    try {
+        test_complex_decompositions();
+        test_svd();
+        test_symmetric_solvers();
+        test_complex_lu();
+
+        std::cout << "════════════════════════════════════════════════════════════\n";
+        std::cout << "  ALL TESTS PASSED ✓\n";
+        std::cout << "════════════════════════════════════════════════════════════\n\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "\n✗ TEST FAILED: " << e.what() << "\n\n";
+        return 1;
+    }
+}
@@ -0,0 +1,162 @@
+// Test Virtual Device - asynchronous GPU backend
+// tests/test_virtual_device.cpp
+
+#undef NDEBUG  // the checks below are the test; keep them in Release builds
+
+#include "matlabcpp/complex_tensor.hpp"
+#include "matlabcpp/device.hpp"
+#include "matlabcpp/thread_pool.hpp"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace matlabcpp;
+
+void test_virtual_device() {
+    std::cout << "Testing the virtual device...\n";
+
+    std::shared_ptr<DeviceBackend> previous = DeviceBackend::current();
+    auto device = std::make_shared<VirtualDevice>();
+    DeviceBackend::set_current(device);
+
+    ComplexTensor A(40, 30), B(40, 30), M(30, 20);
+    for (size_t i = 0; i < 40; i++) {
+        for (size_t j = 0; j < 30; j++) {
+            A(i, j) = {double(i) - double(j), 0.5 * double(j)};
+            B(i, j) = {1.0 + double(i + j), -0.25 * double(i)};
+            if (i < 30 && j < 20) M(i, j) = {double(i * j % 7), double(j) - 3.0};
+        }
+    }
+    ComplexTensor expected = (A.times(B) + A) * ComplexTensor::Complex(0.5, 1.0);
+    ComplexTensor expected_product = (A - B) * M;
+
+    // A chain of device operations downloads nothing until the host reads
+    device->reset_stats();
+    ComplexTensor dA = A.on_gpu(), dB = B.on_gpu(), dM = M.on_gpu();
+    ComplexTensor r = (dA.times(dB) + dA) * ComplexTensor::Complex(0.5, 1.0);
+    ComplexTensor p = (dA - dB) * dM;
+    assert(r.device() == Device::GPU && p.device() == Device::GPU);
+    DeviceStats s = device->stats();
+    assert(s.transfers_to_device == 3 && s.transfers_to_host == 0);
+    assert(s.bytes_to_device == (2 * 40 * 30 + 30 * 20) * sizeof(ComplexTensor::Complex));
+    assert(s.kernel_launches == 5 && s.synchronizations == 0);
+
+    // One download serves every later read
+    const ComplexTensor& rc = r;
+    for (size_t i = 0; i < 40; i++) {
+        for (size_t j = 0; j < 30; j++) assert(std::abs(rc(i, j) - expected(i, j)) < 1e-12);
+    }
+    for (size_t i = 0; i < 40; i++) {
+        for (size_t j = 0; j < 20; j++) assert(std::abs(p(i, j) - expected_product(i, j)) < 1e-9);
+    }
+    s = device->stats();
+    assert(s.transfers_to_host == 2 && s.synchronizations == 2);
+
+    // A host write goes back up before the next kernel reads it
+    r(0, 0) = 100.0;
+    r.scale_inplace(2.0);
+    assert(device->stats().transfers_to_device == 4);
+    ComplexTensor back = r.on_cpu();
+    assert(back.device() == Device::CPU && back(0, 0) == ComplexTensor::Complex(200.0, 0.0));
+    assert(std::abs(back(3, 4) - 2.0 * expected(3, 4)) < 1e-12);
+
+    // A host operand is uploaded for the call and the result stays on the device
+    ComplexTensor mixed = dA + B;
+    assert(mixed.device() == Device::GPU);
+    assert(std::abs(mixed(5, 6) - (A(5, 6) + B(5, 6))) < 1e-12);
+    ComplexTensor moved = A.on_cpu();
+    moved.to_gpu();
+    moved.conj_inplace();
+    moved.to_cpu();
+    assert(moved.device() == Device::CPU && moved(2, 3) == std::conj(A(2, 3)));
+
+    // Output parameters keep their device buffer
+    ComplexTensor out;
+    dA.plus(dB, out);
+    const ComplexTensor::Complex* before = static_cast<const ComplexTensor&>(out).data();
+    dA.minus(dB, out);
+    assert(static_cast<const ComplexTensor&>(out).data() == before);
+
+    // Releases are stream-ordered: the arena empties once the stream drains
+    size_t held = device->stats().memory_in_use;
+    assert(held > 0);
+    {
+        ComplexTensor t(100, 100, Device::GPU);
+        assert(device->stats().memory_in_use >= held + 100 * 100 * sizeof(ComplexTensor::Complex));
+    }
+    device->default_stream().synchronize();
+    assert(device->stats().memory_in_use == held);
+
+    // A small device: freed ranges coalesce, and a full one throws
+    VirtualDevice::Options options;
+    options.memory_bytes = 4096;
+    VirtualDevice small(options);
+    void* x = small.allocate(1000);
+    void* y = small.allocate(1000);
+    void* z = small.allocate(1000);
+    bool full = false;
+    try {
+        small.allocate(2048);
+    } catch (const std::bad_alloc&) {
+        full = true;
+    }
+    assert(full);
+    small.default_stream().release(x, 1000);
+    small.default_stream().release(y, 1000);
+    void* w = small.allocate(2048);                 // waits for the releases
+    assert(w == x);
+    small.default_stream().release(w, 2048);
+    small.default_stream().release(z, 1000);
+    small.default_stream().synchronize();
+    assert(small.stats().memory_in_use == 0 && small.stats().peak_memory_in_use == 3 * 1024);
+
+    // Extra streams run independently of the default one
+    std::unique_ptr<DeviceStream> stream = small.create_stream();
+    std::vector<ComplexTensor::Complex> host(64, {1.0, 2.0}), result(64);
+    auto* d = static_cast<ComplexTensor::Complex*>(small.allocate(64 * sizeof(ComplexTensor::Complex)));
+    stream->copy_to_device(d, host.data(), 64 * sizeof(ComplexTensor::Complex));
+    host.assign(64, {0.0, 0.0});                    // the upload was staged
+    stream->conj(d, d, 64);
+    stream->copy_to_host(result.data(), d, 64 * sizeof(ComplexTensor::Complex));
+    stream->release(d, 64 * sizeof(ComplexTensor::Complex));
+    stream->synchronize();
+    assert(result[63] == ComplexTensor::Complex(1.0, -2.0));
+
+    // Resizing the host pool waits for the stream kernels that run on it
+    size_t threads = ThreadPool::global().threads();
+    ComplexTensor wide(300, 300);
+    for (size_t i = 0; i < wide.size(); i++) wide.data()[i] = {double(i % 17), 1.0};
+    ComplexTensor dwide = wide.on_gpu(), twice;
+    for (size_t round = 0; round < 20; round++) {
+        dwide.plus(dwide, twice);
+        ThreadPool::global().set_threads(1 + round % 4);
+    }
+    assert(std::abs(twice(299, 299) - 2.0 * wide(299, 299)) < 1e-12);
+    ThreadPool::global().set_threads(threads);
+
+    DeviceBackend::set_current(previous);
+    std::cout << "✓ Virtual device tests passed\n\n";
+}
+
+int main() {
+    std::cout << "\n";
+    std::cout << "╔════════════════════════════════════════════════════════════╗\n";
+    std::cout << "║  MatLabC++ Virtual Device Test Suite                       ║\n";
+    std::cout << "╚════════════════════════════════════════════════════════════╝\n\n";
+
+    try {
+        test_virtual_device();
+
+        std::cout << "════════════════════════════════════════════════════════════\n";
+        std::cout << "  ALL TESTS PASSED ✓\n";
+        std::cout << "════════════════════════════════════════════════════════════\n\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cout << "\n✗ TEST FAILED: " << e.what() << "\n\n";
+        return 1;
+    }
+}